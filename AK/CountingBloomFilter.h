@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/NumericLimits.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A Bloom filter whose buckets are counters rather than bits, so keys can be removed again.
+// Each key is expected to be a well-distributed 32-bit hash, of which two key_bits-sized slices select the buckets.
+// A bucket that reaches the maximum counter value sticks there, which only ever produces false positives.
+template<typename CounterType, size_t key_bits>
+class CountingBloomFilter {
+public:
+    static_assert(key_bits > 0 && key_bits <= 16);
+    static constexpr size_t bucket_count = 1 << key_bits;
+    static constexpr u32 key_mask = bucket_count - 1;
+
+    void clear()
+    {
+        for (auto& bucket : m_buckets)
+            bucket = 0;
+    }
+
+    void increment(u32 key)
+    {
+        increment_bucket(first_bucket(key));
+        increment_bucket(second_bucket(key));
+    }
+
+    void decrement(u32 key)
+    {
+        decrement_bucket(first_bucket(key));
+        decrement_bucket(second_bucket(key));
+    }
+
+    [[nodiscard]] bool may_contain(u32 key) const
+    {
+        return first_bucket(key) != 0 && second_bucket(key) != 0;
+    }
+
+    [[nodiscard]] bool is_empty() const
+    {
+        for (auto bucket : m_buckets) {
+            if (bucket != 0)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr CounterType max_count = NumericLimits<CounterType>::max();
+
+    CounterType& first_bucket(u32 key) { return m_buckets[key & key_mask]; }
+    CounterType& second_bucket(u32 key) { return m_buckets[(key >> 16) & key_mask]; }
+    CounterType first_bucket(u32 key) const { return m_buckets[key & key_mask]; }
+    CounterType second_bucket(u32 key) const { return m_buckets[(key >> 16) & key_mask]; }
+
+    static void increment_bucket(CounterType& bucket)
+    {
+        if (bucket != max_count)
+            ++bucket;
+    }
+
+    static void decrement_bucket(CounterType& bucket)
+    {
+        VERIFY(bucket != 0);
+        if (bucket != max_count)
+            --bucket;
+    }
+
+    CounterType m_buckets[bucket_count] {};
+};
+
+}
+
+using AK::CountingBloomFilter;
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Concepts.h>
 #include <AK/Error.h>
 #include <AK/Forward.h>
 #include <AK/HashFunctions.h>
+#include <AK/Platform.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Traits.h>
 #include <AK/Types.h>
@@ -28,28 +30,103 @@ enum class HashSetExistingEntryBehavior {
     Replace
 };
 
-// Upper nibble determines state class:
-// - 0: unused bucket
-// - 1: used bucket
-// - F: end bucket
-// Lower nibble determines state within a class.
+// Each bucket has a control byte, which are kept in an array of their own so that a whole group of them can be
+// matched against a hash at once. Used buckets store the low 7 bits of their hash, which leaves the top bit for
+// the other states.
 enum class BucketState : u8 {
-    Free = 0x00,
-    Used = 0x10,
-    Deleted = 0x01,
-    Rehashed = 0x12,
+    Free = 0x80,
+    Deleted = 0xFE,
     End = 0xFF,
 };
 
-// Note that because there's the end state, used and free are not 100% opposites!
-constexpr bool is_used_bucket(BucketState state)
+constexpr bool is_used_bucket(u8 control)
 {
-    return (static_cast<u8>(state) & 0xf0) == 0x10;
+    return (control & 0x80) == 0;
 }
 
-constexpr bool is_free_bucket(BucketState state)
+constexpr bool is_free_bucket(u8 control)
 {
-    return (static_cast<u8>(state) & 0xf0) == 0x00;
+    return control == static_cast<u8>(BucketState::Free) || control == static_cast<u8>(BucketState::Deleted);
+}
+
+namespace Detail {
+
+// The bits of a group match, one per bucket (or one per byte, of which only the top bit is set).
+template<size_t Shift>
+class HashTableGroupMatch {
+public:
+    explicit constexpr HashTableGroupMatch(u64 bits)
+        : m_bits(bits)
+    {
+    }
+
+    explicit constexpr operator bool() const { return m_bits != 0; }
+    constexpr size_t first() const { return count_trailing_zeroes(m_bits) >> Shift; }
+    constexpr void remove_first() { m_bits &= m_bits - 1; }
+
+private:
+    u64 m_bits;
+};
+
+#if (ARCH(I386) || ARCH(X86_64)) && defined(__SSE2__)
+// Matches 16 control bytes at once with SSE2.
+class HashTableGroup {
+public:
+    static constexpr size_t width = 16;
+    using Match = HashTableGroupMatch<0>;
+
+    explicit HashTableGroup(u8 const* control)
+    {
+        __builtin_memcpy(&m_control, control, sizeof(m_control));
+    }
+
+    Match match(u8 hash) const { return Match(mask_of(m_control == splat(hash))); }
+    Match match_free() const { return Match(mask_of(m_control == splat(static_cast<u8>(BucketState::Free)))); }
+    // Free and deleted buckets are the only ones with the top bit set that are smaller than the end marker.
+    Match match_free_or_deleted() const { return Match(mask_of(m_control < splat(static_cast<u8>(BucketState::End)))); }
+
+private:
+    using Vector = char __attribute__((vector_size(16)));
+
+    static Vector splat(u8 value)
+    {
+        auto element = static_cast<char>(value);
+        return Vector { element, element, element, element, element, element, element, element, element, element, element, element, element, element, element, element };
+    }
+    static u64 mask_of(Vector comparison) { return static_cast<u16>(__builtin_ia32_pmovmskb128(comparison)); }
+
+    Vector m_control;
+};
+#else
+// Matches 8 control bytes at once in a 64-bit integer, for when SSE2 is not available (as is the case in the Kernel).
+class HashTableGroup {
+public:
+    static constexpr size_t width = 8;
+    using Match = HashTableGroupMatch<3>;
+
+    explicit HashTableGroup(u8 const* control)
+    {
+        __builtin_memcpy(&m_control, control, sizeof(m_control));
+    }
+
+    // NOTE: This can report a used bucket right after a matching one as a false positive, which is harmless since
+    //       every match is compared with the value anyway.
+    Match match(u8 hash) const
+    {
+        auto bits = m_control ^ (lsbs * hash);
+        return Match((bits - lsbs) & ~bits & msbs);
+    }
+    Match match_free() const { return Match(m_control & (~m_control << 6) & msbs); }
+    Match match_free_or_deleted() const { return Match(m_control & (~m_control << 7) & msbs); }
+
+private:
+    static constexpr u64 lsbs = 0x0101010101010101;
+    static constexpr u64 msbs = 0x8080808080808080;
+
+    u64 m_control;
+};
+#endif
+
 }
 
 template<typename HashTableType, typename T, typename BucketType>
@@ -70,19 +147,20 @@ private:
             return;
         do {
             ++m_bucket;
-            if (m_bucket->state == BucketState::Used)
-                return;
-        } while (m_bucket->state != BucketState::End);
-        if (m_bucket->state == BucketState::End)
+            ++m_control;
+        } while (is_free_bucket(*m_control));
+        if (*m_control == static_cast<u8>(BucketState::End))
             m_bucket = nullptr;
     }
 
-    explicit HashTableIterator(BucketType* bucket)
+    HashTableIterator(BucketType* bucket, u8 const* control)
         : m_bucket(bucket)
+        , m_control(control)
     {
     }
 
     BucketType* m_bucket { nullptr };
+    u8 const* m_control { nullptr };
 };
 
 template<typename OrderedHashTableType, typename T, typename BucketType>
@@ -103,15 +181,19 @@ private:
     {
     }
 
+    OrderedHashTableIterator(BucketType* bucket, u8 const*)
+        : m_bucket(bucket)
+    {
+    }
+
     BucketType* m_bucket { nullptr };
 };
 
 template<typename T, typename TraitsForT, bool IsOrdered>
 class HashTable {
-    static constexpr size_t load_factor_in_percent = 60;
+    using Group = Detail::HashTableGroup;
 
     struct Bucket {
-        BucketState state;
         alignas(T) u8 storage[sizeof(T)];
 
         T* slot() { return reinterpret_cast<T*>(storage); }
@@ -121,7 +203,6 @@ class HashTable {
     struct OrderedBucket {
         OrderedBucket* previous;
         OrderedBucket* next;
-        BucketState state;
         alignas(T) u8 storage[sizeof(T)];
         T* slot() { return reinterpret_cast<T*>(storage); }
         const T* slot() const { return reinterpret_cast<const T*>(storage); }
@@ -148,9 +229,11 @@ public:
         if (!m_buckets)
             return;
 
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                m_buckets[i].slot()->~T();
+        if constexpr (!Detail::IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (is_used_bucket(m_control[i]))
+                    m_buckets[i].slot()->~T();
+            }
         }
 
         kfree_sized(m_buckets, size_in_bytes(m_capacity));
@@ -172,15 +255,17 @@ public:
 
     HashTable(HashTable&& other) noexcept
         : m_buckets(other.m_buckets)
+        , m_control(other.m_control)
         , m_collection_data(other.m_collection_data)
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
-        , m_deleted_count(other.m_deleted_count)
+        , m_growth_left(other.m_growth_left)
     {
         other.m_size = 0;
         other.m_capacity = 0;
-        other.m_deleted_count = 0;
+        other.m_growth_left = 0;
         other.m_buckets = nullptr;
+        other.m_control = nullptr;
         if constexpr (IsOrdered)
             other.m_collection_data = { nullptr, nullptr };
     }
@@ -195,9 +280,10 @@ public:
     friend void swap(HashTable& a, HashTable& b) noexcept
     {
         swap(a.m_buckets, b.m_buckets);
+        swap(a.m_control, b.m_control);
         swap(a.m_size, b.m_size);
         swap(a.m_capacity, b.m_capacity);
-        swap(a.m_deleted_count, b.m_deleted_count);
+        swap(a.m_growth_left, b.m_growth_left);
 
         if constexpr (IsOrdered)
             swap(a.m_collection_data, b.m_collection_data);
@@ -222,14 +308,17 @@ public:
 
     void ensure_capacity(size_t capacity)
     {
-        VERIFY(capacity >= size());
-        rehash(capacity * 2);
+        MUST(try_ensure_capacity(capacity));
     }
 
     ErrorOr<void> try_ensure_capacity(size_t capacity)
     {
         VERIFY(capacity >= size());
-        return try_rehash(capacity * 2);
+        // Inserting into a deleted bucket doesn't take away from the growth left, so this guarantees that no
+        // allocation happens until the table holds `capacity` values.
+        if (capacity - size() <= m_growth_left)
+            return {};
+        return try_rehash(max(capacity_for_size(capacity), m_capacity));
     }
 
     [[nodiscard]] bool contains(T const& value) const
@@ -253,15 +342,15 @@ public:
             return Iterator(m_collection_data.head);
 
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                return Iterator(&m_buckets[i]);
+            if (is_used_bucket(m_control[i]))
+                return Iterator(&m_buckets[i], &m_control[i]);
         }
         return end();
     }
 
     [[nodiscard]] Iterator end()
     {
-        return Iterator(nullptr);
+        return Iterator(nullptr, nullptr);
     }
 
     using ConstIterator = Conditional<IsOrdered,
@@ -274,15 +363,15 @@ public:
             return ConstIterator(m_collection_data.head);
 
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                return ConstIterator(&m_buckets[i]);
+            if (is_used_bucket(m_control[i]))
+                return ConstIterator(&m_buckets[i], &m_control[i]);
         }
         return end();
     }
 
     [[nodiscard]] ConstIterator end() const
     {
-        return ConstIterator(nullptr);
+        return ConstIterator(nullptr, nullptr);
     }
 
     void clear()
@@ -291,47 +380,35 @@ public:
     }
     void clear_with_capacity()
     {
+        if (!m_buckets)
+            return;
         if constexpr (!Detail::IsTriviallyDestructible<T>) {
-            for (auto* bucket : *this)
-                bucket->~T();
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (is_used_bucket(m_control[i]))
+                    m_buckets[i].slot()->~T();
+            }
         }
-        __builtin_memset(m_buckets, 0, size_in_bytes(capacity()));
+        reset_control_bytes();
         m_size = 0;
-        m_deleted_count = 0;
 
         if constexpr (IsOrdered)
             m_collection_data = { nullptr, nullptr };
-        else
-            m_buckets[m_capacity].state = BucketState::End;
     }
 
     template<typename U = T>
     ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
     {
-        auto* bucket = TRY(try_lookup_for_writing(value));
-        if (is_used_bucket(bucket->state)) {
+        auto hash = TraitsForT::hash(value);
+        if (auto* bucket = lookup_with_hash(hash, [&](auto& other) { return TraitsForT::equals(other, value); })) {
             if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
                 return HashSetResult::KeptExistingEntry;
             (*bucket->slot()) = forward<U>(value);
             return HashSetResult::ReplacedExistingEntry;
         }
 
-        new (bucket->slot()) T(forward<U>(value));
-        if (bucket->state == BucketState::Deleted)
-            --m_deleted_count;
-        bucket->state = BucketState::Used;
-
-        if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
-                m_collection_data.head = bucket;
-            } else {
-                bucket->previous = m_collection_data.tail;
-                m_collection_data.tail->next = bucket;
-            }
-            m_collection_data.tail = bucket;
-        }
-
-        ++m_size;
+        auto index = TRY(try_find_bucket_for_insertion(hash));
+        new (m_buckets[index].slot()) T(forward<U>(value));
+        occupy_bucket(index, hash);
         return HashSetResult::InsertedNewEntry;
     }
     template<typename U = T>
@@ -343,7 +420,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
     {
-        return Iterator(lookup_with_hash(hash, move(predicate)));
+        return make_iterator<Iterator>(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] Iterator find(T const& value)
@@ -354,7 +431,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
     {
-        return ConstIterator(lookup_with_hash(hash, move(predicate)));
+        return make_iterator<ConstIterator>(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] ConstIterator find(T const& value) const
@@ -411,14 +488,10 @@ public:
     void remove(Iterator iterator)
     {
         VERIFY(iterator.m_bucket);
-        auto& bucket = *iterator.m_bucket;
-        VERIFY(is_used_bucket(bucket.state));
+        size_t index = iterator.m_bucket - m_buckets;
+        VERIFY(is_used_bucket(m_control[index]));
 
-        delete_bucket(bucket);
-        --m_size;
-        ++m_deleted_count;
-
-        rehash_in_place_if_needed();
+        delete_bucket(index);
     }
 
     template<typename TUnaryPredicate>
@@ -426,80 +499,127 @@ public:
     {
         size_t removed_count = 0;
         for (size_t i = 0; i < m_capacity; ++i) {
-            auto& bucket = m_buckets[i];
-            if (is_used_bucket(bucket.state) && predicate(*bucket.slot())) {
-                delete_bucket(bucket);
+            if (is_used_bucket(m_control[i]) && predicate(*m_buckets[i].slot())) {
+                delete_bucket(i);
                 ++removed_count;
             }
         }
-        if (removed_count) {
-            m_deleted_count += removed_count;
-            m_size -= removed_count;
-        }
-        rehash_in_place_if_needed();
         return removed_count;
     }
 
 private:
-    void insert_during_rehash(T&& value)
-    {
-        auto& bucket = lookup_for_writing(value);
-        new (bucket.slot()) T(move(value));
-        bucket.state = BucketState::Used;
+    // The hash is split into the part that selects the group to start probing at, and the 7 bits that are stored in
+    // the control bytes. Both are taken from a mix of all the bits of the hash, as many hash functions only vary in
+    // the low bits for similar values.
+    static constexpr u32 mix_hash(u32 hash)
+    {
+        hash ^= hash >> 16;
+        hash *= 0x7feb352d;
+        hash ^= hash >> 15;
+        return hash;
+    }
+    static constexpr size_t group_hash(u32 mixed_hash) { return mixed_hash >> 7; }
+    static constexpr u8 control_hash(u32 mixed_hash) { return mixed_hash & 0x7f; }
+
+    // The buckets are probed a group at a time, and the groups are visited in triangular steps which cover all of them
+    // since their count is a power of two. Tables that are smaller than a group have their control bytes padded with
+    // end markers, so they consist of a single group.
+    class ProbeSequence {
+    public:
+        ProbeSequence(u32 mixed_hash, size_t capacity)
+            : m_mask(capacity > Group::width ? capacity / Group::width - 1 : 0)
+            , m_group(group_hash(mixed_hash) & m_mask)
+        {
+        }
 
-        if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
-                m_collection_data.head = &bucket;
-            } else {
-                bucket.previous = m_collection_data.tail;
-                m_collection_data.tail->next = &bucket;
-            }
-            m_collection_data.tail = &bucket;
+        size_t offset() const { return m_group * Group::width; }
+        void next()
+        {
+            ++m_step;
+            m_group = (m_group + m_step) & m_mask;
         }
+
+    private:
+        size_t m_mask { 0 };
+        size_t m_group { 0 };
+        size_t m_step { 0 };
+    };
+
+    // A table keeps at least one free bucket, and tables that span multiple groups keep an eighth of them free, so that
+    // probing for values that aren't in the table ends early.
+    [[nodiscard]] static constexpr size_t capacity_to_growth(size_t capacity)
+    {
+        if (capacity < 8)
+            return capacity - 1;
+        return capacity - capacity / 8;
+    }
+
+    [[nodiscard]] static constexpr size_t capacity_for_size(size_t size)
+    {
+        size_t capacity = 4;
+        while (capacity_to_growth(capacity) < size)
+            capacity *= 2;
+        return capacity;
+    }
+
+    [[nodiscard]] static constexpr size_t control_bytes_count(size_t capacity)
+    {
+        return max(capacity, Group::width) + 1;
     }
 
     [[nodiscard]] static constexpr size_t size_in_bytes(size_t capacity)
     {
-        if constexpr (IsOrdered) {
-            return sizeof(BucketType) * capacity;
-        } else {
-            return sizeof(BucketType) * (capacity + 1);
-        }
+        return sizeof(BucketType) * capacity + control_bytes_count(capacity);
     }
 
-    ErrorOr<void> try_rehash(size_t new_capacity)
+    template<typename IteratorType, typename BucketPointer>
+    IteratorType make_iterator(BucketPointer bucket) const
     {
-        if (new_capacity == m_capacity && new_capacity >= 4) {
-            rehash_in_place();
-            return {};
-        }
+        if (!bucket)
+            return IteratorType(nullptr, nullptr);
+        return IteratorType(bucket, &m_control[bucket - m_buckets]);
+    }
 
-        new_capacity = max(new_capacity, static_cast<size_t>(4));
-        new_capacity = kmalloc_good_size(new_capacity * sizeof(BucketType)) / sizeof(BucketType);
+    void reset_control_bytes()
+    {
+        __builtin_memset(m_control, static_cast<u8>(BucketState::Free), m_capacity);
+        __builtin_memset(m_control + m_capacity, static_cast<u8>(BucketState::End), control_bytes_count(m_capacity) - m_capacity);
+        m_growth_left = capacity_to_growth(m_capacity);
+    }
 
-        auto* old_buckets = m_buckets;
-        auto old_capacity = m_capacity;
-        Iterator old_iter = begin();
+    ErrorOr<void> try_rehash(size_t new_capacity)
+    {
+        new_capacity = max(new_capacity, static_cast<size_t>(4));
+        if (new_capacity & (new_capacity - 1))
+            new_capacity = static_cast<size_t>(1) << (sizeof(size_t) * 8 - count_leading_zeroes(new_capacity));
+        VERIFY(capacity_to_growth(new_capacity) >= m_size);
 
-        auto* new_buckets = kcalloc(1, size_in_bytes(new_capacity));
+        auto* new_buckets = kmalloc(size_in_bytes(new_capacity));
         if (!new_buckets)
             return Error::from_errno(ENOMEM);
 
-        m_buckets = (BucketType*)new_buckets;
+        auto* old_buckets = m_buckets;
+        auto old_capacity = m_capacity;
+        Iterator old_iter = begin();
 
+        m_buckets = static_cast<BucketType*>(new_buckets);
+        m_control = reinterpret_cast<u8*>(m_buckets + new_capacity);
         m_capacity = new_capacity;
-        m_deleted_count = 0;
+        m_size = 0;
+        reset_control_bytes();
 
         if constexpr (IsOrdered)
             m_collection_data = { nullptr, nullptr };
-        else
-            m_buckets[m_capacity].state = BucketState::End;
 
         if (!old_buckets)
             return {};
 
+        // NOTE: The values are moved over in the order that they are iterated in, which keeps ordered tables ordered.
         for (auto it = move(old_iter); it != end(); ++it) {
-            insert_during_rehash(move(*it));
+            auto hash = TraitsForT::hash(*it);
+            auto index = find_free_bucket(mix_hash(hash));
+            new (m_buckets[index].slot()) T(move(*it));
+            occupy_bucket(index, hash);
             it->~T();
         }
 
@@ -511,193 +631,89 @@ private:
         MUST(try_rehash(new_capacity));
     }
 
-    void rehash_in_place()
+    template<typename TUnaryPredicate>
+    [[nodiscard]] BucketType* lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
     {
-        // FIXME: This implementation takes two loops over the entire bucket array, but avoids re-allocation.
-        //        Please benchmark your new implementation before you replace this.
-        //        The reason is that because of collisions, we use the special "rehashed" bucket state to mark already-rehashed used buckets.
-        //        Because we of course want to write into old used buckets, but already rehashed data shall not be touched.
-
-        // FIXME: Find a way to reduce the cognitive complexity of this function.
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            auto& bucket = m_buckets[i];
-
-            // FIXME: Bail out when we have handled every filled bucket.
-
-            if (bucket.state == BucketState::Rehashed || bucket.state == BucketState::End || bucket.state == BucketState::Free)
-                continue;
-            if (bucket.state == BucketState::Deleted) {
-                bucket.state = BucketState::Free;
-                continue;
-            }
-
-            auto const new_hash = TraitsForT::hash(*bucket.slot());
-            if (new_hash % m_capacity == i) {
-                bucket.state = BucketState::Rehashed;
-                continue;
-            }
+        if (is_empty())
+            return nullptr;
 
-            auto target_hash = new_hash;
-            auto const to_move_hash = i;
-            BucketType* target_bucket = &m_buckets[target_hash % m_capacity];
-            BucketType* bucket_to_move = &m_buckets[i];
-
-            // Try to move the bucket to move into its correct spot.
-            // During the procedure, we might re-hash or actually change the bucket to move.
-            while (!is_free_bucket(bucket_to_move->state)) {
-
-                // If we're targeting ourselves, there's nothing to do.
-                if (to_move_hash == target_hash % m_capacity) {
-                    bucket_to_move->state = BucketState::Rehashed;
-                    break;
-                }
-
-                if (is_free_bucket(target_bucket->state)) {
-                    // We can just overwrite the target bucket and bail out.
-                    new (target_bucket->slot()) T(move(*bucket_to_move->slot()));
-                    target_bucket->state = BucketState::Rehashed;
-                    bucket_to_move->state = BucketState::Free;
-
-                    if constexpr (IsOrdered) {
-                        swap(bucket_to_move->previous, target_bucket->previous);
-                        swap(bucket_to_move->next, target_bucket->next);
-
-                        if (target_bucket->previous)
-                            target_bucket->previous->next = target_bucket;
-                        else
-                            m_collection_data.head = target_bucket;
-                        if (target_bucket->next)
-                            target_bucket->next->previous = target_bucket;
-                        else
-                            m_collection_data.tail = target_bucket;
-                    }
-                } else if (target_bucket->state == BucketState::Rehashed) {
-                    // If the target bucket is already re-hashed, we do normal probing.
-                    target_hash = double_hash(target_hash);
-                    target_bucket = &m_buckets[target_hash % m_capacity];
-                } else {
-                    VERIFY(target_bucket->state != BucketState::End);
-                    // The target bucket is a used bucket that hasn't been re-hashed.
-                    // Swap the data into the target; now the target's data resides in the bucket to move again.
-                    // (That's of course what we want, how neat!)
-                    swap(*bucket_to_move->slot(), *target_bucket->slot());
-                    bucket_to_move->state = target_bucket->state;
-                    target_bucket->state = BucketState::Rehashed;
-
-                    if constexpr (IsOrdered) {
-                        // Update state for the target bucket, we'll do the bucket to move later.
-                        swap(bucket_to_move->previous, target_bucket->previous);
-                        swap(bucket_to_move->next, target_bucket->next);
-
-                        if (target_bucket->previous)
-                            target_bucket->previous->next = target_bucket;
-                        else
-                            m_collection_data.head = target_bucket;
-                        if (target_bucket->next)
-                            target_bucket->next->previous = target_bucket;
-                        else
-                            m_collection_data.tail = target_bucket;
-                    }
-
-                    target_hash = TraitsForT::hash(*bucket_to_move->slot());
-                    target_bucket = &m_buckets[target_hash % m_capacity];
-
-                    // The data is already in the correct location: Adjust the pointers
-                    if (target_hash % m_capacity == to_move_hash) {
-                        bucket_to_move->state = BucketState::Rehashed;
-                        if constexpr (IsOrdered) {
-                            // Update state for the bucket to move as it's not actually moved anymore.
-                            if (bucket_to_move->previous)
-                                bucket_to_move->previous->next = bucket_to_move;
-                            else
-                                m_collection_data.head = bucket_to_move;
-                            if (bucket_to_move->next)
-                                bucket_to_move->next->previous = bucket_to_move;
-                            else
-                                m_collection_data.tail = bucket_to_move;
-                        }
-                        break;
-                    }
-                }
+        auto mixed_hash = mix_hash(hash);
+        auto expected_control = control_hash(mixed_hash);
+        for (ProbeSequence sequence(mixed_hash, m_capacity);; sequence.next()) {
+            Group group(m_control + sequence.offset());
+            for (auto match = group.match(expected_control); match; match.remove_first()) {
+                auto& bucket = m_buckets[sequence.offset() + match.first()];
+                if (predicate(*bucket.slot()))
+                    return &bucket;
             }
-            // After this, the bucket_to_move either contains data that rehashes to itself, or it contains nothing as we were able to move the last thing.
-            if (bucket_to_move->state == BucketState::Deleted)
-                bucket_to_move->state = BucketState::Free;
-        }
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].state == BucketState::Rehashed)
-                m_buckets[i].state = BucketState::Used;
+            // Values are only ever placed past a group once it is full, so a free bucket ends the search.
+            if (group.match_free())
+                return nullptr;
         }
-
-        m_deleted_count = 0;
     }
 
-    void rehash_in_place_if_needed()
+    [[nodiscard]] size_t find_free_bucket(u32 mixed_hash) const
     {
-        // This signals a "thrashed" hash table with many deleted slots.
-        if (m_deleted_count >= m_size && should_grow())
-            rehash_in_place();
+        for (ProbeSequence sequence(mixed_hash, m_capacity);; sequence.next()) {
+            auto match = Group(m_control + sequence.offset()).match_free_or_deleted();
+            if (match)
+                return sequence.offset() + match.first();
+        }
     }
 
-    template<typename TUnaryPredicate>
-    [[nodiscard]] BucketType* lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
+    ErrorOr<size_t> try_find_bucket_for_insertion(unsigned hash)
     {
-        if (is_empty())
-            return nullptr;
-
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (is_used_bucket(bucket.state) && predicate(*bucket.slot()))
-                return &bucket;
-
-            if (bucket.state != BucketState::Used && bucket.state != BucketState::Deleted)
-                return nullptr;
-
-            hash = double_hash(hash);
+        if (!m_buckets)
+            TRY(try_rehash(4));
+
+        auto mixed_hash = mix_hash(hash);
+        auto index = find_free_bucket(mixed_hash);
+        if (m_growth_left == 0 && m_control[index] == static_cast<u8>(BucketState::Free)) {
+            // Once the table has run out of free buckets, it's rebuilt at the same size if enough of the used ones have
+            // been deleted since, so that a table that sees a lot of insertions and removals doesn't keep growing.
+            if (m_size * 32 <= m_capacity * 25 && m_size < capacity_to_growth(m_capacity))
+                TRY(try_rehash(m_capacity));
+            else
+                TRY(try_rehash(m_capacity * 2));
+            index = find_free_bucket(mixed_hash);
         }
+        return index;
     }
 
-    ErrorOr<BucketType*> try_lookup_for_writing(T const& value)
+    void occupy_bucket(size_t index, unsigned hash)
     {
-        // FIXME: Maybe overrun the "allowed" load factor to avoid OOM
-        //        If we are allowed to do that, separate that logic from
-        //        the normal lookup_for_writing
-        if (should_grow())
-            TRY(try_rehash(capacity() * 2));
-        auto hash = TraitsForT::hash(value);
-        BucketType* first_empty_bucket = nullptr;
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (is_used_bucket(bucket.state) && TraitsForT::equals(*bucket.slot(), value))
-                return &bucket;
-
-            if (!is_used_bucket(bucket.state)) {
-                if (!first_empty_bucket)
-                    first_empty_bucket = &bucket;
-
-                if (bucket.state != BucketState::Deleted)
-                    return const_cast<BucketType*>(first_empty_bucket);
-            }
+        if (m_control[index] == static_cast<u8>(BucketState::Free))
+            --m_growth_left;
+        m_control[index] = control_hash(mix_hash(hash));
+        ++m_size;
 
-            hash = double_hash(hash);
+        if constexpr (IsOrdered) {
+            auto& bucket = m_buckets[index];
+            bucket.previous = m_collection_data.tail;
+            bucket.next = nullptr;
+            if (!m_collection_data.head) [[unlikely]]
+                m_collection_data.head = &bucket;
+            else
+                m_collection_data.tail->next = &bucket;
+            m_collection_data.tail = &bucket;
         }
     }
-    [[nodiscard]] BucketType& lookup_for_writing(T const& value)
-    {
-        return *MUST(try_lookup_for_writing(value));
-    }
-
-    [[nodiscard]] size_t used_bucket_count() const { return m_size + m_deleted_count; }
-    [[nodiscard]] bool should_grow() const { return ((used_bucket_count() + 1) * 100) >= (m_capacity * load_factor_in_percent); }
 
-    void delete_bucket(auto& bucket)
+    void delete_bucket(size_t index)
     {
+        auto& bucket = m_buckets[index];
         bucket.slot()->~T();
-        bucket.state = BucketState::Deleted;
+        --m_size;
+
+        // If the group of this bucket still has a free bucket, no lookup has ever probed past it, so the bucket can be
+        // made free again. Otherwise it has to be marked as deleted, which lookups step over.
+        size_t group_offset = index - index % Group::width;
+        if (Group(m_control + group_offset).match_free()) {
+            m_control[index] = static_cast<u8>(BucketState::Free);
+            ++m_growth_left;
+        } else {
+            m_control[index] = static_cast<u8>(BucketState::Deleted);
+        }
 
         if constexpr (IsOrdered) {
             if (bucket.previous)
@@ -713,11 +729,13 @@ private:
     }
 
     BucketType* m_buckets { nullptr };
+    u8* m_control { nullptr };
 
     [[no_unique_address]] CollectionDataType m_collection_data;
     size_t m_size { 0 };
     size_t m_capacity { 0 };
-    size_t m_deleted_count { 0 };
+    // The number of free buckets that can be used before the table has to be rebuilt.
+    size_t m_growth_left { 0 };
 };
 }
 
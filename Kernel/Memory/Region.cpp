@@ -119,7 +119,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
 
     // Set up a COW region. The parent (this) region becomes COW as well!
     if (is_writable())
-        remap();
+        remap_mapped_pages();
 
     OwnPtr<KString> clone_region_name;
     if (m_name)
@@ -322,6 +322,35 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     return ENOMEM;
 }
 
+void Region::map_on_demand(PageDirectory& page_directory)
+{
+    SpinlockLocker page_lock(page_directory.get_lock());
+    SpinlockLocker lock(s_mm_lock);
+
+    if (is_user() && !is_shared()) {
+        VERIFY(!vmobject().is_shared_inode());
+    }
+
+    set_page_directory(page_directory);
+}
+
+void Region::remap_mapped_pages()
+{
+    VERIFY(m_page_directory);
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    SpinlockLocker lock(s_mm_lock);
+
+    for (size_t page_index = 0; page_index < page_count(); ++page_index) {
+        auto* pte = MM.pte(*m_page_directory, vaddr_from_page_index(page_index));
+        if (!pte || !pte->is_present())
+            continue;
+        // NOTE: The page table is already there, so this can't fail.
+        bool success = map_individual_page_impl(page_index);
+        VERIFY(success);
+    }
+    MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
+}
+
 void Region::remap()
 {
     VERIFY(m_page_directory);
@@ -373,6 +402,13 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
         }
 
         auto& page_slot = physical_page_slot(page_index_in_region);
+        if (page_slot && !page_slot->is_lazy_committed_page()) {
+            // The page is there, it just hasn't been mapped yet. This is the case for regions mapped on demand.
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(on demand) fault in Region({})[{}]", this, page_index_in_region);
+            if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region)))
+                return PageFaultResponse::OutOfMemory;
+            return PageFaultResponse::Continue;
+        }
         if (page_slot->is_lazy_committed_page()) {
             auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
             VERIFY(m_vmobject->is_anonymous());
@@ -182,10 +182,14 @@ public:
 
     void set_page_directory(PageDirectory&);
     ErrorOr<void> map(PageDirectory&, ShouldFlushTLB = ShouldFlushTLB::Yes);
+    // Attaches the region to the page directory without mapping any pages. They're mapped when first accessed instead.
+    void map_on_demand(PageDirectory&);
     void unmap(ShouldFlushTLB = ShouldFlushTLB::Yes);
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock>& pd_locker, SpinlockLocker<RecursiveSpinlock>& mm_locker);
 
     void remap();
+    // Like remap(), but leaves pages that aren't mapped alone, so they're still mapped on demand.
+    void remap_mapped_pages();
 
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
@@ -111,7 +111,8 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
         for (auto& region : address_space().regions()) {
             dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
             auto region_clone = TRY(region.try_clone());
-            TRY(region_clone->map(child->address_space().page_directory(), Memory::ShouldFlushTLB::No));
+            // NOTE: Most children exec soon after forking, so their page tables are only filled in as they're used.
+            region_clone->map_on_demand(child->address_space().page_directory());
             TRY(child->address_space().region_tree().place_specifically(*region_clone, region.range()));
             auto* child_region = region_clone.leak_ptr();
 
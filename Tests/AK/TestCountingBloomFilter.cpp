@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/CountingBloomFilter.h>
+#include <AK/StringHash.h>
+
+static u32 hash_of(StringView string)
+{
+    return string_hash(string.characters_without_null_termination(), string.length());
+}
+
+TEST_CASE(construct_empty)
+{
+    CountingBloomFilter<u8, 10> filter;
+    EXPECT(filter.is_empty());
+    EXPECT(!filter.may_contain(hash_of("div"sv)));
+}
+
+TEST_CASE(increment_and_decrement)
+{
+    CountingBloomFilter<u8, 10> filter;
+    filter.increment(hash_of("div"sv));
+    filter.increment(hash_of("span"sv));
+    EXPECT(filter.may_contain(hash_of("div"sv)));
+    EXPECT(filter.may_contain(hash_of("span"sv)));
+
+    filter.decrement(hash_of("div"sv));
+    EXPECT(filter.may_contain(hash_of("span"sv)));
+
+    filter.decrement(hash_of("span"sv));
+    EXPECT(filter.is_empty());
+}
+
+TEST_CASE(repeated_keys)
+{
+    CountingBloomFilter<u8, 10> filter;
+    filter.increment(hash_of("div"sv));
+    filter.increment(hash_of("div"sv));
+    filter.decrement(hash_of("div"sv));
+    EXPECT(filter.may_contain(hash_of("div"sv)));
+    filter.decrement(hash_of("div"sv));
+    EXPECT(!filter.may_contain(hash_of("div"sv)));
+}
+
+TEST_CASE(saturated_buckets_stay_set)
+{
+    CountingBloomFilter<u8, 10> filter;
+    for (size_t i = 0; i < 300; ++i)
+        filter.increment(hash_of("div"sv));
+    for (size_t i = 0; i < 300; ++i)
+        filter.decrement(hash_of("div"sv));
+    EXPECT(filter.may_contain(hash_of("div"sv)));
+}
+
+TEST_CASE(clear)
+{
+    CountingBloomFilter<u8, 10> filter;
+    filter.increment(hash_of("div"sv));
+    filter.clear();
+    EXPECT(filter.is_empty());
+}
@@ -9,6 +9,7 @@
 #include <AK/HashTable.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 
 TEST_CASE(construct)
 {
@@ -300,3 +301,92 @@ BENCHMARK_CASE(benchmark_thrashing)
         table.remove(i);
     }
 }
+
+BENCHMARK_CASE(benchmark_insert)
+{
+    for (int run = 0; run < 10; ++run) {
+        HashTable<int> table;
+        for (int i = 0; i < 1'000'000; ++i)
+            table.set(i);
+        EXPECT_EQ(table.size(), 1'000'000u);
+    }
+}
+
+BENCHMARK_CASE(benchmark_insert_strings)
+{
+    Vector<String> strings;
+    for (int i = 0; i < 100'000; ++i)
+        strings.append(String::number(i));
+
+    for (int run = 0; run < 10; ++run) {
+        HashTable<String> table;
+        for (auto& string : strings)
+            table.set(string);
+        EXPECT_EQ(table.size(), 100'000u);
+    }
+}
+
+BENCHMARK_CASE(benchmark_lookup)
+{
+    HashTable<int> table;
+    for (int i = 0; i < 100'000; ++i)
+        table.set(i * 2);
+
+    size_t found = 0;
+    for (int run = 0; run < 50; ++run) {
+        for (int i = 0; i < 200'000; ++i) {
+            if (table.contains(i))
+                ++found;
+        }
+    }
+    EXPECT_EQ(found, 50u * 100'000u);
+}
+
+BENCHMARK_CASE(benchmark_lookup_strings)
+{
+    HashTable<String> table;
+    Vector<String> strings;
+    for (int i = 0; i < 100'000; ++i) {
+        strings.append(String::number(i));
+        if (i % 2 == 0)
+            table.set(strings.last());
+    }
+
+    size_t found = 0;
+    for (int run = 0; run < 20; ++run) {
+        for (auto& string : strings) {
+            if (table.contains(string))
+                ++found;
+        }
+    }
+    EXPECT_EQ(found, 20u * 50'000u);
+}
+
+BENCHMARK_CASE(benchmark_erase)
+{
+    for (int run = 0; run < 10; ++run) {
+        HashTable<int> table;
+        for (int i = 0; i < 1'000'000; ++i)
+            table.set(i);
+        for (int i = 0; i < 1'000'000; ++i)
+            table.remove(i);
+        EXPECT(table.is_empty());
+    }
+}
+
+// Removing values and inserting new ones into a table of a fixed size should keep reusing the buckets of the removed
+// ones, instead of leaving behind deleted markers that slow down every later lookup.
+BENCHMARK_CASE(benchmark_erase_and_insert_at_high_load)
+{
+    HashTable<int> table;
+    for (int i = 0; i < 100'000; ++i)
+        table.set(i);
+    auto capacity = table.capacity();
+
+    for (int i = 100'000; i < 10'000'000; ++i) {
+        table.remove(i - 100'000);
+        table.set(i);
+    }
+    EXPECT_EQ(table.size(), 100'000u);
+    EXPECT_EQ(table.capacity(), capacity);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <spawn.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr int run_count = 100;
+
+// Forking gets more expensive the more memory the parent has mapped, so the benchmarks give it a fair amount.
+static constexpr size_t parent_memory_size = 64 * MiB;
+
+static u8* parent_memory()
+{
+    static u8* memory = nullptr;
+    if (!memory) {
+        auto* mapping = mmap(nullptr, parent_memory_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+        VERIFY(mapping != MAP_FAILED);
+        memory = static_cast<u8*>(mapping);
+        memset(memory, 0xaa, parent_memory_size);
+    }
+    return memory;
+}
+
+static void wait_for_successful_exit(pid_t pid)
+{
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+template<typename ForkFunction>
+static void fork_and_exec_true(ForkFunction fork_function)
+{
+    pid_t pid = fork_function();
+    EXPECT(pid >= 0);
+    if (pid == 0) {
+        execl("/bin/true", "true", nullptr);
+        _exit(1);
+    }
+    wait_for_successful_exit(pid);
+}
+
+TEST_CASE(child_sees_parent_memory_as_of_fork)
+{
+    auto* memory = parent_memory();
+    memory[0] = 1;
+    memory[parent_memory_size - 1] = 2;
+
+    pid_t pid = fork();
+    EXPECT(pid >= 0);
+    if (pid == 0) {
+        // Give the parent a chance to write to its copy first.
+        usleep(10000);
+        bool ok = memory[0] == 1 && memory[parent_memory_size - 1] == 2 && memory[parent_memory_size / 2] == 0xaa;
+        memory[0] = 3;
+        _exit(ok ? 0 : 1);
+    }
+    memory[parent_memory_size - 1] = 4;
+    wait_for_successful_exit(pid);
+    EXPECT_EQ(memory[0], 1);
+    EXPECT_EQ(memory[parent_memory_size - 1], 4);
+}
+
+BENCHMARK_CASE(fork_exec)
+{
+    (void)parent_memory();
+    for (int i = 0; i < run_count; ++i)
+        fork_and_exec_true(fork);
+}
+
+BENCHMARK_CASE(vfork_exec)
+{
+    (void)parent_memory();
+    for (int i = 0; i < run_count; ++i)
+        fork_and_exec_true(vfork);
+}
+
+BENCHMARK_CASE(posix_spawn)
+{
+    (void)parent_memory();
+    char const* argv[] = { "true", nullptr };
+    for (int i = 0; i < run_count; ++i) {
+        pid_t pid = 0;
+        EXPECT_EQ(posix_spawn(&pid, "/bin/true", nullptr, nullptr, const_cast<char**>(argv), environ), 0);
+        wait_for_successful_exit(pid);
+    }
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <LibCrypto/Authentication/GHash.h>
+#include <LibCrypto/CPUFeatures.h>
+#include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTest/TestCase.h>
+#include <cstring>
+
+static constexpr size_t buffer_size = 1 * MiB;
+static constexpr int run_count = 32;
+
+// Turns off all instruction set extensions for as long as it is alive, so the portable implementations are measured.
+class PortablePathsScope {
+public:
+    PortablePathsScope()
+        : m_saved(Crypto::CPUFeatures::the())
+    {
+        Crypto::CPUFeatures::the() = {};
+    }
+
+    ~PortablePathsScope()
+    {
+        Crypto::CPUFeatures::the() = m_saved;
+    }
+
+private:
+    Crypto::CPUFeatures m_saved;
+};
+
+static ByteBuffer random_buffer(size_t size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(size).release_value();
+    fill_with_random(buffer.data(), buffer.size());
+    return buffer;
+}
+
+static ByteBuffer aes_cbc_encrypt(ReadonlyBytes key, ReadonlyBytes in)
+{
+    Crypto::Cipher::AESCipher::CBCMode cipher(key, key.size() * 8, Crypto::Cipher::Intent::Encryption);
+    auto out = cipher.create_aligned_buffer(in.size()).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    auto out_span = out.bytes();
+    cipher.encrypt(in, out_span, iv);
+    return ByteBuffer::copy(out_span).release_value();
+}
+
+static ByteBuffer aes_cbc_decrypt(ReadonlyBytes key, ReadonlyBytes in)
+{
+    Crypto::Cipher::AESCipher::CBCMode cipher(key, key.size() * 8, Crypto::Cipher::Intent::Decryption);
+    auto out = cipher.create_aligned_buffer(in.size()).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    auto out_span = out.bytes();
+    cipher.decrypt(in, out_span, iv);
+    return ByteBuffer::copy(out_span).release_value();
+}
+
+static ByteBuffer aes_ctr_encrypt(ReadonlyBytes key, ReadonlyBytes in)
+{
+    Crypto::Cipher::AESCipher::CTRMode cipher(key, key.size() * 8, Crypto::Cipher::Intent::Encryption);
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    auto out_span = out.bytes();
+    cipher.encrypt(in, out_span, iv);
+    return out;
+}
+
+static ByteBuffer aes_gcm_encrypt(ReadonlyBytes key, ReadonlyBytes in, ReadonlyBytes aad)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher(key, key.size() * 8, Crypto::Cipher::Intent::Encryption);
+    auto out = ByteBuffer::create_uninitialized(in.size() + 16).release_value();
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size()).release_value();
+    cipher.encrypt(in, out.bytes().trim(in.size()), iv, aad, out.bytes().slice(in.size()));
+    return out;
+}
+
+static Crypto::Authentication::GHash::TagType ghash(ReadonlyBytes key, ReadonlyBytes aad, ReadonlyBytes in)
+{
+    Crypto::Authentication::GHash ghash(key);
+    return ghash.process(aad, in);
+}
+
+template<typename HashType>
+static typename HashType::DigestType hash(ReadonlyBytes in)
+{
+    HashType hash;
+    // Feed the data in uneven pieces, so partially filled blocks are carried across updates.
+    for (size_t offset = 0; offset < in.size(); offset += 1000)
+        hash.update(in.slice(offset, min<size_t>(1000, in.size() - offset)));
+    return hash.digest();
+}
+
+template<typename Callback>
+static void expect_portable_result(Callback callback)
+{
+    auto accelerated = callback();
+    PortablePathsScope portable;
+    auto reference = callback();
+    EXPECT_EQ(accelerated.size(), reference.size());
+    EXPECT(memcmp(accelerated.data(), reference.data(), accelerated.size()) == 0);
+}
+
+TEST_CASE(test_accelerated_aes_matches_portable)
+{
+    auto input = random_buffer(4096);
+    for (size_t key_size : { 16, 24, 32 }) {
+        auto key = random_buffer(key_size);
+        expect_portable_result([&] { return aes_cbc_encrypt(key, input); });
+        auto encrypted = aes_cbc_encrypt(key, input);
+        expect_portable_result([&] { return aes_cbc_decrypt(key, encrypted); });
+        expect_portable_result([&] { return aes_ctr_encrypt(key, input); });
+    }
+}
+
+TEST_CASE(test_accelerated_aes_gcm_matches_portable)
+{
+    auto key = random_buffer(16);
+    auto input = random_buffer(4096);
+    for (size_t length : { 0, 1, 15, 16, 17, 63, 4096 }) {
+        auto aad = random_buffer(length % 29);
+        expect_portable_result([&] { return aes_gcm_encrypt(key, input.bytes().trim(length), aad); });
+    }
+}
+
+TEST_CASE(test_accelerated_ghash_matches_portable)
+{
+    auto key = random_buffer(16);
+    auto input = random_buffer(4096);
+    for (size_t length : { 0, 1, 15, 16, 17, 63, 4096 }) {
+        auto aad = random_buffer(length % 37);
+        expect_portable_result([&] {
+            auto tag = ghash(key, aad, input.bytes().trim(length));
+            return ByteBuffer::copy(tag.data, sizeof(tag.data)).release_value();
+        });
+    }
+}
+
+TEST_CASE(test_accelerated_sha_matches_portable)
+{
+    auto input = random_buffer(8192);
+    for (size_t length : { 0, 1, 55, 56, 64, 65, 1000, 8192 }) {
+        expect_portable_result([&] {
+            auto digest = hash<Crypto::Hash::SHA1>(input.bytes().trim(length));
+            return ByteBuffer::copy(digest.immutable_data(), digest.data_length()).release_value();
+        });
+        expect_portable_result([&] {
+            auto digest = hash<Crypto::Hash::SHA256>(input.bytes().trim(length));
+            return ByteBuffer::copy(digest.immutable_data(), digest.data_length()).release_value();
+        });
+    }
+}
+
+#define CRYPTO_BENCHMARK(name, ...)         \
+    BENCHMARK_CASE(name)                    \
+    {                                       \
+        for (int i = 0; i < run_count; ++i) \
+            (void)(__VA_ARGS__);            \
+    }                                       \
+    BENCHMARK_CASE(name##_portable)         \
+    {                                       \
+        PortablePathsScope portable;        \
+        for (int i = 0; i < run_count; ++i) \
+            (void)(__VA_ARGS__);            \
+    }
+
+static auto const g_key = random_buffer(16);
+static auto const g_input = random_buffer(buffer_size);
+static auto const g_encrypted_input = aes_cbc_encrypt(g_key, g_input);
+
+CRYPTO_BENCHMARK(aes_128_cbc_encrypt, aes_cbc_encrypt(g_key, g_input))
+CRYPTO_BENCHMARK(aes_128_cbc_decrypt, aes_cbc_decrypt(g_key, g_encrypted_input))
+CRYPTO_BENCHMARK(aes_128_ctr_encrypt, aes_ctr_encrypt(g_key, g_input))
+CRYPTO_BENCHMARK(aes_128_gcm_encrypt, aes_gcm_encrypt(g_key, g_input, {}))
+CRYPTO_BENCHMARK(ghash, ghash(g_key, {}, g_input))
+CRYPTO_BENCHMARK(sha1, Crypto::Hash::SHA1::hash(g_input))
+CRYPTO_BENCHMARK(sha256, Crypto::Hash::SHA256::hash(g_input))
@@ -201,6 +201,31 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_multiplication_with_karatsuba)
+{
+    // These are large enough to go through Karatsuba multiplication, and checked through
+    // the identity F(a + b) = F(a) * F(b + 1) + F(a - 1) * F(b).
+    auto check_fibonacci_identity = [](size_t a, size_t b) {
+        auto expected = bigint_fibonacci(a + b);
+        auto actual = bigint_fibonacci(a).multiplied_by(bigint_fibonacci(b + 1)).plus(bigint_fibonacci(a - 1).multiplied_by(bigint_fibonacci(b)));
+        EXPECT_EQ(actual, expected);
+    };
+    check_fibonacci_identity(6000, 6000);
+    check_fibonacci_identity(6001, 5999);
+    check_fibonacci_identity(15000, 2500);
+    check_fibonacci_identity(20000, 1800);
+}
+
+TEST_CASE(test_unsigned_bigint_square_with_karatsuba)
+{
+    // F(2n + 1) = F(n + 1)^2 + F(n)^2
+    for (size_t n : { 100, 1900, 6000, 12345 }) {
+        auto f_n = bigint_fibonacci(n);
+        auto f_n_plus_1 = bigint_fibonacci(n + 1);
+        EXPECT_EQ(f_n_plus_1.multiplied_by(f_n_plus_1).plus(f_n.multiplied_by(f_n)), bigint_fibonacci(2 * n + 1));
+    }
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -330,6 +355,27 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+TEST_CASE(test_bigint_modular_power_window_sizes)
+{
+    // Exponents of different sizes use different window sizes.
+    struct {
+        Crypto::UnsignedBigInteger base;
+        Crypto::UnsignedBigInteger exp;
+        Crypto::UnsignedBigInteger mod;
+        Crypto::UnsignedBigInteger expected;
+    } mod_pow_tests[] = {
+        { "98492387755030171027536964550150461914305484506373857689198957003880996492460651011060452258528993138248630045541960144832614011554765073423204363576996988044575902920975829567252168382880988897897798347884254491155813770881038552027571539671176464560580682722313541532304474653476710375636628694865617632525469172382293054162330361539787849730711594008511980079518318264831571581097087603068192385213830362653981468815594104772678932056139107765281241322904506650528866121254878294195077530938338763629677851519018725378177774727259101071370965248989019637118811590012385333953917259241039252046686302305530872943343692395928478378602"_bigint, "28769561151784146202430017339934553196663787144433663736059741799986308281172721113967543714157170069589317845742969363650816566102612371930602591413943585409707041583139168046122324504768890507117488088275087926181018129969756265007271052138370497428402074186642073632322808513532621120374710133117667442424105120666655449004891421928908338530530825664164423803833899438556059809997411681642608073516138984701447510223756958927803049281400130821524179928084701823844452299280388709727557010673872523166334093656547478383853417430722043488767539788027821237879287259393248830722981463228829398230280852316098708745277"_bigint, "20382932532153611781845362730196773052775716003891824181841724509012861339295781313483658555682000817617831219503872434562975869282319436125727614873220407601319789970136569490998009604777055395209615901078705487649029571618372630126457989344553561317599557661647188324331923921820012363768915653225553275771789591960006097450061847092265391928476585406526635263305762669773124489476218766036831854244524508591241461748944367578410429200482788437106888011699402163619253044849279157047345317449412402306833403386046693717190603640347217404702145804039184739804818146563853298189282044981562353813894767321245149601803"_bigint, "13308235025682038192052440672839421254461515283011021797611443414425118153873891848298057955758896999229367596677166271542110873476102262309950215910863814412263926760658747225828521062369037835489135202349172823065587409422898691963576744032483356522067106985848456678424896888461091511202211520479589273655737618468229471169721529912993533384691830063327091099743084035040380478002991786925528686683709885944480452207879666639500085854541167306550383999496625021156752939866202620176287002968687338473196904314377129050634240512092440558815770439973074762281014924738656092549556901886316704911794286025057193003206"_bigint },
+        { "115321515919960736589904512015090180600784789997565705532298120163048570378714265017071609236653828414256498101069716973563119670806929063454467200051301611632209566315665904035350179806671239160060172070658129326685595491577365640507855466229402156065934728100891623076747039195442151335170106265123830492415759655459318496660419697555461124706673311556037038672957788715655765595712832823364414004685547862356714526150821689698216415641566077118615614404855834921313613136687998415952684171698085144173785606995249660040923270224515488315628483074034750920875419737074790279610004082774436537128581376061050303121296832469155622698000"_bigint, "65537"_bigint, "29449651370902478562846073758049963463650352787367354980307379521132314272920714919766260812950751276351577299438230819451850336428120475893219499586511326815043296933742236335875534531942258504019958957383803599660741478105220756172314738233729366326248430971007719524535205299995218393898616961208265985078228830278968802259957459862576784313355323827162784369842825661811101450666945268666468906324477616277711299237358895773233767387125659128495611035634435670624444909168573503228461883667833520816695826661248860851262905597192089527539287553141129111244938730840885618828573084237462527052458750427834244607087"_bigint, "20936261077394446510929876088383034692260353019580768998501027517568913577482524881515805675928654160956531294214026048151474530259708225585013194142643279206915521203982124891800440236734458495619827575722636185000575280956884278140654095267540606896650475289182787028196981002673580287972061455176701670528601273486914452039114806461372614820441111926862900819431130588096091455646012030776780734660429873268835688801996751684830456648678423064478844418619179279549506474089318988099473136095198763803959103773601919253496271734298601156938928545343777992143310319333606287212872862334983490363854508945322028318986"_bigint },
+        { "2397705183448237577639515611101586315048552938293736422551559277093191653567771247696284341611877865889566543830683410132543898651007332469215811052995261594957442316056354244646435145323900472005935712300812364523754269086881786409422873402021014001079914098830846827699356934294078894617197053039795066327348528171658654622931"_bigint, "1966800759058985186138656933226067551393523300322966793514434072213740167852770077661988108"_bigint, "160584642715368546328054918695585399751739539400276174845855509707023079827259254625117817911120897640412123936938147045040370033265027088447902337011585354166101308416640603706137431774130827963779476538005535861370862051717897350278699663960965993513454479652534959218672386181881554867415669476216175989953"_bigint, "69316471673277495748275130614333692656085745554384959290977333487482759707724951223846851127335959023204039537157236980177946512896681352745643989662175613990540455997009262697356796930145358070814514154069068384797415733180895881425741702316505392211168988121373723827736479639353249905916326502172052891386"_bigint },
+        { "41396303528990286251818350583004245244551931108306589416970195240103632397039119702092765988113933228242767796685028321605260940416242059516159430542774356837600503027980189654471280568144379472427670793719514416891174518525884953338036115347139948935641087246721419411027580279410670988686015942401238505226206784748632947359999518069904694638560131037329786757128005778018736223434385742707431929467235816460080582536834967341957804396672110464748532085644311556073474924663031215"_bigint, "985202034146801656372613276856"_bigint, "2014610921890806846743601594590272224574137351583202290232239014378703719234101575950153053409711331728168657379774568561461400095612742600858594678467026633275824398038569946184322723378154107121956630779544515535969002158271293870394474780670640158321170794482474510123652945608593608550342060954963752750880494840484832928507039373413249854060078696182583090702408103500526839804847040540471768142558717442337558280652282842236566302306546259507359743155555285"_bigint, "86924475832482343351375133458972438266130191228725583135172821518005689273676262532713390091468217050485681641312293068177130785796285455245157320890230972172523751657408793087492304995424013133491216978545870982463442380638859979880082975677667816640439629760753564416258952146099661383996202222398553378946473241914341190049433636491137116851442030752521321543943635579400173797382218871627372698428476585376422804059155300963508045150608660809708910774274335"_bigint },
+    };
+
+    for (auto& test_case : mod_pow_tests) {
+        auto actual = Crypto::NumberTheory::ModularPower(test_case.base, test_case.exp, test_case.mod);
+        EXPECT_EQ(actual, test_case.expected);
+    }
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
@@ -135,3 +135,40 @@ TEST_CASE(test_RSA_EMSA_PSS_construction)
     Crypto::PK::RSA rsa;
     Crypto::PK::RSA_EMSA_PSS<Crypto::Hash::SHA256> rsa_esma_pss(rsa);
 }
+
+static void run_rsa_sign_and_verify(Crypto::PK::RSA& rsa, int run_count)
+{
+    auto size = rsa.output_size();
+    auto message = ByteBuffer::create_zeroed(size).release_value();
+    // Keep the message below the modulus by leaving the top byte zero.
+    for (size_t i = 1; i < size; ++i)
+        message[i] = static_cast<u8>(i);
+    auto signature = ByteBuffer::create_zeroed(size).release_value();
+    auto verified = ByteBuffer::create_zeroed(size).release_value();
+
+    for (int i = 0; i < run_count; ++i) {
+        auto signature_bytes = signature.bytes();
+        rsa.sign(message, signature_bytes);
+        auto verified_bytes = verified.bytes();
+        rsa.verify(signature_bytes, verified_bytes);
+        EXPECT_EQ(Crypto::UnsignedBigInteger::import_data(verified_bytes.data(), verified_bytes.size()), Crypto::UnsignedBigInteger::import_data(message.data(), message.size()));
+    }
+}
+
+BENCHMARK_CASE(test_RSA_2048_sign_verify)
+{
+    Crypto::PK::RSA rsa(
+        "22523360329331175741792502533642323361796510782120908638865629529754573666546703594183670580214452833139147291950455144217074692112517778826009441745038190141166913155782042740222802571133660089009045082292572034930235350289461118310506232844008720202884187900965213367816767356844650789073833060422986323024887013124997734980184546869251288469133554997539693519870382531480324770697824513475514266268949106586735323805575936627082101061923015976814956494092290229179423132887973255334078813839744157763742036455274251446792303472862370210509140130029573948365062764293763698500300211015679959759969303611811766665097"_bigint,
+        "4628772732892822992787773629771909489271042395425415536301047214878610180934194079043330747663432228865138857464252332421192158486312246580070924304485204753289082042794916499789291795921596974362853406333178303133464681254460946823398281841700588187627533831944550044164977511110703559098538544246868048455935448433077740833146715277926023526701512382085006582125222177032775584532322755807411429689709480990695596230093229144809583025123030274833544917258412891230694985878266521546877597068624390496590431805596579830897596065830178342903802574209948654520943228878443685378768251710677123251339140222067559584763"_bigint,
+        "65537"_bigint);
+    run_rsa_sign_and_verify(rsa, 20);
+}
+
+BENCHMARK_CASE(test_RSA_4096_sign_verify)
+{
+    Crypto::PK::RSA rsa(
+        "927945485552228158215446485686899996624863628127146242839078932764570741227358332738247985979178612206196916547198776646345543454194921251831234802897790477088959102979579237598306511261351983879083693831687947435165175119781541277633822455029349043062465248972340649853317317909419431872363559306910824521529597052142835099477118683991368281916578328056390372326094156783059117694413209478052233588751776364777738194864253832879560246156741299169262177568786890537815766858980371654199350945977147642390639926720738466555969351743432270132752958022712772929716558621486656213005309369560793344351837367489982260830595009990124084011110038850511782744412173924179630677484813749310833097521002424681035121688418119084658099698688816319745460825643858756147750819018202489441702439536565560432389543290474885107953649770091061575531739967417680807288029203029354720041063732823948313553538292221329791514367423660234756251844688758550520565215855975941766731330361630692420431061502977816515155686010151773619031956313732428523570374530437331476859379349724079741807983104468247526973975843996188805946586574732366717373432048994307145908010918969662593660210367935058982464981156415675577449653825953908583535745973352698396344689993"_bigint,
+        "345418528354813037425346365283347862545765912995343030153665106798573104011657845283060389428186395991215296361249183753847791405416973639303735121139097724702438344702051135859582930184114505130265136531591975855693303471849956364168575243017966714680720371413167162419650008835608003879369595969784137504233872238362307302276485784447127957054730710928172960740974258843113336065338014431875478958670582423774895282555059041152529288571597454321737880172716794911504715510448382695119097090232776985671313247971615656207427107137294992844096842813114568137188157923775542390472115365749429086350233433001233841098788380145259247119700916275076692733157936068319305309765920144517946579008767447790806714421340677398985774900680502866762510880525229787473095854697442527945012861324941137228927487213498888115403898207040054101480606781564450878934827881037426256688789789415545399785418212076203175132289461348451485559291515914769849775011166943545242930143371863852244879845188634154165014721419405652461833665814559040217653053412227534471396803870435895525004797740234404691376224309673423056328765457583450267038241893822711950315074706718757326734247993339824261432446705985395712551206098590527188011714479209757764731420263"_bigint,
+        "65537"_bigint);
+    run_rsa_sign_and_verify(rsa, 5);
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Function.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibGL/GL/gl.h>
+#include <LibGL/GLContext.h>
+#include <LibGfx/Bitmap.h>
+
+static constexpr int RENDER_WIDTH = 1280;
+static constexpr int RENDER_HEIGHT = 720;
+static constexpr int TEXTURE_SIZE = 256;
+
+static NonnullOwnPtr<GL::GLContext> create_context(Gfx::Bitmap& bitmap)
+{
+    auto context = GL::create_context(bitmap);
+    GL::make_context_current(context);
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glFrustum(-0.5, 0.5, -0.28125, 0.28125, 1.0, 100.0);
+    glMatrixMode(GL_MODELVIEW);
+
+    return context;
+}
+
+static void bind_checkerboard_texture(GLint min_filter = GL_LINEAR)
+{
+    Vector<u32> texels;
+    texels.resize(TEXTURE_SIZE * TEXTURE_SIZE);
+    for (int y = 0; y < TEXTURE_SIZE; ++y) {
+        for (int x = 0; x < TEXTURE_SIZE; ++x)
+            texels[y * TEXTURE_SIZE + x] = ((x / 16) + (y / 16)) % 2 ? 0xffe0a040 : 0xff3060c0;
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, min_filter != GL_NEAREST && min_filter != GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEXTURE_SIZE, TEXTURE_SIZE, 0, GL_BGRA, GL_UNSIGNED_BYTE, texels.data());
+    glEnable(GL_TEXTURE_2D);
+}
+
+static constexpr float cube_vertices[6][4][3] = {
+    { { -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 }, { -1, 1, 1 } },
+    { { 1, -1, -1 }, { -1, -1, -1 }, { -1, 1, -1 }, { 1, 1, -1 } },
+    { { -1, -1, -1 }, { -1, -1, 1 }, { -1, 1, 1 }, { -1, 1, -1 } },
+    { { 1, -1, 1 }, { 1, -1, -1 }, { 1, 1, -1 }, { 1, 1, 1 } },
+    { { -1, 1, 1 }, { 1, 1, 1 }, { 1, 1, -1 }, { -1, 1, -1 } },
+    { { -1, -1, -1 }, { 1, -1, -1 }, { 1, -1, 1 }, { -1, -1, 1 } },
+};
+static constexpr float cube_texture_coordinates[6][4][2] = {
+    { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } },
+    { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } },
+    { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } },
+    { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } },
+    { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } },
+    { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } },
+};
+
+static void draw_cube()
+{
+    glBegin(GL_QUADS);
+    for (size_t face = 0; face < 6; ++face) {
+        for (size_t i = 0; i < 4; ++i) {
+            glTexCoord2f(cube_texture_coordinates[face][i][0], cube_texture_coordinates[face][i][1]);
+            glVertex3f(cube_vertices[face][i][0], cube_vertices[face][i][1], cube_vertices[face][i][2]);
+        }
+    }
+    glEnd();
+}
+
+static void report(char const* name, int frame_count, Core::ElapsedTimer const& timer)
+{
+    auto elapsed = max(timer.elapsed(), 1);
+    outln("{} ({}x{}): {} frames in {}ms, {} frames per second", name, RENDER_WIDTH, RENDER_HEIGHT, frame_count, elapsed, frame_count * 1000 / elapsed);
+}
+
+BENCHMARK_CASE(textured_cube_fill_rate)
+{
+    int const frame_count = 100;
+
+    auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { RENDER_WIDTH, RENDER_HEIGHT }));
+    auto context = create_context(*bitmap);
+    bind_checkerboard_texture();
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < frame_count; ++frame) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glLoadIdentity();
+        glTranslatef(0, 0, -2.5f);
+        glRotatef(frame * 3.6f, 0.3f, 1, 0.2f);
+        draw_cube();
+        context->present();
+    }
+    report("textured cube", frame_count, timer);
+
+    EXPECT_EQ(glGetError(), 0u);
+}
+
+static void render_many_small_cubes(char const* name, Function<void()> draw_cube)
+{
+    int const frame_count = 20;
+    int const cubes_per_row = 24;
+
+    auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { RENDER_WIDTH, RENDER_HEIGHT }));
+    auto context = create_context(*bitmap);
+    bind_checkerboard_texture();
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < frame_count; ++frame) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        for (int y = 0; y < cubes_per_row / 2; ++y) {
+            for (int x = 0; x < cubes_per_row; ++x) {
+                glLoadIdentity();
+                glTranslatef((x - cubes_per_row / 2 + 0.5f) * 0.9f, (y - cubes_per_row / 4 + 0.5f) * 0.9f, -20.0f);
+                glRotatef(frame * 9.0f + x * 10 + y * 20, 0.3f, 1, 0.2f);
+                glScalef(0.3f, 0.3f, 0.3f);
+                draw_cube();
+            }
+        }
+        context->present();
+    }
+    report(name, frame_count, timer);
+
+    EXPECT_EQ(glGetError(), 0u);
+}
+
+BENCHMARK_CASE(many_small_textured_cubes)
+{
+    render_many_small_cubes("many small cubes", draw_cube);
+}
+
+BENCHMARK_CASE(many_small_textured_cubes_from_display_list)
+{
+    GLuint cube_list = 0;
+    render_many_small_cubes("many small cubes from display list", [&] {
+        if (cube_list == 0) {
+            cube_list = glGenLists(1);
+            glNewList(cube_list, GL_COMPILE);
+            draw_cube();
+            glEndList();
+        }
+        glCallList(cube_list);
+    });
+}
+
+BENCHMARK_CASE(many_small_textured_cubes_from_vertex_arrays)
+{
+    render_many_small_cubes("many small cubes from vertex arrays", [] {
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glVertexPointer(3, GL_FLOAT, 0, cube_vertices);
+        glTexCoordPointer(2, GL_FLOAT, 0, cube_texture_coordinates);
+        glDrawArrays(GL_QUADS, 0, 24);
+    });
+}
+
+BENCHMARK_CASE(trilinear_filtered_floor)
+{
+    int const frame_count = 50;
+
+    auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { RENDER_WIDTH, RENDER_HEIGHT }));
+    auto context = create_context(*bitmap);
+    bind_checkerboard_texture(GL_LINEAR_MIPMAP_LINEAR);
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < frame_count; ++frame) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glLoadIdentity();
+        glTranslatef(0, -1, 0);
+        glRotatef(frame * 1.8f, 0, 1, 0);
+
+        // A large floor that recedes towards the horizon, so that it is both magnified and heavily minified.
+        glBegin(GL_QUADS);
+        glTexCoord2f(0, 0);
+        glVertex3f(-50, 0, 50);
+        glTexCoord2f(64, 0);
+        glVertex3f(50, 0, 50);
+        glTexCoord2f(64, 64);
+        glVertex3f(50, 0, -50);
+        glTexCoord2f(0, 64);
+        glVertex3f(-50, 0, -50);
+        glEnd();
+
+        context->present();
+    }
+    report("trilinear filtered floor", frame_count, timer);
+
+    EXPECT_EQ(glGetError(), 0u);
+}
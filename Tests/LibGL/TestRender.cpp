@@ -8,6 +8,8 @@
 
 #include <AK/Debug.h>
 #include <AK/Format.h>
+#include <AK/Function.h>
+#include <AK/HashTable.h>
 #include <LibGL/GL/gl.h>
 #include <LibGL/GLContext.h>
 #include <LibGfx/BMPWriter.h>
@@ -45,7 +47,11 @@ TEST_CASE(simple_triangle)
     context->present();
 
     EXPECT_EQ(glGetError(), 0u);
-    // FIXME: Verify that the image is indeed correct
+
+    // The triangle covers the center of the image, but not the top corners.
+    EXPECT_EQ(bitmap->get_pixel(RENDER_WIDTH / 2, RENDER_HEIGHT / 2), Color(Color::White));
+    EXPECT_EQ(bitmap->get_pixel(0, 0), Color(Color::Black));
+    EXPECT_EQ(bitmap->get_pixel(RENDER_WIDTH - 1, 0), Color(Color::Black));
 
     if constexpr (GL_DEBUG) {
         // output the image to manually verify that the output is correct
@@ -58,3 +64,354 @@ TEST_CASE(simple_triangle)
         close(fd);
     }
 }
+
+static constexpr int SCENE_SIZE = 64;
+
+// Renders what the callback draws into a new context, looking down the negative z axis from z = 3.
+static NonnullRefPtr<Gfx::Bitmap> render_scene(Function<void()> draw)
+{
+    auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { SCENE_SIZE, SCENE_SIZE }));
+    auto context = GL::create_context(*bitmap);
+    GL::make_context_current(context);
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glFrustum(-1, 1, -1, 1, 1, 10);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glTranslatef(0, 0, -3);
+
+    draw();
+    context->present();
+    EXPECT_EQ(glGetError(), 0u);
+    return bitmap;
+}
+
+static void expect_same_pixels(Gfx::Bitmap const& expected, Gfx::Bitmap const& actual)
+{
+    size_t differing_pixels = 0;
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            if (expected.get_pixel(x, y) != actual.get_pixel(x, y))
+                ++differing_pixels;
+        }
+    }
+    EXPECT_EQ(differing_pixels, 0u);
+}
+
+// Makes sure that a comparison isn't between two empty images.
+static void expect_many_colors(Gfx::Bitmap const& bitmap)
+{
+    HashTable<Gfx::ARGB32> colors;
+    for (int y = 0; y < bitmap.height(); ++y) {
+        for (int x = 0; x < bitmap.width(); ++x)
+            colors.set(bitmap.get_pixel(x, y).value());
+    }
+    EXPECT(colors.size() > 16);
+}
+
+static void enable_lighting()
+{
+    GLfloat const light_position[] = { 1, 1, 2, 0 };
+    glLightfv(GL_LIGHT0, GL_POSITION, light_position);
+    glEnable(GL_LIGHT0);
+    glEnable(GL_LIGHTING);
+    glEnable(GL_COLOR_MATERIAL);
+}
+
+// Consecutive independent triangles and quads end up in a single batch when compiled into a display list.
+static void draw_mergeable_primitives()
+{
+    glBegin(GL_TRIANGLES);
+    glColor3f(1, 0, 0);
+    glVertex3f(-1, -1, 0);
+    glColor3f(0, 1, 0);
+    glVertex3f(0, -1, 0);
+    glColor3f(0, 0, 1);
+    glVertex3f(-1, 0, 0);
+    glEnd();
+    glBegin(GL_TRIANGLES);
+    glVertex3f(0, -1, 0.5f);
+    glColor3f(1, 1, 0);
+    glVertex3f(1, -1, -0.5f);
+    glVertex3f(0, 0, 0);
+    glEnd();
+
+    glBegin(GL_QUADS);
+    glColor3f(0, 1, 1);
+    glVertex3f(-1, 0.1f, 0);
+    glVertex3f(-0.1f, 0.1f, 0);
+    glColor3f(1, 0, 1);
+    glVertex3f(-0.1f, 1, -1);
+    glVertex3f(-1, 1, -1);
+    glEnd();
+    glBegin(GL_QUADS);
+    glVertex3f(0.1f, 0.1f, 0);
+    glVertex3f(1, 0.1f, 0);
+    glColor3f(1, 1, 1);
+    glVertex3f(1, 1, 0);
+    glVertex3f(0.1f, 1, 0);
+    glEnd();
+
+    glBegin(GL_TRIANGLE_FAN);
+    glColor3f(0.5f, 0.2f, 0.8f);
+    glVertex3f(0.5f, -0.5f, 0.2f);
+    glVertex3f(0.3f, -0.9f, 0.2f);
+    glVertex3f(0.9f, -0.9f, 0.2f);
+    glColor3f(0.2f, 0.8f, 0.5f);
+    glVertex3f(0.9f, -0.1f, 0.2f);
+    glEnd();
+}
+
+TEST_CASE(display_list_renders_like_immediate_mode)
+{
+    auto immediate = render_scene([] {
+        draw_mergeable_primitives();
+    });
+    expect_many_colors(*immediate);
+
+    auto compiled = render_scene([] {
+        auto list = glGenLists(1);
+        glNewList(list, GL_COMPILE);
+        draw_mergeable_primitives();
+        glEndList();
+        glCallList(list);
+    });
+    expect_same_pixels(*immediate, *compiled);
+
+    auto compiled_and_executed = render_scene([] {
+        auto list = glGenLists(1);
+        glNewList(list, GL_COMPILE_AND_EXECUTE);
+        draw_mergeable_primitives();
+        glEndList();
+    });
+    expect_same_pixels(*immediate, *compiled_and_executed);
+}
+
+// The first vertices of these primitives use whatever color and normal were current before, and they leave
+// the last ones they set behind.
+static void draw_primitives_changing_attributes()
+{
+    glBegin(GL_TRIANGLES);
+    glVertex3f(-1, -1, 0);
+    glVertex3f(0, -1, 0);
+    glColor3f(0, 1, 0);
+    glNormal3f(0, 0.7f, 0.7f);
+    glVertex3f(-1, 0, 0);
+    glEnd();
+
+    glBegin(GL_TRIANGLES);
+    glVertex3f(0, -1, 0);
+    glNormal3f(0.7f, 0, 0.7f);
+    glVertex3f(1, -1, 0);
+    glColor3f(1, 0, 1);
+    glVertex3f(0, 0, 0);
+    glEnd();
+
+    glBegin(GL_QUADS);
+    glVertex3f(-1, 0.1f, 0);
+    glColor3f(0, 0.5f, 1);
+    glVertex3f(0, 0.1f, 0);
+    glVertex3f(0, 1, 0);
+    glNormal3f(-0.7f, 0, 0.7f);
+    glVertex3f(-1, 1, 0);
+    glEnd();
+}
+
+static void draw_with_inherited_attributes(Function<void()> const& draw_primitives)
+{
+    enable_lighting();
+
+    glColor3f(1, 0.5f, 0);
+    glNormal3f(0, 0, 1);
+    draw_primitives();
+
+    glPushMatrix();
+    glTranslatef(0, 0, -1);
+    glColor3f(0.2f, 0.2f, 1);
+    glNormal3f(0, 0.7f, 0.7f);
+    draw_primitives();
+    glPopMatrix();
+
+    // This is drawn with the color and normal that the primitives left behind.
+    glBegin(GL_TRIANGLES);
+    glVertex3f(0.1f, 0.1f, 0);
+    glVertex3f(1, 0.1f, 0);
+    glVertex3f(1, 1, 0);
+    glEnd();
+}
+
+TEST_CASE(display_list_keeps_attributes_set_within_and_before_primitives)
+{
+    auto immediate = render_scene([] {
+        draw_with_inherited_attributes(draw_primitives_changing_attributes);
+    });
+    expect_many_colors(*immediate);
+
+    auto compiled = render_scene([] {
+        auto list = glGenLists(1);
+        glNewList(list, GL_COMPILE);
+        draw_primitives_changing_attributes();
+        glEndList();
+        draw_with_inherited_attributes([list] { glCallList(list); });
+    });
+    expect_same_pixels(*immediate, *compiled);
+}
+
+static constexpr GLfloat array_vertices[][3] = {
+    { -1, -1, 0 }, { 0, -1, 0.5f }, { 0, 0, 0 }, { -1, 0, -0.5f },
+    { 0.1f, 0.1f, 0 }, { 1, 0.1f, 0 }, { 1, 1, -1 }, { 0.1f, 1, -1 }
+};
+static constexpr GLfloat array_colors[][4] = {
+    { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 0, 0, 1, 1 }, { 1, 1, 0, 1 },
+    { 0, 1, 1, 1 }, { 1, 0, 1, 1 }, { 1, 1, 1, 1 }, { 0.5f, 0.5f, 0.5f, 1 }
+};
+static constexpr GLfloat array_normals[][3] = {
+    { 0, 0, 1 }, { 0, 0.7f, 0.7f }, { 0.7f, 0, 0.7f }, { 0, 0, 1 },
+    { -0.7f, 0, 0.7f }, { 0, 0, 1 }, { 0, -0.7f, 0.7f }, { 0, 0, 1 }
+};
+static constexpr GLfloat array_tex_coords[][2] = {
+    { 0, 0 }, { 2, 0 }, { 2, 2 }, { 0, 2 },
+    { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 }
+};
+static constexpr GLushort array_indices[] = { 0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4 };
+
+static void bind_checkerboard_texture()
+{
+    u32 const texels[] = { 0xffffffff, 0xff808080, 0xff808080, 0xffffffff };
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_BGRA, GL_UNSIGNED_BYTE, texels);
+    glEnable(GL_TEXTURE_2D);
+}
+
+static void enable_client_arrays()
+{
+    enable_lighting();
+    bind_checkerboard_texture();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, array_vertices);
+    glColorPointer(4, GL_FLOAT, 0, array_colors);
+    glNormalPointer(GL_FLOAT, 0, array_normals);
+    glTexCoordPointer(2, GL_FLOAT, 0, array_tex_coords);
+}
+
+TEST_CASE(vertex_arrays_render_like_immediate_mode)
+{
+    auto immediate = render_scene([] {
+        enable_lighting();
+        bind_checkerboard_texture();
+        glBegin(GL_TRIANGLES);
+        for (auto index : array_indices) {
+            glColor4fv(array_colors[index]);
+            glNormal3fv(array_normals[index]);
+            glTexCoord2fv(array_tex_coords[index]);
+            glVertex3fv(array_vertices[index]);
+        }
+        glEnd();
+    });
+    expect_many_colors(*immediate);
+
+    auto draw_elements = render_scene([] {
+        enable_client_arrays();
+        glDrawElements(GL_TRIANGLES, sizeof(array_indices) / sizeof(array_indices[0]), GL_UNSIGNED_SHORT, array_indices);
+    });
+    expect_same_pixels(*immediate, *draw_elements);
+
+    auto immediate_quads = render_scene([] {
+        enable_lighting();
+        bind_checkerboard_texture();
+        glBegin(GL_QUADS);
+        for (size_t index = 0; index < 8; ++index) {
+            glColor4fv(array_colors[index]);
+            glNormal3fv(array_normals[index]);
+            glTexCoord2fv(array_tex_coords[index]);
+            glVertex3fv(array_vertices[index]);
+        }
+        glEnd();
+    });
+    expect_many_colors(*immediate_quads);
+
+    auto draw_arrays = render_scene([] {
+        enable_client_arrays();
+        glDrawArrays(GL_QUADS, 0, 8);
+    });
+    expect_same_pixels(*immediate_quads, *draw_arrays);
+}
+
+TEST_CASE(generate_mipmap)
+{
+    // Columns of red and blue texels, which average out to purple.
+    static constexpr int texture_size = 4;
+    u32 texels[texture_size * texture_size];
+    for (int i = 0; i < texture_size * texture_size; ++i)
+        texels[i] = i % 2 ? 0xff0000ff : 0xffff0000;
+    // NOTE: Green is at the same place in RGBA and BGRA.
+    u32 green_texels[texture_size * texture_size];
+    for (auto& texel : green_texels)
+        texel = 0xff00ff00;
+
+    auto draw_texture = [](int x, int y, int size, float repeat) {
+        glBegin(GL_QUADS);
+        glTexCoord2f(0, 0);
+        glVertex2i(x, y);
+        glTexCoord2f(repeat, 0);
+        glVertex2i(x + size, y);
+        glTexCoord2f(repeat, repeat);
+        glVertex2i(x + size, y + size);
+        glTexCoord2f(0, repeat);
+        glVertex2i(x, y + size);
+        glEnd();
+    };
+
+    auto set_up = [&] {
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0, SCENE_SIZE, 0, SCENE_SIZE, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+
+        GLuint texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture_size, texture_size, 0, GL_BGRA, GL_UNSIGNED_BYTE, texels);
+        glEnable(GL_TEXTURE_2D);
+        glColor3f(1, 1, 1);
+    };
+
+    auto bitmap = render_scene([&] {
+        set_up();
+        // Magnified, two pixels per texel.
+        draw_texture(0, 28, 2 * texture_size, 1);
+        // Minified, four texels per pixel in each direction, which samples the 1x1 level.
+        draw_texture(28, 28, 8, 8);
+    });
+
+    EXPECT_EQ(bitmap->get_pixel(1, 32), Color(Color::Red));
+    EXPECT_EQ(bitmap->get_pixel(3, 32), Color(Color::Blue));
+    auto purple = bitmap->get_pixel(32, 32);
+    EXPECT(purple.red() >= 127 && purple.red() <= 128);
+    EXPECT_EQ(purple.green(), 0);
+    EXPECT(purple.blue() >= 127 && purple.blue() <= 128);
+
+    // Replacing the base level generates the other levels again.
+    bitmap = render_scene([&] {
+        set_up();
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture_size, texture_size, GL_RGBA, GL_UNSIGNED_BYTE, green_texels);
+        draw_texture(28, 28, 8, 8);
+    });
+    EXPECT_EQ(bitmap->get_pixel(32, 32), Color(Color::Green));
+}
@@ -61,3 +61,126 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+BENCHMARK_CASE(fill_translucent)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(Color(0, 128, 255, 100));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(255, 0, 0, 50));
+    }
+}
+
+BENCHMARK_CASE(fill_with_vertical_gradient)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect_with_gradient(Gfx::Orientation::Vertical, bitmap->rect(), Color::Blue, Color::Red);
+    }
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_source_bitmap(Gfx::BitmapFormat format, int size)
+{
+    auto bitmap = Gfx::Bitmap::try_create(format, { size, size }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++)
+            bitmap->set_pixel(x, y, Color(x, y, x + y, x ^ y));
+    }
+    return bitmap;
+}
+
+BENCHMARK_CASE(blit)
+{
+    int const run_count = 200;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_source_bitmap(Gfx::BitmapFormat::BGRx8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect());
+    }
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(Color(0, 128, 255, 100));
+    auto source = create_source_bitmap(Gfx::BitmapFormat::BGRA8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect(), 0.8f);
+    }
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_source_bitmap(Gfx::BitmapFormat::BGRx8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect(), 0.5f);
+    }
+}
+
+static void draw_scaled_bitmaps(Gfx::Painter::ScalingMode scaling_mode, Gfx::BitmapFormat source_format, int run_count)
+{
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_source_bitmap(source_format, 700);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect(), 1.0f, scaling_mode);
+        painter.draw_scaled_bitmap({ 0, 0, 300, 300 }, source, source->rect(), 1.0f, scaling_mode);
+    }
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_nearest_neighbor)
+{
+    draw_scaled_bitmaps(Gfx::Painter::ScalingMode::NearestNeighbor, Gfx::BitmapFormat::BGRA8888, 20);
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_bilinear_blend)
+{
+    draw_scaled_bitmaps(Gfx::Painter::ScalingMode::BilinearBlend, Gfx::BitmapFormat::BGRA8888, 10);
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_box_sampling)
+{
+    draw_scaled_bitmaps(Gfx::Painter::ScalingMode::BoxSampling, Gfx::BitmapFormat::BGRA8888, 10);
+}
+
+BENCHMARK_CASE(draw_integer_scaled_bitmap)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_source_bitmap(Gfx::BitmapFormat::BGRx8888, bitmap_size / 4);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect());
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibCore/MappedFile.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/JPGLoader.h>
+#include <LibGfx/PNGLoader.h>
+
+static void decode_jpg(StringView path, int run_count)
+{
+    auto file = Core::MappedFile::map(path).release_value();
+    for (int run = 0; run < run_count; run++) {
+        auto jpg = Gfx::JPGImageDecoderPlugin((u8 const*)file->data(), file->size());
+        auto frame = jpg.frame(0).release_value_but_fixme_should_propagate_errors();
+        EXPECT(frame.image);
+    }
+}
+
+BENCHMARK_CASE(jpg_decode_large_photo)
+{
+    decode_jpg("/res/html/misc/jpgsuite_files/oh-lena.jpg"sv, 50);
+}
+
+BENCHMARK_CASE(jpg_decode_chroma_subsampled)
+{
+    decode_jpg("/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg"sv, 100);
+}
+
+BENCHMARK_CASE(jpg_decode_not_subsampled)
+{
+    decode_jpg("/res/html/misc/jpgsuite_files/non-subsampled-lena.jpg"sv, 100);
+}
+
+static void decode_png(StringView path, int run_count)
+{
+    auto file = Core::MappedFile::map(path).release_value();
+    for (int run = 0; run < run_count; run++) {
+        auto png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+        auto frame = png.frame(0).release_value_but_fixme_should_propagate_errors();
+        EXPECT(frame.image);
+    }
+}
+
+BENCHMARK_CASE(png_decode_screenshot)
+{
+    decode_png("/res/html/misc/serenity-screenshot.png"sv, 20);
+}
+
+BENCHMARK_CASE(png_decode_wallpaper)
+{
+    decode_png("/res/wallpapers/sunset-retro.png"sv, 20);
+}
@@ -5,11 +5,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/System.h>
 #include <LibGfx/Font/BitmapFont.h>
+#include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/FontDatabase.h>
+#include <LibGfx/Font/GlyphAtlas.h>
+#include <LibGfx/Font/VectorFont.h>
 #include <LibTest/TestCase.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 TEST_CASE(test_fontdatabase_get_by_name)
@@ -134,3 +140,139 @@ TEST_CASE(test_write_to_file)
     EXPECT(font->write_to_file(path));
     unlink(path);
 }
+
+class TestVectorFont final : public Gfx::VectorFont {
+public:
+    explicit TestVectorFont(u32 glyph_count)
+        : m_glyph_count(glyph_count)
+    {
+    }
+
+    virtual Gfx::ScaledFontMetrics metrics(float, float) const override { return {}; }
+    virtual Gfx::ScaledGlyphMetrics glyph_metrics(u32, float, float) const override { return {}; }
+    virtual float glyphs_horizontal_kerning(u32, u32, float) const override { return 0; }
+    virtual RefPtr<Gfx::Bitmap> rasterize_glyph(u32, float x_scale, float y_scale) const override
+    {
+        auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { static_cast<int>(x_scale * units_per_em()), static_cast<int>(y_scale * units_per_em()) }));
+        bitmap->fill(Color::Black);
+        return bitmap;
+    }
+    virtual u32 glyph_count() const override { return m_glyph_count; }
+    virtual u16 units_per_em() const override { return 100; }
+    virtual u32 glyph_id_for_code_point(u32 code_point) const override { return code_point; }
+    virtual String family() const override { return "Test"; }
+    virtual String variant() const override { return "Regular"; }
+    virtual u16 weight() const override { return 400; }
+    virtual u8 slope() const override { return 0; }
+    virtual bool is_fixed_width() const override { return false; }
+
+private:
+    u32 m_glyph_count { 0 };
+};
+
+TEST_CASE(test_glyph_atlas_shares_glyphs_between_mappings)
+{
+    auto atlas = MUST(Gfx::GlyphAtlas::try_create(256 * KiB));
+    auto other_atlas = MUST(Gfx::GlyphAtlas::try_create_read_only(atlas->read_only_fd()));
+    EXPECT(atlas->is_writable());
+    EXPECT(!other_atlas->is_writable());
+
+    Gfx::GlyphAtlas::Key key { 1, 2, 3, 'A' };
+    EXPECT(!atlas->find(key));
+
+    auto glyph = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { 5, 7 }));
+    glyph->fill(Color::from_rgb(0xffffff).with_alpha(0x80));
+    glyph->set_pixel(4, 6, Color::Black);
+    atlas->insert(key, *glyph);
+
+    auto shared_glyph = other_atlas->find(key);
+    EXPECT(shared_glyph);
+    EXPECT_EQ(shared_glyph->size(), glyph->size());
+    EXPECT_EQ(shared_glyph->get_pixel(0, 0), glyph->get_pixel(0, 0));
+    EXPECT_EQ(shared_glyph->get_pixel(4, 6), Color(Color::Black));
+
+    EXPECT(!other_atlas->find({ 1, 2, 3, 'B' }));
+}
+
+TEST_CASE(test_glyph_atlas_cannot_be_written_through_read_only_mapping)
+{
+    auto atlas = MUST(Gfx::GlyphAtlas::try_create(256 * KiB));
+    EXPECT(Core::System::mmap(nullptr, 256 * KiB, PROT_READ | PROT_WRITE, MAP_SHARED, atlas->read_only_fd(), 0).is_error());
+
+    auto glyph = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { 5, 7 }));
+    atlas->insert({ 1, 2, 3, 'A' }, *glyph);
+
+    auto other_atlas = MUST(Gfx::GlyphAtlas::try_create_read_only(atlas->read_only_fd()));
+    auto shared_glyph = other_atlas->find({ 1, 2, 3, 'A' });
+    EXPECT(shared_glyph);
+
+    // NOTE: The superuser may write to any file, so it's allowed to upgrade the mapping on some systems.
+    if (geteuid() != 0) {
+        auto page_size = sysconf(_SC_PAGESIZE);
+        auto page = reinterpret_cast<FlatPtr>(shared_glyph->scanline(0)) & ~static_cast<FlatPtr>(page_size - 1);
+        EXPECT(mprotect(reinterpret_cast<void*>(page), page_size, PROT_READ | PROT_WRITE) < 0);
+    }
+}
+
+TEST_CASE(test_glyph_atlas_typeface_indices)
+{
+    auto atlas = MUST(Gfx::GlyphAtlas::try_create(256 * KiB));
+    auto font = adopt_ref(*new TestVectorFont(100));
+    auto other_font = adopt_ref(*new TestVectorFont(200));
+
+    auto index = atlas->register_typeface("Test"sv, "Regular"sv, font);
+    auto bold_index = atlas->register_typeface("Test"sv, "Bold"sv, font);
+    auto other_index = atlas->register_typeface("Other"sv, "Regular"sv, other_font);
+    EXPECT(index.has_value());
+    EXPECT(bold_index.has_value());
+    EXPECT(other_index.has_value());
+    EXPECT_NE(index.value(), bold_index.value());
+    EXPECT_NE(index.value(), other_index.value());
+    EXPECT_NE(bold_index.value(), other_index.value());
+    EXPECT_EQ(atlas->register_typeface("Test"sv, "Regular"sv, font), index);
+
+    auto other_atlas = MUST(Gfx::GlyphAtlas::try_create_read_only(atlas->read_only_fd()));
+    EXPECT_EQ(other_atlas->find_typeface("Test"sv, "Regular"sv, 100), index);
+    EXPECT_EQ(other_atlas->find_typeface("Test"sv, "Bold"sv, 100), bold_index);
+    EXPECT_EQ(other_atlas->find_typeface("Other"sv, "Regular"sv, 200), other_index);
+    EXPECT(!other_atlas->find_typeface("Test"sv, "Regular"sv, 200).has_value());
+    EXPECT(!other_atlas->find_typeface("Tes"sv, "Regular"sv, 100).has_value());
+    EXPECT(!other_atlas->find_typeface("Test"sv, "Italic"sv, 100).has_value());
+
+    auto long_family = String::repeated('x', 200);
+    EXPECT(!atlas->register_typeface(long_family, "Regular"sv, font).has_value());
+}
+
+TEST_CASE(test_glyph_atlas_rasterizes_for_other_processes)
+{
+    auto atlas = MUST(Gfx::GlyphAtlas::try_create(256 * KiB));
+    auto font = adopt_ref(*new TestVectorFont(100));
+    auto index = atlas->register_typeface("Test"sv, "Regular"sv, font).value();
+    auto other_atlas = MUST(Gfx::GlyphAtlas::try_create_read_only(atlas->read_only_fd()));
+
+    Gfx::GlyphAtlas::Key key { index, bit_cast<u32>(0.1f), bit_cast<u32>(0.2f), 'A' };
+    atlas->rasterize_and_insert(key);
+    auto glyph = other_atlas->find(key);
+    EXPECT(glyph);
+    EXPECT_EQ(glyph->size(), Gfx::IntSize(10, 20));
+
+    // Unknown typefaces, glyphs and absurd sizes are ignored.
+    Gfx::GlyphAtlas::Key unknown_typeface { index + 1, bit_cast<u32>(0.1f), bit_cast<u32>(0.1f), 'A' };
+    Gfx::GlyphAtlas::Key unknown_glyph { index, bit_cast<u32>(0.1f), bit_cast<u32>(0.1f), 1000 };
+    Gfx::GlyphAtlas::Key huge_glyph { index, bit_cast<u32>(1000.0f), bit_cast<u32>(1000.0f), 'A' };
+    Gfx::GlyphAtlas::Key bogus_scale { index, bit_cast<u32>(NAN), bit_cast<u32>(0.1f), 'A' };
+    for (auto& bad_key : { unknown_typeface, unknown_glyph, huge_glyph, bogus_scale }) {
+        atlas->rasterize_and_insert(bad_key);
+        EXPECT(!other_atlas->find(bad_key));
+    }
+}
+
+TEST_CASE(test_glyph_atlas_rejects_bogus_file)
+{
+    char path[] = "/tmp/glyph-atlas-test.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(path));
+    unlink(path);
+    MUST(Core::System::ftruncate(fd, 64 * KiB));
+    EXPECT(Gfx::GlyphAtlas::try_create_read_only(fd).is_error());
+    MUST(Core::System::close(fd));
+}
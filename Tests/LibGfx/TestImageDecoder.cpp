@@ -77,6 +77,17 @@ TEST_CASE(test_jpg)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_jpg_subsampled_with_partial_macroblocks)
+{
+    // 1200x822 with horizontally subsampled chroma, so the last row of MCUs is cut off by the bottom of the image.
+    auto file = Core::MappedFile::map("/res/html/misc/jpgsuite_files/oh-lena.jpg").release_value();
+    auto jpg = Gfx::JPGImageDecoderPlugin((u8 const*)file->data(), file->size());
+    EXPECT_EQ(jpg.size(), Gfx::IntSize(1200, 822));
+
+    auto frame = jpg.frame(0).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(frame.image->size(), Gfx::IntSize(1200, 822));
+}
+
 TEST_CASE(test_pbm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/pbmsuite_files/buggie-raw.pbm").release_value();
@@ -119,6 +130,34 @@ TEST_CASE(test_png)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_png_filtered_palette_indices)
+{
+    // The scanlines of this 4-bit palette image use all filter types, which must be undone before looking up the palette.
+    auto file = Core::MappedFile::map("/res/emoji/U+1F926.png").release_value();
+    auto png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+    EXPECT(png.sniff());
+
+    auto frame = png.frame(0);
+    EXPECT(!frame.is_error());
+    auto& bitmap = *frame.value().image;
+    EXPECT_EQ(bitmap.size(), Gfx::IntSize(7, 10));
+
+    // Palette index 0 is made transparent by the tRNS chunk.
+    EXPECT_EQ(bitmap.get_pixel(0, 0), Gfx::Color(0, 0, 0, 0));
+    EXPECT_EQ(bitmap.get_pixel(1, 1), Gfx::Color(255, 229, 134)); // Average
+    EXPECT_EQ(bitmap.get_pixel(2, 2), Gfx::Color(255, 221, 92));  // Paeth
+    EXPECT_EQ(bitmap.get_pixel(1, 3), Gfx::Color(59, 25, 0));     // Up
+    EXPECT_EQ(bitmap.get_pixel(2, 4), Gfx::Color(255, 213, 45));  // Up
+    EXPECT_EQ(bitmap.get_pixel(0, 5), Gfx::Color(234, 161, 98));  // Paeth
+    EXPECT_EQ(bitmap.get_pixel(1, 6), Gfx::Color(254, 204, 12));  // Up
+    EXPECT_EQ(bitmap.get_pixel(2, 6), Gfx::Color(254, 204, 10));  // Up
+    EXPECT_EQ(bitmap.get_pixel(3, 6), Gfx::Color(254, 203, 5));   // Up
+    EXPECT_EQ(bitmap.get_pixel(5, 8), Gfx::Color(255, 181, 0));   // Sub
+    EXPECT_EQ(bitmap.get_pixel(6, 8), Gfx::Color(255, 144, 0));   // Sub
+    EXPECT_EQ(bitmap.get_pixel(3, 9), Gfx::Color(255, 144, 0));   // Up
+    EXPECT_EQ(bitmap.get_pixel(6, 9), Gfx::Color(0, 0, 0, 0));
+}
+
 TEST_CASE(test_ppm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/ppmsuite_files/buggie-raw.ppm").release_value();
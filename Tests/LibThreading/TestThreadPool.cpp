@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/ThreadPool.h>
+
+TEST_CASE(runs_every_submitted_job)
+{
+    Threading::ThreadPool pool(4);
+    EXPECT_EQ(pool.thread_count(), 4u);
+
+    Atomic<int> sum = 0;
+    for (int i = 1; i <= 100; i++)
+        pool.submit([&sum, i] { sum += i; });
+    pool.wait();
+    EXPECT_EQ(sum.load(), 5050);
+}
+
+TEST_CASE(can_be_reused_after_waiting)
+{
+    Threading::ThreadPool pool(2);
+    Atomic<int> count = 0;
+    for (int round = 1; round <= 10; round++) {
+        for (int i = 0; i < 8; i++)
+            pool.submit([&count] { count++; });
+        pool.wait();
+        EXPECT_EQ(count.load(), round * 8);
+    }
+}
+
+TEST_CASE(waiting_without_jobs_returns)
+{
+    Threading::ThreadPool pool;
+    EXPECT(pool.thread_count() > 0);
+    pool.wait();
+}
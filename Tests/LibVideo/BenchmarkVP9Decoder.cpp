@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/LexicalPath.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibVideo/MatroskaReader.h>
+#include <LibVideo/VP9/Decoder.h>
+
+static void decode_video(String const& path, int run_count)
+{
+    auto document = Video::MatroskaReader::parse_matroska_from_file(path);
+    VERIFY(document);
+    auto optional_track = document->track_for_track_type(Video::TrackEntry::TrackType::Video);
+    VERIFY(optional_track.has_value());
+    auto const& track = optional_track.value();
+
+    size_t shown_frames = 0;
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < run_count; run++) {
+        Video::VP9::Decoder vp9_decoder;
+        for (auto const& cluster : document->clusters()) {
+            for (auto const& block : cluster.blocks()) {
+                if (block.track_number() != track.track_number())
+                    continue;
+                EXPECT(vp9_decoder.decode_frame(block.frame(0)));
+                if (vp9_decoder.shown_frame())
+                    shown_frames++;
+            }
+        }
+    }
+
+    auto elapsed = max(timer.elapsed(), 1);
+    auto video_track = track.video_track().value();
+    outln("{} ({}x{}): {} frames in {}ms, {} frames per second", LexicalPath::basename(path), video_track.pixel_width, video_track.pixel_height,
+        shown_frames, elapsed, shown_frames * 1000 / elapsed);
+}
+
+BENCHMARK_CASE(vp9_decode_sample_videos)
+{
+    decode_video("/usr/Tests/LibVideo/vp9_start_of_stream.webm", 10);
+    decode_video("/usr/Tests/LibVideo/vp9_with_audio_track.webm", 10);
+}
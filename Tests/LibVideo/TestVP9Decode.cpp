@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibVideo/MatroskaReader.h>
+#include <LibVideo/VP9/Decoder.h>
+
+// CRC32s of the visible Y, U and V samples of every shown frame.
+static Vector<u32> decode_and_checksum_frames(StringView path)
+{
+    auto document = Video::MatroskaReader::parse_matroska_from_file(path);
+    VERIFY(document);
+    auto optional_track = document->track_for_track_type(Video::TrackEntry::TrackType::Video);
+    VERIFY(optional_track.has_value());
+    auto track_number = optional_track.value().track_number();
+
+    Vector<u32> checksums;
+    Video::VP9::Decoder vp9_decoder;
+    for (auto const& cluster : document->clusters()) {
+        for (auto const& block : cluster.blocks()) {
+            if (block.track_number() != track_number)
+                continue;
+            EXPECT(vp9_decoder.decode_frame(block.frame(0)));
+            auto frame = vp9_decoder.shown_frame();
+            if (!frame)
+                continue;
+            Crypto::Checksum::CRC32 crc32;
+            for (u8 plane = 0; plane < 3; plane++) {
+                for (u32 y = 0; y < frame->plane_height(plane); y++)
+                    crc32.update({ frame->data(plane) + y * frame->stride(plane), frame->plane_width(plane) });
+            }
+            checksums.append(crc32.digest());
+        }
+    }
+    return checksums;
+}
+
+// Both files are cut from the 854x480 test video in /home/anon/Videos, which is coded in two tile columns.
+// The first frames include a superframe that carries a hidden alternate reference frame.
+TEST_CASE(vp9_start_of_stream)
+{
+    auto checksums = decode_and_checksum_frames("/usr/Tests/LibVideo/vp9_start_of_stream.webm"sv);
+    Array<u32, 13> expected_checksums {
+        0x91806a0d, 0xeb058d65, 0x0f33148a, 0xc56ac08e, 0xa26483fe, 0xa6ee9d89, 0xfdcb7671,
+        0xa9982c93, 0x878a6eb5, 0x1a4a0601, 0x10b1b16b, 0x97c4b075, 0x51063896
+    };
+    EXPECT_EQ(checksums.size(), expected_checksums.size());
+    for (size_t i = 0; i < min(checksums.size(), expected_checksums.size()); i++)
+        EXPECT_EQ(checksums[i], expected_checksums[i]);
+}
+
+// This one starts at the second key frame and still has the Opus audio track interleaved with the video.
+TEST_CASE(vp9_with_audio_track)
+{
+    auto checksums = decode_and_checksum_frames("/usr/Tests/LibVideo/vp9_with_audio_track.webm"sv);
+    Array<u32, 12> expected_checksums {
+        0xbe8fd1d9, 0xd6a4acdc, 0x1e8e114f, 0x3666e19e, 0x6b62095e, 0x750af5c0,
+        0x3aca0dac, 0x9803070a, 0x6b8c8df0, 0xeafd2f08, 0x37e2ea01, 0x1099259d
+    };
+    EXPECT_EQ(checksums.size(), expected_checksums.size());
+    for (size_t i = 0; i < min(checksums.size(), expected_checksums.size()); i++)
+        EXPECT_EQ(checksums[i], expected_checksums[i]);
+}
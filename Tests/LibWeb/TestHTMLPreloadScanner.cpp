@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+
+using Scanner = Web::HTML::HTMLPreloadScanner;
+using ResourceType = Web::Resource::Type;
+
+static Vector<Scanner::SpeculativeFetch> scan(StringView input)
+{
+    auto document = Web::DOM::Document::create(AK::URL("http://example.com/dir/page.html"));
+    Scanner scanner(document, input);
+    return scanner.scan();
+}
+
+TEST_CASE(finds_scripts_style_sheets_and_images)
+{
+    auto fetches = scan(R"(
+        <link rel="stylesheet" href="style.css">
+        <script src="/app.js"></script>
+        <p><img src="https://cdn.example.com/photo.png"></p>
+    )"sv);
+
+    EXPECT_EQ(fetches.size(), 3u);
+    EXPECT(fetches[0].type == ResourceType::Generic);
+    EXPECT_EQ(fetches[0].url, AK::URL("http://example.com/dir/style.css"));
+    EXPECT(fetches[1].type == ResourceType::Generic);
+    EXPECT_EQ(fetches[1].url, AK::URL("http://example.com/app.js"));
+    EXPECT(fetches[2].type == ResourceType::Image);
+    EXPECT_EQ(fetches[2].url, AK::URL("https://cdn.example.com/photo.png"));
+}
+
+TEST_CASE(skips_resources_the_parser_would_not_fetch)
+{
+    auto fetches = scan(R"(
+        <link rel="alternate stylesheet" href="alternate.css">
+        <link rel="icon" href="favicon.ico">
+        <script type="module" src="module.js"></script>
+        <script nomodule src="legacy.js"></script>
+        <script type="text/plain" src="data.txt"></script>
+        <script src=""></script>
+        <img>
+    )"sv);
+
+    EXPECT(fetches.is_empty());
+}
+
+TEST_CASE(does_not_look_for_markup_in_text)
+{
+    auto fetches = scan(R"(
+        <script>document.write('<img src="in-script.png">');</script>
+        <style>/* <link rel="stylesheet" href="in-style.css"> */</style>
+        <title><img src="in-title.png"></title>
+        <textarea><img src="in-textarea.png"></textarea>
+        <!-- <img src="in-comment.png"> -->
+        <img src="image.png">
+    )"sv);
+
+    EXPECT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(fetches[0].url, AK::URL("http://example.com/dir/image.png"));
+}
+
+TEST_CASE(resolves_urls_against_first_base_element)
+{
+    auto fetches = scan(R"(
+        <base href="https://static.example.com/assets/">
+        <base href="https://ignored.example.com/">
+        <script src="app.js"></script>
+        <img src="../photo.png">
+    )"sv);
+
+    EXPECT_EQ(fetches.size(), 2u);
+    EXPECT_EQ(fetches[0].url, AK::URL("https://static.example.com/assets/app.js"));
+    EXPECT_EQ(fetches[1].url, AK::URL("https://static.example.com/photo.png"));
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibCore/AnonymousBuffer.h>
+#include <LibCore/EventLoop.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Palette.h>
+#include <LibGfx/SystemTheme.h>
+#include <LibWeb/CSS/StyleValue.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/BrowsingContext.h>
+#include <LibWeb/Layout/Node.h>
+#include <LibWeb/Loader/ImageResource.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/Page/Page.h>
+
+// 32x32 PNGs filled with a single color.
+constexpr auto red_image_url = "data:image/png;base64,iVBORw0KGgoAAAANSUhEUgAAACAAAAAgCAIAAAD8GO2jAAAAJ0lEQVR42u3NsQkAAAjAsP7/tF7hIASyp6lTCQQCgUAgEAgEgi/BAjLD/C5w/SM9AAAAAElFTkSuQmCC"sv;
+constexpr auto green_image_url = "data:image/png;base64,iVBORw0KGgoAAAANSUhEUgAAACAAAAAgCAIAAAD8GO2jAAAAJklEQVR42u3NsQkAAAjAsP7/tF7hIASyp6ZbAoFAIBAIBAKB4EuwNof8Lqbpz1cAAAAASUVORK5CYII="sv;
+constexpr auto blue_image_url = "data:image/png;base64,iVBORw0KGgoAAAANSUhEUgAAACAAAAAgCAIAAAD8GO2jAAAAJklEQVR42u3NsQkAAAjAsP7/tF7hIASyp5pjAoFAIBAIBAKB4EmwOkv8Lom8x/sAAAAASUVORK5CYII="sv;
+constexpr size_t decoded_image_size = 32 * 32 * sizeof(Gfx::ARGB32);
+
+class TestImageClient final : public Web::ImageResourceClient {
+public:
+    explicit TestImageClient(StringView url)
+    {
+        auto request = Web::LoadRequest::create_for_url_on_page(AK::URL(url), nullptr);
+        set_resource(Web::ResourceLoader::the().load_resource(Web::Resource::Type::Image, request));
+        while (!resource()->is_loaded() && !resource()->is_failed())
+            Core::EventLoop::current().pump();
+    }
+
+    Web::ImageResource const& image() const { return *resource(); }
+
+    void set_visible_in_viewport(bool visible_in_viewport) { m_visible_in_viewport = visible_in_viewport; }
+
+private:
+    virtual bool is_visible_in_viewport() const override { return m_visible_in_viewport; }
+
+    bool m_visible_in_viewport { false };
+};
+
+class TestPageClient final : public Web::PageClient {
+public:
+    TestPageClient()
+    {
+        auto buffer = MUST(Core::AnonymousBuffer::create_with_size(sizeof(Gfx::SystemTheme)));
+        m_palette_impl = Gfx::PaletteImpl::create_with_anonymous_buffer(buffer);
+    }
+
+    virtual Gfx::Palette palette() const override { return Gfx::Palette(*m_palette_impl); }
+    virtual Gfx::IntRect screen_rect() const override { return { 0, 0, 800, 600 }; }
+    virtual Web::CSS::PreferredColorScheme preferred_color_scheme() const override { return Web::CSS::PreferredColorScheme::Auto; }
+
+private:
+    RefPtr<Gfx::PaletteImpl> m_palette_impl;
+};
+
+template<typename Callback>
+static void with_decoded_image_memory_budget(size_t budget, Callback callback)
+{
+    auto previous_budget = Web::ImageResource::decoded_image_memory_budget();
+    Web::ImageResource::set_decoded_image_memory_budget(budget);
+    callback();
+    Web::ResourceLoader::the().clear_cache();
+    Web::ImageResource::set_decoded_image_memory_budget(previous_budget);
+}
+
+TEST_CASE(images_outside_the_viewport_are_discarded_and_decoded_again)
+{
+    Core::EventLoop event_loop;
+    with_decoded_image_memory_budget(2 * decoded_image_size, [] {
+        TestImageClient red(red_image_url);
+        TestImageClient green(green_image_url);
+        TestImageClient blue(blue_image_url);
+        red.set_visible_in_viewport(true);
+
+        EXPECT(red.image().bitmap());
+        EXPECT(green.image().bitmap());
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), 2 * decoded_image_size);
+
+        // Green is the least recently used image that's out of view, so it has to make room for blue.
+        EXPECT(blue.image().bitmap());
+        EXPECT(red.image().has_decoded_frames());
+        EXPECT(!green.image().has_decoded_frames());
+        EXPECT(blue.image().has_decoded_frames());
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), 2 * decoded_image_size);
+
+        auto const* green_bitmap = green.image().bitmap();
+        EXPECT(green_bitmap);
+        EXPECT_EQ(green_bitmap->get_pixel(0, 0), Color(0, 255, 0));
+        EXPECT(red.image().has_decoded_frames());
+        EXPECT(!blue.image().has_decoded_frames());
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), 2 * decoded_image_size);
+    });
+
+    // Nothing is left decoded once the images are gone.
+    EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), 0u);
+}
+
+TEST_CASE(images_in_the_viewport_are_kept_over_budget)
+{
+    Core::EventLoop event_loop;
+    with_decoded_image_memory_budget(decoded_image_size, [] {
+        TestImageClient red(red_image_url);
+        TestImageClient green(green_image_url);
+        red.set_visible_in_viewport(true);
+        green.set_visible_in_viewport(true);
+
+        EXPECT(red.image().bitmap());
+        EXPECT(green.image().bitmap());
+        EXPECT(red.image().has_decoded_frames());
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), 2 * decoded_image_size);
+
+        // Once it's out of view, lowering the budget is enough to get rid of it.
+        red.set_visible_in_viewport(false);
+        Web::ImageResource::set_decoded_image_memory_budget(decoded_image_size);
+        EXPECT(!red.image().has_decoded_frames());
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), decoded_image_size);
+    });
+    EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), 0u);
+}
+
+TEST_CASE(css_background_images_are_discarded_only_outside_the_viewport)
+{
+    Core::EventLoop event_loop;
+    with_decoded_image_memory_budget(decoded_image_size, [&] {
+        TestPageClient page_client;
+        Web::Page page(page_client);
+        auto& browsing_context = page.top_level_browsing_context();
+        browsing_context.set_viewport_rect({ 0, 0, 800, 600 });
+        auto html = String::formatted(R"~~~(
+            <body style="margin: 0">
+            <div id="top" style="width: 32px; height: 32px; background-image: url({})"></div>
+            <div style="height: 2000px"></div>
+            <div id="bottom" style="width: 32px; height: 32px; background-image: url({})"></div>
+        )~~~",
+            red_image_url, blue_image_url);
+        page.load_html(html, AK::URL("about:blank"));
+
+        auto& document = *browsing_context.active_document();
+        document.update_layout();
+        auto background_image = [&](StringView id) -> Web::CSS::ImageStyleValue const& {
+            auto const* layout_node = document.get_element_by_id(id)->layout_node();
+            VERIFY(layout_node && !layout_node->background_layers().is_empty());
+            return *layout_node->background_layers().first().image;
+        };
+        auto& top = background_image("top"sv);
+        auto& bottom = background_image("bottom"sv);
+
+        while (!top.bitmap())
+            event_loop.pump();
+        while (!bottom.bitmap())
+            event_loop.pump();
+
+        // The style values don't hold on to the bitmaps, so this is all the memory they use.
+        // The top image is in view, so it stays decoded even though that's over budget.
+        EXPECT(top.is_visible_in_viewport());
+        EXPECT(!bottom.is_visible_in_viewport());
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), 2 * decoded_image_size);
+
+        browsing_context.set_viewport_rect({ 0, 2000, 800, 600 });
+        EXPECT(!top.is_visible_in_viewport());
+        EXPECT(bottom.is_visible_in_viewport());
+        Web::ImageResource::set_decoded_image_memory_budget(decoded_image_size);
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), decoded_image_size);
+
+        // Scrolling back up decodes the top image again, the bottom one has to go in turn.
+        browsing_context.set_viewport_rect({ 0, 0, 800, 600 });
+        auto const* top_bitmap = top.bitmap();
+        EXPECT(top_bitmap);
+        EXPECT_EQ(top_bitmap->get_pixel(0, 0), Color(255, 0, 0));
+        EXPECT_EQ(Web::ImageResource::decoded_image_memory_usage(), decoded_image_size);
+    });
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <RequestServer/DiskCache.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+using RequestServer::DiskCache;
+
+static String create_cache_directory()
+{
+    static int s_directory_count = 0;
+    auto path = String::formatted("/tmp/TestDiskCache-{}-{}", getpid(), s_directory_count++);
+    MUST(DiskCache::the().set_directory(path));
+    return path;
+}
+
+static void remove_cache_directory(String const& path)
+{
+    (void)Core::File::remove(path, Core::File::RecursionMode::Allowed, true);
+}
+
+static u64 size_on_disk(String const& path)
+{
+    u64 size = 0;
+    Core::DirIterator iterator(path, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto name = iterator.next_full_path();
+        if (name.ends_with(".body"sv) || name.ends_with(".meta"sv))
+            size += MUST(Core::System::stat(name)).st_size;
+    }
+    return size;
+}
+
+static bool directory_contains_file_ending_with(String const& path, StringView suffix)
+{
+    Core::DirIterator iterator(path, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        if (iterator.next_path().ends_with(suffix))
+            return true;
+    }
+    return false;
+}
+
+static DiskCache::Headers cacheable_headers()
+{
+    DiskCache::Headers headers;
+    headers.set("Cache-Control", "max-age=3600");
+    headers.set("Content-Type", "text/plain");
+    return headers;
+}
+
+static void wait_for_child(pid_t pid)
+{
+    auto result = MUST(Core::System::waitpid(pid));
+    EXPECT(WIFEXITED(result.status));
+    EXPECT_EQ(WEXITSTATUS(result.status), 0);
+}
+
+TEST_CASE(store_and_lookup)
+{
+    auto path = create_cache_directory();
+    auto& cache = DiskCache::the();
+    cache.set_maximum_size(DiskCache::DefaultMaximumSize);
+
+    URL url("http://localhost/resource");
+    EXPECT(!cache.lookup(url).has_value());
+
+    auto body = "Well hello friends!"sv;
+    MUST(cache.store(url, 200, cacheable_headers(), body.bytes()));
+
+    auto entry = cache.lookup(url);
+    EXPECT(entry.has_value());
+    EXPECT_EQ(entry->status_code, 200u);
+    EXPECT(entry->is_fresh());
+    EXPECT_EQ(entry->response_headers.get("Content-Type"sv), "text/plain");
+
+    auto mapped_body = MUST(cache.open_body(url));
+    EXPECT(!mapped_body.is_null());
+    EXPECT_EQ(StringView(static_cast<char const*>(mapped_body->data()), mapped_body->size()), body);
+
+    cache.remove(url);
+    EXPECT(!cache.lookup(url).has_value());
+
+    remove_cache_directory(path);
+}
+
+TEST_CASE(uncacheable_response_is_not_stored)
+{
+    auto path = create_cache_directory();
+    auto& cache = DiskCache::the();
+    cache.set_maximum_size(DiskCache::DefaultMaximumSize);
+
+    URL url("http://localhost/private");
+    DiskCache::Headers headers;
+    headers.set("Cache-Control", "no-store");
+    MUST(cache.store(url, 200, headers, "secret"sv.bytes()));
+    EXPECT(!cache.lookup(url).has_value());
+    EXPECT_EQ(size_on_disk(path), 0u);
+
+    remove_cache_directory(path);
+}
+
+TEST_CASE(metadata_without_body_is_not_an_entry)
+{
+    auto path = create_cache_directory();
+    auto& cache = DiskCache::the();
+    cache.set_maximum_size(DiskCache::DefaultMaximumSize);
+
+    URL url("http://localhost/half-written");
+    MUST(cache.store(url, 200, cacheable_headers(), "body"sv.bytes()));
+
+    // Simulate an instance that crashed after writing the metadata of an entry, but before its body was in place.
+    Core::DirIterator iterator(path, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto name = iterator.next_full_path();
+        if (name.ends_with(".body"sv))
+            MUST(Core::System::unlink(name));
+    }
+    auto stale_file = MUST(Core::Stream::File::open(String::formatted("{}/leftover.body.1234.tmp", path), Core::Stream::OpenMode::Write));
+    stale_file->close();
+
+    EXPECT(!cache.lookup(url).has_value());
+
+    // The leftovers are cleaned up once the directory is used again.
+    MUST(cache.set_directory(path));
+    EXPECT(!directory_contains_file_ending_with(path, ".meta"sv));
+    EXPECT(!directory_contains_file_ending_with(path, ".tmp"sv));
+
+    remove_cache_directory(path);
+}
+
+TEST_CASE(entries_are_shared_between_processes)
+{
+    auto path = create_cache_directory();
+    auto& cache = DiskCache::the();
+    cache.set_maximum_size(DiskCache::DefaultMaximumSize);
+
+    URL url("http://localhost/shared");
+    auto pid = MUST(Core::System::fork());
+    if (pid == 0) {
+        auto result = cache.store(url, 200, cacheable_headers(), "from another instance"sv.bytes());
+        _exit(result.is_error() ? 1 : 0);
+    }
+    wait_for_child(pid);
+
+    auto entry = cache.lookup(url);
+    EXPECT(entry.has_value());
+    auto mapped_body = MUST(cache.open_body(url));
+    EXPECT_EQ(StringView(static_cast<char const*>(mapped_body->data()), mapped_body->size()), "from another instance"sv);
+
+    remove_cache_directory(path);
+}
+
+TEST_CASE(maximum_size_is_shared_between_processes)
+{
+    static constexpr u64 maximum_size = 64 * KiB;
+    static constexpr size_t process_count = 4;
+    static constexpr size_t entries_per_process = 8;
+
+    auto path = create_cache_directory();
+    auto& cache = DiskCache::the();
+    cache.set_maximum_size(maximum_size);
+
+    auto body = MUST(ByteBuffer::create_zeroed(8 * KiB));
+
+    Vector<pid_t> pids;
+    for (size_t process = 0; process < process_count; ++process) {
+        auto pid = MUST(Core::System::fork());
+        if (pid == 0) {
+            for (size_t i = 0; i < entries_per_process; ++i) {
+                URL url(String::formatted("http://localhost/{}/{}", process, i));
+                if (cache.store(url, 200, cacheable_headers(), body.bytes()).is_error())
+                    _exit(1);
+            }
+            _exit(0);
+        }
+        pids.append(pid);
+    }
+    for (auto pid : pids)
+        wait_for_child(pid);
+
+    // The instances stored their entries concurrently, but together they must still stay within the limit.
+    EXPECT(size_on_disk(path) <= maximum_size);
+
+    // This instance has to respect what the others stored, too.
+    for (size_t i = 0; i < entries_per_process; ++i)
+        MUST(cache.store(URL(String::formatted("http://localhost/parent/{}", i)), 200, cacheable_headers(), body.bytes()));
+    EXPECT(size_on_disk(path) <= maximum_size);
+    EXPECT(cache.lookup(URL("http://localhost/parent/7")).has_value());
+
+    remove_cache_directory(path);
+}
+
+TEST_CASE(entries_are_not_removed_while_another_instance_holds_the_lock)
+{
+    auto path = create_cache_directory();
+    auto& cache = DiskCache::the();
+    cache.set_maximum_size(DiskCache::DefaultMaximumSize);
+
+    URL url("http://localhost/locked");
+    MUST(cache.store(url, 200, cacheable_headers(), "locked"sv.bytes()));
+
+    // A separate open file description stands in for another instance, as flock() locks belong to those.
+    auto lock_fd = MUST(Core::System::open(String::formatted("{}/lock", path), O_RDWR));
+    EXPECT_EQ(flock(lock_fd, LOCK_EX | LOCK_NB), 0);
+
+    cache.remove(url);
+    EXPECT(cache.lookup(url).has_value());
+
+    EXPECT_EQ(flock(lock_fd, LOCK_UN), 0);
+    MUST(Core::System::close(lock_fd));
+
+    cache.remove(url);
+    EXPECT(!cache.lookup(url).has_value());
+
+    remove_cache_directory(path);
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Function.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/System.h>
+#include <LibCore/TCPServer.h>
+#include <LibCore/Timer.h>
+#include <LibProtocol/Request.h>
+#include <LibProtocol/RequestClient.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+// These tests talk to RequestServer like any other client would, with a local HTTP server on the other end.
+
+static constexpr auto response_body = "Well hello friends!"sv;
+
+struct ReceivedRequest {
+    String path;
+    Optional<String> if_none_match;
+};
+
+class LocalHTTPServer {
+public:
+    // The server answers every request with `response_headers`, or with 304 Not Modified when the request has a matching ETag.
+    explicit LocalHTTPServer(String response_headers)
+        : m_response_headers(move(response_headers))
+    {
+        m_server = MUST(Core::TCPServer::try_create());
+        MUST(m_server->listen({ 127, 0, 0, 1 }, 0));
+        m_server->on_ready_to_accept = [this] {
+            auto socket_or_error = m_server->accept();
+            if (socket_or_error.is_error())
+                return;
+            handle(socket_or_error.release_value());
+        };
+    }
+
+    u16 port() const { return m_server->local_port().value(); }
+    Vector<ReceivedRequest> const& received_requests() const { return m_received_requests; }
+
+private:
+    void handle(NonnullOwnPtr<Core::Stream::TCPSocket> socket)
+    {
+        MUST(socket->set_blocking(true));
+
+        StringBuilder request;
+        Array<u8, 1024> buffer;
+        while (!request.string_view().contains("\r\n\r\n"sv)) {
+            auto nread = MUST(socket->read(buffer));
+            if (nread == 0)
+                return;
+            request.append(StringView { buffer.data(), nread });
+        }
+
+        ReceivedRequest received_request;
+        auto lines = request.string_view().split_view("\r\n"sv);
+        received_request.path = lines[0].split_view(' ')[1];
+        for (auto line : lines) {
+            if (line.starts_with("If-None-Match:"sv, CaseSensitivity::CaseInsensitive))
+                received_request.if_none_match = line.substring_view(14).trim_whitespace();
+        }
+
+        String response;
+        if (received_request.if_none_match == "\"v1\""sv)
+            response = "HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\nConnection: close\r\n\r\n";
+        else
+            response = String::formatted("HTTP/1.1 200 OK\r\n{}Content-Type: text/plain\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}", m_response_headers, response_body.length(), response_body);
+
+        m_received_requests.append(move(received_request));
+        MUST(socket->write(response.bytes()));
+        socket->close();
+    }
+
+    String m_response_headers;
+    RefPtr<Core::TCPServer> m_server;
+    Vector<ReceivedRequest> m_received_requests;
+};
+
+struct Response {
+    bool success { false };
+    Optional<u32> status_code;
+    String body;
+};
+
+// Requests `url` `count` times, one after another, and returns the responses.
+static Vector<Response> fetch_repeatedly(Core::EventLoop& event_loop, URL const& url, size_t count)
+{
+    auto client = MUST(Protocol::RequestClient::try_create());
+    Vector<Response> responses;
+    RefPtr<Protocol::Request> request;
+
+    Function<void()> start_next_request = [&] {
+        request = client->start_request("GET", url);
+        VERIFY(request);
+        request->on_buffered_request_finish = [&](bool success, u32, auto&, Optional<u32> status_code, ReadonlyBytes payload) {
+            responses.append({ success, status_code, String { StringView { payload } } });
+            Core::deferred_invoke([&] {
+                if (responses.size() == count)
+                    event_loop.quit(0);
+                else
+                    start_next_request();
+            });
+        };
+        request->set_should_buffer_all_input(true);
+    };
+    start_next_request();
+
+    auto timeout = Core::Timer::create_single_shot(10'000, [&] { event_loop.quit(1); });
+    timeout->start();
+    EXPECT_EQ(event_loop.exec(), 0);
+    return responses;
+}
+
+static URL unique_url(LocalHTTPServer const& server, StringView name)
+{
+    // RequestServer's cache outlives this test, so make sure we never run into an entry from a previous run.
+    return URL(String::formatted("http://127.0.0.1:{}/{}-{}-{}", server.port(), name, getpid(), time(nullptr)));
+}
+
+TEST_CASE(fresh_response_is_served_from_cache)
+{
+    Core::EventLoop event_loop;
+    LocalHTTPServer server("Cache-Control: max-age=3600\r\n");
+
+    auto responses = fetch_repeatedly(event_loop, unique_url(server, "fresh"sv), 2);
+    EXPECT_EQ(responses.size(), 2u);
+    for (auto& response : responses) {
+        EXPECT(response.success);
+        EXPECT_EQ(response.status_code, 200u);
+        EXPECT_EQ(response.body, response_body);
+    }
+
+    // The second request never made it to the server.
+    EXPECT_EQ(server.received_requests().size(), 1u);
+}
+
+TEST_CASE(stale_response_is_revalidated)
+{
+    Core::EventLoop event_loop;
+    LocalHTTPServer server("Cache-Control: no-cache\r\nETag: \"v1\"\r\n");
+
+    auto responses = fetch_repeatedly(event_loop, unique_url(server, "stale"sv), 2);
+    EXPECT_EQ(responses.size(), 2u);
+    for (auto& response : responses) {
+        EXPECT(response.success);
+        EXPECT_EQ(response.status_code, 200u);
+        EXPECT_EQ(response.body, response_body);
+    }
+
+    // The second request was conditional, and the cached body replayed for the 304.
+    EXPECT_EQ(server.received_requests().size(), 2u);
+    EXPECT(!server.received_requests()[0].if_none_match.has_value());
+    EXPECT_EQ(server.received_requests()[1].if_none_match, "\"v1\"");
+}
+
+TEST_CASE(uncacheable_response_is_fetched_every_time)
+{
+    Core::EventLoop event_loop;
+    LocalHTTPServer server("Cache-Control: no-store\r\n");
+
+    auto responses = fetch_repeatedly(event_loop, unique_url(server, "no-store"sv), 2);
+    EXPECT_EQ(responses.size(), 2u);
+    EXPECT_EQ(server.received_requests().size(), 2u);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibTest/TestCase.h>
+#include <WebContent/TileCache.h>
+
+using WebContent::TileCache;
+
+// Stands in for the page: every pixel's color follows from where it is in the content.
+static Color content_color_at(int x, int y)
+{
+    return Color(x & 0xff, y & 0xff, ((x >> 8) * 16 + (y >> 8)) & 0xff);
+}
+
+class TestPage {
+public:
+    void paint(TileCache& tile_cache, Gfx::IntRect const& content_rect)
+    {
+        m_target = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, content_rect.size()));
+        m_content_rect = content_rect;
+        tile_cache.paint(content_rect, *m_target, [&](Gfx::IntRect const& rect, Gfx::Bitmap& bitmap) {
+            // Each of these stands for a full traversal of the paint tree.
+            ++m_traversal_count;
+            m_rasterized_rects.append(rect);
+            for (int y = 0; y < rect.height(); ++y) {
+                for (int x = 0; x < rect.width(); ++x)
+                    bitmap.set_pixel(x, y, content_color_at(rect.x() + x, rect.y() + y));
+            }
+        });
+    }
+
+    bool target_matches_content() const
+    {
+        for (int y = 0; y < m_target->height(); ++y) {
+            for (int x = 0; x < m_target->width(); ++x) {
+                if (m_target->get_pixel(x, y) != content_color_at(m_content_rect.x() + x, m_content_rect.y() + y))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    size_t take_traversal_count() { return exchange(m_traversal_count, 0); }
+    Vector<Gfx::IntRect> take_rasterized_rects() { return move(m_rasterized_rects); }
+
+private:
+    RefPtr<Gfx::Bitmap> m_target;
+    Gfx::IntRect m_content_rect;
+    size_t m_traversal_count { 0 };
+    Vector<Gfx::IntRect> m_rasterized_rects;
+};
+
+TEST_CASE(first_paint_traverses_the_page_once)
+{
+    TileCache tile_cache;
+    TestPage page;
+
+    page.paint(tile_cache, { 0, 0, 1920, 1080 });
+    EXPECT_EQ(page.take_traversal_count(), 1u);
+    EXPECT(page.target_matches_content());
+    EXPECT_EQ(tile_cache.tile_count(), 8u * 5u);
+
+    // Everything is in the cache now.
+    page.paint(tile_cache, { 0, 0, 1920, 1080 });
+    EXPECT_EQ(page.take_traversal_count(), 0u);
+    EXPECT(page.target_matches_content());
+}
+
+TEST_CASE(invalidated_tiles_are_painted_in_one_traversal)
+{
+    TileCache tile_cache;
+    TestPage page;
+    page.paint(tile_cache, { 0, 0, 1920, 1080 });
+    page.take_traversal_count();
+    page.take_rasterized_rects();
+
+    tile_cache.invalidate({ 10, 10, 20, 20 });
+    tile_cache.invalidate({ 1000, 600, 200, 20 });
+    EXPECT_EQ(tile_cache.tile_count(), 8u * 5u - 3u);
+
+    page.paint(tile_cache, { 0, 0, 1920, 1080 });
+    EXPECT_EQ(page.take_traversal_count(), 1u);
+    auto rasterized_rects = page.take_rasterized_rects();
+    EXPECT_EQ(rasterized_rects.size(), 1u);
+    EXPECT_EQ(rasterized_rects[0], Gfx::IntRect(0, 0, 5 * TileCache::tile_size, 3 * TileCache::tile_size));
+    EXPECT(page.target_matches_content());
+    EXPECT_EQ(tile_cache.tile_count(), 8u * 5u);
+}
+
+TEST_CASE(scrolling_traverses_the_page_at_most_once_per_frame)
+{
+    TileCache tile_cache;
+    TestPage page;
+
+    for (int frame = 0; frame < 40; ++frame) {
+        page.paint(tile_cache, { 13, frame * 97 - 300, 1000, 700 });
+        EXPECT(page.take_traversal_count() <= 1u);
+    }
+    EXPECT(page.target_matches_content());
+
+    // Scrolling back up within the retained tiles doesn't need to paint anything.
+    page.paint(tile_cache, { 13, 39 * 97 - 800, 1000, 700 });
+    EXPECT_EQ(page.take_traversal_count(), 0u);
+    EXPECT(page.target_matches_content());
+}
@@ -41,6 +41,7 @@
 #include <LibGfx/Font/FontStyleMapping.h>
 #include <LibGfx/Palette.h>
 #include <LibGfx/TextDirection.h>
+#include <LibGfx/TextLayout.h>
 #include <LibUnicode/CharacterTypes.h>
 
 static constexpr Array pangrams = {
@@ -843,6 +844,7 @@ void FontEditorWidget::update_statusbar()
 
 void FontEditorWidget::update_preview()
 {
+    Gfx::TextLayout::purge_cached_layouts_for(*m_edited_font);
     if (m_font_preview_window)
         m_font_preview_window->update();
 }
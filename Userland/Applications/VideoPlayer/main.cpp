@@ -5,6 +5,8 @@
  */
 
 #include <LibAudio/ConnectionFromClient.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/Timer.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/ImageWidget.h>
@@ -26,30 +28,60 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto const& track = optional_track.value();
     auto const video_track = track.video_track().value();
 
-    auto image = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, Gfx::IntSize(video_track.pixel_height, video_track.pixel_width)).release_value_but_fixme_should_propagate_errors();
+    auto image = TRY(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, Gfx::IntSize(video_track.pixel_width, video_track.pixel_height)));
     auto main_widget = TRY(window->try_set_main_widget<GUI::Widget>());
     main_widget->set_fill_with_background_color(true);
     main_widget->set_layout<GUI::VerticalBoxLayout>();
     auto& image_widget = main_widget->add<GUI::ImageWidget>();
     image_widget.set_bitmap(image);
-    image_widget.set_fixed_size(video_track.pixel_height, video_track.pixel_width);
-    TRY(main_widget->try_add_child(image_widget));
+    image_widget.set_fixed_size(video_track.pixel_width, video_track.pixel_height);
 
-    Video::VP9::Decoder vp9_decoder;
+    // The blocks of the video track, with the time at which they are presented in milliseconds.
+    struct PresentedBlock {
+        Video::Block const* block;
+        u64 presentation_time;
+    };
+    Vector<PresentedBlock> blocks;
+    u64 timestamp_scale = 1'000'000;
+    if (auto segment_information = document->segment_information(); segment_information.has_value())
+        timestamp_scale = segment_information->timestamp_scale();
     for (auto const& cluster : document->clusters()) {
         for (auto const& block : cluster.blocks()) {
             if (block.track_number() != track.track_number())
                 continue;
+            auto timestamp = static_cast<i64>(cluster.timestamp()) + block.timestamp();
+            blocks.append({ &block, static_cast<u64>(max<i64>(timestamp, 0)) * timestamp_scale / 1'000'000 });
+        }
+    }
 
-            auto const& frame = block.frame(0);
-            dbgln("Reading frame 0 from block @ {}", block.timestamp());
-            bool failed = !vp9_decoder.decode_frame(frame);
+    Video::VP9::Decoder vp9_decoder;
+    size_t next_block = 0;
+    Core::ElapsedTimer playback_timer;
+    RefPtr<Core::Timer> frame_timer;
+    frame_timer = Core::Timer::create_single_shot(0, [&] {
+        if (next_block >= blocks.size())
+            return;
+        auto const& block = *blocks[next_block++].block;
+        if (!vp9_decoder.decode_frame(block.frame(0))) {
             vp9_decoder.dump_frame_info();
-            if (failed)
-                return 1;
+            return;
         }
-    }
+        if (auto frame = vp9_decoder.shown_frame()) {
+            frame->convert_to_bgrx8888(reinterpret_cast<u32*>(image->scanline_u8(0)), image->pitch());
+            image_widget.update();
+        }
+
+        if (next_block >= blocks.size())
+            return;
+        // If decoding fell behind, the next frame is decoded right away instead of being dropped, since every frame
+        // can be referenced by the ones that follow it.
+        auto next_presentation_time = blocks[next_block].presentation_time;
+        auto elapsed = static_cast<u64>(playback_timer.elapsed());
+        frame_timer->restart(next_presentation_time > elapsed ? static_cast<int>(next_presentation_time - elapsed) : 0);
+    });
 
     window->show();
+    playback_timer.start();
+    frame_timer->start();
     return app->exec();
 }
@@ -178,8 +178,97 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     result.resize_with_leading_zeros(num_words);
 }
 
+/**
+ * Computes the "almost montgomery" square : x * x * 2 ^ (-num_words * BITS_IN_WORD) % modulo
+ * with the same assumptions as almost_montgomery_multiplication_without_allocation().
+ * Unlike the interleaved multiplication above, this computes the full square first (which only needs about half of
+ * the word multiplications, or even fewer through Karatsuba), and then reduces it word by word.
+ */
+void UnsignedBigIntegerAlgorithms::almost_montgomery_square_without_allocation(
+    UnsignedBigInteger const& x,
+    UnsignedBigInteger const& modulo,
+    UnsignedBigInteger& z,
+    UnsignedBigInteger& temp_scratch,
+    UnsignedBigInteger::Word k,
+    size_t num_words,
+    UnsignedBigInteger& result)
+{
+    VERIFY(x.length() >= num_words);
+    VERIFY(modulo.length() >= num_words);
+
+    // z = x * x, with one extra word for the carry of the reduction.
+    z.set_to_0();
+    z.m_words.resize_and_keep_capacity(num_words * 2 + 1);
+    multiply_words(x.m_words.data(), x.m_words.data(), num_words, z.m_words.data(), temp_scratch);
+    z.m_words[num_words * 2] = 0;
+
+    for (size_t i = 0; i < num_words; ++i) {
+        // z[i->num_words+i] += modulo * (z_i * k), which clears z_i
+        UnsignedBigInteger::Word t = z.m_words[i] * k;
+        UnsignedBigInteger::Word carry = montgomery_fragment(z, i, modulo, t, num_words);
+        for (size_t j = num_words + i; carry != 0 && j <= num_words * 2; ++j) {
+            UnsignedBigInteger::Word carry_out;
+            addition_with_carry(z.m_words[j], carry, carry_out, z.m_words[j]);
+            carry = carry_out;
+        }
+    }
+
+    if (z.m_words[num_words * 2] == 0) {
+        // Return the top num_words words of Z, which contains our result.
+        z.m_words.resize(num_words * 2);
+        shift_right_by_n_words(z, num_words, result);
+        return;
+    }
+
+    // Same as in the multiplication: subtract the modulo once to get rid of the carry.
+    UnsignedBigInteger::Word c { 0 };
+    for (size_t i = 0; i < num_words; ++i) {
+        UnsignedBigInteger::Word z_digit = z.m_words[num_words + i];
+        UnsignedBigInteger::Word modulo_digit = modulo.m_words[i];
+        UnsignedBigInteger::Word new_z_digit = z_digit - modulo_digit - c;
+        z.m_words[i] = new_z_digit;
+        c = ((modulo_digit & ~z_digit) | ((modulo_digit | ~z_digit) & new_z_digit)) >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+    }
+
+    z.m_words.resize(num_words);
+    result.set_to(z);
+}
+
+/**
+ * Picks the window size that minimizes the number of multiplications for an exponent with the given number of bits,
+ * trading the 2^window_size - 2 multiplications needed to precompute the powers against one multiplication per window.
+ */
+static size_t window_size_for_exponent(size_t exponent_bits)
+{
+    if (exponent_bits > 671)
+        return 6;
+    if (exponent_bits > 239)
+        return 5;
+    if (exponent_bits > 79)
+        return 4;
+    if (exponent_bits > 23)
+        return 3;
+    return 1;
+}
+
+/**
+ * Returns the window_size bits of the exponent starting at first_bit.
+ */
+static size_t exponent_window(UnsignedBigInteger const& exponent, size_t first_bit, size_t window_size)
+{
+    auto const& words = exponent.words();
+    size_t word_index = first_bit / UnsignedBigInteger::BITS_IN_WORD;
+    size_t bit_in_word = first_bit % UnsignedBigInteger::BITS_IN_WORD;
+
+    u64 bits = words[word_index] >> bit_in_word;
+    if (bit_in_word + window_size > UnsignedBigInteger::BITS_IN_WORD && word_index + 1 < words.size())
+        bits |= static_cast<u64>(words[word_index + 1]) << (UnsignedBigInteger::BITS_IN_WORD - bit_in_word);
+    return bits & ((1u << window_size) - 1);
+}
+
 /**
  * Complexity: still O(N^3) with N the number of words in the largest word, but less complex than the classical mod power.
+ * Method: fixed-window exponentiation, with the window size picked from the size of the exponent.
  * Note: the montgomery multiplications requires an inverse modulo over 2^32, which is only defined for odd numbers.
  */
 void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocations(
@@ -197,9 +286,7 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 {
     VERIFY(modulo.is_odd());
 
-    // Note: While this is a constexpr variable for clarity and could be changed in theory,
-    // various optimized parts of the algorithm rely on this value being exactly 4.
-    constexpr size_t window_size = 4;
+    constexpr size_t max_window_size = 6;
 
     size_t num_words = modulo.trimmed_length();
     UnsignedBigInteger::Word k = inverse_wrapped(modulo.m_words[0]);
@@ -220,39 +307,34 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
     one.set_to(1);
     one.resize_with_leading_zeros(num_words);
 
+    size_t exponent_bits = exponent.one_based_index_of_highest_set_bit();
+    size_t window_size = window_size_for_exponent(exponent_bits);
+    size_t window_count = (exponent_bits + window_size - 1) / window_size;
+
     // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
-    UnsignedBigInteger powers[1 << window_size];
+    UnsignedBigInteger powers[1 << max_window_size];
     almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, powers[0]);
     almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[1]);
-    for (size_t i = 2; i < (1 << window_size); ++i)
+    for (size_t i = 2; i < (1u << window_size); ++i)
         almost_montgomery_multiplication_without_allocation(powers[i - 1], powers[1], modulo, temp_z, k, num_words, powers[i]);
 
-    z.set_to(powers[0]);
+    // The topmost window doesn't need any squarings, so start right from its power.
+    z.set_to(powers[window_count > 0 ? exponent_window(exponent, (window_count - 1) * window_size, window_size) : 0]);
     z.resize_with_leading_zeros(num_words);
     zz.set_to(0);
     zz.resize_with_leading_zeros(num_words);
 
-    ssize_t exponent_length = exponent.trimmed_length();
-    for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
-        UnsignedBigInteger::Word exponent_word = exponent.m_words[word_in_exponent];
-        size_t bit_in_word = 0;
-        while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
-            if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
-            }
-            auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
-            auto& power = powers[power_index];
-            almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
-
+    // Note: Every window is processed the same way, including all-zero ones, so the sequence of
+    // operations only depends on the length of the exponent.
+    for (ssize_t window = static_cast<ssize_t>(window_count) - 2; window >= 0; --window) {
+        for (size_t i = 0; i < window_size; ++i) {
+            almost_montgomery_square_without_allocation(z, modulo, temp_z, temp_extra, k, num_words, zz);
             swap(z, zz);
-
-            // Move to the next window
-            exponent_word <<= window_size;
-            bit_in_word += window_size;
         }
+
+        auto& power = powers[exponent_window(exponent, window * window_size, window_size)];
+        almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
+        swap(z, zz);
     }
 
     almost_montgomery_multiplication_without_allocation(z, one, modulo, temp_z, k, num_words, zz);
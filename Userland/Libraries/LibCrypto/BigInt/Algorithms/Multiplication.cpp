@@ -1,6 +1,7 @@
 /*
  * Copyright (c) 2020, Itamar S. <itamar8910@gmail.com>
  * Copyright (c) 2020-2021, Dex♪ <dexes.ttp@gmail.com>
+ * Copyright (c) 2022, the SerenityOS developers.
  *
  * SPDX-License-Identifier: BSD-2-Clause
  */
@@ -9,13 +10,195 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+static_assert(sizeof(DoubleWord) == 2 * sizeof(Word));
+
+// Below this many words, the additions and subtractions of a Karatsuba step cost more than they save.
+static constexpr size_t karatsuba_threshold = 40;
+
+/**
+ * Adds value into target, rippling the carry through target, and returns the carry that fell off its end.
+ */
+static Word add_into(Word* target, size_t target_length, Word const* value, size_t value_length)
+{
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        carry += static_cast<DoubleWord>(target[i]) + value[i];
+        target[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry && i < target_length; ++i) {
+        carry += target[i];
+        target[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    return static_cast<Word>(carry);
+}
+
+/**
+ * Subtracts value from target, assuming that target is the larger of the two.
+ */
+static void subtract_from(Word* target, size_t target_length, Word const* value, size_t value_length)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(target[i]) - value[i] - borrow;
+        target[i] = static_cast<Word>(difference);
+        borrow = static_cast<Word>(difference >> UnsignedBigInteger::BITS_IN_WORD) & 1;
+    }
+    for (; borrow && i < target_length; ++i) {
+        borrow = target[i] == 0;
+        --target[i];
+    }
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N*M) where N and M are the number of words in the two numbers
+ * Writes left_length + right_length words to output.
+ */
+static void schoolbook_multiply(Word const* left, size_t left_length, Word const* right, size_t right_length, Word* output)
+{
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    for (size_t i = 0; i < left_length; ++i) {
+        DoubleWord left_word = left[i];
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < right_length; ++j) {
+            // This can't overflow, as (2^32 - 1)^2 + 2 * (2^32 - 1) == 2^64 - 1
+            carry += left_word * right[j] + output[i + j];
+            output[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + right_length] = static_cast<Word>(carry);
+    }
+}
+
+/**
+ * Complexity: O(N^2), but with about half the word multiplications of schoolbook_multiply()
+ * Writes 2 * length words to output.
+ */
+static void schoolbook_square(Word const* number, size_t length, Word* output)
+{
+    // Every cross product number[i] * number[j] with i != j shows up twice in the square,
+    // so we only sum the ones where i < j...
+    __builtin_memset(output, 0, 2 * length * sizeof(Word));
+    for (size_t i = 0; i < length; ++i) {
+        DoubleWord carry = 0;
+        for (size_t j = i + 1; j < length; ++j) {
+            carry += static_cast<DoubleWord>(number[i]) * number[j] + output[i + j];
+            output[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + length] = static_cast<Word>(carry);
+    }
+
+    // ...then double them and add the squares of the individual words in a single pass.
+    Word shifted_out = 0;
+    DoubleWord carry = 0;
+    for (size_t i = 0; i < length; ++i) {
+        DoubleWord square = static_cast<DoubleWord>(number[i]) * number[i];
+        Word low = output[2 * i];
+        Word high = output[2 * i + 1];
+
+        carry += static_cast<DoubleWord>(static_cast<Word>((low << 1) | shifted_out)) + static_cast<Word>(square);
+        output[2 * i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+
+        carry += static_cast<DoubleWord>(static_cast<Word>((high << 1) | (low >> 31))) + (square >> UnsignedBigInteger::BITS_IN_WORD);
+        output[2 * i + 1] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+
+        shifted_out = high >> 31;
+    }
+}
+
+static size_t karatsuba_scratch_size(size_t length)
+{
+    if (length < karatsuba_threshold)
+        return 0;
+    size_t sum_length = length - length / 2 + 1;
+    return 4 * sum_length + karatsuba_scratch_size(sum_length);
+}
+
+/**
+ * Complexity: O(N^log2(3)) where N is the number of words in both numbers
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Split both numbers into a low and a high half, x = x1 * B + x0 and y = y1 * B + y0. Then
+ * x * y = x1 * y1 * B^2 + ((x0 + x1) * (y0 + y1) - x0 * y0 - x1 * y1) * B + x0 * y0
+ * which only needs three multiplications of half the size instead of four.
+ * Squaring is detected by left and right being the same pointer, and stays a squaring all the way down.
+ */
+static void karatsuba_multiply(Word const* left, Word const* right, size_t length, Word* output, Word* scratch)
+{
+    bool is_square = left == right;
+    if (length < karatsuba_threshold) {
+        if (is_square)
+            schoolbook_square(left, length, output);
+        else
+            schoolbook_multiply(left, length, right, length, output);
+        return;
+    }
+
+    size_t low_length = length / 2;
+    size_t high_length = length - low_length;
+    size_t sum_length = high_length + 1;
+
+    // output = x1 * y1 * B^2 + x0 * y0
+    karatsuba_multiply(left, right, low_length, output, scratch);
+    karatsuba_multiply(left + low_length, right + low_length, high_length, output + 2 * low_length, scratch);
+
+    Word* left_sum = scratch;
+    Word* right_sum = left_sum + sum_length;
+    Word* middle = right_sum + sum_length;
+    Word* next_scratch = middle + 2 * sum_length;
+
+    // left_sum = x0 + x1, right_sum = y0 + y1
+    __builtin_memcpy(left_sum, left + low_length, high_length * sizeof(Word));
+    left_sum[high_length] = 0;
+    add_into(left_sum, sum_length, left, low_length);
+    if (!is_square) {
+        __builtin_memcpy(right_sum, right + low_length, high_length * sizeof(Word));
+        right_sum[high_length] = 0;
+        add_into(right_sum, sum_length, right, low_length);
+    }
+
+    // middle = (x0 + x1) * (y0 + y1) - x0 * y0 - x1 * y1
+    karatsuba_multiply(left_sum, is_square ? left_sum : right_sum, sum_length, middle, next_scratch);
+    subtract_from(middle, 2 * sum_length, output, 2 * low_length);
+    subtract_from(middle, 2 * sum_length, output + 2 * low_length, 2 * high_length);
+
+    // output += middle * B
+    // Note: The full product fits in output, so anything past its end in middle is zero.
+    size_t remaining_length = 2 * length - low_length;
+    add_into(output + low_length, remaining_length, middle, min(2 * sum_length, remaining_length));
+}
+
+/**
+ * Writes the 2 * length words of left * right to output, using scratch as temporary storage.
+ * Passing the same pointer as left and right computes a (faster) square.
+ */
+void UnsignedBigIntegerAlgorithms::multiply_words(
+    UnsignedBigInteger::Word const* left,
+    UnsignedBigInteger::Word const* right,
+    size_t length,
+    UnsignedBigInteger::Word* output,
+    UnsignedBigInteger& scratch)
+{
+    scratch.set_to_0();
+    scratch.m_words.resize_and_keep_capacity(karatsuba_scratch_size(length));
+    karatsuba_multiply(left, right, length, output, scratch.m_words.data());
+}
+
+/**
+ * Complexity: O(N^log2(3)) where N is the number of words in the larger number,
+ *             or O(N*M) if the smaller number has M < karatsuba_threshold words
+ * Multiplication method:
+ * Small numbers use the schoolbook method, one row of word products per word of the shorter number.
+ * Large numbers use Karatsuba multiplication, which needs the numbers to be of equal size,
+ * so the longer number is multiplied piece by piece, each piece the size of the shorter number.
+ * Note: The temporaries are only used as scratch space.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
@@ -25,22 +208,56 @@ FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger& temp_shift,
     UnsignedBigInteger& output)
 {
+    UnsignedBigInteger const* longer = &left;
+    UnsignedBigInteger const* shorter = &right;
+    size_t longer_length = left.trimmed_length();
+    size_t shorter_length = right.trimmed_length();
+    if (longer_length < shorter_length) {
+        swap(longer, shorter);
+        swap(longer_length, shorter_length);
+    }
+
     output.set_to_0();
+    if (shorter_length == 0)
+        return;
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    if (shorter_length < karatsuba_threshold) {
+        output.m_words.resize_and_keep_capacity(longer_length + shorter_length);
+        if (longer == shorter)
+            schoolbook_square(longer->m_words.data(), longer_length, output.m_words.data());
+        else
+            schoolbook_multiply(longer->m_words.data(), longer_length, shorter->m_words.data(), shorter_length, output.m_words.data());
+        output.clamp_to_trimmed_length();
+        return;
+    }
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    size_t piece_count = (longer_length + shorter_length - 1) / shorter_length;
+    // The last piece may be shorter, but its product is computed as if it were zero-padded.
+    size_t output_length = (piece_count + 1) * shorter_length;
+    output.m_words.resize_and_keep_capacity(output_length);
+    __builtin_memset(output.m_words.data(), 0, output_length * sizeof(Word));
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
+    auto& padded_piece = temp_shift_result;
+    auto& product = temp_shift_plus;
+    product.set_to_0();
+    product.m_words.resize_and_keep_capacity(2 * shorter_length);
+
+    for (size_t piece = 0; piece < piece_count; ++piece) {
+        size_t offset = piece * shorter_length;
+        Word const* piece_words = longer->m_words.data() + offset;
+        if (offset + shorter_length > longer_length) {
+            padded_piece.set_to_0();
+            padded_piece.m_words.resize_and_keep_capacity(shorter_length);
+            __builtin_memset(padded_piece.m_words.data(), 0, shorter_length * sizeof(Word));
+            __builtin_memcpy(padded_piece.m_words.data(), piece_words, (longer_length - offset) * sizeof(Word));
+            piece_words = padded_piece.m_words.data();
         }
+
+        multiply_words(piece_words, shorter->m_words.data(), shorter_length, product.m_words.data(), temp_shift);
+        add_into(output.m_words.data() + offset, output_length - offset, product.m_words.data(), 2 * shorter_length);
     }
+
+    output.clamp_to_trimmed_length();
 }
 
 }
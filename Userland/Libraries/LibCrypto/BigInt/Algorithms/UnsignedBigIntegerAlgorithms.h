@@ -32,6 +32,8 @@ public:
 private:
     static UnsignedBigInteger::Word montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words);
     static void almost_montgomery_multiplication_without_allocation(UnsignedBigInteger const& x, UnsignedBigInteger const& y, UnsignedBigInteger const& modulo, UnsignedBigInteger& z, UnsignedBigInteger::Word k, size_t num_words, UnsignedBigInteger& result);
+    static void almost_montgomery_square_without_allocation(UnsignedBigInteger const& x, UnsignedBigInteger const& modulo, UnsignedBigInteger& z, UnsignedBigInteger& temp_scratch, UnsignedBigInteger::Word k, size_t num_words, UnsignedBigInteger& result);
+    static void multiply_words(UnsignedBigInteger::Word const* left, UnsignedBigInteger::Word const* right, size_t length, UnsignedBigInteger::Word* output, UnsignedBigInteger& scratch);
     static void shift_left_by_n_words(UnsignedBigInteger const& number, size_t number_of_words, UnsignedBigInteger& output);
     static void shift_right_by_n_words(UnsignedBigInteger const& number, size_t number_of_words, UnsignedBigInteger& output);
     ALWAYS_INLINE static UnsignedBigInteger::Word shift_left_get_one_word(UnsignedBigInteger const& number, size_t num_bits, size_t result_word_index);
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/CPUFeatures.h>
+
+#if CRYPTO_HAS_X86_EXTENSIONS
+#    include <cpuid.h>
+#endif
+
+namespace Crypto {
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+#if CRYPTO_HAS_X86_EXTENSIONS
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return features;
+
+    // All of the hardware paths also shuffle bytes around with SSSE3/SSE4.1 instructions.
+    bool has_sse4_1 = (ecx & bit_SSSE3) && (ecx & bit_SSE4_1);
+    features.aes_ni = has_sse4_1 && (ecx & bit_AES);
+    features.pclmulqdq = has_sse4_1 && (ecx & bit_PCLMUL);
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        features.sha = has_sse4_1 && (ebx & bit_SHA);
+#endif
+    return features;
+}
+
+CPUFeatures& CPUFeatures::the()
+{
+    static CPUFeatures s_the = detect_cpu_features();
+    return s_the;
+}
+
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+
+// The kernel doesn't preserve the vector registers across its own code, so it always takes the portable paths.
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    define CRYPTO_HAS_X86_EXTENSIONS 1
+#else
+#    define CRYPTO_HAS_X86_EXTENSIONS 0
+#endif
+
+namespace Crypto {
+
+// Instruction set extensions that the primitives can dispatch to at runtime.
+// These are detected once, and may be turned off (but never on) to exercise the portable implementations.
+struct CPUFeatures {
+    bool aes_ni { false };
+    bool pclmulqdq { false };
+    bool sha { false };
+
+    static CPUFeatures& the();
+};
+
+}
@@ -5,9 +5,14 @@
  */
 
 #include <AK/StringBuilder.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if CRYPTO_HAS_X86_EXTENSIONS
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
@@ -197,8 +202,48 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
     }
 }
 
+#if CRYPTO_HAS_X86_EXTENSIONS
+[[gnu::target("aes,ssse3")]] static inline __m128i load_round_key(u32 const* round_keys, size_t round)
+{
+    // The round keys are stored as big-endian words, AES-NI wants them in plain byte order.
+    auto const byte_swap_words = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(round_keys + round * 4)), byte_swap_words);
+}
+
+[[gnu::target("aes,ssse3")]] static void encrypt_block_with_aes_ni(AESCipherKey const& key, u8 const* in, u8* out)
+{
+    auto const* round_keys = key.round_keys();
+    auto rounds = key.rounds();
+
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), load_round_key(round_keys, 0));
+    for (size_t round = 1; round < rounds; ++round)
+        state = _mm_aesenc_si128(state, load_round_key(round_keys, round));
+    state = _mm_aesenclast_si128(state, load_round_key(round_keys, rounds));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+// Note: expand_decrypt_key() produces the key schedule of the "equivalent inverse cipher" (FIPS-197 section 5.3.5),
+//       reversed and with InvMixColumns applied to the middle round keys, which is exactly what AESDEC expects.
+[[gnu::target("aes,ssse3")]] static void decrypt_block_with_aes_ni(AESCipherKey const& key, u8 const* in, u8* out)
+{
+    auto const* round_keys = key.round_keys();
+    auto rounds = key.rounds();
+
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), load_round_key(round_keys, 0));
+    for (size_t round = 1; round < rounds; ++round)
+        state = _mm_aesdec_si128(state, load_round_key(round_keys, round));
+    state = _mm_aesdeclast_si128(state, load_round_key(round_keys, rounds));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+#endif
+
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_EXTENSIONS
+    if (CPUFeatures::the().aes_ni)
+        return encrypt_block_with_aes_ni(key(), in.bytes().data(), out.bytes().data());
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -291,6 +336,11 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_EXTENSIONS
+    if (CPUFeatures::the().aes_ni)
+        return decrypt_block_with_aes_ni(key(), in.bytes().data(), out.bytes().data());
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -171,9 +171,13 @@ public:
 
     virtual DigestType peek() override
     {
+        // NOTE: Finishing a hash messes with its state, so do that on a copy to allow for further updates.
         return m_algorithm.visit(
             [&](Empty&) -> DigestType { VERIFY_NOT_REACHED(); },
-            [&](auto& hash) -> DigestType { return hash.peek(); });
+            [&](auto& hash) -> DigestType {
+                auto copy = hash;
+                return copy.peek();
+            });
     }
 
     virtual DigestType digest() override
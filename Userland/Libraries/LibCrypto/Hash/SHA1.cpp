@@ -7,8 +7,13 @@
 #include <AK/Endian.h>
 #include <AK/Memory.h>
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if CRYPTO_HAS_X86_EXTENSIONS
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 
@@ -17,8 +22,63 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
     return (value << bits) | (value >> (32 - bits));
 }
 
+#if CRYPTO_HAS_X86_EXTENSIONS
+[[gnu::target("sha,sse4.1")]] static void transform_with_sha_extensions(u32 (&state)[5], u8 const* data)
+{
+    // The message words and the state are kept in reverse order, with A (and E) in the highest lane.
+    auto const reverse_bytes = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    auto e = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+    auto const saved_abcd = abcd;
+    auto const saved_e = e;
+
+    __m128i words[4];
+    for (size_t i = 0; i < 4; ++i)
+        words[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16)), reverse_bytes);
+
+    // Each iteration performs four rounds, computing the next four message words as it goes.
+    e = _mm_add_epi32(e, words[0]);
+    __m128i next_e = abcd;
+    for (size_t i = 0; i < 20; ++i) {
+        if (i >= 4) {
+            // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1
+            auto& w = words[i % 4];
+            w = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w, words[(i + 1) % 4]), words[(i + 2) % 4]), words[(i + 3) % 4]);
+        }
+        if (i > 0)
+            e = _mm_sha1nexte_epu32(next_e, words[i % 4]);
+        next_e = abcd;
+        switch (i / 5) {
+        case 0:
+            abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+            break;
+        case 1:
+            abcd = _mm_sha1rnds4_epu32(abcd, e, 1);
+            break;
+        case 2:
+            abcd = _mm_sha1rnds4_epu32(abcd, e, 2);
+            break;
+        default:
+            abcd = _mm_sha1rnds4_epu32(abcd, e, 3);
+            break;
+        }
+    }
+
+    e = _mm_sha1nexte_epu32(next_e, saved_e);
+    abcd = _mm_add_epi32(abcd, saved_abcd);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = static_cast<u32>(_mm_extract_epi32(e, 3));
+}
+#endif
+
 inline void SHA1::transform(u8 const* data)
 {
+#if CRYPTO_HAS_X86_EXTENSIONS
+    if (CPUFeatures::the().sha)
+        return transform_with_sha_extensions(m_state, data);
+#endif
+
     u32 blocks[80];
     for (size_t i = 0; i < 16; ++i)
         blocks[i] = AK::convert_between_host_and_network_endian(((u32 const*)data)[i]);
@@ -69,13 +129,17 @@ inline void SHA1::transform(u8 const* data)
 
 void SHA1::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
+    while (length > 0) {
         if (m_data_length == BlockSize) {
             transform(m_data_buffer);
             m_bit_length += 512;
             m_data_length = 0;
         }
-        m_data_buffer[m_data_length++] = message[i];
+        auto chunk_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, chunk_length);
+        m_data_length += chunk_length;
+        message += chunk_length;
+        length -= chunk_length;
     }
 }
 
@@ -5,8 +5,13 @@
  */
 
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if CRYPTO_HAS_X86_EXTENSIONS
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
@@ -25,8 +30,53 @@ constexpr static auto EP1(u64 x) { return ROTRIGHT(x, 14) ^ ROTRIGHT(x, 18) ^ RO
 constexpr static auto SIGN0(u64 x) { return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x >> 7); }
 constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6); }
 
+#if CRYPTO_HAS_X86_EXTENSIONS
+[[gnu::target("sha,sse4.1")]] static void transform_with_sha_extensions(u32 (&state)[8], u8 const* data)
+{
+    auto const byte_swap_words = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    // SHA256RNDS2 wants the state split up as ABEF and CDGH.
+    auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0])), 0xb1);
+    auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4])), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+    auto const saved_abef = abef;
+    auto const saved_cdgh = cdgh;
+
+    __m128i words[4];
+    for (size_t i = 0; i < 4; ++i)
+        words[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16)), byte_swap_words);
+
+    // Each iteration performs four rounds, computing the next four message words as it goes.
+    for (size_t i = 0; i < 16; ++i) {
+        auto& w = words[i % 4];
+        if (i >= 4) {
+            // w[i] = SIGN1(w[i-2]) + w[i-7] + SIGN0(w[i-15]) + w[i-16]
+            auto w_minus_7 = _mm_alignr_epi8(words[(i + 3) % 4], words[(i + 2) % 4], 4);
+            w = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w, words[(i + 1) % 4]), w_minus_7), words[(i + 3) % 4]);
+        }
+        auto message = _mm_add_epi32(w, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[i * 4])));
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0e));
+    }
+
+    abef = _mm_add_epi32(abef, saved_abef);
+    cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+#endif
+
 inline void SHA256::transform(u8 const* data)
 {
+#if CRYPTO_HAS_X86_EXTENSIONS
+    if (CPUFeatures::the().sha)
+        return transform_with_sha_extensions(m_state, data);
+#endif
+
     u32 m[64];
 
     size_t i = 0;
@@ -68,13 +118,17 @@ inline void SHA256::transform(u8 const* data)
 
 void SHA256::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
+    while (length > 0) {
         if (m_data_length == BlockSize) {
             transform(m_data_buffer);
             m_bit_length += 512;
             m_data_length = 0;
         }
-        m_data_buffer[m_data_length++] = message[i];
+        auto chunk_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, chunk_length);
+        m_data_length += chunk_length;
+        message += chunk_length;
+        length -= chunk_length;
     }
 }
 
@@ -186,13 +240,17 @@ inline void SHA384::transform(u8 const* data)
 
 void SHA384::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
+    while (length > 0) {
         if (m_data_length == BlockSize) {
             transform(m_data_buffer);
             m_bit_length += 1024;
             m_data_length = 0;
         }
-        m_data_buffer[m_data_length++] = message[i];
+        auto chunk_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, chunk_length);
+        m_data_length += chunk_length;
+        message += chunk_length;
+        length -= chunk_length;
     }
 }
 
@@ -310,13 +368,17 @@ inline void SHA512::transform(u8 const* data)
 
 void SHA512::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
+    while (length > 0) {
         if (m_data_length == BlockSize) {
             transform(m_data_buffer);
             m_bit_length += 1024;
             m_data_length = 0;
         }
-        m_data_buffer[m_data_length++] = message[i];
+        auto chunk_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, chunk_length);
+        m_data_length += chunk_length;
+        message += chunk_length;
+        length -= chunk_length;
     }
 }
 
@@ -14,6 +14,7 @@
 #include <AK/LexicalPath.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/ScopeGuard.h>
+#include <AK/Time.h>
 #include <AK/Vector.h>
 #include <LibC/bits/pthread_integration.h>
 #include <LibC/link.h>
@@ -26,6 +27,7 @@
 #include <LibELF/DynamicLoader.h>
 #include <LibELF/DynamicObject.h>
 #include <LibELF/Hashes.h>
+#include <LibELF/PrelinkCache.h>
 #include <fcntl.h>
 #include <string.h>
 #include <sys/types.h>
@@ -53,8 +55,24 @@ static __pthread_mutex_t s_loader_lock = __PTHREAD_MUTEX_INITIALIZER;
 
 static bool s_allowed_to_check_environment_variables { false };
 static bool s_do_breakpoint_trap_before_entry { false };
+static bool s_exit_before_initializers { false };
+static bool s_bind_now { false };
+static bool s_show_load_timings { false };
 static StringView s_ld_library_path;
 
+enum class PrelinkMode {
+    UseCache,
+    Record,
+    Ignore,
+};
+static PrelinkMode s_prelink_mode { PrelinkMode::UseCache };
+static bool s_has_set_up_prelinking { false };
+static OwnPtr<PrelinkCache> s_prelink_cache;
+static OwnPtr<PrelinkCache::Builder> s_prelink_cache_builder;
+// The objects loaded on startup, in the order they were added to the global scope. Objects are referred to by their index in here in the prelink cache.
+static Vector<DynamicObject const*> s_prelinked_objects;
+static HashMap<DynamicObject const*, u32> s_prelinked_object_indices;
+
 static Result<void, DlErrorMessage> __dlclose(void* handle);
 static Result<void*, DlErrorMessage> __dlopen(char const* filename, int flags);
 static Result<void*, DlErrorMessage> __dlsym(void* handle, char const* symbol_name);
@@ -79,11 +97,111 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return weak_result;
 }
 
+static Optional<DynamicObject::SymbolLookupResult> lookup_prelinked_symbol(u32 object_index, DynamicObject::Symbol const& symbol)
+{
+    auto resolution = s_prelink_cache->find_resolution(object_index, symbol.index());
+    if (!resolution.has_value())
+        return {};
+
+    // NOTE: The cache can't know how many symbols the provider has until it's loaded, so a stale or corrupt cache might point past them.
+    auto const& provider = *s_prelinked_objects[resolution->provider_object_index];
+    if (resolution->provider_symbol_index >= provider.symbol_count())
+        return {};
+    auto provider_symbol = provider.symbol(resolution->provider_symbol_index);
+    // NOTE: This is cheap compared to a lookup, and catches a cache that doesn't match the objects after all.
+    if (provider_symbol.is_undefined() || provider_symbol.name() != symbol.name())
+        return {};
+    return DynamicObject::SymbolLookupResult { provider_symbol.value(), provider_symbol.size(), provider_symbol.address(), provider_symbol.bind(), &provider, provider_symbol.index() };
+}
+
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(DynamicObject::Symbol const& symbol)
+{
+    if (!s_prelink_cache && !s_prelink_cache_builder)
+        return lookup_global_symbol(symbol.name());
+
+    auto object_index = s_prelinked_object_indices.get(&symbol.object());
+    if (s_prelink_cache && object_index.has_value()) {
+        if (auto result = lookup_prelinked_symbol(*object_index, symbol); result.has_value())
+            return result;
+    }
+
+    auto result = lookup_global_symbol(symbol.name());
+
+    if (s_prelink_cache_builder && object_index.has_value() && result.has_value()) {
+        if (auto provider_object_index = s_prelinked_object_indices.get(result->dynamic_object); provider_object_index.has_value())
+            s_prelink_cache_builder->add_resolution(*object_index, { symbol.index(), *provider_object_index, result->symbol_index });
+    }
+    return result;
+}
+
 static String get_library_name(String path)
 {
     return LexicalPath::basename(move(path));
 }
 
+static void set_up_prelinking()
+{
+    for (auto& it : s_global_objects) {
+        s_prelinked_object_indices.set(it.value.ptr(), s_prelinked_objects.size());
+        s_prelinked_objects.append(it.value.ptr());
+    }
+
+    auto identity_of = [](DynamicObject const& object) {
+        return (*s_loaders.get(get_library_name(object.filename())))->file_identity();
+    };
+
+    if (s_prelink_mode == PrelinkMode::Record) {
+        s_prelink_cache_builder = make<PrelinkCache::Builder>();
+        for (auto const* object : s_prelinked_objects)
+            s_prelink_cache_builder->add_object(object->filename(), identity_of(*object));
+        return;
+    }
+
+    if (s_prelink_mode == PrelinkMode::Ignore)
+        return;
+
+    auto cache = PrelinkCache::open(PrelinkCache::path_for_program(s_main_program_name));
+    if (!cache)
+        return;
+
+    // The cache is only usable if it was recorded with exactly the same object files, loaded in the same order.
+    if (cache->object_count() != s_prelinked_objects.size()) {
+        dbgln_if(DYNAMIC_LOAD_DEBUG, "Prelink cache for {} is stale: object count differs", s_main_program_name);
+        return;
+    }
+    for (size_t i = 0; i < s_prelinked_objects.size(); ++i) {
+        auto const& object = *s_prelinked_objects[i];
+        if (cache->object_name(i) != object.filename() || cache->object_identity(i) != identity_of(object)) {
+            dbgln_if(DYNAMIC_LOAD_DEBUG, "Prelink cache for {} is stale: {} changed", s_main_program_name, object.filename());
+            return;
+        }
+    }
+
+    dbgln_if(DYNAMIC_LOAD_DEBUG, "Using prelink cache for {}", s_main_program_name);
+    s_prelink_cache = move(cache);
+}
+
+static void finish_recording_prelink_cache()
+{
+    // PLT entries are normally bound lazily, after we're done here. Resolve them now so they're recorded too.
+    for (auto const* object : s_prelinked_objects) {
+        if (!object->has_plt())
+            continue;
+        object->plt_relocation_section().for_each_relocation([](DynamicObject::Relocation const& relocation) {
+            (void)DynamicLoader::lookup_symbol(relocation.symbol());
+        });
+    }
+
+    auto path = PrelinkCache::path_for_program(s_main_program_name);
+    auto result = s_prelink_cache_builder->write_to_file(path);
+    if (result.is_error()) {
+        warnln("{}", result.error().text);
+        fflush(stderr);
+        _exit(1);
+    }
+    dbgln_if(DYNAMIC_LOAD_DEBUG, "Wrote prelink cache for {} to {}", s_main_program_name, path);
+}
+
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(String const& filename, int fd)
 {
     auto result = ELF::DynamicLoader::try_create(fd, filename);
@@ -295,6 +413,50 @@ static void for_each_unfinished_dependency_of(String const& name, HashTable<Stri
     callback(*s_loaders.get(name).value());
 }
 
+struct LoadTimings {
+    Time mapping;
+    Time relocation;
+    Time initialization;
+};
+
+// Adds the time spent in its scope to the given total, if load timings are being reported.
+class ScopedLoadTimer {
+public:
+    explicit ScopedLoadTimer(Time& total)
+        : m_total(s_show_load_timings ? &total : nullptr)
+    {
+        if (m_total)
+            m_start = Time::now_monotonic();
+    }
+
+    ~ScopedLoadTimer()
+    {
+        if (m_total)
+            *m_total += Time::now_monotonic() - m_start;
+    }
+
+private:
+    Time* m_total { nullptr };
+    Time m_start;
+};
+
+static void report_load_timings(NonnullRefPtrVector<DynamicLoader> const& loaders, HashMap<DynamicLoader const*, LoadTimings>& timings, bool did_run_initializers)
+{
+    for (auto const& loader : loaders) {
+        auto const& loader_timings = timings.ensure(&loader);
+        auto const& object = loader.dynamic_object();
+        auto plt_entry_count = object.has_plt() ? object.plt_relocation_section().entry_count() : 0;
+        warnln("{}: mapped in {}us, {} relocations and {} PLT entries ({}) in {}us, initializers {}",
+            loader.filename(),
+            loader_timings.mapping.to_microseconds(),
+            object.relocation_section().entry_count(),
+            plt_entry_count,
+            loader.binds_plt_entries_now() ? "bound now" : "bound lazily",
+            loader_timings.relocation.to_microseconds(),
+            did_run_initializers ? String::formatted("in {}us", loader_timings.initialization.to_microseconds()) : "not run");
+    }
+}
+
 static NonnullRefPtrVector<DynamicLoader> collect_loaders_for_library(String const& name, bool skip_global_objects)
 {
     HashTable<String> seen_names;
@@ -307,19 +469,33 @@ static NonnullRefPtrVector<DynamicLoader> collect_loaders_for_library(String con
 
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> load_main_library(String const& name, int flags, bool skip_global_objects)
 {
+    HashMap<DynamicLoader const*, LoadTimings> timings;
+
     auto main_library_loader = *s_loaders.get(name);
-    auto main_library_object = main_library_loader->map();
+    RefPtr<DynamicObject> main_library_object;
+    {
+        ScopedLoadTimer timer(timings.ensure(main_library_loader).mapping);
+        main_library_object = main_library_loader->map();
+    }
     s_global_objects.set(name, *main_library_object);
 
     auto loaders = collect_loaders_for_library(name, skip_global_objects);
 
     for (auto& loader : loaders) {
+        ScopedLoadTimer timer(timings.ensure(&loader).mapping);
         auto dynamic_object = loader.map();
         if (dynamic_object)
             s_global_objects.set(dynamic_object->filename(), *dynamic_object);
     }
 
+    // NOTE: Only the objects loaded on startup take part in prelinking, objects loaded with dlopen() later on don't.
+    if (!s_has_set_up_prelinking) {
+        s_has_set_up_prelinking = true;
+        set_up_prelinking();
+    }
+
     for (auto& loader : loaders) {
+        ScopedLoadTimer timer(timings.ensure(&loader).relocation);
         bool success = loader.link(flags);
         if (!success) {
             return DlErrorMessage { String::formatted("Failed to link library {}", loader.filename()) };
@@ -327,6 +503,7 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> load_main_library(St
     }
 
     for (auto& loader : loaders) {
+        ScopedLoadTimer timer(timings.ensure(&loader).relocation);
         auto result = loader.load_stage_3(flags);
         VERIFY(!result.is_error());
         auto& object = result.value();
@@ -345,10 +522,22 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> load_main_library(St
         }
     }
 
+    if (s_exit_before_initializers) {
+        if (s_show_load_timings)
+            report_load_timings(loaders, timings, false);
+        if (s_prelink_cache_builder)
+            finish_recording_prelink_cache();
+        _exit(0);
+    }
+
     for (auto& loader : loaders) {
+        ScopedLoadTimer timer(timings.ensure(&loader).initialization);
         loader.load_stage_4();
     }
 
+    if (s_show_load_timings)
+        report_load_timings(loaders, timings, true);
+
     return NonnullRefPtr<DynamicLoader>(*main_library_loader);
 }
 
@@ -398,9 +587,13 @@ static Optional<DlErrorMessage> verify_tls_for_dlopen(DynamicLoader const& loade
 
 static Result<void*, DlErrorMessage> __dlopen(char const* filename, int flags)
 {
-    // FIXME: RTLD_NOW and RTLD_LOCAL are not supported
-    flags &= ~RTLD_NOW;
-    flags |= RTLD_LAZY;
+    // FIXME: RTLD_LOCAL is not supported
+    if (s_bind_now)
+        flags |= RTLD_NOW;
+    if (flags & RTLD_NOW)
+        flags &= ~RTLD_LAZY;
+    else
+        flags |= RTLD_LAZY;
     flags &= ~RTLD_LOCAL;
     flags |= RTLD_GLOBAL;
 
@@ -525,6 +718,26 @@ static void read_environment_variables()
             s_do_breakpoint_trap_before_entry = true;
         }
 
+        if (env_string == "_LOADER_PRELINK=record"sv) {
+            // Resolve everything from scratch, write the results to the prelink cache, and exit without running the program.
+            s_prelink_mode = PrelinkMode::Record;
+            s_exit_before_initializers = true;
+        }
+        if (env_string == "_LOADER_PRELINK=ignore"sv && s_prelink_mode != PrelinkMode::Record) {
+            s_prelink_mode = PrelinkMode::Ignore;
+        }
+        // Like elsewhere, any non-empty value of LD_BIND_NOW makes us bind all PLT entries on load instead of lazily.
+        constexpr auto bind_now_string = "LD_BIND_NOW="sv;
+        if (env_string.starts_with(bind_now_string) && env_string.length() > bind_now_string.length()) {
+            s_bind_now = true;
+        }
+        if (env_string == "_LOADER_SHOW_TIMINGS=1"sv) {
+            s_show_load_timings = true;
+        }
+        if (env_string == "_LOADER_EXIT_BEFORE_INITIALIZERS=1"sv) {
+            s_exit_before_initializers = true;
+        }
+
         constexpr auto library_path_string = "LD_LIBRARY_PATH="sv;
         if (env_string.starts_with(library_path_string)) {
             s_ld_library_path = env_string.substring_view(library_path_string.length());
@@ -570,7 +783,7 @@ void ELF::DynamicLinker::linker_main(String&& main_program_name, int main_progra
 
     auto entry_point_function = [&main_program_name] {
         auto library_name = get_library_name(main_program_name);
-        auto result = load_main_library(library_name, RTLD_GLOBAL | RTLD_LAZY, false);
+        auto result = load_main_library(library_name, RTLD_GLOBAL | (s_bind_now ? RTLD_NOW : RTLD_LAZY), false);
         if (result.is_error()) {
             warnln("{}", result.error().text);
             _exit(1);
@@ -15,6 +15,8 @@ namespace ELF {
 class DynamicLinker {
 public:
     static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol(StringView symbol);
+    // Resolves a symbol reference made by a loaded object, using the prelink cache if there is one.
+    static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol(DynamicObject::Symbol const&);
     [[noreturn]] static void linker_main(String&& main_program_name, int fd, bool is_secure, int argc, char** argv, char** envp);
 
 private:
@@ -57,6 +57,7 @@ Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> DynamicLoader::try_create(i
     auto loader = adopt_ref(*new DynamicLoader(fd, move(filename), data, size));
     if (!loader->is_valid())
         return DlErrorMessage { "ELF image validation failed" };
+    loader->m_file_identity = { static_cast<u64>(stat.st_dev), static_cast<u64>(stat.st_ino), static_cast<i64>(stat.st_mtime), static_cast<u64>(stat.st_size) };
     return loader;
 }
 
@@ -160,6 +161,8 @@ bool DynamicLoader::load_stage_2(unsigned flags)
 {
     VERIFY(flags & RTLD_GLOBAL);
 
+    m_bind_plt_entries_now = (flags & RTLD_NOW) || m_dynamic_object->must_bind_now();
+
     if (m_dynamic_object->has_text_relocations()) {
         for (auto& text_segment : m_text_segments) {
             VERIFY(text_segment.address().get() != 0);
@@ -516,8 +519,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
 #else
     case R_X86_64_JUMP_SLOT: {
 #endif
-        // FIXME: Or BIND_NOW flag passed in?
-        if (m_dynamic_object->must_bind_now()) {
+        if (m_bind_plt_entries_now) {
             // Eagerly BIND_NOW the PLT entries, doing all the symbol looking goodness
             // The patch method returns the address for the LAZY fixup path, but we don't need it here
             m_dynamic_object->patch_plt_entry(relocation.offset_in_section());
@@ -633,9 +635,9 @@ void DynamicLoader::call_object_init_functions()
 Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const ELF::DynamicObject::Symbol& symbol)
 {
     if (symbol.is_undefined() || symbol.bind() == STB_WEAK)
-        return DynamicLinker::lookup_global_symbol(symbol.name());
+        return DynamicLinker::lookup_global_symbol(symbol);
 
-    return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), &symbol.object() };
+    return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), &symbol.object(), symbol.index() };
 }
 
 } // end namespace ELF
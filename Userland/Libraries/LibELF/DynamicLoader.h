@@ -15,6 +15,7 @@
 #include <LibDl/dlfcn_integration.h>
 #include <LibELF/DynamicObject.h>
 #include <LibELF/Image.h>
+#include <LibELF/PrelinkCache.h>
 #include <sys/mman.h>
 
 namespace ELF {
@@ -46,6 +47,7 @@ public:
     ~DynamicLoader();
 
     String const& filename() const { return m_filename; }
+    PrelinkCache::FileIdentity const& file_identity() const { return m_file_identity; }
 
     bool is_valid() const { return m_valid; }
 
@@ -76,6 +78,7 @@ public:
     VirtualAddress base_address() const { return m_base_address; }
     Vector<LoadedSegment> const text_segments() const { return m_text_segments; }
     bool is_dynamic() const { return m_elf_image.is_dynamic(); }
+    bool binds_plt_entries_now() const { return m_bind_plt_entries_now; }
 
     static Optional<DynamicObject::SymbolLookupResult> lookup_symbol(const ELF::DynamicObject::Symbol&);
     void copy_initial_tls_data_into(ByteBuffer& buffer) const;
@@ -135,6 +138,7 @@ private:
     ssize_t negative_offset_from_tls_block_end(ssize_t tls_offset, size_t value_of_symbol) const;
 
     String m_filename;
+    PrelinkCache::FileIdentity m_file_identity;
     size_t m_file_size { 0 };
     int m_image_fd { -1 };
     void* m_file_data { nullptr };
@@ -156,6 +160,9 @@ private:
 
     Vector<DynamicObject::Relocation> m_unresolved_relocations;
 
+    // Otherwise, PLT entries are bound lazily through the PLT trampoline, when they're first called.
+    bool m_bind_plt_entries_now { false };
+
     mutable RefPtr<DynamicObject> m_cached_dynamic_object;
 };
 
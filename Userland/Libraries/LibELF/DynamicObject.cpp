@@ -191,8 +191,34 @@ void DynamicObject::parse()
 
     auto hash_section_address = hash_section().address().as_ptr();
     // TODO: consider base address - it might not be zero
-    auto num_hash_chains = ((u32*)hash_section_address)[1];
-    m_symbol_count = num_hash_chains;
+    if (m_hash_type == HashType::SYSV) {
+        auto num_hash_chains = ((u32*)hash_section_address)[1];
+        m_symbol_count = num_hash_chains;
+    } else {
+        m_symbol_count = gnu_hash_symbol_count((u32 const*)hash_section_address);
+    }
+}
+
+unsigned DynamicObject::gnu_hash_symbol_count(u32 const* hash_table_begin)
+{
+    // The GNU hash table doesn't store the number of symbols, but the last symbol is the end of the longest chain.
+    const size_t num_buckets = hash_table_begin[0];
+    const u32 num_omitted_symbols = hash_table_begin[1];
+    const u32 num_maskwords = hash_table_begin[2];
+
+    FlatPtr const* bloom_words = (FlatPtr const*)&hash_table_begin[4];
+    u32 const* const buckets = (u32 const*)&bloom_words[num_maskwords];
+    u32 const* const chains = &buckets[num_buckets];
+
+    u32 last_symbol = 0;
+    for (size_t i = 0; i < num_buckets; ++i)
+        last_symbol = max(last_symbol, buckets[i]);
+    if (last_symbol < num_omitted_symbols)
+        return num_omitted_symbols;
+
+    while ((chains[last_symbol - num_omitted_symbols] & 1) == 0)
+        ++last_symbol;
+    return last_symbol + 1;
 }
 
 DynamicObject::Relocation DynamicObject::RelocationSection::relocation(unsigned index) const
@@ -471,7 +497,7 @@ auto DynamicObject::lookup_symbol(HashSymbol const& symbol) const -> Optional<Sy
     auto symbol_result = result.value();
     if (symbol_result.is_undefined())
         return {};
-    return SymbolLookupResult { symbol_result.value(), symbol_result.size(), symbol_result.address(), symbol_result.bind(), this };
+    return SymbolLookupResult { symbol_result.value(), symbol_result.size(), symbol_result.address(), symbol_result.bind(), this, symbol_result.index() };
 }
 
 NonnullRefPtr<DynamicObject> DynamicObject::create(String const& filename, VirtualAddress base_address, VirtualAddress dynamic_section_address)
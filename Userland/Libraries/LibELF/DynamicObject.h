@@ -323,6 +323,7 @@ public:
         VirtualAddress address;
         unsigned bind { STB_LOCAL };
         const ELF::DynamicObject* dynamic_object { nullptr }; // The object in which the symbol is defined
+        unsigned symbol_index { 0 };                           // The index of the symbol in that object's symbol table
     };
 
     Optional<SymbolLookupResult> lookup_symbol(StringView name) const;
@@ -341,6 +342,7 @@ private:
     StringView symbol_string_table_string(ElfW(Word)) const;
     char const* raw_symbol_string_table_string(ElfW(Word)) const;
     void parse();
+    static unsigned gnu_hash_symbol_count(u32 const* hash_table);
 
     String m_filename;
 
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <AK/StringHash.h>
+#include <LibELF/PrelinkCache.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ELF {
+
+String PrelinkCache::path_for_program(StringView program_path)
+{
+    // NOTE: The hash keeps programs with the same name in different directories apart.
+    auto hash = string_hash(program_path.characters_without_null_termination(), program_path.length());
+    return String::formatted("{}/{}-{:08x}", directory, LexicalPath::basename(program_path), hash);
+}
+
+OwnPtr<PrelinkCache> PrelinkCache::open(StringView path)
+{
+    auto path_string = path.to_string();
+    int fd = ::open(path_string.characters(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat stat;
+    if (fstat(fd, &stat) < 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    // The cache decides which code symbol references end up pointing to, so only trust one that
+    // nobody but root could have written.
+    if (stat.st_uid != 0 || (stat.st_mode & (S_IWGRP | S_IWOTH)) || !S_ISREG(stat.st_mode)) {
+        dbgln_if(DYNAMIC_LOAD_DEBUG, "PrelinkCache: Ignoring {}, it is not owned and exclusively writable by root", path);
+        close(fd);
+        return nullptr;
+    }
+
+    auto size = static_cast<size_t>(stat.st_size);
+    if (size < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+
+    auto* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    auto cache = adopt_own(*new PrelinkCache(static_cast<u8 const*>(data), size));
+    if (!cache->validate()) {
+        dbgln_if(DYNAMIC_LOAD_DEBUG, "PrelinkCache: Ignoring {}, it is malformed", path);
+        return nullptr;
+    }
+    return cache;
+}
+
+PrelinkCache::PrelinkCache(u8 const* data, size_t size)
+    : m_data(data)
+    , m_size(size)
+    , m_header(reinterpret_cast<Header const*>(data))
+{
+}
+
+PrelinkCache::~PrelinkCache()
+{
+    munmap(const_cast<u8*>(m_data), m_size);
+}
+
+bool PrelinkCache::validate()
+{
+    if (m_header->magic != magic || m_header->version != version)
+        return false;
+
+    size_t objects_size = static_cast<size_t>(m_header->object_count) * sizeof(ObjectEntry);
+    size_t resolutions_size = static_cast<size_t>(m_header->resolution_count) * sizeof(Resolution);
+    if (sizeof(Header) + objects_size + resolutions_size + m_header->string_table_size != m_size)
+        return false;
+
+    m_objects = reinterpret_cast<ObjectEntry const*>(m_data + sizeof(Header));
+    m_resolutions = reinterpret_cast<Resolution const*>(m_data + sizeof(Header) + objects_size);
+    m_string_table = reinterpret_cast<char const*>(m_data + sizeof(Header) + objects_size + resolutions_size);
+
+    for (size_t i = 0; i < m_header->object_count; ++i) {
+        auto const& object = m_objects[i];
+        if (static_cast<u64>(object.name_offset) + object.name_length > m_header->string_table_size)
+            return false;
+        if (static_cast<u64>(object.first_resolution) + object.resolution_count > m_header->resolution_count)
+            return false;
+    }
+    for (size_t i = 0; i < m_header->resolution_count; ++i) {
+        if (m_resolutions[i].provider_object_index >= m_header->object_count)
+            return false;
+    }
+    return true;
+}
+
+StringView PrelinkCache::object_name(size_t object_index) const
+{
+    VERIFY(object_index < object_count());
+    auto const& object = m_objects[object_index];
+    return { m_string_table + object.name_offset, object.name_length };
+}
+
+PrelinkCache::FileIdentity PrelinkCache::object_identity(size_t object_index) const
+{
+    VERIFY(object_index < object_count());
+    auto const& object = m_objects[object_index];
+    return { object.device, object.inode, object.modification_time, object.size };
+}
+
+Optional<PrelinkCache::Resolution> PrelinkCache::find_resolution(size_t object_index, u32 symbol_index) const
+{
+    VERIFY(object_index < object_count());
+    auto const& object = m_objects[object_index];
+
+    // NOTE: This is a binary search over the object's resolutions, which are sorted by symbol index.
+    auto const* resolutions = m_resolutions + object.first_resolution;
+    size_t low = 0;
+    size_t high = object.resolution_count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        auto middle_index = resolutions[middle].symbol_index;
+        if (middle_index == symbol_index)
+            return resolutions[middle];
+        if (middle_index < symbol_index)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return {};
+}
+
+void PrelinkCache::Builder::add_object(StringView name, FileIdentity identity)
+{
+    m_objects.append({ name.to_string(), identity, {}, {} });
+}
+
+void PrelinkCache::Builder::add_resolution(size_t object_index, Resolution resolution)
+{
+    auto& object = m_objects[object_index];
+    // The same symbol is usually referenced by several relocations, only the first one needs recording.
+    if (object.recorded_symbol_indices.set(u32 { resolution.symbol_index }) != AK::HashSetResult::InsertedNewEntry)
+        return;
+    object.resolutions.append(resolution);
+}
+
+static bool write_all(int fd, void const* data, size_t size)
+{
+    auto const* bytes = static_cast<u8 const*>(data);
+    while (size > 0) {
+        auto nwritten = write(fd, bytes, size);
+        if (nwritten < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        bytes += nwritten;
+        size -= nwritten;
+    }
+    return true;
+}
+
+Result<void, DlErrorMessage> PrelinkCache::Builder::write_to_file(StringView path) const
+{
+    Header header {};
+    header.magic = magic;
+    header.version = version;
+    header.object_count = m_objects.size();
+
+    Vector<ObjectEntry> object_entries;
+    Vector<Resolution> all_resolutions;
+    StringBuilder string_table;
+    for (auto const& object : m_objects) {
+        ObjectEntry entry {};
+        entry.name_offset = string_table.length();
+        entry.name_length = object.name.length();
+        entry.device = object.identity.device;
+        entry.inode = object.identity.inode;
+        entry.modification_time = object.identity.modification_time;
+        entry.size = object.identity.size;
+        entry.first_resolution = all_resolutions.size();
+        entry.resolution_count = object.resolutions.size();
+        object_entries.append(entry);
+
+        string_table.append(object.name);
+
+        auto resolutions = object.resolutions;
+        quick_sort(resolutions, [](auto& a, auto& b) { return a.symbol_index < b.symbol_index; });
+        all_resolutions.extend(move(resolutions));
+    }
+    header.resolution_count = all_resolutions.size();
+    header.string_table_size = string_table.length();
+
+    // Write to a temporary file first, so that a process starting up concurrently never sees a partial cache.
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    int fd = ::open(temporary_path.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return DlErrorMessage { String::formatted("Could not create {}: {}", temporary_path, strerror(errno)) };
+
+    bool success = write_all(fd, &header, sizeof(header))
+        && write_all(fd, object_entries.data(), object_entries.size() * sizeof(ObjectEntry))
+        && write_all(fd, all_resolutions.data(), all_resolutions.size() * sizeof(Resolution))
+        && write_all(fd, string_table.string_view().characters_without_null_termination(), string_table.length());
+    close(fd);
+
+    auto path_string = path.to_string();
+    if (!success || rename(temporary_path.characters(), path_string.characters()) < 0) {
+        auto error = DlErrorMessage { String::formatted("Could not write {}: {}", path, strerror(errno)) };
+        unlink(temporary_path.characters());
+        return error;
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/OwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibDl/dlfcn_integration.h>
+
+namespace ELF {
+
+// A prelink cache remembers what every symbol reference made by a program and its libraries resolved to,
+// so that later launches of the same program don't have to search the global symbol scope again.
+// Objects are mapped at randomized addresses, so resolutions are stored as (object, symbol index) pairs
+// rather than as addresses. The cache is only valid for the exact set of object files it was recorded with.
+class PrelinkCache {
+public:
+    static constexpr StringView directory = "/usr/lib/prelink"sv;
+
+    static String path_for_program(StringView program_path);
+
+    struct FileIdentity {
+        u64 device { 0 };
+        u64 inode { 0 };
+        i64 modification_time { 0 };
+        u64 size { 0 };
+
+        bool operator==(FileIdentity const&) const = default;
+    };
+
+    struct [[gnu::packed]] Resolution {
+        u32 symbol_index;
+        u32 provider_object_index;
+        u32 provider_symbol_index;
+    };
+
+    // Returns nullptr if there is no usable cache at the given path.
+    static OwnPtr<PrelinkCache> open(StringView path);
+    ~PrelinkCache();
+
+    size_t object_count() const { return m_header->object_count; }
+    StringView object_name(size_t object_index) const;
+    FileIdentity object_identity(size_t object_index) const;
+
+    Optional<Resolution> find_resolution(size_t object_index, u32 symbol_index) const;
+
+    class Builder {
+    public:
+        void add_object(StringView name, FileIdentity);
+        void add_resolution(size_t object_index, Resolution);
+
+        Result<void, DlErrorMessage> write_to_file(StringView path) const;
+
+    private:
+        struct Object {
+            String name;
+            FileIdentity identity;
+            Vector<Resolution> resolutions;
+            HashTable<u32> recorded_symbol_indices;
+        };
+        Vector<Object> m_objects;
+    };
+
+private:
+    static constexpr u32 magic = 0x4b4c5250; // "PRLK"
+    static constexpr u32 version = 1;
+
+    struct [[gnu::packed]] Header {
+        u32 magic;
+        u32 version;
+        u32 object_count;
+        u32 resolution_count;
+        u32 string_table_size;
+    };
+
+    struct [[gnu::packed]] ObjectEntry {
+        u32 name_offset;
+        u32 name_length;
+        u64 device;
+        u64 inode;
+        i64 modification_time;
+        u64 size;
+        // Resolutions of each object are stored together, sorted by symbol index.
+        u32 first_resolution;
+        u32 resolution_count;
+    };
+
+    PrelinkCache(u8 const* data, size_t size);
+
+    bool validate();
+
+    u8 const* m_data { nullptr };
+    size_t m_size { 0 };
+    Header const* m_header { nullptr };
+    ObjectEntry const* m_objects { nullptr };
+    Resolution const* m_resolutions { nullptr };
+    char const* m_string_table { nullptr };
+};
+
+}
@@ -442,6 +442,7 @@ extern "C" {
 #define GL_MIRRORED_REPEAT 0x8370
 #define GL_CLAMP_TO_BORDER 0x812D
 #define GL_CLAMP_TO_EDGE 0x812F
+#define GL_GENERATE_MIPMAP 0x8191
 
 // Texture gen modes
 #define GL_EYE_LINEAR 0x2400
@@ -118,6 +118,11 @@ GLContext::~GLContext()
     dbgln_if(GL_DEBUG, "GLContext::~GLContext() {:p}", this);
     if (g_gl_context == this)
         make_context_current(nullptr);
+
+    // The images of our textures live in the driver's library, so they have to be destroyed before it is unloaded.
+    m_texture_units.clear();
+    m_default_textures.clear();
+    m_allocated_textures.clear();
 }
 
 Optional<ContextParameter> GLContext::get_context_parameter(GLenum name)
@@ -352,6 +357,13 @@ void GLContext::gl_end()
         RETURN_WITH_ERROR_IF(true, GL_INVALID_ENUM);
     }
 
+    draw_vertices(m_current_draw_mode, m_vertex_list);
+
+    m_vertex_list.clear_with_capacity();
+}
+
+void GLContext::draw_vertices(GLenum mode, Vector<GPU::Vertex> const& vertices)
+{
     Vector<size_t, 32> enabled_texture_units;
     for (size_t i = 0; i < m_texture_units.size(); ++i) {
         if (m_texture_units[i].texture_2d_enabled())
@@ -361,7 +373,7 @@ void GLContext::gl_end()
     sync_device_config();
 
     GPU::PrimitiveType primitive_type;
-    switch (m_current_draw_mode) {
+    switch (mode) {
     case GL_TRIANGLES:
         primitive_type = GPU::PrimitiveType::Triangles;
         break;
@@ -380,9 +392,7 @@ void GLContext::gl_end()
         VERIFY_NOT_REACHED();
     }
 
-    m_rasterizer->draw_primitives(primitive_type, m_model_view_matrix, m_projection_matrix, m_texture_matrix, m_vertex_list, enabled_texture_units);
-
-    m_vertex_list.clear_with_capacity();
+    m_rasterizer->draw_primitives(primitive_type, m_model_view_matrix, m_projection_matrix, m_texture_matrix, vertices, enabled_texture_units);
 }
 
 void GLContext::gl_frustum(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble near_val, GLdouble far_val)
@@ -970,7 +980,8 @@ void GLContext::gl_tex_parameter(GLenum target, GLenum pname, GLfloat param)
     RETURN_WITH_ERROR_IF(!(pname == GL_TEXTURE_MIN_FILTER
                              || pname == GL_TEXTURE_MAG_FILTER
                              || pname == GL_TEXTURE_WRAP_S
-                             || pname == GL_TEXTURE_WRAP_T),
+                             || pname == GL_TEXTURE_WRAP_T
+                             || pname == GL_GENERATE_MIPMAP),
         GL_INVALID_ENUM);
 
     // We assume GL_TEXTURE_2D (see above)
@@ -1021,6 +1032,14 @@ void GLContext::gl_tex_parameter(GLenum target, GLenum pname, GLfloat param)
         texture_2d->sampler().set_wrap_t_mode(param);
         break;
 
+    case GL_GENERATE_MIPMAP:
+        RETURN_WITH_ERROR_IF(!(param == GL_TRUE
+                                 || param == GL_FALSE),
+            GL_INVALID_ENUM);
+
+        texture_2d->set_generate_mipmaps(param == GL_TRUE);
+        break;
+
     default:
         VERIFY_NOT_REACHED();
     }
@@ -1098,17 +1117,196 @@ void GLContext::invoke_list(size_t list_index)
     for (auto& entry : listing.entries) {
         entry.function.visit([&](auto& function) {
             entry.arguments.visit([&](auto& arguments) {
-                auto apply = [&]<typename... Args>(Args&&... args) {
-                    if constexpr (requires { (this->*function)(forward<Args>(args)...); })
+                // The arguments of an entry always match the exact argument types of its function.
+                if constexpr (IsSame<RemoveCVReference<decltype(arguments)>, Listing::TupleTypeForArgumentListOf<RemoveCVReference<decltype(function)>>>) {
+                    auto apply = [&]<typename... Args>(Args&&... args) {
                         (this->*function)(forward<Args>(args)...);
-                };
+                    };
 
-                arguments.apply_as_args(apply);
+                    arguments.apply_as_args(apply);
+                }
             });
         });
     }
 }
 
+template<auto member>
+GLContext::Listing::ArgumentsFor<member>* GLContext::arguments_if_call_to(Listing::FunctionsAndArgs& entry)
+{
+    // Different functions with the same signature share a type, so we also need to compare the actual function pointers.
+    bool is_call_to_member = entry.function.visit([](auto function) {
+        if constexpr (IsSame<decltype(function), decltype(member)>)
+            return function == member;
+        else
+            return false;
+    });
+    if (!is_call_to_member)
+        return nullptr;
+    return entry.arguments.template get_pointer<Listing::ArgumentsFor<member>>();
+}
+
+Optional<GLContext::VertexBatch> GLContext::compile_vertex_batch(Span<Listing::FunctionsAndArgs> entries, size_t& entries_consumed) const
+{
+    auto* begin_arguments = arguments_if_call_to<&GLContext::gl_begin>(entries[0]);
+    VERIFY(begin_arguments);
+
+    // Primitives that gl_end() cannot draw are left alone, so that they still generate their error on execution.
+    auto mode = begin_arguments->get<0>();
+    if (!(mode == GL_TRIANGLES
+            || mode == GL_TRIANGLE_FAN
+            || mode == GL_TRIANGLE_STRIP
+            || mode == GL_QUADS
+            || mode == GL_QUAD_STRIP
+            || mode == GL_POLYGON))
+        return {};
+
+    VertexBatch batch;
+    batch.mode = mode;
+
+    auto take_attribute_from = [](auto& attribute, auto& value) {
+        if (attribute.final_value.has_value())
+            value = attribute.final_value.value();
+        else
+            ++attribute.vertices_with_current_value;
+    };
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        auto& entry = entries[i];
+
+        if (arguments_if_call_to<&GLContext::gl_end>(entry)) {
+            entries_consumed = i + 1;
+            return batch;
+        }
+
+        if (auto* arguments = arguments_if_call_to<&GLContext::gl_vertex>(entry)) {
+            GPU::Vertex vertex;
+            vertex.position = {
+                static_cast<float>(arguments->get<0>()),
+                static_cast<float>(arguments->get<1>()),
+                static_cast<float>(arguments->get<2>()),
+                static_cast<float>(arguments->get<3>()),
+            };
+            take_attribute_from(batch.color, vertex.color);
+            for (size_t t = 0; t < m_device_info.num_texture_units; ++t)
+                take_attribute_from(batch.tex_coords[t], vertex.tex_coords[t]);
+            take_attribute_from(batch.normal, vertex.normal);
+            batch.vertices.append(vertex);
+        } else if (auto* arguments = arguments_if_call_to<&GLContext::gl_color>(entry)) {
+            batch.color.final_value = FloatVector4 {
+                static_cast<float>(arguments->get<0>()),
+                static_cast<float>(arguments->get<1>()),
+                static_cast<float>(arguments->get<2>()),
+                static_cast<float>(arguments->get<3>()),
+            };
+        } else if (auto* arguments = arguments_if_call_to<&GLContext::gl_tex_coord>(entry)) {
+            batch.tex_coords[0].final_value = FloatVector4 { arguments->get<0>(), arguments->get<1>(), arguments->get<2>(), arguments->get<3>() };
+        } else if (auto* arguments = arguments_if_call_to<&GLContext::gl_multi_tex_coord>(entry)) {
+            auto target = arguments->get<0>();
+            if (target < GL_TEXTURE0 || target >= GL_TEXTURE0 + m_device_info.num_texture_units)
+                return {};
+            batch.tex_coords[target - GL_TEXTURE0].final_value = FloatVector4 { arguments->get<1>(), arguments->get<2>(), arguments->get<3>(), arguments->get<4>() };
+        } else if (auto* arguments = arguments_if_call_to<&GLContext::gl_normal>(entry)) {
+            batch.normal.final_value = FloatVector3 { arguments->get<0>(), arguments->get<1>(), arguments->get<2>() };
+        } else {
+            // Any other call between glBegin() and glEnd() depends on state we do not know about yet.
+            return {};
+        }
+    }
+
+    // The primitive is only finished by another list, or not at all.
+    return {};
+}
+
+void GLContext::compile_vertex_batches(Listing& listing)
+{
+    Vector<Listing::FunctionsAndArgs> compiled_entries;
+    compiled_entries.ensure_capacity(listing.entries.size());
+    VertexBatch* previous_batch = nullptr;
+
+    // Independent triangles and quads drawn by consecutive batches are merged into a single batch, unless the previous
+    // batch ends with an incomplete primitive.
+    auto can_merge_batches = [](VertexBatch const& batch, VertexBatch const& next_batch) {
+        if (batch.mode != next_batch.mode)
+            return false;
+        if (batch.mode == GL_TRIANGLES)
+            return batch.vertices.size() % 3 == 0;
+        if (batch.mode == GL_QUADS)
+            return batch.vertices.size() % 4 == 0;
+        return false;
+    };
+
+    for (size_t i = 0; i < listing.entries.size();) {
+        Optional<VertexBatch> batch;
+        size_t entries_consumed = 0;
+        if (arguments_if_call_to<&GLContext::gl_begin>(listing.entries[i]))
+            batch = compile_vertex_batch(listing.entries.span().slice(i), entries_consumed);
+
+        if (!batch.has_value()) {
+            compiled_entries.append(move(listing.entries[i++]));
+            previous_batch = nullptr;
+            continue;
+        }
+        i += entries_consumed;
+
+        if (previous_batch && can_merge_batches(*previous_batch, *batch)) {
+            // Vertices of the next batch that would take an attribute from the current state now take the last value
+            // set by the previous batch, if there was one.
+            auto merge_attribute = [&](auto& attribute, auto const& next_attribute, auto set_value) {
+                if (attribute.final_value.has_value()) {
+                    for (size_t j = 0; j < next_attribute.vertices_with_current_value; ++j)
+                        set_value(batch->vertices[j], attribute.final_value.value());
+                } else {
+                    attribute.vertices_with_current_value += next_attribute.vertices_with_current_value;
+                }
+                if (next_attribute.final_value.has_value())
+                    attribute.final_value = next_attribute.final_value;
+            };
+
+            merge_attribute(previous_batch->color, batch->color, [](auto& vertex, auto const& value) { vertex.color = value; });
+            for (size_t t = 0; t < m_device_info.num_texture_units; ++t)
+                merge_attribute(previous_batch->tex_coords[t], batch->tex_coords[t], [t](auto& vertex, auto const& value) { vertex.tex_coords[t] = value; });
+            merge_attribute(previous_batch->normal, batch->normal, [](auto& vertex, auto const& value) { vertex.normal = value; });
+            previous_batch->vertices.extend(move(batch->vertices));
+            continue;
+        }
+
+        listing.vertex_batches.append(make<VertexBatch>(batch.release_value()));
+        previous_batch = listing.vertex_batches.last().ptr();
+        compiled_entries.empend(&GLContext::draw_vertex_batch, Listing::ArgumentsFor<&GLContext::draw_vertex_batch> { previous_batch });
+    }
+
+    listing.entries = move(compiled_entries);
+}
+
+void GLContext::draw_vertex_batch(VertexBatch* batch_pointer)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    // The vertices that take attributes from the current state are updated in place, as the list is the only user of
+    // this batch.
+    auto& batch = *batch_pointer;
+
+    for (size_t i = 0; i < batch.color.vertices_with_current_value; ++i)
+        batch.vertices[i].color = m_current_vertex_color;
+    for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+        for (size_t i = 0; i < batch.tex_coords[t].vertices_with_current_value; ++i)
+            batch.vertices[i].tex_coords[t] = m_current_vertex_tex_coord[t];
+    }
+    for (size_t i = 0; i < batch.normal.vertices_with_current_value; ++i)
+        batch.vertices[i].normal = m_current_vertex_normal;
+
+    draw_vertices(batch.mode, batch.vertices);
+
+    if (batch.color.final_value.has_value())
+        m_current_vertex_color = batch.color.final_value.value();
+    for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+        if (batch.tex_coords[t].final_value.has_value())
+            m_current_vertex_tex_coord[t] = batch.tex_coords[t].final_value.value();
+    }
+    if (batch.normal.final_value.has_value())
+        m_current_vertex_normal = batch.normal.final_value.value();
+}
+
 void GLContext::gl_call_list(GLuint list)
 {
     if (m_gl_call_depth > max_allowed_gl_call_depth)
@@ -1207,6 +1405,7 @@ void GLContext::gl_end_list()
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
     RETURN_WITH_ERROR_IF(!m_current_listing_index.has_value(), GL_INVALID_OPERATION);
 
+    compile_vertex_batches(m_current_listing_index->listing);
     m_listings[m_current_listing_index->index] = move(m_current_listing_index->listing);
     m_current_listing_index.clear();
 }
@@ -2125,34 +2324,11 @@ void GLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
     if (!m_client_side_vertex_array_enabled)
         return;
 
-    auto last = first + count;
-    gl_begin(mode);
-    for (int i = first; i < last; i++) {
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0, 0, 0, 1 };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
-
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0, 0, 0, 0 };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
-
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal);
-            gl_normal(normal[0], normal[1], normal[2]);
-        }
+    m_vertex_list.ensure_capacity(count);
+    for (int i = first; i < first + count; ++i)
+        append_vertex_from_client_arrays(i);
 
-        float vertex[4] { 0, 0, 0, 1 };
-        read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex);
-        gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
-    }
-    gl_end();
+    draw_vertices_from_client_arrays(mode);
 }
 
 void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, void const* indices)
@@ -2180,46 +2356,76 @@ void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, void c
     if (!m_client_side_vertex_array_enabled)
         return;
 
-    gl_begin(mode);
+    m_vertex_list.ensure_capacity(count);
     for (int index = 0; index < count; index++) {
-        int i = 0;
         switch (type) {
         case GL_UNSIGNED_BYTE:
-            i = reinterpret_cast<GLubyte const*>(indices)[index];
+            append_vertex_from_client_arrays(reinterpret_cast<GLubyte const*>(indices)[index]);
             break;
         case GL_UNSIGNED_SHORT:
-            i = reinterpret_cast<GLushort const*>(indices)[index];
+            append_vertex_from_client_arrays(reinterpret_cast<GLushort const*>(indices)[index]);
             break;
         case GL_UNSIGNED_INT:
-            i = reinterpret_cast<GLuint const*>(indices)[index];
+            append_vertex_from_client_arrays(reinterpret_cast<GLuint const*>(indices)[index]);
             break;
         }
+    }
 
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0, 0, 0, 1 };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
+    draw_vertices_from_client_arrays(mode);
+}
 
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0, 0, 0, 0 };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
+void GLContext::append_vertex_from_client_arrays(int index)
+{
+    GPU::Vertex vertex;
 
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal);
-            gl_normal(normal[0], normal[1], normal[2]);
+    vertex.color = m_current_vertex_color;
+    if (m_client_side_color_array_enabled) {
+        float color[4] { 0, 0, 0, 1 };
+        read_from_vertex_attribute_pointer(m_client_color_pointer, index, color);
+        vertex.color = { color[0], color[1], color[2], color[3] };
+    }
+
+    for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+        vertex.tex_coords[t] = m_current_vertex_tex_coord[t];
+        if (m_client_side_texture_coord_array_enabled[t]) {
+            float tex_coords[4] { 0, 0, 0, 0 };
+            read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], index, tex_coords);
+            vertex.tex_coords[t] = { tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3] };
         }
+    }
 
-        float vertex[4] { 0, 0, 0, 1 };
-        read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex);
-        gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
+    vertex.normal = m_current_vertex_normal;
+    if (m_client_side_normal_array_enabled) {
+        float normal[3];
+        read_from_vertex_attribute_pointer(m_client_normal_pointer, index, normal);
+        vertex.normal = { normal[0], normal[1], normal[2] };
     }
-    gl_end();
+
+    float position[4] { 0, 0, 0, 1 };
+    read_from_vertex_attribute_pointer(m_client_vertex_pointer, index, position);
+    vertex.position = { position[0], position[1], position[2], position[3] };
+
+    m_vertex_list.append(vertex);
+}
+
+void GLContext::draw_vertices_from_client_arrays(GLenum mode)
+{
+    draw_vertices(mode, m_vertex_list);
+
+    // The current vertex attributes are left as they were set by the last vertex, just like glArrayElement() would.
+    if (!m_vertex_list.is_empty()) {
+        auto const& last_vertex = m_vertex_list.last();
+        if (m_client_side_color_array_enabled)
+            m_current_vertex_color = last_vertex.color;
+        for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+            if (m_client_side_texture_coord_array_enabled[t])
+                m_current_vertex_tex_coord[t] = last_vertex.tex_coords[t];
+        }
+        if (m_client_side_normal_array_enabled)
+            m_current_vertex_normal = last_vertex.normal;
+    }
+
+    m_vertex_list.clear_with_capacity();
 }
 
 void GLContext::gl_draw_pixels(GLsizei width, GLsizei height, GLenum format, GLenum type, void const* data)
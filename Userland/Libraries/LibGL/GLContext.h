@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
@@ -196,6 +197,10 @@ private:
     template<typename T>
     void get_material_param(Face face, GLenum pname, T* params);
 
+    void draw_vertices(GLenum mode, Vector<GPU::Vertex> const& vertices);
+    void append_vertex_from_client_arrays(int index);
+    void draw_vertices_from_client_arrays(GLenum mode);
+
     void invoke_list(size_t list_index);
     [[nodiscard]] bool should_append_to_listing() const { return m_current_listing_index.has_value(); }
     [[nodiscard]] bool should_execute_after_appending_to_listing() const { return m_current_listing_index.has_value() && m_current_listing_index->mode == GL_COMPILE_AND_EXECUTE; }
@@ -314,6 +319,27 @@ private:
     bool m_sampler_config_is_dirty { true };
     bool m_light_state_is_dirty { true };
 
+    template<typename T>
+    struct VertexBatchAttribute {
+        // The leading vertices that precede the first call setting this attribute take its value from the current state
+        // when the batch is drawn.
+        size_t vertices_with_current_value { 0 };
+        // The last value set within the batch, which becomes the new current state once the batch has been drawn.
+        Optional<T> final_value;
+    };
+
+    // The vertices specified between a glBegin() and glEnd() pair within a display list, compiled once when the list is
+    // closed so that executing the list submits them to the device without replaying every single call.
+    struct VertexBatch {
+        GLenum mode { GL_TRIANGLES };
+        Vector<GPU::Vertex> vertices;
+        VertexBatchAttribute<FloatVector4> color;
+        Array<VertexBatchAttribute<FloatVector4>, GPU::NUM_SAMPLERS> tex_coords;
+        VertexBatchAttribute<FloatVector3> normal;
+    };
+
+    void draw_vertex_batch(VertexBatch*);
+
     struct Listing {
 
         template<typename F>
@@ -404,15 +430,22 @@ private:
             decltype(&GLContext::gl_get_light),
             decltype(&GLContext::gl_clip_plane),
             decltype(&GLContext::gl_array_element),
-            decltype(&GLContext::gl_copy_tex_sub_image_2d)>;
+            decltype(&GLContext::gl_copy_tex_sub_image_2d),
+            decltype(&GLContext::draw_vertex_batch)>;
 
         using ExtraSavedArguments = Variant<
             FloatMatrix4x4>;
 
         Vector<NonnullOwnPtr<ExtraSavedArguments>> saved_arguments;
+        Vector<NonnullOwnPtr<VertexBatch>> vertex_batches;
         Vector<FunctionsAndArgs> entries;
     };
 
+    template<auto member>
+    static Listing::ArgumentsFor<member>* arguments_if_call_to(Listing::FunctionsAndArgs&);
+    Optional<VertexBatch> compile_vertex_batch(Span<Listing::FunctionsAndArgs> entries, size_t& entries_consumed) const;
+    void compile_vertex_batches(Listing&);
+
     static constexpr size_t max_allowed_gl_call_depth { 128 };
     size_t m_gl_call_depth { 0 };
     Vector<Listing> m_listings;
@@ -22,6 +22,18 @@ void Texture2D::upload_texture_data(GLuint lod, GLint internal_format, GLsizei w
 
     m_internal_format = internal_format;
 
+    // With GL_GENERATE_MIPMAP enabled, all other levels are derived from the base level. See OpenGL 1.5 spec chapter 3.8.8.
+    if (lod == 0 && m_generate_mipmaps) {
+        auto level_width = width;
+        auto level_height = height;
+        for (size_t level = 1; level < m_mipmaps.size(); ++level) {
+            level_width = max(level_width / 2, 1);
+            level_height = max(level_height / 2, 1);
+            m_mipmaps[level].set_width(level_width);
+            m_mipmaps[level].set_height(level_height);
+        }
+    }
+
     // No pixel data was supplied; leave the texture memory uninitialized.
     if (pixels == nullptr)
         return;
@@ -91,6 +103,9 @@ void Texture2D::replace_sub_texture_data(GLuint lod, GLint xoffset, GLint yoffse
     };
 
     device_image()->write_texels(0, lod, offset, size, pixels, layout);
+
+    if (lod == 0 && m_generate_mipmaps)
+        device_image()->regenerate_mipmaps();
 }
 
 }
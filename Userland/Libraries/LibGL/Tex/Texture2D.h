@@ -43,6 +43,9 @@ public:
     Sampler2D const& sampler() const { return m_sampler; }
     Sampler2D& sampler() { return m_sampler; }
 
+    bool generate_mipmaps() const { return m_generate_mipmaps; }
+    void set_generate_mipmaps(bool generate_mipmaps) { m_generate_mipmaps = generate_mipmaps; }
+
     int width_at_lod(unsigned level) const { return (level >= m_mipmaps.size()) ? 0 : m_mipmaps.at(level).width(); }
     int height_at_lod(unsigned level) const { return (level >= m_mipmaps.size()) ? 0 : m_mipmaps.at(level).height(); }
 
@@ -51,6 +54,7 @@ private:
     Array<MipMap, LOG2_MAX_TEXTURE_SIZE> m_mipmaps;
     GLenum m_internal_format;
     Sampler2D m_sampler;
+    bool m_generate_mipmaps { false };
 };
 
 }
@@ -22,6 +22,7 @@
 #include <LibGUI/Window.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/FontDatabase.h>
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/Palette.h>
 #include <LibGfx/SystemTheme.h>
 
@@ -51,10 +52,21 @@ ConnectionToWindowServer::ConnectionToWindowServer(NonnullOwnPtr<Core::Stream::L
     Desktop::the().did_receive_screen_rects({}, message->screen_rects(), message->main_screen_index(), message->workspace_rows(), message->workspace_columns());
     Gfx::FontDatabase::set_default_font_query(message->default_font_query());
     Gfx::FontDatabase::set_fixed_width_font_query(message->fixed_width_font_query());
+    if (message->glyph_atlas_file().has_value()) {
+        if (auto atlas_or_error = Gfx::GlyphAtlas::try_create_read_only(message->glyph_atlas_file()->fd()); !atlas_or_error.is_error()) {
+            auto atlas = atlas_or_error.release_value();
+            atlas->on_glyph_missing = [this](auto& key) {
+                async_add_glyph_to_atlas(key.typeface_index, key.x_scale_bits, key.y_scale_bits, key.glyph_id);
+            };
+            Gfx::GlyphAtlas::set_the(move(atlas));
+        } else {
+            dbgln("Ignoring glyph atlas from WindowServer: {}", atlas_or_error.error());
+        }
+    }
     m_client_id = message->client_id();
 }
 
-void ConnectionToWindowServer::fast_greet(Vector<Gfx::IntRect> const&, u32, u32, u32, Core::AnonymousBuffer const&, String const&, String const&, i32)
+void ConnectionToWindowServer::fast_greet(Vector<Gfx::IntRect> const&, u32, u32, u32, Core::AnonymousBuffer const&, String const&, String const&, Optional<IPC::File> const&, i32)
 {
     // NOTE: This message is handled in the constructor.
 }
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/HashFunctions.h>
+#include <AK/IterationDecision.h>
+#include <AK/Random.h>
+#include <AK/ScopeGuard.h>
+#include <AK/String.h>
+#include <LibCore/System.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/GlyphAtlas.h>
+#include <LibGfx/Font/VectorFont.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Gfx {
+
+static constexpr u32 atlas_magic = 0x534c5447; // "GTLS"
+static constexpr u32 atlas_version = 2;
+
+// Entries are looked up with linear probing, giving up after this many.
+static constexpr u32 max_probe_count = 32;
+
+// Glyphs rasterized on behalf of other processes may be at most this many pixels to the em.
+static constexpr float max_em_size_in_pixels = 512;
+
+enum EntryState : u32 {
+    Empty = 0,
+    Ready,
+};
+
+struct GlyphAtlas::Header {
+    u32 magic;
+    u32 version;
+    u32 entry_capacity;
+    u32 pixel_capacity;
+    u32 used_pixels;
+    u32 typeface_count;
+    u32 padding[2];
+};
+
+struct GlyphAtlas::TypefaceEntry {
+    char family[80];
+    char variant[40];
+    u32 glyph_count;
+    u32 padding;
+};
+
+struct GlyphAtlas::Entry {
+    u32 state;
+    u32 typeface_index;
+    u32 x_scale_bits;
+    u32 y_scale_bits;
+    u32 glyph_id;
+    u16 width;
+    u16 height;
+    u32 pixel_offset;
+    u32 padding;
+};
+
+static_assert(sizeof(GlyphAtlas::Header) == 32);
+static_assert(sizeof(GlyphAtlas::TypefaceEntry) == 128);
+static_assert(sizeof(GlyphAtlas::Entry) == 32);
+
+static constexpr size_t typeface_table_size = GlyphAtlas::max_typeface_count * sizeof(GlyphAtlas::TypefaceEntry);
+
+static RefPtr<GlyphAtlas> s_the;
+
+GlyphAtlas* GlyphAtlas::the()
+{
+    return s_the.ptr();
+}
+
+void GlyphAtlas::set_the(NonnullRefPtr<GlyphAtlas> atlas)
+{
+    if (s_the)
+        return;
+    s_the = move(atlas);
+}
+
+ErrorOr<NonnullRefPtr<GlyphAtlas>> GlyphAtlas::try_create(size_t size)
+{
+    if (size < 64 * KiB || size > 256 * MiB)
+        return Error::from_string_literal("Gfx::GlyphAtlas size out of range"sv);
+
+    // NOTE: This gives each glyph about 1 KiB of pixels, which is plenty for glyphs at common sizes.
+    u32 entry_capacity = 1;
+    while (entry_capacity * 2 <= size / KiB)
+        entry_capacity *= 2;
+    size_t pixels_size = size - sizeof(Header) - typeface_table_size - entry_capacity * sizeof(Entry);
+    u32 pixel_capacity = pixels_size / sizeof(ARGB32);
+
+    // NOTE: Other processes get a read-only descriptor for the same file, which the kernel won't let them map writable.
+    //       Nobody may write to the file itself either, so they can't get a writable mapping by upgrading theirs.
+    auto path = String::formatted("/tmp/glyph-atlas-{}-{:08x}", getpid(), get_random<u32>());
+    int fd = TRY(Core::System::open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0444));
+    ScopeGuard close_fd = [&] { (void)Core::System::close(fd); };
+    auto read_only_fd_or_error = Core::System::open(path, O_RDONLY | O_CLOEXEC);
+    (void)Core::System::unlink(path);
+    int read_only_fd = TRY(read_only_fd_or_error);
+    ArmedScopeGuard close_read_only_fd = [&] { (void)Core::System::close(read_only_fd); };
+
+    TRY(Core::System::ftruncate(fd, size));
+    auto* data = static_cast<u8*>(TRY(Core::System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "GlyphAtlas"sv)));
+    ArmedScopeGuard unmap_data = [&] { (void)Core::System::munmap(data, size); };
+
+    auto* header = reinterpret_cast<Header*>(data);
+    header->magic = atlas_magic;
+    header->version = atlas_version;
+    header->entry_capacity = entry_capacity;
+    header->pixel_capacity = pixel_capacity;
+
+    auto atlas = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) GlyphAtlas(data, size, read_only_fd, entry_capacity, pixel_capacity)));
+    close_read_only_fd.disarm();
+    unmap_data.disarm();
+    return atlas;
+}
+
+ErrorOr<NonnullRefPtr<GlyphAtlas>> GlyphAtlas::try_create_read_only(int fd)
+{
+    auto stat = TRY(Core::System::fstat(fd));
+    if (stat.st_size < static_cast<off_t>(sizeof(Header)))
+        return Error::from_string_literal("Gfx::GlyphAtlas file is too small"sv);
+
+    size_t size = stat.st_size;
+    auto* data = static_cast<u8*>(TRY(Core::System::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0, 0, "GlyphAtlas (read-only)"sv)));
+    ArmedScopeGuard unmap_data = [&] { (void)Core::System::munmap(data, size); };
+
+    auto const* header = reinterpret_cast<Header const*>(data);
+    u32 entry_capacity = header->entry_capacity;
+    u32 pixel_capacity = header->pixel_capacity;
+    if (header->magic != atlas_magic || header->version != atlas_version)
+        return Error::from_string_literal("Gfx::GlyphAtlas file has an unknown format"sv);
+    if (entry_capacity == 0 || !is_power_of_two(entry_capacity))
+        return Error::from_string_literal("Gfx::GlyphAtlas file has an invalid entry capacity"sv);
+
+    u64 needed_size = sizeof(Header) + typeface_table_size + static_cast<u64>(entry_capacity) * sizeof(Entry) + static_cast<u64>(pixel_capacity) * sizeof(ARGB32);
+    if (needed_size > size)
+        return Error::from_string_literal("Gfx::GlyphAtlas file is too small"sv);
+
+    auto atlas = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) GlyphAtlas(data, size, -1, entry_capacity, pixel_capacity)));
+    unmap_data.disarm();
+    return atlas;
+}
+
+GlyphAtlas::GlyphAtlas(u8* data, size_t size, int read_only_fd, u32 entry_capacity, u32 pixel_capacity)
+    : m_data(data)
+    , m_size(size)
+    , m_read_only_fd(read_only_fd)
+    , m_entry_capacity(entry_capacity)
+    , m_pixel_capacity(pixel_capacity)
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    (void)Core::System::munmap(m_data, m_size);
+    if (m_read_only_fd != -1)
+        (void)Core::System::close(m_read_only_fd);
+}
+
+GlyphAtlas::Header* GlyphAtlas::header() const
+{
+    return reinterpret_cast<Header*>(m_data);
+}
+
+GlyphAtlas::TypefaceEntry* GlyphAtlas::typefaces() const
+{
+    return reinterpret_cast<TypefaceEntry*>(header() + 1);
+}
+
+GlyphAtlas::Entry* GlyphAtlas::entries() const
+{
+    return reinterpret_cast<Entry*>(typefaces() + max_typeface_count);
+}
+
+u32* GlyphAtlas::pixels() const
+{
+    return reinterpret_cast<u32*>(entries() + m_entry_capacity);
+}
+
+template<size_t Size>
+static StringView string_from_table(char const (&characters)[Size])
+{
+    return { characters, strnlen(characters, Size) };
+}
+
+Optional<u32> GlyphAtlas::register_typeface(StringView family, StringView variant, VectorFont& font)
+{
+    VERIFY(is_writable());
+    if (auto index = find_typeface(family, variant, font.glyph_count()); index.has_value())
+        return index;
+
+    u32 index = header()->typeface_count;
+    if (index >= max_typeface_count)
+        return {};
+
+    auto& typeface = typefaces()[index];
+    // NOTE: Names that don't fit are not truncated, since that could make two typefaces look the same.
+    if (family.length() >= sizeof(typeface.family) || variant.length() >= sizeof(typeface.variant))
+        return {};
+    (void)family.copy_characters_to_buffer(typeface.family, sizeof(typeface.family));
+    (void)variant.copy_characters_to_buffer(typeface.variant, sizeof(typeface.variant));
+    typeface.glyph_count = font.glyph_count();
+
+    m_registered_fonts.append(font);
+    AK::atomic_store(&header()->typeface_count, index + 1, AK::memory_order_release);
+    return index;
+}
+
+Optional<u32> GlyphAtlas::find_typeface(StringView family, StringView variant, u32 glyph_count) const
+{
+    u32 typeface_count = min(AK::atomic_load(&header()->typeface_count, AK::memory_order_acquire), static_cast<u32>(max_typeface_count));
+    for (u32 index = 0; index < typeface_count; ++index) {
+        auto const& typeface = typefaces()[index];
+        // NOTE: The glyph count guards against a font file having been replaced since the owner of the atlas loaded it.
+        if (typeface.glyph_count == glyph_count && string_from_table(typeface.family) == family && string_from_table(typeface.variant) == variant)
+            return index;
+    }
+    return {};
+}
+
+static u32 hash_key(GlyphAtlas::Key const& key)
+{
+    return pair_int_hash(pair_int_hash(key.typeface_index, key.glyph_id), pair_int_hash(key.x_scale_bits, key.y_scale_bits));
+}
+
+static bool entry_matches(GlyphAtlas::Entry const& entry, GlyphAtlas::Key const& key)
+{
+    return entry.typeface_index == key.typeface_index
+        && entry.x_scale_bits == key.x_scale_bits
+        && entry.y_scale_bits == key.y_scale_bits
+        && entry.glyph_id == key.glyph_id;
+}
+
+template<typename Callback>
+void GlyphAtlas::for_each_probed_entry(Key const& key, Callback callback) const
+{
+    auto mask = m_entry_capacity - 1;
+    auto index = hash_key(key) & mask;
+    for (u32 i = 0; i < min(max_probe_count, m_entry_capacity); ++i) {
+        if (callback(entries()[(index + i) & mask]) == IterationDecision::Break)
+            return;
+    }
+}
+
+RefPtr<Bitmap> GlyphAtlas::find(Key const& key) const
+{
+    RefPtr<Bitmap> bitmap;
+    for_each_probed_entry(key, [&](Entry& entry) {
+        auto state = AK::atomic_load(&entry.state, AK::memory_order_acquire);
+        if (state == EntryState::Empty)
+            return IterationDecision::Break;
+        if (state != EntryState::Ready || !entry_matches(entry, key))
+            return IterationDecision::Continue;
+
+        u32 width = entry.width;
+        u32 height = entry.height;
+        u64 pixel_offset = entry.pixel_offset;
+        if (width == 0 || height == 0 || pixel_offset + width * height > m_pixel_capacity)
+            return IterationDecision::Break;
+
+        auto bitmap_or_error = Bitmap::try_create_wrapper(BitmapFormat::BGRA8888, { width, height }, 1, width * sizeof(ARGB32), pixels() + pixel_offset);
+        if (!bitmap_or_error.is_error())
+            bitmap = bitmap_or_error.release_value();
+        return IterationDecision::Break;
+    });
+    return bitmap;
+}
+
+void GlyphAtlas::insert(Key const& key, Bitmap const& bitmap)
+{
+    VERIFY(is_writable());
+    if (bitmap.format() != BitmapFormat::BGRA8888 || bitmap.scale() != 1)
+        return;
+    if (bitmap.width() <= 0 || bitmap.height() <= 0 || bitmap.width() > NumericLimits<u16>::max() || bitmap.height() > NumericLimits<u16>::max())
+        return;
+
+    u32 pixel_count = bitmap.width() * bitmap.height();
+    u32 pixel_offset = header()->used_pixels;
+    if (pixel_offset + static_cast<u64>(pixel_count) > m_pixel_capacity)
+        return;
+
+    for_each_probed_entry(key, [&](Entry& entry) {
+        if (entry.state != EntryState::Empty) {
+            if (entry_matches(entry, key))
+                return IterationDecision::Break;
+            return IterationDecision::Continue;
+        }
+
+        auto* destination = pixels() + pixel_offset;
+        for (int y = 0; y < bitmap.height(); ++y)
+            memcpy(destination + y * bitmap.width(), bitmap.scanline(y), bitmap.width() * sizeof(ARGB32));
+        header()->used_pixels = pixel_offset + pixel_count;
+
+        entry.typeface_index = key.typeface_index;
+        entry.x_scale_bits = key.x_scale_bits;
+        entry.y_scale_bits = key.y_scale_bits;
+        entry.glyph_id = key.glyph_id;
+        entry.width = bitmap.width();
+        entry.height = bitmap.height();
+        entry.pixel_offset = pixel_offset;
+        // NOTE: Processes reading the atlas only look at an entry once they see this.
+        AK::atomic_store(&entry.state, static_cast<u32>(EntryState::Ready), AK::memory_order_release);
+        return IterationDecision::Break;
+    });
+}
+
+void GlyphAtlas::rasterize_and_insert(Key const& key)
+{
+    VERIFY(is_writable());
+    if (key.typeface_index >= m_registered_fonts.size())
+        return;
+    auto& font = m_registered_fonts[key.typeface_index];
+    if (key.glyph_id >= font.glyph_count())
+        return;
+
+    // NOTE: The key comes from another process, so don't let it make us rasterize huge glyphs.
+    auto x_scale = bit_cast<float>(key.x_scale_bits);
+    auto y_scale = bit_cast<float>(key.y_scale_bits);
+    auto max_scale = max_em_size_in_pixels / max<float>(font.units_per_em(), 1);
+    if (!(x_scale > 0 && x_scale <= max_scale) || !(y_scale > 0 && y_scale <= max_scale))
+        return;
+
+    if (find(key))
+        return;
+    if (auto glyph_bitmap = font.rasterize_glyph(key.glyph_id, x_scale, y_scale))
+        insert(key, *glyph_bitmap);
+}
+
+}
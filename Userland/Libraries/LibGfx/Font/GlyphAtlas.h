@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <LibGfx/Forward.h>
+
+namespace Gfx {
+
+class VectorFont;
+
+// A glyph atlas keeps rasterized glyphs in shared memory, so that all processes using the same fonts
+// only have to rasterize (and store) each glyph once between them. WindowServer creates the atlas
+// shared by GUI applications, and passes it to them when they connect.
+//
+// Only the process that created the atlas writes to it. Everyone else maps it read-only, and asks the
+// owner to rasterize the glyphs they are missing. Typefaces are identified by their index in a table
+// kept in the atlas, which is also only assigned by the owner.
+// Glyphs are never removed; once the atlas is full, processes keep further glyphs to themselves.
+class GlyphAtlas : public RefCounted<GlyphAtlas> {
+public:
+    static constexpr size_t default_size = 8 * MiB;
+    static constexpr size_t max_typeface_count = 256;
+
+    struct Key {
+        u32 typeface_index { 0 };
+        u32 x_scale_bits { 0 };
+        u32 y_scale_bits { 0 };
+        u32 glyph_id { 0 };
+
+        bool operator==(Key const&) const = default;
+    };
+
+    // NOTE: The atlas is kept in an unlinked file, so that other processes can be given a read-only descriptor for it.
+    static ErrorOr<NonnullRefPtr<GlyphAtlas>> try_create(size_t size = default_size);
+    static ErrorOr<NonnullRefPtr<GlyphAtlas>> try_create_read_only(int fd);
+
+    ~GlyphAtlas();
+
+    // The atlas shared by the fonts of this process, if there is one.
+    // It can only be set once, since the glyph bitmaps handed out point into it.
+    static GlyphAtlas* the();
+    static void set_the(NonnullRefPtr<GlyphAtlas>);
+
+    bool is_writable() const { return m_read_only_fd != -1; }
+
+    // The descriptor to hand out to other processes, only valid for a writable atlas.
+    int read_only_fd() const { return m_read_only_fd; }
+
+    Optional<u32> register_typeface(StringView family, StringView variant, VectorFont&);
+    Optional<u32> find_typeface(StringView family, StringView variant, u32 glyph_count) const;
+
+    // NOTE: The returned bitmap refers to memory in the atlas, so it must not outlive it.
+    RefPtr<Bitmap> find(Key const&) const;
+    void insert(Key const&, Bitmap const&);
+
+    // Adds a glyph of one of our registered typefaces on behalf of a process with a read-only atlas.
+    void rasterize_and_insert(Key const&);
+
+    // Called in processes with a read-only atlas for glyphs they had to rasterize themselves.
+    Function<void(Key const&)> on_glyph_missing;
+
+    struct Header;
+    struct TypefaceEntry;
+    struct Entry;
+
+private:
+    GlyphAtlas(u8* data, size_t size, int read_only_fd, u32 entry_capacity, u32 pixel_capacity);
+
+    Header* header() const;
+    TypefaceEntry* typefaces() const;
+    Entry* entries() const;
+    u32* pixels() const;
+
+    template<typename Callback>
+    void for_each_probed_entry(Key const&, Callback) const;
+
+    u8* m_data { nullptr };
+    size_t m_size { 0 };
+    int m_read_only_fd { -1 };
+    // NOTE: These are copied out of the header when the atlas is mapped, so they can be trusted to stay the same.
+    u32 m_entry_capacity { 0 };
+    u32 m_pixel_capacity { 0 };
+
+    // The fonts behind our registered typefaces, by index.
+    NonnullRefPtrVector<VectorFont> m_registered_fonts;
+};
+
+}
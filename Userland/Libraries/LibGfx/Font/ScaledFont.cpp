@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BitCast.h>
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/Font/ScaledFont.h>
 
 namespace Gfx {
@@ -44,7 +46,27 @@ RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id) const
     if (glyph_iterator != m_cached_glyph_bitmaps.end())
         return glyph_iterator->value;
 
-    auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale);
+    auto* atlas = m_glyph_atlas_typeface_index.has_value() ? GlyphAtlas::the() : nullptr;
+    if (!atlas) {
+        auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale);
+        m_cached_glyph_bitmaps.set(glyph_id, glyph_bitmap);
+        return glyph_bitmap;
+    }
+
+    GlyphAtlas::Key key { *m_glyph_atlas_typeface_index, bit_cast<u32>(m_x_scale), bit_cast<u32>(m_y_scale), glyph_id };
+    auto glyph_bitmap = atlas->find(key);
+    if (!glyph_bitmap) {
+        glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale);
+        if (glyph_bitmap && atlas->is_writable()) {
+            atlas->insert(key, *glyph_bitmap);
+            // NOTE: If the glyph made it into the atlas, use that copy and let go of our own.
+            if (auto shared_glyph_bitmap = atlas->find(key))
+                glyph_bitmap = move(shared_glyph_bitmap);
+        } else if (glyph_bitmap && atlas->on_glyph_missing) {
+            // We can't add it ourselves, but the owner of the atlas can, for the next process that needs it.
+            atlas->on_glyph_missing(key);
+        }
+    }
     m_cached_glyph_bitmaps.set(glyph_id, glyph_bitmap);
     return glyph_bitmap;
 }
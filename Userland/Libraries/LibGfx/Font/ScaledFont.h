@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/Optional.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/Font.h>
 #include <LibGfx/Font/VectorFont.h>
@@ -32,6 +33,9 @@ public:
     ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const { return m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale); }
     RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id) const;
 
+    // Fonts whose typeface is registered in the GlyphAtlas, like the system fonts, share their glyphs through it.
+    void set_glyph_atlas_typeface_index(u32 typeface_index) { m_glyph_atlas_typeface_index = typeface_index; }
+
     // ^Gfx::Font
     virtual NonnullRefPtr<Font> clone() const override { return *this; } // FIXME: clone() should not need to be implemented
     virtual u8 presentation_size() const override { return m_point_height; }
@@ -72,6 +76,7 @@ private:
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
     mutable HashMap<u32, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
+    Optional<u32> m_glyph_atlas_typeface_index;
 
     template<typename T>
     int unicode_view_width(T const& view) const;
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/Font/ScaledFont.h>
 #include <LibGfx/Font/Typeface.h>
 
@@ -53,8 +54,14 @@ RefPtr<Font> Typeface::get_font(float point_size, Font::AllowInexactSizeMatch al
 {
     VERIFY(point_size > 0);
 
-    if (m_vector_font)
-        return adopt_ref(*new Gfx::ScaledFont(*m_vector_font, point_size, point_size));
+    if (m_vector_font) {
+        auto font = adopt_ref(*new Gfx::ScaledFont(*m_vector_font, point_size, point_size));
+        if (auto* atlas = GlyphAtlas::the()) {
+            if (auto typeface_index = atlas->find_typeface(m_family, m_variant, m_vector_font->glyph_count()); typeface_index.has_value())
+                font->set_glyph_atlas_typeface_index(*typeface_index);
+        }
+        return font;
+    }
 
     RefPtr<BitmapFont> best_match;
     int size = roundf(point_size);
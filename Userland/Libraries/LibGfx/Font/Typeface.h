@@ -35,6 +35,7 @@ public:
 
     void add_bitmap_font(RefPtr<BitmapFont>);
     void set_vector_font(RefPtr<VectorFont>);
+    RefPtr<VectorFont> vector_font() const { return m_vector_font; }
 
     RefPtr<Font> get_font(float point_size, Font::AllowInexactSizeMatch = Font::AllowInexactSizeMatch::No) const;
 
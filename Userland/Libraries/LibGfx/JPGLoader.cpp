@@ -8,6 +8,8 @@
 #include <AK/HashMap.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Vector.h>
 #include <LibGfx/JPGLoader.h>
 
@@ -361,63 +363,6 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
     return true;
 }
 
-static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& context)
-{
-    Vector<Macroblock> macroblocks;
-    macroblocks.resize(context.mblock_meta.padded_total);
-
-    if constexpr (JPG_DEBUG) {
-        dbgln("Image width: {}", context.frame.width);
-        dbgln("Image height: {}", context.frame.height);
-        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
-        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
-        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
-    }
-
-    // Compute huffman codes for DC and AC tables.
-    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
-        generate_huffman_codes(it->value);
-
-    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
-        generate_huffman_codes(it->value);
-
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            if (context.dc_reset_interval > 0) {
-                if (i % context.dc_reset_interval == 0) {
-                    context.previous_dc_values[0] = 0;
-                    context.previous_dc_values[1] = 0;
-                    context.previous_dc_values[2] = 0;
-
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
-                        if (context.huffman_stream.bit_offset > 0) {
-                            context.huffman_stream.bit_offset = 0;
-                            context.huffman_stream.byte_offset++;
-                        }
-
-                        // Skip the restart marker (RSTn).
-                        context.huffman_stream.byte_offset++;
-                    }
-                }
-            }
-
-            if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
-                if constexpr (JPG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}", i);
-                    dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
-                    dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
-                }
-                return {};
-            }
-        }
-    }
-
-    return macroblocks;
-}
-
 static inline bool bounds_okay(const size_t cursor, const size_t delta, const size_t bound)
 {
     return (delta + cursor) < bound;
@@ -841,28 +786,44 @@ static bool skip_marker_with_length(InputMemoryStream& stream)
     return !stream.handle_any_error();
 }
 
-static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+// The stages below work on one band of macroblocks at a time, i.e. one row of MCUs: `vsample_factor` rows of
+// `hpadded_count` macroblocks. Only a single band is ever resident, rather than the macroblocks for the whole image.
+
+static void dequantize(JPGLoadingContext const& context, Vector<Macroblock>& band)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 i = 0; i < context.component_count; i++) {
-                auto& component = context.components[i];
-                u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
-                for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        int* block_component = get_component(block, i);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
-                    }
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        for (u32 i = 0; i < context.component_count; i++) {
+            auto& component = context.components[i];
+            u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
+            for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+                for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                    u32 mb_index = vfactor_i * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                    Macroblock& block = band[mb_index];
+                    int* block_component = get_component(block, i);
+                    for (u32 k = 0; k < 64; k++)
+                        block_component[k] *= table[k];
                 }
             }
         }
     }
 }
 
-static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+ALWAYS_INLINE static AK::SIMD::f32x4 load_coefficients(i32 const* coefficients)
+{
+    AK::SIMD::i32x4 vector;
+    __builtin_memcpy(&vector, coefficients, sizeof(vector));
+    return AK::SIMD::to_f32x4(vector);
+}
+
+ALWAYS_INLINE static void store_coefficients(i32* coefficients, AK::SIMD::f32x4 vector)
+{
+    // NOTE: Converting to integers truncates, just like assigning a float to an i32 does.
+    auto integers = AK::SIMD::to_i32x4(vector);
+    __builtin_memcpy(coefficients, &integers, sizeof(integers));
+}
+
+// Runs the 1D IDCT down four adjacent columns of an 8x8 block at once, one column per vector lane.
+ALWAYS_INLINE static void inverse_dct_columns(i32* block_component, u32 first_column)
 {
     static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
     static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
@@ -879,214 +840,233 @@ static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& ma
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 component_i = 0; component_i < context.component_count; component_i++) {
-                auto& component = context.components[component_i];
-                for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        i32* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            float const g0 = block_component[0 * 8 + k] * s0;
-                            float const g1 = block_component[4 * 8 + k] * s4;
-                            float const g2 = block_component[2 * 8 + k] * s2;
-                            float const g3 = block_component[6 * 8 + k] * s6;
-                            float const g4 = block_component[5 * 8 + k] * s5;
-                            float const g5 = block_component[1 * 8 + k] * s1;
-                            float const g6 = block_component[7 * 8 + k] * s7;
-                            float const g7 = block_component[3 * 8 + k] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            float const g0 = block_component[l * 8 + 0] * s0;
-                            float const g1 = block_component[l * 8 + 4] * s4;
-                            float const g2 = block_component[l * 8 + 2] * s2;
-                            float const g3 = block_component[l * 8 + 6] * s6;
-                            float const g4 = block_component[l * 8 + 5] * s5;
-                            float const g5 = block_component[l * 8 + 1] * s1;
-                            float const g6 = block_component[l * 8 + 7] * s7;
-                            float const g7 = block_component[l * 8 + 3] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
-                    }
+    auto* column = block_component + first_column;
+    auto const g0 = load_coefficients(column + 0 * 8) * s0;
+    auto const g1 = load_coefficients(column + 4 * 8) * s4;
+    auto const g2 = load_coefficients(column + 2 * 8) * s2;
+    auto const g3 = load_coefficients(column + 6 * 8) * s6;
+    auto const g4 = load_coefficients(column + 5 * 8) * s5;
+    auto const g5 = load_coefficients(column + 1 * 8) * s1;
+    auto const g6 = load_coefficients(column + 7 * 8) * s7;
+    auto const g7 = load_coefficients(column + 3 * 8) * s3;
+
+    auto const f0 = g0;
+    auto const f1 = g1;
+    auto const f2 = g2;
+    auto const f3 = g3;
+    auto const f4 = g4 - g7;
+    auto const f5 = g5 + g6;
+    auto const f6 = g5 - g6;
+    auto const f7 = g4 + g7;
+
+    auto const e0 = f0;
+    auto const e1 = f1;
+    auto const e2 = f2 - f3;
+    auto const e3 = f2 + f3;
+    auto const e4 = f4;
+    auto const e5 = f5 - f7;
+    auto const e6 = f6;
+    auto const e7 = f5 + f7;
+    auto const e8 = f4 + f6;
+
+    auto const d0 = e0;
+    auto const d1 = e1;
+    auto const d2 = e2 * m1;
+    auto const d3 = e3;
+    auto const d4 = e4 * m2;
+    auto const d5 = e5 * m3;
+    auto const d6 = e6 * m4;
+    auto const d7 = e7;
+    auto const d8 = e8 * m5;
+
+    auto const c0 = d0 + d1;
+    auto const c1 = d0 - d1;
+    auto const c2 = d2 - d3;
+    auto const c3 = d3;
+    auto const c4 = d4 + d8;
+    auto const c5 = d5 + d7;
+    auto const c6 = d6 - d8;
+    auto const c7 = d7;
+    auto const c8 = c5 - c6;
+
+    auto const b0 = c0 + c3;
+    auto const b1 = c1 + c2;
+    auto const b2 = c1 - c2;
+    auto const b3 = c0 - c3;
+    auto const b4 = c4 - c8;
+    auto const b5 = c8;
+    auto const b6 = c6 - c7;
+    auto const b7 = c7;
+
+    store_coefficients(column + 0 * 8, b0 + b7);
+    store_coefficients(column + 1 * 8, b1 + b6);
+    store_coefficients(column + 2 * 8, b2 + b5);
+    store_coefficients(column + 3 * 8, b3 + b4);
+    store_coefficients(column + 4 * 8, b3 - b4);
+    store_coefficients(column + 5 * 8, b2 - b5);
+    store_coefficients(column + 6 * 8, b1 - b6);
+    store_coefficients(column + 7 * 8, b0 - b7);
+}
+
+static void transpose_block_component(i32* block_component)
+{
+    for (u32 row = 0; row < 8; ++row) {
+        for (u32 column = row + 1; column < 8; ++column)
+            swap(block_component[row * 8 + column], block_component[column * 8 + row]);
+    }
+}
+
+static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& band)
+{
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        for (u32 component_i = 0; component_i < context.component_count; component_i++) {
+            auto& component = context.components[component_i];
+            for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+                for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                    u32 mb_index = vfactor_i * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                    Macroblock& block = band[mb_index];
+                    i32* block_component = get_component(block, component_i);
+                    // The rows are transformed by transposing the block, transforming its columns and transposing it back.
+                    inverse_dct_columns(block_component, 0);
+                    inverse_dct_columns(block_component, 4);
+                    transpose_block_component(block_component);
+                    inverse_dct_columns(block_component, 0);
+                    inverse_dct_columns(block_component, 4);
+                    transpose_block_component(block_component);
                 }
             }
         }
     }
 }
 
-static void ycbcr_to_rgb(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+// Loads the chroma samples for four adjacent pixels, repeating each sample for horizontally subsampled chroma.
+ALWAYS_INLINE static AK::SIMD::f32x4 load_upsampled_chroma(i32 const* chroma_row, u32 first_pixel_column, u8 hsample_factor)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            Macroblock const& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    i32* y = macroblocks[mb_index].y;
-                    i32* cb = macroblocks[mb_index].cb;
-                    i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+    if (hsample_factor == 1)
+        return load_coefficients(chroma_row + first_pixel_column);
+    auto const* samples = chroma_row + first_pixel_column / 2;
+    return AK::SIMD::to_f32x4(AK::SIMD::i32x4 { samples[0], samples[0], samples[1], samples[1] });
+}
+
+ALWAYS_INLINE static AK::SIMD::i32x4 clamp_to_u8(AK::SIMD::i32x4 value)
+{
+    value &= ~(value < 0);
+    auto const too_large = value > 255;
+    return (value & ~too_large) | (AK::SIMD::expand4(255) & too_large);
+}
+
+// Converts the band from YCbCr to RGB and writes it straight into its rows of the bitmap.
+static void write_band_to_bitmap(JPGLoadingContext& context, Vector<Macroblock> const& band, u32 first_block_row)
+{
+    auto& bitmap = *context.bitmap;
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        Macroblock const& chroma = band[hcursor];
+        for (u8 vfactor_i = 0; vfactor_i < context.vsample_factor; vfactor_i++) {
+            for (u8 hfactor_i = 0; hfactor_i < context.hsample_factor; hfactor_i++) {
+                u32 block_row = first_block_row + vfactor_i;
+                u32 block_column = hcursor + hfactor_i;
+                if (block_column * 8 >= context.frame.width)
+                    continue;
+                auto const& block = band[vfactor_i * context.mblock_meta.hpadded_count + block_column];
+                for (u32 i = 0; i < 8; ++i) {
+                    u32 y = block_row * 8 + i;
+                    if (y >= context.frame.height)
+                        break;
+                    u32 const chroma_row = (i / context.vsample_factor) + 4 * vfactor_i;
+                    auto* scanline = bitmap.scanline(y) + block_column * 8;
+                    for (u32 j = 0; j < 8; j += 4) {
+                        auto const luma = load_coefficients(block.y + i * 8 + j);
+                        auto const cb = load_upsampled_chroma(chroma.cb + chroma_row * 8 + 4 * hfactor_i, j, context.hsample_factor);
+                        auto const cr = load_upsampled_chroma(chroma.cr + chroma_row * 8 + 4 * hfactor_i, j, context.hsample_factor);
+
+                        auto const r = clamp_to_u8(AK::SIMD::to_i32x4(luma + 1.402f * cr + 128.0f));
+                        auto const g = clamp_to_u8(AK::SIMD::to_i32x4(luma - 0.344f * cb - 0.714f * cr + 128.0f));
+                        auto const b = clamp_to_u8(AK::SIMD::to_i32x4(luma + 1.772f * cb + 128.0f));
+                        auto const pixels = AK::SIMD::expand4(0xff000000u) | AK::SIMD::to_u32x4((r << 16) | (g << 8) | b);
+
+                        u32 x = block_column * 8 + j;
+                        if (x + 4 <= context.frame.width) {
+                            __builtin_memcpy(scanline + j, &pixels, sizeof(pixels));
+                            continue;
                         }
+                        for (u32 lane = 0; x + lane < context.frame.width; ++lane)
+                            scanline[j + lane] = pixels[lane];
                     }
                 }
             }
         }
     }
 }
-
-static bool compose_bitmap(JPGLoadingContext& context, Vector<Macroblock> const& macroblocks)
+static bool decode_huffman_stream(JPGLoadingContext& context)
 {
+    if constexpr (JPG_DEBUG) {
+        dbgln("Image width: {}", context.frame.width);
+        dbgln("Image height: {}", context.frame.height);
+        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
+        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
+        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
+    }
+
     auto bitmap_or_error = Bitmap::try_create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
     if (bitmap_or_error.is_error())
         return false;
-    context.bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
-    if (bitmap_or_error.is_error())
+    context.bitmap = bitmap_or_error.release_value();
+
+    // Compute huffman codes for DC and AC tables.
+    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+
+    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+
+    Vector<Macroblock> band;
+    if (band.try_resize(context.mblock_meta.hpadded_count * context.vsample_factor).is_error())
         return false;
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        const u32 block_row = y / 8;
-        const u32 pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            const u32 block_column = x / 8;
-            auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            const u32 pixel_column = x % 8;
-            const u32 pixel_index = pixel_row * 8 + pixel_column;
-            const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
+        // Only non-zero coefficients are stored while decoding, so every band has to start out cleared.
+        for (auto& block : band)
+            block = {};
+
+        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
+            if (context.dc_reset_interval > 0) {
+                if (i % context.dc_reset_interval == 0) {
+                    context.previous_dc_values[0] = 0;
+                    context.previous_dc_values[1] = 0;
+                    context.previous_dc_values[2] = 0;
+
+                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+                    //  the 0th bit of the next byte.
+                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
+                        if (context.huffman_stream.bit_offset > 0) {
+                            context.huffman_stream.bit_offset = 0;
+                            context.huffman_stream.byte_offset++;
+                        }
+
+                        // Skip the restart marker (RSTn).
+                        context.huffman_stream.byte_offset++;
+                    }
+                }
+            }
+
+            if (!build_macroblocks(context, band, hcursor, 0)) {
+                if constexpr (JPG_DEBUG) {
+                    dbgln("Failed to build Macroblock {}", i);
+                    dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
+                    dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
+                }
+                return false;
+            }
         }
+
+        dequantize(context, band);
+        inverse_dct(context, band);
+        write_band_to_bitmap(context, band, vcursor);
     }
 
     return true;
 }
-
 static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
 {
     auto marker = read_marker_at_cursor(stream);
@@ -1209,18 +1189,11 @@ static bool decode_jpg(JPGLoadingContext& context)
     if (!scan_huffman_stream(stream, context))
         return false;
 
-    auto result = decode_huffman_stream(context);
-    if (!result.has_value()) {
+    if (!decode_huffman_stream(context)) {
         dbgln_if(JPG_DEBUG, "{}: Failed to decode Macroblocks!", stream.offset());
+        context.bitmap = nullptr;
         return false;
     }
-
-    auto macroblocks = result.release_value();
-    dequantize(context, macroblocks);
-    inverse_dct(context, macroblocks);
-    ycbcr_to_rgb(context, macroblocks);
-    if (!compose_bitmap(context, macroblocks))
-        return false;
     return true;
 }
 
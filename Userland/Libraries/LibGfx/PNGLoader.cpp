@@ -8,15 +8,15 @@
 #include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Vector.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <string.h>
 
-#ifdef __serenity__
-#    include <LibCompress/Deflate.h>
-#endif
-
 namespace Gfx {
 
 static constexpr Array<u8, 8> png_header = { 0x89, 'P', 'N', 'G', 13, 10, 26, 10 };
@@ -33,11 +33,6 @@ struct PNG_IHDR {
 
 static_assert(AssertSize<PNG_IHDR, 13>());
 
-struct Scanline {
-    u8 filter { 0 };
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -95,9 +90,7 @@ struct PNGLoadingContext {
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return color_type & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
     RefPtr<Gfx::Bitmap> bitmap;
-    ByteBuffer* decompression_buffer { nullptr };
     Vector<u8> compressed_data;
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
@@ -178,187 +171,223 @@ ALWAYS_INLINE static u8 paeth_predictor(int a, int b, int c)
     return c;
 }
 
-union [[gnu::packed]] Pixel {
-    ARGB32 rgba { 0 };
-    u8 v[4];
-    struct {
-        u8 r;
-        u8 g;
-        u8 b;
-        u8 a;
-    };
-};
-static_assert(AssertSize<Pixel, 4>());
+// The filters below undo the filtering of a single scanline in place, given the scanline above it (all zeroes for the first one).
+// They work on the raw bytes of the scanline, looking back a whole pixel (rounded up to a byte) at a time.
+//
+// Sub, Average and Paeth each depend on the byte a pixel to the left, so for pixels of up to four bytes they handle all
+// bytes of a pixel at once in a vector, and work their way along the scanline one pixel at a time.
+
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static AK::SIMD::i32x4 load_pixel(u8 const* bytes)
+{
+    AK::SIMD::u8x4 pixel {};
+    __builtin_memcpy(&pixel, bytes, bytes_per_pixel);
+    return AK::SIMD::to_i32x4(pixel);
+}
 
-template<bool has_alpha, u8 filter_type>
-ALWAYS_INLINE static void unfilter_impl(Gfx::Bitmap& bitmap, int y, void const* dummy_scanline_data)
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static void store_pixel(u8* bytes, AK::SIMD::i32x4 pixel)
 {
-    auto* dummy_scanline = (Pixel const*)dummy_scanline_data;
-    if constexpr (filter_type == 0) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
+    // NOTE: Converting to u8 wraps around, just like the filters' arithmetic is supposed to.
+    auto narrowed_pixel = __builtin_convertvector(pixel, AK::SIMD::u8x4);
+    __builtin_memcpy(bytes, &narrowed_pixel, bytes_per_pixel);
+}
+
+ALWAYS_INLINE static AK::SIMD::i32x4 absolute_value(AK::SIMD::i32x4 value)
+{
+    auto sign = value >> 31;
+    return (value ^ sign) - sign;
+}
+
+static void unfilter_up(Bytes scanline, ReadonlyBytes previous_scanline)
+{
+    size_t i = 0;
+    for (; i + sizeof(AK::SIMD::u8x16) <= scanline.size(); i += sizeof(AK::SIMD::u8x16)) {
+        AK::SIMD::u8x16 x;
+        AK::SIMD::u8x16 b;
+        __builtin_memcpy(&x, &scanline[i], sizeof(x));
+        __builtin_memcpy(&b, &previous_scanline[i], sizeof(b));
+        x += b;
+        __builtin_memcpy(&scanline[i], &x, sizeof(x));
+    }
+    for (; i < scanline.size(); ++i)
+        scanline[i] += previous_scanline[i];
+}
+
+template<size_t bytes_per_pixel>
+static void unfilter_sub(Bytes scanline)
+{
+    if constexpr (bytes_per_pixel <= 4) {
+        auto a = load_pixel<bytes_per_pixel>(&scanline[0]);
+        for (size_t i = bytes_per_pixel; i + bytes_per_pixel <= scanline.size(); i += bytes_per_pixel) {
+            a = (a + load_pixel<bytes_per_pixel>(&scanline[i])) & 0xff;
+            store_pixel<bytes_per_pixel>(&scanline[i], a);
         }
+    } else {
+        for (size_t i = bytes_per_pixel; i < scanline.size(); ++i)
+            scanline[i] += scanline[i - bytes_per_pixel];
     }
+}
 
-    if constexpr (filter_type == 1) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        swap(pixels[0].r, pixels[0].b);
-        for (int i = 1; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            auto& a = (Pixel const&)pixels[i - 1];
-            x.v[0] += a.v[0];
-            x.v[1] += a.v[1];
-            x.v[2] += a.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += a.v[3];
+template<size_t bytes_per_pixel>
+static void unfilter_average(Bytes scanline, ReadonlyBytes previous_scanline)
+{
+    if constexpr (bytes_per_pixel <= 4) {
+        AK::SIMD::i32x4 a {};
+        for (size_t i = 0; i + bytes_per_pixel <= scanline.size(); i += bytes_per_pixel) {
+            auto b = load_pixel<bytes_per_pixel>(&previous_scanline[i]);
+            auto x = load_pixel<bytes_per_pixel>(&scanline[i]) + ((a + b) >> 1);
+            // NOTE: The left neighbor has to wrap around like the stored byte does before it's used again.
+            a = x & 0xff;
+            store_pixel<bytes_per_pixel>(&scanline[i], x);
         }
-        return;
-    }
-    if constexpr (filter_type == 2) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (Pixel const*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel const& b = pixels_y_minus_1[i];
-            x.v[0] += b.v[0];
-            x.v[1] += b.v[1];
-            x.v[2] += b.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += b.v[3];
+    } else {
+        for (size_t i = 0; i < scanline.size(); ++i) {
+            u8 a = i >= bytes_per_pixel ? scanline[i - bytes_per_pixel] : 0;
+            scanline[i] += (a + previous_scanline[i]) / 2;
         }
-        return;
-    }
-    if constexpr (filter_type == 3) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (Pixel const*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            if (i != 0)
-                a = pixels[i - 1];
-            Pixel const& b = pixels_y_minus_1[i];
-            x.v[0] = x.v[0] + ((a.v[0] + b.v[0]) / 2);
-            x.v[1] = x.v[1] + ((a.v[1] + b.v[1]) / 2);
-            x.v[2] = x.v[2] + ((a.v[2] + b.v[2]) / 2);
-            if constexpr (has_alpha)
-                x.v[3] = x.v[3] + ((a.v[3] + b.v[3]) / 2);
+    }
+}
+
+template<size_t bytes_per_pixel>
+static void unfilter_paeth(Bytes scanline, ReadonlyBytes previous_scanline)
+{
+    if constexpr (bytes_per_pixel <= 4) {
+        AK::SIMD::i32x4 a {};
+        AK::SIMD::i32x4 c {};
+        for (size_t i = 0; i + bytes_per_pixel <= scanline.size(); i += bytes_per_pixel) {
+            auto b = load_pixel<bytes_per_pixel>(&previous_scanline[i]);
+
+            // This is paeth_predictor() for all bytes of the pixel at once, without branches.
+            auto pa = absolute_value(b - c);
+            auto pb = absolute_value(a - c);
+            auto pc = absolute_value(a + b - c - c);
+            auto use_a = (pa <= pb) & (pa <= pc);
+            auto use_b = ~use_a & (pb <= pc);
+            auto predictor = (a & use_a) | (b & use_b) | (c & ~(use_a | use_b));
+
+            auto x = (load_pixel<bytes_per_pixel>(&scanline[i]) + predictor) & 0xff;
+            store_pixel<bytes_per_pixel>(&scanline[i], x);
+            a = x;
+            c = b;
         }
-        return;
-    }
-    if constexpr (filter_type == 4) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            Pixel const& b = pixels_y_minus_1[i];
-            Pixel c;
-            if (i != 0) {
-                a = pixels[i - 1];
-                c = pixels_y_minus_1[i - 1];
-            }
-            x.v[0] += paeth_predictor(a.v[0], b.v[0], c.v[0]);
-            x.v[1] += paeth_predictor(a.v[1], b.v[1], c.v[1]);
-            x.v[2] += paeth_predictor(a.v[2], b.v[2], c.v[2]);
-            if constexpr (has_alpha)
-                x.v[3] += paeth_predictor(a.v[3], b.v[3], c.v[3]);
+    } else {
+        for (size_t i = 0; i < scanline.size(); ++i) {
+            u8 a = i >= bytes_per_pixel ? scanline[i - bytes_per_pixel] : 0;
+            u8 c = i >= bytes_per_pixel ? previous_scanline[i - bytes_per_pixel] : 0;
+            scanline[i] += paeth_predictor(a, previous_scanline[i], c);
         }
     }
 }
 
-template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<const T*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
+template<size_t bytes_per_pixel>
+static void unfilter_scanline_impl(u8 filter, Bytes scanline, ReadonlyBytes previous_scanline)
+{
+    switch (filter) {
+    case 0:
+        break;
+    case 1:
+        unfilter_sub<bytes_per_pixel>(scanline);
+        break;
+    case 2:
+        unfilter_up(scanline, previous_scanline);
+        break;
+    case 3:
+        unfilter_average<bytes_per_pixel>(scanline, previous_scanline);
+        break;
+    case 4:
+        unfilter_paeth<bytes_per_pixel>(scanline, previous_scanline);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+NEVER_INLINE FLATTEN static void unfilter_scanline(u8 filter, Bytes scanline, ReadonlyBytes previous_scanline, size_t bytes_per_pixel)
+{
+    switch (bytes_per_pixel) {
+    case 1:
+        return unfilter_scanline_impl<1>(filter, scanline, previous_scanline);
+    case 2:
+        return unfilter_scanline_impl<2>(filter, scanline, previous_scanline);
+    case 3:
+        return unfilter_scanline_impl<3>(filter, scanline, previous_scanline);
+    case 4:
+        return unfilter_scanline_impl<4>(filter, scanline, previous_scanline);
+    case 6:
+        return unfilter_scanline_impl<6>(filter, scanline, previous_scanline);
+    case 8:
+        return unfilter_scanline_impl<8>(filter, scanline, previous_scanline);
+    default:
+        VERIFY_NOT_REACHED();
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<Tuple<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
-        }
+ALWAYS_INLINE static void unpack_grayscale_without_alpha(ReadonlyBytes scanline, ARGB32* pixels, int width)
+{
+    auto* gray_values = reinterpret_cast<T const*>(scanline.data());
+    for (int i = 0; i < width; ++i) {
+        u8 gray = gray_values[i];
+        pixels[i] = Color(gray, gray, gray).value();
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_grayscale_with_alpha(ReadonlyBytes scanline, ARGB32* pixels, int width)
+{
+    auto* tuples = reinterpret_cast<Tuple<T> const*>(scanline.data());
+    for (int i = 0; i < width; ++i) {
+        u8 gray = tuples[i].gray;
+        pixels[i] = Color(gray, gray, gray, static_cast<u8>(tuples[i].a)).value();
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingContext& context, Triplet<T> transparency_value)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            if (triplets[i] == transparency_value)
-                pixel.a = 0x00;
-            else
-                pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_triplets_without_alpha(ReadonlyBytes scanline, ARGB32* pixels, int width)
+{
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(scanline.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = Color(static_cast<u8>(triplets[i].r), static_cast<u8>(triplets[i].g), static_cast<u8>(triplets[i].b)).value();
+}
+
+template<typename T>
+ALWAYS_INLINE static void unpack_triplets_with_transparency_value(ReadonlyBytes scanline, ARGB32* pixels, int width, Triplet<T> transparency_value)
+{
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(scanline.data());
+    for (int i = 0; i < width; ++i) {
+        u8 alpha = triplets[i] == transparency_value ? 0x00 : 0xff;
+        pixels[i] = Color(static_cast<u8>(triplets[i].r), static_cast<u8>(triplets[i].g), static_cast<u8>(triplets[i].b), alpha).value();
     }
 }
 
-NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
+template<typename T>
+ALWAYS_INLINE static void unpack_quartets(ReadonlyBytes scanline, ARGB32* pixels, int width)
+{
+    auto* quartets = reinterpret_cast<Quartet<T> const*>(scanline.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = Color(static_cast<u8>(quartets[i].r), static_cast<u8>(quartets[i].g), static_cast<u8>(quartets[i].b), static_cast<u8>(quartets[i].a)).value();
+}
+
+// Converts an unfiltered scanline to BGRA pixels.
+// NOTE: For 16-bit samples, only the most significant byte (which comes first) is kept.
+NEVER_INLINE FLATTEN static ErrorOr<void> unpack_scanline(PNGLoadingContext const& context, ReadonlyBytes scanline, ARGB32* pixels, int width)
 {
-    // First unpack the scanlines to RGBA:
     switch (context.color_type) {
     case 0:
         if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
+            unpack_grayscale_without_alpha<u8>(scanline, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
+            unpack_grayscale_without_alpha<u16>(scanline, pixels, width);
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto bit_depth_squared = context.bit_depth * context.bit_depth;
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
+            for (int x = 0; x < width; ++x) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
+                auto value = (scanline[x / pixels_per_byte] >> bit_offset) & mask;
+                u8 gray = value * (0xff / bit_depth_squared);
+                pixels[x] = Color(gray, gray, gray).value();
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -366,9 +395,9 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case 4:
         if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
+            unpack_grayscale_with_alpha<u8>(scanline, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
+            unpack_grayscale_with_alpha<u16>(scanline, pixels, width);
         } else {
             VERIFY_NOT_REACHED();
         }
@@ -376,82 +405,59 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     case 2:
         if (context.palette_transparency_data.size() == 6) {
             if (context.bit_depth == 8) {
-                unpack_triplets_with_transparency_value<u8>(context, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
+                // NOTE: The transparent color is always stored with 16-bit samples, big-endian.
+                unpack_triplets_with_transparency_value<u8>(scanline, pixels, width, Triplet<u8> { context.palette_transparency_data[1], context.palette_transparency_data[3], context.palette_transparency_data[5] });
             } else if (context.bit_depth == 16) {
                 u16 tr = context.palette_transparency_data[0] | context.palette_transparency_data[1] << 8;
                 u16 tg = context.palette_transparency_data[2] | context.palette_transparency_data[3] << 8;
                 u16 tb = context.palette_transparency_data[4] | context.palette_transparency_data[5] << 8;
-                unpack_triplets_with_transparency_value<u16>(context, Triplet<u16> { tr, tg, tb });
+                unpack_triplets_with_transparency_value<u16>(scanline, pixels, width, Triplet<u16> { tr, tg, tb });
             } else {
                 VERIFY_NOT_REACHED();
             }
         } else {
             if (context.bit_depth == 8)
-                unpack_triplets_without_alpha<u8>(context);
+                unpack_triplets_without_alpha<u8>(scanline, pixels, width);
             else if (context.bit_depth == 16)
-                unpack_triplets_without_alpha<u16>(context);
+                unpack_triplets_without_alpha<u16>(scanline, pixels, width);
             else
                 VERIFY_NOT_REACHED();
         }
         break;
     case 6:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
-            }
+            unpack_quartets<u8>(scanline, pixels, width);
         } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* quartets = reinterpret_cast<Quartet<u16> const*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = quartets[i].r & 0xFF;
-                    pixel.g = quartets[i].g & 0xFF;
-                    pixel.b = quartets[i].b & 0xFF;
-                    pixel.a = quartets[i].a & 0xFF;
-                }
-            }
+            unpack_quartets<u16>(scanline, pixels, width);
         } else {
             VERIFY_NOT_REACHED();
         }
         break;
     case 3:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range"sv);
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data.data()[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            for (int i = 0; i < width; ++i) {
+                auto palette_index = scanline[i];
+                if (palette_index >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range"sv);
+                auto& color = context.palette_data.at(palette_index);
+                auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+                    ? context.palette_transparency_data.data()[palette_index]
+                    : 0xff;
+                pixels[i] = Color(color.r, color.g, color.b, transparency).value();
             }
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indices = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range"sv);
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data.data()[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            for (int i = 0; i < width; ++i) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
+                auto palette_index = (scanline[i / pixels_per_byte] >> bit_offset) & mask;
+                if ((size_t)palette_index >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range"sv);
+                auto& color = context.palette_data.at(palette_index);
+                auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+                    ? context.palette_transparency_data.data()[palette_index]
+                    : 0xff;
+                pixels[i] = Color(color.r, color.g, color.b, transparency).value();
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -462,48 +468,6 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     }
 
-    u8 dummy_scanline[context.width * sizeof(ARGB32)];
-    memset(dummy_scanline, 0, sizeof(dummy_scanline));
-
-    for (int y = 0; y < context.height; ++y) {
-        auto filter = context.scanlines[y].filter;
-        if (filter == 0) {
-            if (context.has_alpha())
-                unfilter_impl<true, 0>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 0>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 1) {
-            if (context.has_alpha())
-                unfilter_impl<true, 1>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 1>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 2) {
-            if (context.has_alpha())
-                unfilter_impl<true, 2>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 2>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 3) {
-            if (context.has_alpha())
-                unfilter_impl<true, 3>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 3>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 4) {
-            if (context.has_alpha())
-                unfilter_impl<true, 4>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 4>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-    }
-
     return {};
 }
 
@@ -584,13 +548,28 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
+// Reads the scanlines of an image (or of one Adam7 pass) from the inflated image data one at a time, and hands each one
+// to the callback as a row of pixels. Only the scanline being decoded and the one above it are kept around.
+template<typename Callback>
+static ErrorOr<void> decode_scanlines(PNGLoadingContext& context, InputStream& stream, int width, int height, Callback callback)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow"sv);
+
+    // Filters refer to the corresponding byte of the previous pixel, i.e. to the byte one pixel (at least one byte) back.
+    size_t bytes_per_pixel = max(1, context.channels * context.bit_depth / 8);
 
-    for (int y = 0; y < context.height; ++y) {
+    auto scanline_buffer = TRY(ByteBuffer::create_zeroed(row_size.value() * 2));
+    Bytes scanline = scanline_buffer.bytes().slice(0, row_size.value());
+    Bytes previous_scanline = scanline_buffer.bytes().slice(row_size.value());
+
+    Vector<ARGB32> pixels;
+    TRY(pixels.try_resize(width));
+
+    for (int y = 0; y < height; ++y) {
         u8 filter;
-        if (!streamer.read(filter)) {
+        if (!stream.read_or_error({ &filter, sizeof(filter) })) {
             context.state = PNGLoadingContext::State::Error;
             return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
         }
@@ -600,20 +579,25 @@ static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
             return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter"sv);
         }
 
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow"sv);
-
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
+        if (!stream.read_or_error(scanline)) {
             context.state = PNGLoadingContext::State::Error;
             return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
         }
+
+        unfilter_scanline(filter, scanline, previous_scanline, bytes_per_pixel);
+        TRY(unpack_scanline(context, scanline, pixels.data(), width));
+        callback(y, pixels.span());
+        swap(scanline, previous_scanline);
     }
+    return {};
+}
 
+static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context, InputStream& stream)
+{
     context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    return unfilter(context);
+    return decode_scanlines(context, stream, context.width, context.height, [&](int y, Span<ARGB32> pixels) {
+        memcpy(context.bitmap->scanline(y), pixels.data(), pixels.size() * sizeof(ARGB32));
+    });
 }
 
 static int adam7_height(PNGLoadingContext& context, int pass)
@@ -666,65 +650,31 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, InputStream& stream, int pass)
 {
-    PNGLoadingContext subimage_context;
-    subimage_context.width = adam7_width(context, pass);
-    subimage_context.height = adam7_height(context, pass);
-    subimage_context.channels = context.channels;
-    subimage_context.color_type = context.color_type;
-    subimage_context.palette_data = context.palette_data;
-    subimage_context.palette_transparency_data = context.palette_transparency_data;
-    subimage_context.bit_depth = context.bit_depth;
-    subimage_context.filter_method = context.filter_method;
+    int width = adam7_width(context, pass);
+    int height = adam7_height(context, pass);
 
     // For small images, some passes might be empty
-    if (!subimage_context.width || !subimage_context.height)
+    if (!width || !height)
         return {};
 
-    subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        u8 filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
-        }
-
-        if (filter > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter"sv);
-        }
-
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
-
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow"sv);
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
-        }
-    }
-
-    subimage_context.bitmap = TRY(Bitmap::try_create(context.bitmap->format(), { subimage_context.width, subimage_context.height }));
-    TRY(unfilter(subimage_context));
-
-    // Copy the subimage data into the main image according to the pass pattern
-    for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
-        }
-    }
-    return {};
+    // Copy the pass's pixels into the main image according to the pass pattern
+    return decode_scanlines(context, stream, width, height, [&](int y, Span<ARGB32> pixels) {
+        int dy = adam7_starty[pass] + y * adam7_stepy[pass];
+        if (dy >= context.height)
+            return;
+        auto* scanline = context.bitmap->scanline(dy);
+        for (int x = 0, dx = adam7_startx[pass]; x < width && dx < context.width; ++x, dx += adam7_stepx[pass])
+            scanline[dx] = pixels[x];
+    });
 }
 
-static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context)
+static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context, InputStream& stream)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
     context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
     for (int pass = 1; pass <= 7; ++pass)
-        TRY(decode_adam7_pass(context, streamer, pass));
+        TRY(decode_adam7_pass(context, stream, pass));
     return {};
 }
 
@@ -744,29 +694,35 @@ static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == 3 && context.palette_data.is_empty())
         return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see a PLTE chunk for a palletized image, or it was empty."sv);
 
-    auto result = Compress::Zlib::decompress_all(context.compressed_data.span());
-    if (!result.has_value()) {
+    auto zlib = Compress::Zlib::try_create(context.compressed_data.span());
+    if (!zlib.has_value()) {
         context.state = PNGLoadingContext::State::Error;
         return Error::from_string_literal("PNGImageDecoderPlugin: Decompression failed"sv);
     }
-    context.decompression_buffer = &result.value();
-    context.compressed_data.clear();
 
-    context.scanlines.ensure_capacity(context.height);
+    // The image data is inflated as the scanlines are decoded, rather than all up front.
+    InputMemoryStream compressed_stream { zlib->deflate_data() };
+    Compress::DeflateDecompressor decompressor { compressed_stream };
+
+    ErrorOr<void> result;
     switch (context.interlace_method) {
     case PngInterlaceMethod::Null:
-        TRY(decode_png_bitmap_simple(context));
+        result = decode_png_bitmap_simple(context, decompressor);
         break;
     case PngInterlaceMethod::Adam7:
-        TRY(decode_png_adam7(context));
+        result = decode_png_adam7(context, decompressor);
         break;
     default:
         context.state = PNGLoadingContext::State::Error;
-        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method"sv);
+        result = Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method"sv);
+        break;
     }
 
-    context.decompression_buffer = nullptr;
+    // NOTE: Any stream errors have been turned into the result by now, but the streams must not be destroyed with them pending.
+    decompressor.handle_any_error();
+    TRY(result);
 
+    context.compressed_data.clear();
     context.state = PNGLoadingContext::State::BitmapDecoded;
     return {};
 }
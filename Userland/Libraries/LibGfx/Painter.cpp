@@ -17,12 +17,15 @@
 #include "Font/FontDatabase.h"
 #include "Gamma.h"
 #include <AK/Assertions.h>
+#include <AK/BitCast.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
 #include <AK/Math.h>
 #include <AK/Memory.h>
 #include <AK/Queue.h>
 #include <AK/QuickSort.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf32View.h>
@@ -59,6 +62,87 @@ ALWAYS_INLINE Color get_pixel(Gfx::Bitmap const& bitmap, int x, int y)
     return bitmap.get_pixel(x, y);
 }
 
+// The kernels below work on four pixels at once, with each pixel in a lane of a vector.
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+using AK::SIMD::u32x4;
+
+ALWAYS_INLINE static u32x4 load_pixels(ARGB32 const* pixels)
+{
+    u32x4 vector;
+    __builtin_memcpy(&vector, pixels, sizeof(vector));
+    return vector;
+}
+
+ALWAYS_INLINE static void store_pixels(ARGB32* pixels, u32x4 vector)
+{
+    __builtin_memcpy(pixels, &vector, sizeof(vector));
+}
+
+ALWAYS_INLINE static i32x4 channel_of_pixels(u32x4 pixels, u32 shift)
+{
+    return (i32x4)((pixels >> shift) & 0xff);
+}
+
+ALWAYS_INLINE static u32x4 select_pixels(i32x4 mask, u32x4 if_set, u32x4 if_clear)
+{
+    return (if_set & (u32x4)mask) | (if_clear & ~(u32x4)mask);
+}
+
+ALWAYS_INLINE static u32x4 swap_red_and_blue_channels_of_pixels(u32x4 pixels)
+{
+    return (pixels & 0xff00ff00) | ((pixels & 0xff) << 16) | ((pixels >> 16) & 0xff);
+}
+
+// Blends four source pixels over four destination pixels, with the result that Color::blend() has for each of them.
+template<bool destination_is_opaque>
+ALWAYS_INLINE static u32x4 blend_pixels(u32x4 destination, u32x4 source)
+{
+    if constexpr (destination_is_opaque)
+        destination |= 0xff000000;
+    auto source_alpha = (i32x4)(source >> 24);
+    auto destination_alpha = (i32x4)(destination >> 24);
+
+    u32x4 blended;
+    if (destination_is_opaque || AK::SIMD::all(destination_alpha == 255)) {
+        // Over an opaque destination, blending comes down to mixing the colors by the source alpha.
+        auto destination_weight = 255 - source_alpha;
+        auto mix = [&](u32 shift) {
+            auto value = channel_of_pixels(destination, shift) * destination_weight + channel_of_pixels(source, shift) * source_alpha;
+            // This divides by 255, and is exact for every value that fits into 16 bits.
+            return (u32x4)((value + 1 + (value >> 8)) >> 8) << shift;
+        };
+        blended = mix(0) | mix(8) | mix(16) | 0xff000000;
+    } else {
+        auto denominator = 255 * (destination_alpha + source_alpha) - destination_alpha * source_alpha;
+        // NOTE: Lanes where both pixels are transparent take the source pixel below, and only must not divide by zero here.
+        auto float_denominator = AK::SIMD::to_f32x4(denominator - (denominator == 0));
+        auto destination_weight = destination_alpha * (255 - source_alpha);
+        auto source_weight = 255 * source_alpha;
+        auto mix = [&](u32 shift) {
+            auto value = channel_of_pixels(destination, shift) * destination_weight + channel_of_pixels(source, shift) * source_weight;
+            // The values fit into the mantissa of a float, and their quotients are never close enough to the next integer
+            // for the rounding of the division to reach it, so truncating gives the same result as integer division.
+            return AK::SIMD::to_u32x4(AK::SIMD::to_i32x4(AK::SIMD::to_f32x4(value) / float_denominator)) << shift;
+        };
+        auto alpha = AK::SIMD::to_u32x4(AK::SIMD::to_i32x4(AK::SIMD::to_f32x4(denominator) / 255.0f));
+        blended = mix(0) | mix(8) | mix(16) | (alpha << 24);
+    }
+
+    blended = select_pixels(source_alpha == 0, destination, blended);
+    return select_pixels((destination_alpha == 0) | (source_alpha == 255), source, blended);
+}
+
+ALWAYS_INLINE static i32x4 channels_of(Color color)
+{
+    return AK::SIMD::to_i32x4(bit_cast<AK::SIMD::u8x4>(color.value()));
+}
+
+ALWAYS_INLINE static Color color_from_channels(i32x4 channels)
+{
+    return Color::from_argb(bit_cast<ARGB32>(__builtin_convertvector(channels, AK::SIMD::u8x4)));
+}
+
 Painter::Painter(Gfx::Bitmap& bitmap)
     : m_target(bitmap)
 {
@@ -115,8 +199,12 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     ARGB32* dst = m_target->scanline(physical_rect.top()) + physical_rect.left();
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
+    auto source = AK::SIMD::expand4(color.value());
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
+        int j = 0;
+        for (; j + 4 <= physical_rect.width(); j += 4)
+            store_pixels(dst + j, blend_pixels<false>(load_pixels(dst + j), source));
+        for (; j < physical_rect.width(); ++j)
             dst[j] = Color::from_argb(dst[j]).blend(color).value();
         dst += dst_skip;
     }
@@ -223,6 +311,40 @@ void Painter::fill_rect_with_checkerboard(IntRect const& a_rect, IntSize const&
     }
 }
 
+// Fills a row with a horizontal gradient, where each pixel moves the mix between the colors and the alpha along by an increment.
+static void fill_row_with_gradient(ARGB32* row, int width, Color gradient_start, Color gradient_end, float c, float c_alpha, float increment, float alpha_increment)
+{
+    int x = 0;
+#ifdef __SSE__
+    auto channel = [](u8 value) { return AK::SIMD::expand4(static_cast<float>(value)) * (1.f / 255.f); };
+    f32x4 const start[] = { channel(gradient_start.red()), channel(gradient_start.green()), channel(gradient_start.blue()) };
+    f32x4 const end[] = { channel(gradient_end.red()), channel(gradient_end.green()), channel(gradient_end.blue()) };
+    for (; x + 4 <= width; x += 4) {
+        f32x4 mix;
+        f32x4 alpha;
+        for (int i = 0; i < 4; ++i) {
+            mix[i] = c;
+            alpha[i] = c_alpha;
+            c += increment;
+            c_alpha += alpha_increment;
+        }
+        auto lerp = [&](int index) {
+            auto value = 255.f * linear_to_gamma4(gamma_to_linear4(start[index]) * (1 - mix) + gamma_to_linear4(end[index]) * mix);
+            return AK::SIMD::to_u32x4(AK::SIMD::to_i32x4(value)) & 0xff;
+        };
+        auto alpha_channel = AK::SIMD::to_u32x4(AK::SIMD::to_i32x4(alpha)) & 0xff;
+        store_pixels(row + x, (alpha_channel << 24) | (lerp(0) << 16) | (lerp(1) << 8) | lerp(2));
+    }
+#endif
+    for (; x < width; ++x) {
+        auto color = gamma_accurate_blend(gradient_start, gradient_end, c);
+        color.set_alpha(c_alpha);
+        row[x] = color.value();
+        c_alpha += alpha_increment;
+        c += increment;
+    }
+}
+
 void Painter::fill_rect_with_gradient(Orientation orientation, IntRect const& a_rect, Color gradient_start, Color gradient_end)
 {
     if (gradient_start == gradient_end) {
@@ -244,16 +366,10 @@ void Painter::fill_rect_with_gradient(Orientation orientation, IntRect const& a_
     float alpha_increment = increment * ((float)gradient_end.alpha() - (float)gradient_start.alpha());
 
     if (orientation == Orientation::Horizontal) {
-        for (int i = clipped_rect.height() - 1; i >= 0; --i) {
-            float c = offset * increment;
-            float c_alpha = gradient_start.alpha() + offset * alpha_increment;
-            for (int j = 0; j < clipped_rect.width(); ++j) {
-                auto color = gamma_accurate_blend(gradient_start, gradient_end, c);
-                color.set_alpha(c_alpha);
-                dst[j] = color.value();
-                c_alpha += alpha_increment;
-                c += increment;
-            }
+        // Every row of a horizontal gradient is the same, so only the first one is computed.
+        fill_row_with_gradient(dst, clipped_rect.width(), gradient_start, gradient_end, offset * increment, gradient_start.alpha() + offset * alpha_increment, increment, alpha_increment);
+        for (int i = clipped_rect.height() - 2; i >= 0; --i) {
+            fast_u32_copy(dst + dst_skip, dst, clipped_rect.width());
             dst += dst_skip;
         }
     } else {
@@ -262,9 +378,7 @@ void Painter::fill_rect_with_gradient(Orientation orientation, IntRect const& a_
         for (int i = clipped_rect.height() - 1; i >= 0; --i) {
             auto color = gamma_accurate_blend(gradient_end, gradient_start, c);
             color.set_alpha(c_alpha);
-            for (int j = 0; j < clipped_rect.width(); ++j) {
-                dst[j] = color.value();
-            }
+            fast_u32_fill(dst, color.value(), clipped_rect.width());
             c_alpha += alpha_increment;
             c += increment;
             dst += dst_skip;
@@ -780,12 +894,33 @@ static void swap_red_and_blue_channels(Color& color)
     color = Color::from_argb(bgra);
 }
 
-// FIXME: This function is very unoptimized.
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    // The alpha that the source pixels end up with, computed in the same way as for the single pixels below.
+    u8 alpha_for_source_alpha[256];
+    if constexpr (has_alpha & BlitState::SrcAlpha) {
+        for (int alpha = 0; alpha < 256; ++alpha) {
+            float pixel_opacity = alpha / 255.0;
+            alpha_for_source_alpha[alpha] = 255 * (state.opacity * pixel_opacity);
+        }
+    }
+    u32 const source_alpha = static_cast<u8>(state.opacity * 255) << 24;
+
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
+        int x = 0;
+        for (; x + 4 <= state.column_count; x += 4) {
+            auto source = load_pixels(state.src + x);
+            if (state.src_format == BitmapFormat::RGBA8888)
+                source = swap_red_and_blue_channels_of_pixels(source);
+            if constexpr (has_alpha & BlitState::SrcAlpha) {
+                source = (source & 0xffffff) | (u32x4 { alpha_for_source_alpha[source[0] >> 24], alpha_for_source_alpha[source[1] >> 24], alpha_for_source_alpha[source[2] >> 24], alpha_for_source_alpha[source[3] >> 24] } << 24);
+            } else {
+                source = (source & 0xffffff) | source_alpha;
+            }
+            store_pixels(state.dst + x, blend_pixels<!(has_alpha & BlitState::DstAlpha)>(load_pixels(state.dst + x), source));
+        }
+        for (; x < state.column_count; ++x) {
             Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
             if constexpr (has_alpha & BlitState::SrcAlpha) {
                 Color src_color_with_alpha = Color::from_argb(state.src[x]);
@@ -1145,18 +1280,24 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
                 auto scaled_y0 = clamp((desired_y - half_pixel) >> 32, clipped_src_rect.top(), clipped_src_rect.bottom());
                 auto scaled_y1 = clamp((desired_y + half_pixel) >> 32, clipped_src_rect.top(), clipped_src_rect.bottom());
 
-                float x_ratio = (((desired_x + half_pixel) & fractional_mask) / (float)shift);
-                float y_ratio = (((desired_y + half_pixel) & fractional_mask) / (float)shift);
+                // The pixels are interpolated with all four channels at once, and with 16-bit fixed point weights.
+                i32 x_weight = ((desired_x + half_pixel) & fractional_mask) >> 16;
+                i32 y_weight = ((desired_y + half_pixel) & fractional_mask) >> 16;
+                auto interpolate = [](i32x4 from, i32x4 to, i32 weight) {
+                    // Like Color::interpolate(), this rounds halfway cases away from zero.
+                    auto product = (to - from) * weight;
+                    return from + ((product + (1 << 15) + (product < 0)) >> 16);
+                };
 
-                auto top_left = get_pixel(source, scaled_x0, scaled_y0);
-                auto top_right = get_pixel(source, scaled_x1, scaled_y0);
-                auto bottom_left = get_pixel(source, scaled_x0, scaled_y1);
-                auto bottom_right = get_pixel(source, scaled_x1, scaled_y1);
+                auto top_left = channels_of(get_pixel(source, scaled_x0, scaled_y0));
+                auto top_right = channels_of(get_pixel(source, scaled_x1, scaled_y0));
+                auto bottom_left = channels_of(get_pixel(source, scaled_x0, scaled_y1));
+                auto bottom_right = channels_of(get_pixel(source, scaled_x1, scaled_y1));
 
-                auto top = top_left.interpolate(top_right, x_ratio);
-                auto bottom = bottom_left.interpolate(bottom_right, x_ratio);
+                auto top = interpolate(top_left, top_right, x_weight);
+                auto bottom = interpolate(bottom_left, bottom_right, x_weight);
 
-                src_pixel = top.interpolate(bottom, y_ratio);
+                src_pixel = color_from_channels(interpolate(top, bottom, y_weight));
             } else {
                 auto scaled_x = clamp(desired_x >> 32, clipped_src_rect.left(), clipped_src_rect.right());
                 auto scaled_y = clamp(desired_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom());
@@ -1174,6 +1315,55 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     }
 }
 
+// Averages all the source pixels that each destination pixel covers, weighted by how much of them it covers. This is
+// meant for scaling down, where the other modes skip over source pixels. The colors are premultiplied by their alpha
+// while they are summed up, so that transparent pixels don't bleed their color into the result.
+template<bool has_alpha_channel, typename GetPixel>
+static void do_draw_box_sampled_scaled_bitmap(Gfx::Bitmap& target, IntRect const& dst_rect, IntRect const& clipped_rect, Gfx::Bitmap const& source, FloatRect const& src_rect, GetPixel get_pixel, float opacity)
+{
+    float source_pixel_width = src_rect.width() / dst_rect.width();
+    float source_pixel_height = src_rect.height() / dst_rect.height();
+    auto source_bounds = source.rect().to_type<float>();
+
+    for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
+        auto* scanline = (Color*)target.scanline(y);
+        float box_top = max(src_rect.top() + (y - dst_rect.y()) * source_pixel_height, source_bounds.top());
+        float box_bottom = min(src_rect.top() + (y - dst_rect.y() + 1) * source_pixel_height, source_bounds.top() + source_bounds.height());
+        if (box_bottom <= box_top)
+            continue;
+
+        for (int x = clipped_rect.left(); x <= clipped_rect.right(); ++x) {
+            float box_left = max(src_rect.left() + (x - dst_rect.x()) * source_pixel_width, source_bounds.left());
+            float box_right = min(src_rect.left() + (x - dst_rect.x() + 1) * source_pixel_width, source_bounds.left() + source_bounds.width());
+            if (box_right <= box_left)
+                continue;
+
+            f32x4 sum {};
+            for (int source_y = box_top; source_y < box_bottom; ++source_y) {
+                float row_coverage = min(source_y + 1.f, box_bottom) - max(static_cast<float>(source_y), box_top);
+                for (int source_x = box_left; source_x < box_right; ++source_x) {
+                    float coverage = row_coverage * (min(source_x + 1.f, box_right) - max(static_cast<float>(source_x), box_left));
+                    auto pixel = AK::SIMD::to_f32x4(channels_of(get_pixel(source, source_x, source_y)));
+                    float weight = has_alpha_channel ? coverage * pixel[3] : coverage;
+                    sum += pixel * f32x4 { weight, weight, weight, coverage };
+                }
+            }
+
+            float area = (box_right - box_left) * (box_bottom - box_top);
+            if constexpr (has_alpha_channel) {
+                if (sum[3] == 0.f)
+                    continue;
+                auto average = sum / f32x4 { sum[3], sum[3], sum[3], area };
+                average[3] *= opacity;
+                auto src_pixel = color_from_channels(AK::SIMD::to_i32x4(average + 0.5f));
+                scanline[x] = scanline[x].blend(src_pixel);
+            } else {
+                scanline[x] = color_from_channels(AK::SIMD::to_i32x4(sum / area + 0.5f));
+            }
+        }
+    }
+}
+
 template<bool has_alpha_channel, typename GetPixel>
 ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect const& dst_rect, IntRect const& clipped_rect, Gfx::Bitmap const& source, FloatRect const& src_rect, GetPixel get_pixel, float opacity, Painter::ScalingMode scaling_mode)
 {
@@ -1184,6 +1374,9 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     case Painter::ScalingMode::BilinearBlend:
         do_draw_scaled_bitmap<has_alpha_channel, true>(target, dst_rect, clipped_rect, source, src_rect, get_pixel, opacity);
         break;
+    case Painter::ScalingMode::BoxSampling:
+        do_draw_box_sampled_scaled_bitmap<has_alpha_channel>(target, dst_rect, clipped_rect, source, src_rect, get_pixel, opacity);
+        break;
     }
 }
 
@@ -37,6 +37,7 @@ public:
     enum class ScalingMode {
         NearestNeighbor,
         BilinearBlend,
+        BoxSampling,
     };
 
     void clear_rect(IntRect const&, Color);
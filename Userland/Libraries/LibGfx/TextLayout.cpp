@@ -6,9 +6,57 @@
  */
 
 #include "TextLayout.h"
+#include <AK/CircularQueue.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
 
 namespace Gfx {
 
+// Widgets lay out the same few texts every time they're painted, so the results are kept around for a while.
+static constexpr size_t layout_cache_capacity = 256;
+
+// Long texts are rarely laid out again with the same parameters, and would take up a lot of room in the cache.
+static constexpr size_t max_cached_text_length = 1024;
+
+struct LayoutCacheKey {
+    // NOTE: Holding a reference keeps the font alive, so another font can't show up at the same address while it's cached.
+    RefPtr<Font const> font;
+    String text;
+    IntSize size;
+    TextElision elision;
+    TextWrapping wrapping;
+    int line_spacing;
+    FitWithinRect fit_within_rect;
+
+    bool operator==(LayoutCacheKey const&) const = default;
+};
+
+struct LayoutCacheKeyTraits : public GenericTraits<LayoutCacheKey> {
+    static unsigned hash(LayoutCacheKey const& key)
+    {
+        auto hash = pair_int_hash(ptr_hash(key.font.ptr()), key.text.hash());
+        hash = pair_int_hash(hash, pair_int_hash(key.size.width(), key.size.height()));
+        hash = pair_int_hash(hash, pair_int_hash(to_underlying(key.elision), to_underlying(key.wrapping)));
+        return pair_int_hash(hash, pair_int_hash(key.line_spacing, to_underlying(key.fit_within_rect)));
+    }
+};
+
+struct LayoutCacheEntry {
+    Vector<String, 32> lines;
+    Optional<IntRect> bounding_rect;
+};
+
+struct LayoutCache {
+    HashMap<LayoutCacheKey, LayoutCacheEntry, LayoutCacheKeyTraits> entries;
+    CircularQueue<LayoutCacheKey, layout_cache_capacity> insertion_order;
+};
+
+static LayoutCache& layout_cache()
+{
+    static LayoutCache cache;
+    return cache;
+}
+
 enum class BlockType {
     Newline,
     Whitespace,
@@ -20,9 +68,65 @@ struct Block {
     Utf8View characters;
 };
 
+void TextLayout::purge_cached_layouts_for(Font const& font)
+{
+    auto& cache = layout_cache();
+    cache.entries.remove_all_matching([&](auto const& key, auto const&) {
+        return key.font == &font;
+    });
+
+    // The insertion order holds on to the keys (and with them the font) as well, so rebuild it without the purged ones.
+    auto queued_keys = cache.insertion_order.size();
+    for (size_t i = 0; i < queued_keys; ++i) {
+        auto key = cache.insertion_order.dequeue();
+        if (key.font != &font)
+            cache.insertion_order.enqueue(move(key));
+    }
+}
+
+Optional<LayoutCacheKey> TextLayout::cache_key(TextElision elision, TextWrapping wrapping, int line_spacing, FitWithinRect fit_within_rect) const
+{
+    if (m_text.byte_length() > max_cached_text_length)
+        return {};
+    return LayoutCacheKey { m_font, String { m_text.as_string() }, m_rect.size(), elision, wrapping, line_spacing, fit_within_rect };
+}
+
+LayoutCacheEntry& TextLayout::cache_entry_for(LayoutCacheKey const& key) const
+{
+    auto& cache = layout_cache();
+    if (auto it = cache.entries.find(key); it != cache.entries.end())
+        return it->value;
+
+    if (cache.insertion_order.size() == cache.insertion_order.capacity())
+        cache.entries.remove(cache.insertion_order.dequeue());
+    cache.insertion_order.enqueue(key);
+
+    LayoutCacheEntry entry { compute_wrapped_lines(key.elision, key.wrapping, key.line_spacing, key.fit_within_rect), {} };
+    return cache.entries.ensure(key, [&] { return move(entry); });
+}
+
+Vector<String, 32> TextLayout::wrap_lines(TextElision elision, TextWrapping wrapping, int line_spacing, FitWithinRect fit_within_rect) const
+{
+    auto key = cache_key(elision, wrapping, line_spacing, fit_within_rect);
+    if (!key.has_value())
+        return compute_wrapped_lines(elision, wrapping, line_spacing, fit_within_rect);
+    return cache_entry_for(*key).lines;
+}
+
 IntRect TextLayout::bounding_rect(TextWrapping wrapping, int line_spacing) const
 {
-    auto lines = wrap_lines(TextElision::None, wrapping, line_spacing, FitWithinRect::No);
+    auto key = cache_key(TextElision::None, wrapping, line_spacing, FitWithinRect::No);
+    if (!key.has_value())
+        return compute_bounding_rect(compute_wrapped_lines(TextElision::None, wrapping, line_spacing, FitWithinRect::No), line_spacing);
+
+    auto& entry = cache_entry_for(*key);
+    if (!entry.bounding_rect.has_value())
+        entry.bounding_rect = compute_bounding_rect(entry.lines, line_spacing);
+    return *entry.bounding_rect;
+}
+
+IntRect TextLayout::compute_bounding_rect(Vector<String, 32> const& lines, int line_spacing) const
+{
     if (!lines.size()) {
         return {};
     }
@@ -40,7 +144,7 @@ IntRect TextLayout::bounding_rect(TextWrapping wrapping, int line_spacing) const
     return bounding_rect;
 }
 
-Vector<String, 32> TextLayout::wrap_lines(TextElision elision, TextWrapping wrapping, int line_spacing, FitWithinRect fit_within_rect) const
+Vector<String, 32> TextLayout::compute_wrapped_lines(TextElision elision, TextWrapping wrapping, int line_spacing, FitWithinRect fit_within_rect) const
 {
     Vector<Block> blocks;
 
@@ -20,6 +20,9 @@
 
 namespace Gfx {
 
+struct LayoutCacheKey;
+struct LayoutCacheEntry;
+
 enum class FitWithinRect {
     Yes,
     No
@@ -67,8 +70,17 @@ public:
 
     IntRect bounding_rect(TextWrapping wrapping, int line_spacing) const;
 
+    // Must be called after changing a font in place, since layouts done with it earlier are cached.
+    static void purge_cached_layouts_for(Font const&);
+
 private:
+    // Laid out lines are cached per process, keyed by the font, text, rect size and layout parameters.
+    Optional<LayoutCacheKey> cache_key(TextElision, TextWrapping, int line_spacing, FitWithinRect) const;
+    LayoutCacheEntry& cache_entry_for(LayoutCacheKey const&) const;
+
     Vector<String, 32> wrap_lines(TextElision, TextWrapping, int line_spacing, FitWithinRect) const;
+    Vector<String, 32> compute_wrapped_lines(TextElision, TextWrapping, int line_spacing, FitWithinRect) const;
+    IntRect compute_bounding_rect(Vector<String, 32> const& lines, int line_spacing) const;
     String elide_text_from_right(Utf8View, bool force_elision) const;
 
     Font const* m_font;
@@ -30,7 +30,8 @@ class Client final
     IPC_CLIENT_CONNECTION(Client, "/tmp/portal/image");
 
 public:
-    Optional<DecodedImage> decode_image(ReadonlyBytes);
+    // If an ideal size is given, frames larger than it are scaled down (keeping their aspect ratio) before being sent back.
+    Optional<DecodedImage> decode_image(ReadonlyBytes, Optional<Gfx::IntSize> ideal_size = {});
 
     Function<void()> on_death;
 
@@ -269,7 +269,16 @@ ThrowCompletionOr<void> CopyObjectExcludingProperties::execute_impl(Bytecode::In
 
 ThrowCompletionOr<void> ConcatString::execute_impl(Bytecode::Interpreter& interpreter) const
 {
-    interpreter.reg(m_lhs) = TRY(add(interpreter.global_object(), interpreter.reg(m_lhs), interpreter.accumulator()));
+    auto& lhs = interpreter.reg(m_lhs);
+    auto rhs = interpreter.accumulator();
+
+    // NOTE: Concatenating two strings can't have any side effects, so we can skip straight to building a rope.
+    if (lhs.is_string() && rhs.is_string()) {
+        lhs = js_rope_string(interpreter.vm(), lhs.as_string(), rhs.as_string());
+        return {};
+    }
+
+    lhs = TRY(add(interpreter.global_object(), lhs, rhs));
     return {};
 }
 
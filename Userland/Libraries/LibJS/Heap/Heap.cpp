@@ -182,8 +182,20 @@ public:
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
-        cell.visit_edges(*this);
+
+        // NOTE: Edges are visited from a work queue rather than recursively, since long chains of cells (like a rope string
+        //       built by many concatenations) would otherwise overflow the stack.
+        m_work_queue.append(cell);
+    }
+
+    void mark_all_live_cells()
+    {
+        while (!m_work_queue.is_empty())
+            m_work_queue.take_last().visit_edges(*this);
     }
+
+private:
+    Vector<Cell&> m_work_queue;
 };
 
 void Heap::mark_live_cells(HashTable<Cell*> const& roots)
@@ -194,6 +206,8 @@ void Heap::mark_live_cells(HashTable<Cell*> const& roots)
     for (auto* root : roots)
         visitor.visit(root);
 
+    visitor.mark_all_live_cells();
+
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
 
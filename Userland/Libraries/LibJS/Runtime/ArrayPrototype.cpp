@@ -468,13 +468,32 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::join)
     String separator = ",";
     if (!vm.argument(0).is_undefined())
         separator = TRY(vm.argument(0).to_string(global_object));
+
+    // NOTE: Elements that are own data properties of an Array are read straight from its indexed storage, which is all
+    //       that [[Get]] would do for them. Converting an element to a string may run arbitrary code, so this is checked
+    //       again for every element.
+    auto* array = is<Array>(*this_object) ? static_cast<Array*>(this_object) : nullptr;
+
     StringBuilder builder;
     for (size_t i = 0; i < length; ++i) {
         if (i > 0)
             builder.append(separator);
-        auto value = TRY(this_object->get(i));
+
+        Value value;
+        Optional<ValueAndAttributes> element;
+        if (array && i < NumericLimits<u32>::max())
+            element = array->indexed_properties().get(i);
+        if (element.has_value() && !element->value.is_accessor())
+            value = element->value;
+        else
+            value = TRY(this_object->get(i));
+
         if (value.is_nullish())
             continue;
+        if (value.is_string()) {
+            builder.append(value.as_string().string());
+            continue;
+        }
         auto string = TRY(value.to_string(global_object));
         builder.append(string);
     }
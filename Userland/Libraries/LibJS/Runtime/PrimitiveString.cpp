@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/CharacterTypes.h>
+#include <AK/StringBuilder.h>
+#include <AK/Utf8View.h>
 #include <AK/Utf16View.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/GlobalObject.h>
@@ -27,13 +30,40 @@ PrimitiveString::PrimitiveString(Utf16String string)
 {
 }
 
+PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
+    : m_is_rope(true)
+    , m_lhs(&lhs)
+    , m_rhs(&rhs)
+{
+}
+
 PrimitiveString::~PrimitiveString()
 {
     vm().string_cache().remove(m_utf8_string);
 }
 
+void PrimitiveString::visit_edges(Cell::Visitor& visitor)
+{
+    Cell::visit_edges(visitor);
+    if (m_is_rope) {
+        visitor.visit(m_lhs);
+        visitor.visit(m_rhs);
+    }
+}
+
+bool PrimitiveString::is_empty() const
+{
+    // NOTE: Ropes are never created from empty strings, so they can't be empty either.
+    if (m_is_rope)
+        return false;
+    if (m_has_utf16_string)
+        return m_utf16_string.is_empty();
+    return m_utf8_string.is_empty();
+}
+
 String const& PrimitiveString::string() const
 {
+    resolve_rope_if_needed();
     if (!m_has_utf8_string) {
         m_utf8_string = m_utf16_string.to_utf8();
         m_has_utf8_string = true;
@@ -43,6 +73,7 @@ String const& PrimitiveString::string() const
 
 Utf16String const& PrimitiveString::utf16_string() const
 {
+    resolve_rope_if_needed();
     if (!m_has_utf16_string) {
         m_utf16_string = Utf16String(m_utf8_string);
         m_has_utf16_string = true;
@@ -55,6 +86,74 @@ Utf16View PrimitiveString::utf16_string_view() const
     return utf16_string().view();
 }
 
+void PrimitiveString::resolve_rope_if_needed() const
+{
+    if (!m_is_rope)
+        return;
+
+    // NOTE: The rope is traversed without recursion, since a long sequence of concatenations would quickly run us out of stack space.
+    Vector<PrimitiveString const*> pieces;
+    Vector<PrimitiveString const*> stack;
+    stack.append(m_rhs);
+    stack.append(m_lhs);
+    while (!stack.is_empty()) {
+        auto const* current = stack.take_last();
+        if (current->m_is_rope) {
+            stack.append(current->m_rhs);
+            stack.append(current->m_lhs);
+            continue;
+        }
+        pieces.append(current);
+    }
+
+    auto has_utf16_pieces_only = all_of(pieces, [](auto const* piece) { return piece->has_utf16_string(); });
+    if (has_utf16_pieces_only) {
+        size_t length = 0;
+        for (auto const* piece : pieces)
+            length += piece->m_utf16_string.length_in_code_units();
+
+        Vector<u16, 1> combined;
+        combined.ensure_capacity(length);
+        for (auto const* piece : pieces)
+            combined.extend(piece->m_utf16_string.string());
+
+        m_utf16_string = Utf16String(move(combined));
+        m_has_utf16_string = true;
+    } else {
+        StringBuilder builder;
+        for (auto const* piece : pieces) {
+            auto const& piece_string = piece->string();
+
+            // A high surrogate at the end of the previous piece and a low surrogate at the start of this one (each encoded
+            // as 3 bytes of UTF-8) form a single code point in the concatenated string.
+            if (builder.length() >= 3 && piece_string.length() >= 3) {
+                auto previous = builder.string_view().substring_view(builder.length() - 3);
+                if ((static_cast<u8>(previous[0]) & 0xf0) == 0xe0 && (static_cast<u8>(piece_string[0]) & 0xf0) == 0xe0) {
+                    auto high_surrogate = *Utf8View(previous).begin();
+                    auto low_surrogate = *Utf8View(piece_string).begin();
+
+                    if (Utf16View::is_high_surrogate(high_surrogate) && Utf16View::is_low_surrogate(low_surrogate)) {
+                        builder.trim(3);
+                        builder.append_code_point(Utf16View::decode_surrogate_pair(high_surrogate, low_surrogate));
+                        builder.append(piece_string.substring_view(3));
+                        continue;
+                    }
+                }
+            }
+
+            builder.append(piece_string);
+        }
+
+        m_utf8_string = builder.to_string();
+        m_has_utf8_string = true;
+    }
+
+    // The pieces are not needed anymore, and can be garbage collected once nothing else refers to them.
+    m_is_rope = false;
+    m_lhs = nullptr;
+    m_rhs = nullptr;
+}
+
 Optional<Value> PrimitiveString::get(GlobalObject& global_object, PropertyKey const& property_key) const
 {
     if (property_key.is_symbol())
@@ -130,4 +229,15 @@ PrimitiveString* js_string(VM& vm, String string)
     return js_string(vm.heap(), move(string));
 }
 
+PrimitiveString* js_rope_string(VM& vm, PrimitiveString& lhs, PrimitiveString& rhs)
+{
+    // NOTE: There is no need for a rope if either side is empty.
+    if (lhs.is_empty())
+        return &rhs;
+    if (rhs.is_empty())
+        return &lhs;
+
+    return vm.heap().allocate_without_global_object<PrimitiveString>(lhs, rhs);
+}
+
 }
@@ -5,8 +5,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BitCast.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Checked.h>
 #include <AK/Function.h>
+#include <AK/SIMD.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf16View.h>
 #include <LibJS/Heap/Heap.h>
@@ -44,20 +47,6 @@ static ThrowCompletionOr<Utf16String> utf16_string_from(VM& vm, GlobalObject& gl
     return TRY(this_value.to_utf16_string(global_object));
 }
 
-// 22.1.3.21.1 SplitMatch ( S, q, R ), https://tc39.es/ecma262/#sec-splitmatch
-static Optional<size_t> split_match(Utf16View const& haystack, size_t start, Utf16View const& needle)
-{
-    auto r = needle.length_in_code_units();
-    auto s = haystack.length_in_code_units();
-    if (start + r > s)
-        return {};
-    for (size_t i = 0; i < r; ++i) {
-        if (haystack.code_unit_at(start + i) != needle.code_unit_at(i))
-            return {};
-    }
-    return start + r;
-}
-
 // 11.1.4 CodePointAt ( string, position ), https://tc39.es/ecma262/#sec-codepointat
 CodePoint code_point_at(Utf16View const& string, size_t position)
 {
@@ -81,6 +70,34 @@ CodePoint code_point_at(Utf16View const& string, size_t position)
     return { false, code_point, 2 };
 }
 
+// Finds the first occurrence of a code unit in [from_index, end_index), comparing eight code units at a time.
+static Optional<size_t> find_code_unit(u16 const* code_units, size_t from_index, size_t end_index, u16 code_unit)
+{
+    using AK::SIMD::u16x8;
+    using AK::SIMD::u64x2;
+
+    auto const needle = u16x8 { code_unit, code_unit, code_unit, code_unit, code_unit, code_unit, code_unit, code_unit };
+
+    size_t index = from_index;
+    for (; index + 8 <= end_index; index += 8) {
+        u16x8 block;
+        __builtin_memcpy(&block, code_units + index, sizeof(block));
+
+        // Every matching code unit sets all 16 bits of its lane.
+        auto matches = bit_cast<u64x2>(block == needle);
+        if (matches[0] != 0)
+            return index + count_trailing_zeroes(matches[0]) / 16;
+        if (matches[1] != 0)
+            return index + 4 + count_trailing_zeroes(matches[1]) / 16;
+    }
+    for (; index < end_index; ++index) {
+        if (code_units[index] == code_unit)
+            return index;
+    }
+
+    return {};
+}
+
 // 6.1.4.1 StringIndexOf ( string, searchValue, fromIndex ), https://tc39.es/ecma262/#sec-stringindexof
 static Optional<size_t> string_index_of(Utf16View const& string, Utf16View const& search_value, size_t from_index)
 {
@@ -93,9 +110,17 @@ static Optional<size_t> string_index_of(Utf16View const& string, Utf16View const
     if (search_length > string_length)
         return {};
 
-    for (size_t i = from_index; i <= string_length - search_length; ++i) {
-        auto candidate = string.substring_view(i, search_length);
-        if (candidate == search_value)
+    // NOTE: Instead of comparing the search value at every position, we look for its first code unit and only compare the
+    //       remaining code units where that occurs.
+    auto const* code_units = string.data();
+    auto const* search_code_units = search_value.data();
+    auto last_index = string_length - search_length;
+    for (size_t i = from_index; i <= last_index; ++i) {
+        auto candidate = find_code_unit(code_units, i, last_index + 1, search_code_units[0]);
+        if (!candidate.has_value())
+            return {};
+        i = *candidate;
+        if (__builtin_memcmp(code_units + i + 1, search_code_units + 1, (search_length - 1) * sizeof(u16)) == 0)
             return i;
     }
 
@@ -679,8 +704,14 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::split)
     size_t start = 0;      // 'p' in the spec.
     auto position = start; // 'q' in the spec.
     while (position != string_length) {
-        auto match = split_match(string.view(), position, separator.view()); // 'e' in the spec.
-        if (!match.has_value() || match.value() == start) {
+        // NOTE: Rather than trying SplitMatch at every position, we skip straight to the next occurrence of the separator.
+        auto next_position = string_index_of(string.view(), separator.view(), position);
+        if (!next_position.has_value())
+            break;
+        position = *next_position;
+
+        auto match = position + separator_length; // 'e' in the spec.
+        if (match == start) {
             ++position;
             continue;
         }
@@ -690,7 +721,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::split)
         ++array_length;
         if (array_length == limit)
             return array;
-        start = match.value();
+        start = match;
         position = start;
     }
 
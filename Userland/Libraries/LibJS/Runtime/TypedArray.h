@@ -57,6 +57,11 @@ public:
     // 25.1.2.13 GetModifySetValueInBuffer ( arrayBuffer, byteIndex, type, value, op [ , isLittleEndian ] ), https://tc39.es/ecma262/#sec-getmodifysetvalueinbuffer
     virtual Value get_modify_set_value_in_buffer(size_t byte_index, Value value, ReadWriteModifyFunction operation, bool is_little_endian = true) = 0;
 
+    // Fast paths for %TypedArray%.prototype methods that work on the raw elements instead of going through a Value for each of them.
+    // The buffer must not be detached.
+    virtual void fill_elements(u32 start, u32 end, Value value) = 0;
+    virtual Optional<u32> index_of_number(double value, u32 start, bool nan_matches_nan) const = 0;
+
 protected:
     explicit TypedArrayBase(Object& prototype)
         : Object(prototype)
@@ -172,6 +177,29 @@ inline ThrowCompletionOr<void> integer_indexed_element_set(TypedArrayBase& typed
     return {};
 }
 
+// Finds the first element that matches the predicate. Elements are tested a block at a time without any early exits,
+// which allows the compiler to vectorize the comparisons.
+template<typename T, typename Predicate>
+static Optional<size_t> find_first_element(Span<T const> elements, Predicate predicate)
+{
+    constexpr size_t block_size = 64 / sizeof(T);
+
+    auto const* data = elements.data();
+    size_t index = 0;
+    for (; index + block_size <= elements.size(); index += block_size) {
+        bool found = false;
+        for (size_t i = 0; i < block_size; ++i)
+            found |= predicate(data[index + i]);
+        if (found)
+            break;
+    }
+    for (; index < elements.size(); ++index) {
+        if (predicate(data[index]))
+            return index;
+    }
+    return {};
+}
+
 template<typename T>
 class TypedArray : public TypedArrayBase {
     JS_OBJECT(TypedArray, TypedArrayBase);
@@ -450,6 +478,64 @@ public:
     void set_value_in_buffer(size_t byte_index, Value value, ArrayBuffer::Order order, bool is_little_endian = true) override { viewed_array_buffer()->template set_value<T>(byte_index, value, true, order, is_little_endian); }
     Value get_modify_set_value_in_buffer(size_t byte_index, Value value, ReadWriteModifyFunction operation, bool is_little_endian = true) override { return viewed_array_buffer()->template get_modify_set_value<T>(byte_index, value, move(operation), is_little_endian); }
 
+    virtual void fill_elements(u32 start, u32 end, Value value) override
+    {
+        VERIFY(!m_viewed_array_buffer->is_detached());
+
+        // The value is only converted to the element type once, which is exactly what SetValueInBuffer would do for every element.
+        auto raw_bytes = numeric_to_raw_bytes<T>(global_object(), value, true);
+        UnderlyingBufferDataType raw_value;
+        __builtin_memcpy(&raw_value, raw_bytes.data(), sizeof(raw_value));
+
+        data().slice(start, end - start).fill(raw_value);
+    }
+
+    virtual Optional<u32> index_of_number(double value, u32 start, bool nan_matches_nan) const override
+    {
+        VERIFY(!m_viewed_array_buffer->is_detached());
+        VERIFY(m_content_type == ContentType::Number);
+
+        if constexpr (IsSame<UnderlyingBufferDataType, i64> || IsSame<UnderlyingBufferDataType, u64>) {
+            VERIFY_NOT_REACHED();
+        } else {
+            if (start >= m_array_length)
+                return {};
+            auto elements = data().slice(start);
+
+            auto to_index = [&](Optional<size_t> index) -> Optional<u32> {
+                if (!index.has_value())
+                    return {};
+                return static_cast<u32>(start + *index);
+            };
+
+            if (__builtin_isnan(value)) {
+                if constexpr (IsFloatingPoint<UnderlyingBufferDataType>) {
+                    if (nan_matches_nan)
+                        return to_index(find_first_element(elements, [](auto element) { return element != element; }));
+                }
+                return {};
+            }
+
+            // An element can only be equal to a value that is exactly representable in the element type.
+            if constexpr (IsIntegral<UnderlyingBufferDataType>) {
+                if (value < NumericLimits<UnderlyingBufferDataType>::min() || value > NumericLimits<UnderlyingBufferDataType>::max() || trunc(value) != value)
+                    return {};
+            } else {
+                if (static_cast<double>(static_cast<UnderlyingBufferDataType>(value)) != value)
+                    return {};
+            }
+            auto raw_value = static_cast<UnderlyingBufferDataType>(value);
+
+            if constexpr (sizeof(UnderlyingBufferDataType) == 1) {
+                auto const* match = static_cast<UnderlyingBufferDataType const*>(__builtin_memchr(elements.data(), raw_value, elements.size()));
+                if (!match)
+                    return {};
+                return to_index(match - elements.data());
+            }
+            return to_index(find_first_element(elements, [raw_value](auto element) { return element == raw_value; }));
+        }
+    }
+
 protected:
     TypedArray(Object& prototype, u32 array_length, ArrayBuffer& array_buffer)
         : TypedArrayBase(prototype)
@@ -248,8 +248,9 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::fill)
     if (typed_array->viewed_array_buffer()->is_detached())
         return vm.throw_completion<TypeError>(global_object, ErrorType::DetachedArrayBuffer);
 
-    for (; k < final; ++k)
-        TRY(typed_array->set(k, value, Object::ShouldThrowExceptions::Yes));
+    // NOTE: The value has already been converted, so setting the elements one by one has no observable side effects.
+    if (k < final)
+        typed_array->fill_elements(k, final, value);
 
     return typed_array;
 }
@@ -348,6 +349,15 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::includes)
     }
 
     auto search_element = vm.argument(0);
+
+    // NOTE: A Number typed array only contains Numbers, so they can be compared without creating a Value for each element.
+    //       A buffer that was detached by the conversions above is left to the generic loop, where every element is undefined.
+    if (typed_array->content_type() == TypedArrayBase::ContentType::Number && !typed_array->viewed_array_buffer()->is_detached()) {
+        if (!search_element.is_number())
+            return Value(false);
+        return Value(typed_array->index_of_number(search_element.as_double(), k, true).has_value());
+    }
+
     for (; k < length; ++k) {
         auto element_k = MUST(typed_array->get(k));
 
@@ -387,6 +397,15 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::index_of)
     }
 
     auto search_element = vm.argument(0);
+
+    // NOTE: A Number typed array only contains Numbers, so they can be compared without creating a Value for each element.
+    if (typed_array->content_type() == TypedArrayBase::ContentType::Number && !typed_array->viewed_array_buffer()->is_detached()) {
+        if (!search_element.is_number())
+            return Value(-1);
+        auto index = typed_array->index_of_number(search_element.as_double(), k, false);
+        return index.has_value() ? Value(*index) : Value(-1);
+    }
+
     for (; k < length; ++k) {
         auto k_present = MUST(typed_array->has_property(k));
         if (k_present) {
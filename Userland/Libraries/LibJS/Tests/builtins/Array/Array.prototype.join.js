@@ -15,6 +15,20 @@ test("basic functionality", () => {
     expect(Array(3).join()).toBe(",,");
 });
 
+test("elements are read with [[Get]]", () => {
+    const a = [1, 2, , 4];
+    Object.defineProperty(a, 1, { get: () => "getter" });
+    Array.prototype[2] = "inherited";
+    try {
+        expect(a.join()).toBe("1,getter,inherited,4");
+    } finally {
+        delete Array.prototype[2];
+    }
+
+    const b = [{ toString: () => ((b[2] = "changed"), "first") }, 2, 3];
+    expect(b.join()).toBe("first,2,changed");
+});
+
 test("circular references", () => {
     const a = ["foo", [], [1, 2, []], ["bar"]];
     a[1] = a;
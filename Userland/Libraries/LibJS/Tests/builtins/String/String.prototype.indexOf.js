@@ -22,6 +22,20 @@ test("basic functionality", () => {
     expect(s.indexOf("e", 2)).toBe(9);
 });
 
+test("long strings", () => {
+    var s = "abcdefgh".repeat(100) + "needle" + "abcdefgh".repeat(100);
+
+    expect(s.indexOf("needle")).toBe(800);
+    expect(s.indexOf("needle", 800)).toBe(800);
+    expect(s.indexOf("needle", 801)).toBe(-1);
+    expect(s.indexOf("needles")).toBe(-1);
+    expect(s.indexOf("habc")).toBe(7);
+    expect(s.indexOf("hn")).toBe(799);
+    expect(s.indexOf("h", 1599)).toBe(1605);
+    expect(s.indexOf("h", 806)).toBe(813);
+    expect(s.indexOf("h", 1606)).toBe(-1);
+});
+
 test("UTF-16", () => {
     var s = "😀";
     expect(s.indexOf("😀")).toBe(0);
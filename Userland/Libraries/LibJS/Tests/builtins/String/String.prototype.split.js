@@ -27,6 +27,20 @@ test("basic functionality", () => {
     expect(",a,b,,,c,d,".split(",,")).toEqual([",a,b", ",c,d,"]);
 });
 
+test("long strings", () => {
+    var s = "abcdefgh".repeat(50);
+    var parts = s.split("h");
+    expect(parts).toHaveLength(51);
+    expect(parts[0]).toBe("abcdefg");
+    expect(parts[49]).toBe("abcdefg");
+    expect(parts[50]).toBe("");
+
+    parts = s.split("habc", 3);
+    expect(parts).toEqual(["abcdefg", "defg", "defg"]);
+
+    expect(s.split("hh")).toEqual([s]);
+});
+
 test("limits", () => {
     expect("a b c d".split(" ", 0)).toEqual([]);
     expect("a b c d".split(" ", 1)).toEqual(["a"]);
@@ -55,3 +55,27 @@ test("basic functionality", () => {
         expect(typedArray[2]).toBe(0n);
     });
 });
+
+test("value is converted to the element type", () => {
+    const expected = {
+        Uint8Array: 44,
+        Uint8ClampedArray: 255,
+        Uint16Array: 300,
+        Uint32Array: 300,
+        Int8Array: 44,
+        Int16Array: 300,
+        Int32Array: 300,
+        Float32Array: 300.5,
+        Float64Array: 300.5,
+    };
+
+    TYPED_ARRAYS.forEach(T => {
+        const typedArray = new T(100);
+        expect(typedArray.fill(300.5, 1, -1)).toBe(typedArray);
+
+        expect(typedArray[0]).toBe(0);
+        expect(typedArray[1]).toBe(expected[T.name]);
+        expect(typedArray[98]).toBe(expected[T.name]);
+        expect(typedArray[99]).toBe(0);
+    });
+});
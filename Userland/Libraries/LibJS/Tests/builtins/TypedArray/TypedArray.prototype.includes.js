@@ -42,3 +42,15 @@ test("basic functionality", () => {
         expect(typedArray.includes(2n, -2)).toBe(true);
     });
 });
+
+test("NaN is found in floating point arrays", () => {
+    [Float32Array, Float64Array].forEach(T => {
+        const typedArray = new T(100);
+        expect(typedArray.includes(NaN)).toBe(false);
+
+        typedArray[98] = NaN;
+        expect(typedArray.includes(NaN)).toBe(true);
+        expect(typedArray.includes(NaN, 99)).toBe(false);
+        expect(typedArray.indexOf(NaN)).toBe(-1);
+    });
+});
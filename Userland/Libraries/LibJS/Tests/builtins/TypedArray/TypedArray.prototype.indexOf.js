@@ -42,3 +42,24 @@ test("basic functionality", () => {
         expect(typedArray.indexOf(2n, -2)).toBe(1);
     });
 });
+
+test("values that cannot be stored in the array are never found", () => {
+    TYPED_ARRAYS.forEach(T => {
+        const typedArray = new T(100);
+        typedArray[99] = 1;
+
+        expect(typedArray.indexOf(1)).toBe(99);
+        expect(typedArray.indexOf(1, 99)).toBe(99);
+        expect(typedArray.indexOf(1, 100)).toBe(-1);
+        expect(typedArray.indexOf(-0)).toBe(0);
+        expect(typedArray.indexOf(NaN)).toBe(-1);
+        expect(typedArray.indexOf(257)).toBe(-1);
+        expect(typedArray.indexOf(1.5)).toBe(-1);
+        expect(typedArray.indexOf("1")).toBe(-1);
+        expect(typedArray.indexOf(1n)).toBe(-1);
+    });
+
+    const floats = new Float32Array([0.1, 0.5]);
+    expect(floats.indexOf(0.1)).toBe(-1);
+    expect(floats.indexOf(0.5)).toBe(1);
+});
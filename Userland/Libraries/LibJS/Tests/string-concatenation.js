@@ -28,3 +28,37 @@ test("adding strings with dangling surrogates", () => {
     expect("\ud834a" + "\udf06").toBe("\ud834a\udf06");
     expect("\ud834" + "a\udf06").toBe("\ud834a\udf06");
 });
+
+test("adding strings many times", () => {
+    let s = "";
+    for (let i = 0; i < 100000; ++i) s += "x";
+    expect(s.length).toBe(100000);
+    expect(s[99999]).toBe("x");
+    expect(s).toBe("x".repeat(100000));
+
+    let t = "";
+    for (let i = 0; i < 1000; ++i) t = i + t;
+    expect(t.startsWith("999998997")).toBeTrue();
+    expect(t.endsWith("210")).toBeTrue();
+});
+
+test("adding strings with surrogate pairs split across many strings", () => {
+    const high = "\ud83d";
+    const low = "\ude00";
+    expect(high + low).toBe("😀");
+    expect((high + low).codePointAt(0)).toBe(0x1f600);
+    expect(("x" + high + (low + "y")).length).toBe(4);
+    expect(("é" + high + low).codePointAt(1)).toBe(0x1f600);
+
+    let s = "";
+    for (let i = 0; i < 5; ++i) s += high + low;
+    expect(s).toBe("😀😀😀😀😀");
+    expect(Array.from(s).length).toBe(5);
+});
+
+test("adding strings used as property keys", () => {
+    const o = {};
+    o["a" + "b"] = 1;
+    expect(o.ab).toBe(1);
+    expect("a" + "b" in o).toBeTrue();
+});
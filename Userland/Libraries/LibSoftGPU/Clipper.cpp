@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/Vector.h>
 #include <LibGPU/Vertex.h>
 #include <LibGfx/Vector4.h>
@@ -91,8 +92,23 @@ FLATTEN static constexpr void clip_plane(Vector<GPU::Vertex>& input_list, Vector
     }
 }
 
+static constexpr bool point_within_frustum(FloatVector4 const& vertex)
+{
+    return point_within_clip_plane<Clipper::ClipPlane::LEFT>(vertex)
+        && point_within_clip_plane<Clipper::ClipPlane::RIGHT>(vertex)
+        && point_within_clip_plane<Clipper::ClipPlane::TOP>(vertex)
+        && point_within_clip_plane<Clipper::ClipPlane::BOTTOM>(vertex)
+        && point_within_clip_plane<Clipper::ClipPlane::NEAR>(vertex)
+        && point_within_clip_plane<Clipper::ClipPlane::FAR>(vertex);
+}
+
 void Clipper::clip_triangle_against_frustum(Vector<GPU::Vertex>& input_verts)
 {
+    // Most triangles lie entirely within the frustum. Clipping those against all six planes would only
+    // rotate their vertices six times over, which for a triangle leaves them exactly where they started.
+    if (all_of(input_verts, [](auto const& vertex) { return point_within_frustum(vertex.clip_coordinates); }))
+        return;
+
     // FIXME C++23. Static reflection will provide looping over all enum values.
     clip_plane<ClipPlane::LEFT>(input_verts, m_vertex_buffer);
     clip_plane<ClipPlane::RIGHT>(m_vertex_buffer, input_verts);
@@ -20,6 +20,19 @@ static constexpr bool ENABLE_STATISTICS_OVERLAY = false;
 static constexpr int MILLISECONDS_PER_STATISTICS_PERIOD = 500;
 static constexpr int NUM_LIGHTS = 8;
 
+// Triangles are binned into square tiles of this many pixels, which are rasterized in parallel. This must be a multiple
+// of 2, so that pixel quads never straddle two tiles.
+static constexpr int RASTERIZER_TILE_SIZE = 64;
+// Draw calls whose triangles cover fewer pixels than this are rasterized on the calling thread, since handing them off
+// to the rasterizer threads costs more than it saves.
+static constexpr int MINIMUM_PIXELS_FOR_PARALLEL_RASTERIZATION = 4 * RASTERIZER_TILE_SIZE * RASTERIZER_TILE_SIZE;
+
+// Image texels are stored in square blocks of this many texels per side instead of in linear rows, so that the texels
+// sampled for neighbouring fragments are usually close together in memory. A block of 4x4 BGRA8888 texels fills exactly
+// one 64-byte cache line.
+static constexpr unsigned IMAGE_BLOCK_SIZE_LOG2 = 2;
+static constexpr unsigned IMAGE_BLOCK_SIZE = 1u << IMAGE_BLOCK_SIZE_LOG2;
+
 // See: https://www.khronos.org/opengl/wiki/Common_Mistakes#Texture_edge_color_problem
 // FIXME: make this dynamically configurable through ConfigServer
 static constexpr bool CLAMP_DEPRECATED_BEHAVIOR = false;
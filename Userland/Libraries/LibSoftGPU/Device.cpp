@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/Error.h>
 #include <AK/Math.h>
 #include <AK/NumericLimits.h>
@@ -23,13 +24,15 @@
 
 namespace SoftGPU {
 
-static long long g_num_rasterized_triangles;
-static long long g_num_pixels;
-static long long g_num_pixels_shaded;
-static long long g_num_pixels_blended;
-static long long g_num_sampler_calls;
-static long long g_num_stencil_writes;
-static long long g_num_quads;
+// The tiles of a draw call are rasterized on several threads, which all add to these.
+using StatisticsCounter = Atomic<long long, AK::MemoryOrder::memory_order_relaxed>;
+static StatisticsCounter g_num_rasterized_triangles;
+static StatisticsCounter g_num_pixels;
+static StatisticsCounter g_num_pixels_shaded;
+static StatisticsCounter g_num_pixels_blended;
+static StatisticsCounter g_num_sampler_calls;
+static StatisticsCounter g_num_stencil_writes;
+static StatisticsCounter g_num_quads;
 
 using AK::SIMD::any;
 using AK::SIMD::exp;
@@ -176,14 +179,82 @@ void Device::setup_blend_factors()
     }
 }
 
-void Device::rasterize_triangle(Triangle const& triangle)
+void Device::rasterize_triangles()
 {
-    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
+    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, m_processed_triangles.size());
 
     // Return if alpha testing is a no-op
     if (m_options.enable_alpha_test && m_options.alpha_test_func == GPU::AlphaTestFunction::Never)
         return;
 
+    auto render_bounds = m_frame_buffer->rect();
+    if (m_options.scissor_enabled)
+        render_bounds.intersect(m_options.scissor_box);
+    if (m_processed_triangles.is_empty() || render_bounds.is_empty())
+        return;
+
+    m_triangle_bounds.clear_with_capacity();
+    size_t covered_pixels = 0;
+    for (auto const& triangle : m_processed_triangles) {
+        auto const& v0 = triangle.vertices[0].window_coordinates;
+        auto const& v1 = triangle.vertices[1].window_coordinates;
+        auto const& v2 = triangle.vertices[2].window_coordinates;
+        auto const left = static_cast<int>(floorf(min(min(v0.x(), v1.x()), v2.x())));
+        auto const top = static_cast<int>(floorf(min(min(v0.y(), v1.y()), v2.y())));
+        auto const right = static_cast<int>(ceilf(max(max(v0.x(), v1.x()), v2.x())));
+        auto const bottom = static_cast<int>(ceilf(max(max(v0.y(), v1.y()), v2.y())));
+        auto bounds = Gfx::IntRect::from_two_points({ left, top }, { right + 1, bottom + 1 }).intersected(render_bounds);
+        covered_pixels += bounds.size().area();
+        m_triangle_bounds.append(bounds);
+    }
+
+    if (covered_pixels >= MINIMUM_PIXELS_FOR_PARALLEL_RASTERIZATION && !m_rasterizer_threads)
+        m_rasterizer_threads = make<Threading::ThreadPool>(0, "SoftGPU"sv);
+
+    if (covered_pixels < MINIMUM_PIXELS_FOR_PARALLEL_RASTERIZATION || m_rasterizer_threads->thread_count() < 2) {
+        for (auto const& triangle : m_processed_triangles)
+            rasterize_triangle(triangle, render_bounds);
+        return;
+    }
+
+    // Sort the triangles into the tiles that their bounds overlap. Every tile keeps the triangles in the order in which
+    // they were drawn, and owns the color, depth and stencil values of its pixels, so the tiles can be rasterized in
+    // parallel with the same result as rasterizing the triangles one after another.
+    auto const frame_buffer_size = m_frame_buffer->rect().size();
+    auto const tile_columns = ceil_div(frame_buffer_size.width(), RASTERIZER_TILE_SIZE);
+    auto const tile_rows = ceil_div(frame_buffer_size.height(), RASTERIZER_TILE_SIZE);
+    m_tile_bins.resize(tile_columns * tile_rows);
+    for (auto& bin : m_tile_bins)
+        bin.clear_with_capacity();
+
+    for (size_t i = 0; i < m_processed_triangles.size(); ++i) {
+        auto const& bounds = m_triangle_bounds[i];
+        if (bounds.is_empty())
+            continue;
+        for (int row = bounds.top() / RASTERIZER_TILE_SIZE; row <= bounds.bottom() / RASTERIZER_TILE_SIZE; ++row) {
+            for (int column = bounds.left() / RASTERIZER_TILE_SIZE; column <= bounds.right() / RASTERIZER_TILE_SIZE; ++column)
+                m_tile_bins[row * tile_columns + column].append(i);
+        }
+    }
+
+    for (int row = 0; row < tile_rows; ++row) {
+        for (int column = 0; column < tile_columns; ++column) {
+            auto const& bin = m_tile_bins[row * tile_columns + column];
+            if (bin.is_empty())
+                continue;
+
+            Gfx::IntRect tile_rect { column * RASTERIZER_TILE_SIZE, row * RASTERIZER_TILE_SIZE, RASTERIZER_TILE_SIZE, RASTERIZER_TILE_SIZE };
+            m_rasterizer_threads->submit([this, &bin, tile_bounds = tile_rect.intersected(render_bounds)] {
+                for (auto index : bin)
+                    rasterize_triangle(m_processed_triangles[index], tile_bounds);
+            });
+        }
+    }
+    m_rasterizer_threads->wait();
+}
+
+void Device::rasterize_triangle(Triangle const& triangle, Gfx::IntRect const& render_bounds)
+{
     // Vertices
     GPU::Vertex const& vertex0 = triangle.vertices[0];
     GPU::Vertex const& vertex1 = triangle.vertices[1];
@@ -197,10 +268,6 @@ void Device::rasterize_triangle(Triangle const& triangle)
     auto const area = edge_function(v0, v1, v2);
     auto const one_over_area = 1.0f / area;
 
-    auto render_bounds = m_frame_buffer->rect();
-    if (m_options.scissor_enabled)
-        render_bounds.intersect(m_options.scissor_box);
-
     // This function calculates the 3 edge values for the pixel relative to the triangle.
     auto calculate_edge_values4 = [v0, v1, v2](Vector2<f32x4> const& p) -> Vector3<f32x4> {
         return {
@@ -658,69 +725,201 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
     m_triangle_list.clear_with_capacity();
     m_processed_triangles.clear_with_capacity();
 
+    if (vertices.size() < (primitive_type == GPU::PrimitiveType::Quads ? 4u : 3u))
+        return;
+
+    // Set up normals transform by taking the upper left 3x3 elements from the model view matrix
+    // See section 2.11.3 of the OpenGL 1.5 spec
+    auto normal_transform = model_view_transform.submatrix_from_topleft<3>().transpose().inverse();
+
+    // Transform and light each vertex exactly once, since quads, fans and strips share vertices between their triangles
+    m_transformed_vertices.clear_with_capacity();
+    m_transformed_vertices.ensure_capacity(vertices.size());
+    for (auto const& input_vertex : vertices) {
+        m_transformed_vertices.unchecked_append(input_vertex);
+        auto& vertex = m_transformed_vertices.last();
+
+        // Transform vertices into eye coordinates using the model-view transform
+        vertex.eye_coordinates = model_view_transform * vertex.position;
+
+        // Transform normals before use in lighting
+        vertex.normal = normal_transform * vertex.normal;
+        if (m_options.normalization_enabled)
+            vertex.normal.normalize();
+
+        // Calculate per-vertex lighting
+        if (m_options.lighting_enabled) {
+            auto const& material = m_materials.at(0);
+            auto ambient = material.ambient;
+            auto diffuse = material.diffuse;
+            auto emissive = material.emissive;
+            auto specular = material.specular;
+
+            if (m_options.color_material_enabled
+                && (m_options.color_material_face == GPU::ColorMaterialFace::Front || m_options.color_material_face == GPU::ColorMaterialFace::FrontAndBack)) {
+                switch (m_options.color_material_mode) {
+                case GPU::ColorMaterialMode::Ambient:
+                    ambient = vertex.color;
+                    break;
+                case GPU::ColorMaterialMode::AmbientAndDiffuse:
+                    ambient = vertex.color;
+                    diffuse = vertex.color;
+                    break;
+                case GPU::ColorMaterialMode::Diffuse:
+                    diffuse = vertex.color;
+                    break;
+                case GPU::ColorMaterialMode::Emissive:
+                    emissive = vertex.color;
+                    break;
+                case GPU::ColorMaterialMode::Specular:
+                    specular = vertex.color;
+                    break;
+                }
+            }
+
+            FloatVector4 result_color = emissive + (ambient * m_lighting_model.scene_ambient_color);
+
+            for (auto const& light : m_lights) {
+                if (!light.is_enabled)
+                    continue;
+
+                // We need to save the length here because the attenuation factor requires a non-normalized vector!
+                auto sgi_arrow_operator = [](FloatVector4 const& p1, FloatVector4 const& p2, float& output_length) {
+                    FloatVector3 light_vector;
+                    if ((p1.w() != 0.f) && (p2.w() == 0.f))
+                        light_vector = p2.xyz();
+                    else if ((p1.w() == 0.f) && (p2.w() != 0.f))
+                        light_vector = -p1.xyz();
+                    else
+                        light_vector = p2.xyz() - p1.xyz();
+
+                    output_length = light_vector.length();
+                    if (output_length == 0.f)
+                        return light_vector;
+                    return light_vector / output_length;
+                };
+
+                auto sgi_dot_operator = [](FloatVector3 const& d1, FloatVector3 const& d2) {
+                    return AK::max(d1.dot(d2), 0.0f);
+                };
+
+                float vertex_to_light_length = 0.f;
+                FloatVector3 vertex_to_light = sgi_arrow_operator(vertex.eye_coordinates, light.position, vertex_to_light_length);
+
+                // Light attenuation value.
+                float light_attenuation_factor = 1.0f;
+                if (light.position.w() != 0.0f)
+                    light_attenuation_factor = 1.0f / (light.constant_attenuation + (light.linear_attenuation * vertex_to_light_length) + (light.quadratic_attenuation * vertex_to_light_length * vertex_to_light_length));
+
+                // Spotlight factor
+                float spotlight_factor = 1.0f;
+                if (light.spotlight_cutoff_angle != 180.0f) {
+                    auto const vertex_to_light_dot_spotlight_direction = sgi_dot_operator(vertex_to_light, light.spotlight_direction.normalized());
+                    auto const cos_spotlight_cutoff = AK::cos<float>(light.spotlight_cutoff_angle * AK::Pi<float> / 180.f);
+
+                    if (vertex_to_light_dot_spotlight_direction >= cos_spotlight_cutoff)
+                        spotlight_factor = AK::pow<float>(vertex_to_light_dot_spotlight_direction, light.spotlight_exponent);
+                    else
+                        spotlight_factor = 0.0f;
+                }
+
+                // FIXME: The spec allows for splitting the colors calculated here into multiple different colors (primary/secondary color). Investigate what this means.
+                (void)m_lighting_model.color_control;
+
+                // FIXME: Two sided lighting should be implemented eventually (I believe this is where the normals are -ve and then lighting is calculated with the BACK material)
+                (void)m_lighting_model.two_sided_lighting;
+
+                // Ambient
+                auto const ambient_component = ambient * light.ambient_intensity;
+
+                // Diffuse
+                auto const normal_dot_vertex_to_light = sgi_dot_operator(vertex.normal, vertex_to_light);
+                auto const diffuse_component = diffuse * light.diffuse_intensity * normal_dot_vertex_to_light;
+
+                // Specular
+                FloatVector4 specular_component = { 0.0f, 0.0f, 0.0f, 0.0f };
+                if (normal_dot_vertex_to_light > 0.0f) {
+                    FloatVector3 half_vector_normalized;
+                    if (!m_lighting_model.viewer_at_infinity) {
+                        half_vector_normalized = vertex_to_light + FloatVector3(0.0f, 0.0f, 1.0f);
+                    } else {
+                        auto const vertex_to_eye_point = sgi_arrow_operator(vertex.eye_coordinates, { 0.f, 0.f, 0.f, 1.f }, vertex_to_light_length);
+                        half_vector_normalized = vertex_to_light + vertex_to_eye_point;
+                    }
+                    half_vector_normalized.normalize();
+
+                    auto const normal_dot_half_vector = sgi_dot_operator(vertex.normal, half_vector_normalized);
+                    auto const specular_coefficient = AK::pow(normal_dot_half_vector, material.shininess);
+                    specular_component = specular * light.specular_intensity * specular_coefficient;
+                }
+
+                auto color = ambient_component + diffuse_component + specular_component;
+                color = color * light_attenuation_factor * spotlight_factor;
+                result_color += color;
+            }
+
+            vertex.color = result_color;
+            vertex.color.set_w(diffuse.w()); // OpenGL 1.5 spec, page 59: "The A produced by lighting is the alpha value associated with diffuse color material"
+            vertex.color.clamp(0.0f, 1.0f);
+        }
+
+        // Transform eye coordinates into clip coordinates using the projection transform
+        vertex.clip_coordinates = projection_transform * vertex.eye_coordinates;
+    }
+
     // Let's construct some triangles
     if (primitive_type == GPU::PrimitiveType::Triangles) {
         Triangle triangle;
-        if (vertices.size() < 3)
-            return;
-        for (size_t i = 0; i < vertices.size() - 2; i += 3) {
-            triangle.vertices[0] = vertices.at(i);
-            triangle.vertices[1] = vertices.at(i + 1);
-            triangle.vertices[2] = vertices.at(i + 2);
+        for (size_t i = 0; i < m_transformed_vertices.size() - 2; i += 3) {
+            triangle.vertices[0] = m_transformed_vertices.at(i);
+            triangle.vertices[1] = m_transformed_vertices.at(i + 1);
+            triangle.vertices[2] = m_transformed_vertices.at(i + 2);
 
             m_triangle_list.append(triangle);
         }
     } else if (primitive_type == GPU::PrimitiveType::Quads) {
         // We need to construct two triangles to form the quad
         Triangle triangle;
-        if (vertices.size() < 4)
-            return;
-        for (size_t i = 0; i < vertices.size() - 3; i += 4) {
+        for (size_t i = 0; i < m_transformed_vertices.size() - 3; i += 4) {
             // Triangle 1
-            triangle.vertices[0] = vertices.at(i);
-            triangle.vertices[1] = vertices.at(i + 1);
-            triangle.vertices[2] = vertices.at(i + 2);
+            triangle.vertices[0] = m_transformed_vertices.at(i);
+            triangle.vertices[1] = m_transformed_vertices.at(i + 1);
+            triangle.vertices[2] = m_transformed_vertices.at(i + 2);
             m_triangle_list.append(triangle);
 
             // Triangle 2
-            triangle.vertices[0] = vertices.at(i + 2);
-            triangle.vertices[1] = vertices.at(i + 3);
-            triangle.vertices[2] = vertices.at(i);
+            triangle.vertices[0] = m_transformed_vertices.at(i + 2);
+            triangle.vertices[1] = m_transformed_vertices.at(i + 3);
+            triangle.vertices[2] = m_transformed_vertices.at(i);
             m_triangle_list.append(triangle);
         }
     } else if (primitive_type == GPU::PrimitiveType::TriangleFan) {
         Triangle triangle;
-        triangle.vertices[0] = vertices.at(0); // Root vertex is always the vertex defined first
+        triangle.vertices[0] = m_transformed_vertices.at(0); // Root vertex is always the vertex defined first
 
         // This is technically `n-2` triangles. We start at index 1
-        for (size_t i = 1; i < vertices.size() - 1; i++) {
-            triangle.vertices[1] = vertices.at(i);
-            triangle.vertices[2] = vertices.at(i + 1);
+        for (size_t i = 1; i < m_transformed_vertices.size() - 1; i++) {
+            triangle.vertices[1] = m_transformed_vertices.at(i);
+            triangle.vertices[2] = m_transformed_vertices.at(i + 1);
             m_triangle_list.append(triangle);
         }
     } else if (primitive_type == GPU::PrimitiveType::TriangleStrip) {
         Triangle triangle;
-        if (vertices.size() < 3)
-            return;
-        for (size_t i = 0; i < vertices.size() - 2; i++) {
+        for (size_t i = 0; i < m_transformed_vertices.size() - 2; i++) {
             if (i % 2 == 0) {
-                triangle.vertices[0] = vertices.at(i);
-                triangle.vertices[1] = vertices.at(i + 1);
-                triangle.vertices[2] = vertices.at(i + 2);
+                triangle.vertices[0] = m_transformed_vertices.at(i);
+                triangle.vertices[1] = m_transformed_vertices.at(i + 1);
+                triangle.vertices[2] = m_transformed_vertices.at(i + 2);
             } else {
-                triangle.vertices[0] = vertices.at(i + 1);
-                triangle.vertices[1] = vertices.at(i);
-                triangle.vertices[2] = vertices.at(i + 2);
+                triangle.vertices[0] = m_transformed_vertices.at(i + 1);
+                triangle.vertices[1] = m_transformed_vertices.at(i);
+                triangle.vertices[2] = m_transformed_vertices.at(i + 2);
             }
             m_triangle_list.append(triangle);
         }
     }
 
-    // Set up normals transform by taking the upper left 3x3 elements from the model view matrix
-    // See section 2.11.3 of the OpenGL 1.5 spec
-    auto normal_transform = model_view_transform.submatrix_from_topleft<3>().transpose().inverse();
-
-    // Now let's transform each triangle and send that to the GPU
+    // Now let's send each triangle to the GPU
     auto const viewport = m_options.viewport;
     auto const viewport_half_width = viewport.width() / 2.0f;
     auto const viewport_half_height = viewport.height() / 2.0f;
@@ -729,144 +928,6 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
     auto const depth_half_range = (m_options.depth_max - m_options.depth_min) / 2;
     auto const depth_halfway = (m_options.depth_min + m_options.depth_max) / 2;
     for (auto& triangle : m_triangle_list) {
-        // Transform vertices into eye coordinates using the model-view transform
-        triangle.vertices[0].eye_coordinates = model_view_transform * triangle.vertices[0].position;
-        triangle.vertices[1].eye_coordinates = model_view_transform * triangle.vertices[1].position;
-        triangle.vertices[2].eye_coordinates = model_view_transform * triangle.vertices[2].position;
-
-        // Transform normals before use in lighting
-        triangle.vertices[0].normal = normal_transform * triangle.vertices[0].normal;
-        triangle.vertices[1].normal = normal_transform * triangle.vertices[1].normal;
-        triangle.vertices[2].normal = normal_transform * triangle.vertices[2].normal;
-        if (m_options.normalization_enabled) {
-            triangle.vertices[0].normal.normalize();
-            triangle.vertices[1].normal.normalize();
-            triangle.vertices[2].normal.normalize();
-        }
-
-        // Calculate per-vertex lighting
-        if (m_options.lighting_enabled) {
-            auto const& material = m_materials.at(0);
-            for (auto& vertex : triangle.vertices) {
-                auto ambient = material.ambient;
-                auto diffuse = material.diffuse;
-                auto emissive = material.emissive;
-                auto specular = material.specular;
-
-                if (m_options.color_material_enabled
-                    && (m_options.color_material_face == GPU::ColorMaterialFace::Front || m_options.color_material_face == GPU::ColorMaterialFace::FrontAndBack)) {
-                    switch (m_options.color_material_mode) {
-                    case GPU::ColorMaterialMode::Ambient:
-                        ambient = vertex.color;
-                        break;
-                    case GPU::ColorMaterialMode::AmbientAndDiffuse:
-                        ambient = vertex.color;
-                        diffuse = vertex.color;
-                        break;
-                    case GPU::ColorMaterialMode::Diffuse:
-                        diffuse = vertex.color;
-                        break;
-                    case GPU::ColorMaterialMode::Emissive:
-                        emissive = vertex.color;
-                        break;
-                    case GPU::ColorMaterialMode::Specular:
-                        specular = vertex.color;
-                        break;
-                    }
-                }
-
-                FloatVector4 result_color = emissive + (ambient * m_lighting_model.scene_ambient_color);
-
-                for (auto const& light : m_lights) {
-                    if (!light.is_enabled)
-                        continue;
-
-                    // We need to save the length here because the attenuation factor requires a non-normalized vector!
-                    auto sgi_arrow_operator = [](FloatVector4 const& p1, FloatVector4 const& p2, float& output_length) {
-                        FloatVector3 light_vector;
-                        if ((p1.w() != 0.f) && (p2.w() == 0.f))
-                            light_vector = p2.xyz();
-                        else if ((p1.w() == 0.f) && (p2.w() != 0.f))
-                            light_vector = -p1.xyz();
-                        else
-                            light_vector = p2.xyz() - p1.xyz();
-
-                        output_length = light_vector.length();
-                        if (output_length == 0.f)
-                            return light_vector;
-                        return light_vector / output_length;
-                    };
-
-                    auto sgi_dot_operator = [](FloatVector3 const& d1, FloatVector3 const& d2) {
-                        return AK::max(d1.dot(d2), 0.0f);
-                    };
-
-                    float vertex_to_light_length = 0.f;
-                    FloatVector3 vertex_to_light = sgi_arrow_operator(vertex.eye_coordinates, light.position, vertex_to_light_length);
-
-                    // Light attenuation value.
-                    float light_attenuation_factor = 1.0f;
-                    if (light.position.w() != 0.0f)
-                        light_attenuation_factor = 1.0f / (light.constant_attenuation + (light.linear_attenuation * vertex_to_light_length) + (light.quadratic_attenuation * vertex_to_light_length * vertex_to_light_length));
-
-                    // Spotlight factor
-                    float spotlight_factor = 1.0f;
-                    if (light.spotlight_cutoff_angle != 180.0f) {
-                        auto const vertex_to_light_dot_spotlight_direction = sgi_dot_operator(vertex_to_light, light.spotlight_direction.normalized());
-                        auto const cos_spotlight_cutoff = AK::cos<float>(light.spotlight_cutoff_angle * AK::Pi<float> / 180.f);
-
-                        if (vertex_to_light_dot_spotlight_direction >= cos_spotlight_cutoff)
-                            spotlight_factor = AK::pow<float>(vertex_to_light_dot_spotlight_direction, light.spotlight_exponent);
-                        else
-                            spotlight_factor = 0.0f;
-                    }
-
-                    // FIXME: The spec allows for splitting the colors calculated here into multiple different colors (primary/secondary color). Investigate what this means.
-                    (void)m_lighting_model.color_control;
-
-                    // FIXME: Two sided lighting should be implemented eventually (I believe this is where the normals are -ve and then lighting is calculated with the BACK material)
-                    (void)m_lighting_model.two_sided_lighting;
-
-                    // Ambient
-                    auto const ambient_component = ambient * light.ambient_intensity;
-
-                    // Diffuse
-                    auto const normal_dot_vertex_to_light = sgi_dot_operator(vertex.normal, vertex_to_light);
-                    auto const diffuse_component = diffuse * light.diffuse_intensity * normal_dot_vertex_to_light;
-
-                    // Specular
-                    FloatVector4 specular_component = { 0.0f, 0.0f, 0.0f, 0.0f };
-                    if (normal_dot_vertex_to_light > 0.0f) {
-                        FloatVector3 half_vector_normalized;
-                        if (!m_lighting_model.viewer_at_infinity) {
-                            half_vector_normalized = vertex_to_light + FloatVector3(0.0f, 0.0f, 1.0f);
-                        } else {
-                            auto const vertex_to_eye_point = sgi_arrow_operator(vertex.eye_coordinates, { 0.f, 0.f, 0.f, 1.f }, vertex_to_light_length);
-                            half_vector_normalized = vertex_to_light + vertex_to_eye_point;
-                        }
-                        half_vector_normalized.normalize();
-
-                        auto const normal_dot_half_vector = sgi_dot_operator(vertex.normal, half_vector_normalized);
-                        auto const specular_coefficient = AK::pow(normal_dot_half_vector, material.shininess);
-                        specular_component = specular * light.specular_intensity * specular_coefficient;
-                    }
-
-                    auto color = ambient_component + diffuse_component + specular_component;
-                    color = color * light_attenuation_factor * spotlight_factor;
-                    result_color += color;
-                }
-
-                vertex.color = result_color;
-                vertex.color.set_w(diffuse.w()); // OpenGL 1.5 spec, page 59: "The A produced by lighting is the alpha value associated with diffuse color material"
-                vertex.color.clamp(0.0f, 1.0f);
-            }
-        }
-
-        // Transform eye coordinates into clip coordinates using the projection transform
-        triangle.vertices[0].clip_coordinates = projection_transform * triangle.vertices[0].eye_coordinates;
-        triangle.vertices[1].clip_coordinates = projection_transform * triangle.vertices[1].eye_coordinates;
-        triangle.vertices[2].clip_coordinates = projection_transform * triangle.vertices[2].eye_coordinates;
-
         // At this point, we're in clip space
         // Here's where we do the clipping. This is a really crude implementation of the
         // https://learnopengl.com/Getting-started/Coordinate-Systems
@@ -923,6 +984,7 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
         }
     }
 
+    size_t rasterized_triangle_count = 0;
     for (auto& triangle : m_processed_triangles) {
         // Let's calculate the (signed) area of the triangle
         // https://cp-algorithms.com/geometry/oriented-triangle-area.html
@@ -961,8 +1023,11 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
             triangle.vertices[2].tex_coords[i] = texture_transform * triangle.vertices[2].tex_coords[i];
         }
 
-        rasterize_triangle(triangle);
+        m_processed_triangles[rasterized_triangle_count++] = triangle;
     }
+    m_processed_triangles.shrink(rasterized_triangle_count);
+
+    rasterize_triangles();
 }
 
 ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
@@ -1163,15 +1228,15 @@ void Device::draw_statistics_overlay(Gfx::Bitmap& target)
         builder.append(String::formatted("Timings      : {:.1}ms {:.1}FPS\n",
             static_cast<double>(milliseconds) / frame_counter,
             (milliseconds > 0) ? 1000.0 * frame_counter / milliseconds : 9999.0));
-        builder.append(String::formatted("Triangles    : {}\n", g_num_rasterized_triangles));
+        builder.append(String::formatted("Triangles    : {}\n", g_num_rasterized_triangles.load()));
         builder.append(String::formatted("SIMD usage   : {}%\n", g_num_quads > 0 ? g_num_pixels_shaded * 25 / g_num_quads : 0));
         builder.append(String::formatted("Pixels       : {}, Stencil: {}%, Shaded: {}%, Blended: {}%, Overdraw: {}%\n",
-            g_num_pixels,
+            g_num_pixels.load(),
             g_num_pixels > 0 ? g_num_stencil_writes * 100 / g_num_pixels : 0,
             g_num_pixels > 0 ? g_num_pixels_shaded * 100 / g_num_pixels : 0,
             g_num_pixels_shaded > 0 ? g_num_pixels_blended * 100 / g_num_pixels_shaded : 0,
             num_rendertarget_pixels > 0 ? g_num_pixels_shaded * 100 / num_rendertarget_pixels - 100 : 0));
-        builder.append(String::formatted("Sampler calls: {}\n", g_num_sampler_calls));
+        builder.append(String::formatted("Sampler calls: {}\n", g_num_sampler_calls.load()));
 
         debug_string = builder.to_string();
 
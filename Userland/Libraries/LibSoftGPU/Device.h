@@ -9,6 +9,7 @@
 
 #include <AK/Array.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
 #include <LibGPU/Device.h>
@@ -37,6 +38,7 @@
 #include <LibSoftGPU/Config.h>
 #include <LibSoftGPU/Sampler.h>
 #include <LibSoftGPU/Triangle.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace SoftGPU {
 
@@ -78,7 +80,8 @@ private:
     void draw_statistics_overlay(Gfx::Bitmap&);
     Gfx::IntRect get_rasterization_rect_of_size(Gfx::IntSize size);
 
-    void rasterize_triangle(Triangle const& triangle);
+    void rasterize_triangles();
+    void rasterize_triangle(Triangle const& triangle, Gfx::IntRect const& render_bounds);
     void setup_blend_factors();
     void shade_fragments(PixelQuad&);
     bool test_alpha(PixelQuad&);
@@ -89,7 +92,11 @@ private:
     Clipper m_clipper;
     Vector<Triangle> m_triangle_list;
     Vector<Triangle> m_processed_triangles;
+    Vector<GPU::Vertex> m_transformed_vertices;
     Vector<GPU::Vertex> m_clipped_vertices;
+    Vector<Gfx::IntRect> m_triangle_bounds;
+    Vector<Vector<u32>> m_tile_bins;
+    OwnPtr<Threading::ThreadPool> m_rasterizer_threads;
     Array<Sampler, GPU::NUM_SAMPLERS> m_samplers;
     Vector<size_t> m_enabled_texture_units;
     AlphaBlendFactors m_alpha_blend_factors;
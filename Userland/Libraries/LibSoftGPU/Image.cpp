@@ -12,7 +12,6 @@ namespace SoftGPU {
 Image::Image(void* const ownership_token, unsigned width, unsigned height, unsigned depth, unsigned max_levels, unsigned layers)
     : GPU::Image(ownership_token)
     , m_num_layers(layers)
-    , m_mipmap_buffers(FixedArray<RefPtr<Typed3DBuffer<GPU::ColorType>>>::must_create_but_fixme_should_propagate_errors(layers * max_levels))
 {
     VERIFY(width > 0);
     VERIFY(height > 0);
@@ -26,8 +25,21 @@ Image::Image(void* const ownership_token, unsigned width, unsigned height, unsig
 
     unsigned level;
     for (level = 0; level < max_levels; ++level) {
-        for (unsigned layer = 0; layer < layers; ++layer)
-            m_mipmap_buffers[layer * layers + level] = MUST(Typed3DBuffer<GPU::ColorType>::try_create(width, height, depth));
+        VERIFY(level < m_levels.size());
+
+        auto blocks_per_row = (width + IMAGE_BLOCK_SIZE - 1) >> IMAGE_BLOCK_SIZE_LOG2;
+        auto blocks_per_column = (height + IMAGE_BLOCK_SIZE - 1) >> IMAGE_BLOCK_SIZE_LOG2;
+        auto slice_size = static_cast<size_t>(blocks_per_row) * blocks_per_column * IMAGE_BLOCK_SIZE * IMAGE_BLOCK_SIZE;
+
+        m_levels[level] = {
+            .offset = m_layer_size,
+            .slice_size = slice_size,
+            .width = width,
+            .height = height,
+            .depth = depth,
+            .blocks_per_row = blocks_per_row,
+        };
+        m_layer_size += slice_size * depth;
 
         if (width <= 1 && height <= 1 && depth <= 1)
             break;
@@ -37,7 +49,15 @@ Image::Image(void* const ownership_token, unsigned width, unsigned height, unsig
         depth = max(depth / 2, 1);
     }
 
-    m_num_levels = level + 1;
+    m_num_levels = min(level + 1, max_levels);
+
+    // Every block starts at a multiple of the block size, so aligning the start of the texel data to the block size in
+    // bytes ensures that no block straddles two cache lines.
+    constexpr size_t texels_per_block = IMAGE_BLOCK_SIZE * IMAGE_BLOCK_SIZE;
+    auto texels = FixedArray<GPU::ColorType>::must_create_but_fixme_should_propagate_errors(m_layer_size * layers + texels_per_block - 1);
+    m_texels.swap(texels);
+    auto texel_data_address = align_up_to(reinterpret_cast<FlatPtr>(m_texels.data()), texels_per_block * sizeof(GPU::ColorType));
+    m_texel_data = reinterpret_cast<GPU::ColorType*>(texel_data_address);
 }
 
 void Image::write_texels(unsigned layer, unsigned level, Vector3<unsigned> const& offset, Vector3<unsigned> const& size, void const* data, GPU::ImageDataLayout const& layout)
@@ -105,4 +125,61 @@ void Image::copy_texels(GPU::Image const& source, unsigned source_layer, unsigne
     }
 }
 
+void Image::regenerate_mipmaps()
+{
+    // Each texel of a level is the box filtered average of the 2x2 (or 2x2x2 for 3D images) texels it covers in the
+    // level above it. The color channels are summed up pairwise in the 16-bit halves of a u32, which cannot overflow
+    // for at most 8 texels.
+    auto average_of_texels = [](GPU::ColorType const* texels, size_t count, unsigned count_log2) -> GPU::ColorType {
+        u32 blue_and_red = 0;
+        u32 green_and_alpha = 0;
+        for (size_t i = 0; i < count; ++i) {
+            blue_and_red += texels[i] & 0x00ff00ff;
+            green_and_alpha += (texels[i] >> 8) & 0x00ff00ff;
+        }
+        u32 const rounding = (count >> 1) * 0x00010001;
+        blue_and_red = ((blue_and_red + rounding) >> count_log2) & 0x00ff00ff;
+        green_and_alpha = ((green_and_alpha + rounding) >> count_log2) & 0x00ff00ff;
+        return blue_and_red | (green_and_alpha << 8);
+    };
+
+    for (unsigned layer = 0; layer < m_num_layers; ++layer) {
+        for (unsigned level = 1; level < m_num_levels; ++level) {
+            auto const& source = m_levels[level - 1];
+            auto const& destination = m_levels[level];
+            bool const source_is_3d = source.depth > 1;
+
+            for (unsigned z = 0; z < destination.depth; ++z) {
+                unsigned const z0 = min(z * 2, source.depth - 1);
+                unsigned const z1 = min(z * 2 + 1, source.depth - 1);
+                for (unsigned y = 0; y < destination.height; ++y) {
+                    unsigned const y0 = min(y * 2, source.height - 1);
+                    unsigned const y1 = min(y * 2 + 1, source.height - 1);
+                    for (unsigned x = 0; x < destination.width; ++x) {
+                        unsigned const x0 = min(x * 2, source.width - 1);
+                        unsigned const x1 = min(x * 2 + 1, source.width - 1);
+
+                        GPU::ColorType texels[8] = {
+                            m_texel_data[texel_offset(layer, level - 1, x0, y0, z0)],
+                            m_texel_data[texel_offset(layer, level - 1, x1, y0, z0)],
+                            m_texel_data[texel_offset(layer, level - 1, x0, y1, z0)],
+                            m_texel_data[texel_offset(layer, level - 1, x1, y1, z0)],
+                        };
+                        if (source_is_3d) {
+                            texels[4] = m_texel_data[texel_offset(layer, level - 1, x0, y0, z1)];
+                            texels[5] = m_texel_data[texel_offset(layer, level - 1, x1, y0, z1)];
+                            texels[6] = m_texel_data[texel_offset(layer, level - 1, x0, y1, z1)];
+                            texels[7] = m_texel_data[texel_offset(layer, level - 1, x1, y1, z1)];
+                        }
+
+                        m_texel_data[texel_offset(layer, level, x, y, z)] = source_is_3d
+                            ? average_of_texels(texels, 8, 3)
+                            : average_of_texels(texels, 4, 2);
+                    }
+                }
+            }
+        }
+    }
+}
+
 }
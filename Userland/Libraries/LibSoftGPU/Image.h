@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/FixedArray.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -16,7 +17,6 @@
 #include <LibGPU/ImageFormat.h>
 #include <LibGfx/Vector3.h>
 #include <LibGfx/Vector4.h>
-#include <LibSoftGPU/Buffer/Typed3DBuffer.h>
 #include <LibSoftGPU/Config.h>
 
 namespace SoftGPU {
@@ -138,15 +138,21 @@ class Image final : public GPU::Image {
 public:
     Image(void* const ownership_token, unsigned width, unsigned height, unsigned depth, unsigned max_levels, unsigned layers);
 
-    unsigned level_width(unsigned level) const { return m_mipmap_buffers[level]->width(); }
-    unsigned level_height(unsigned level) const { return m_mipmap_buffers[level]->height(); }
-    unsigned level_depth(unsigned level) const { return m_mipmap_buffers[level]->depth(); }
+    unsigned level_width(unsigned level) const { return m_levels[level].width; }
+    unsigned level_height(unsigned level) const { return m_levels[level].height; }
+    unsigned level_depth(unsigned level) const { return m_levels[level].depth; }
     unsigned num_levels() const { return m_num_levels; }
     unsigned num_layers() const { return m_num_layers; }
     bool width_is_power_of_two() const { return m_width_is_power_of_two; }
     bool height_is_power_of_two() const { return m_height_is_power_of_two; }
     bool depth_is_power_of_two() const { return m_depth_is_power_of_two; }
 
+    // Texels are laid out in blocks of IMAGE_BLOCK_SIZE x IMAGE_BLOCK_SIZE texels. The blocks of each depth slice are
+    // stored row by row, and the texels within a block are stored row by row as well.
+    GPU::ColorType const* texel_data() const { return m_texel_data; }
+    size_t level_offset(unsigned layer, unsigned level) const { return layer * m_layer_size + m_levels[level].offset; }
+    unsigned level_blocks_per_row(unsigned level) const { return m_levels[level].blocks_per_row; }
+
     FloatVector4 texel(unsigned layer, unsigned level, int x, int y, int z) const
     {
         return unpack_color(texel_pointer(layer, level, x, y, z), GPU::ImageFormat::BGRA8888);
@@ -160,23 +166,45 @@ public:
     virtual void write_texels(unsigned layer, unsigned level, Vector3<unsigned> const& offset, Vector3<unsigned> const& size, void const* data, GPU::ImageDataLayout const& layout) override;
     virtual void read_texels(unsigned layer, unsigned level, Vector3<unsigned> const& offset, Vector3<unsigned> const& size, void* data, GPU::ImageDataLayout const& layout) const override;
     virtual void copy_texels(GPU::Image const& source, unsigned source_layer, unsigned source_level, Vector3<unsigned> const& source_offset, Vector3<unsigned> const& size, unsigned destination_layer, unsigned destination_level, Vector3<unsigned> const& destination_offset) override;
+    virtual void regenerate_mipmaps() override;
 
 private:
+    struct Level {
+        size_t offset;
+        size_t slice_size;
+        unsigned width;
+        unsigned height;
+        unsigned depth;
+        unsigned blocks_per_row;
+    };
+
+    size_t texel_offset(unsigned layer, unsigned level, int x, int y, int z) const
+    {
+        auto const& level_info = m_levels[level];
+        auto block_index = (y >> IMAGE_BLOCK_SIZE_LOG2) * level_info.blocks_per_row + (x >> IMAGE_BLOCK_SIZE_LOG2);
+        auto index_in_block = ((y & (IMAGE_BLOCK_SIZE - 1)) << IMAGE_BLOCK_SIZE_LOG2) + (x & (IMAGE_BLOCK_SIZE - 1));
+        return level_offset(layer, level) + z * level_info.slice_size + (block_index << (2 * IMAGE_BLOCK_SIZE_LOG2)) + index_in_block;
+    }
+
     void const* texel_pointer(unsigned layer, unsigned level, int x, int y, int z) const
     {
-        return m_mipmap_buffers[layer * m_num_layers + level]->buffer_pointer(x, y, z);
+        return m_texel_data + texel_offset(layer, level, x, y, z);
     }
 
     void* texel_pointer(unsigned layer, unsigned level, int x, int y, int z)
     {
-        return m_mipmap_buffers[layer * m_num_layers + level]->buffer_pointer(x, y, z);
+        return m_texel_data + texel_offset(layer, level, x, y, z);
     }
 
 private:
     unsigned m_num_levels { 0 };
     unsigned m_num_layers { 0 };
 
-    FixedArray<RefPtr<Typed3DBuffer<GPU::ColorType>>> m_mipmap_buffers;
+    Array<Level, 32> m_levels;
+    size_t m_layer_size { 0 };
+
+    FixedArray<GPU::ColorType> m_texels;
+    GPU::ColorType* m_texel_data { nullptr };
 
     bool m_width_is_power_of_two { false };
     bool m_height_is_power_of_two { false };
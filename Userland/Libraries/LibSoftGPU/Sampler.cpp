@@ -22,7 +22,7 @@ using AK::SIMD::clamp;
 using AK::SIMD::expand4;
 using AK::SIMD::floor_int_range;
 using AK::SIMD::frac_int_range;
-using AK::SIMD::maskbits;
+using AK::SIMD::load4;
 using AK::SIMD::to_f32x4;
 using AK::SIMD::to_i32x4;
 using AK::SIMD::to_u32x4;
@@ -72,35 +72,41 @@ static f32x4 wrap(f32x4 value, GPU::TextureWrapMode mode, u32x4 num_texels)
     }
 }
 
-ALWAYS_INLINE static Vector4<f32x4> texel4(Image const& image, u32x4 layer, u32x4 level, u32x4 x, u32x4 y, u32x4 z)
+// Computes the offsets of the texels at the given coordinates for each lane's mipmap level. See Image::texel_offset().
+ALWAYS_INLINE static u32x4 texel_offsets(u32x4 level_offset, u32x4 blocks_per_row, u32x4 x, u32x4 y)
 {
-    auto t0 = image.texel(layer[0], level[0], x[0], y[0], z[0]);
-    auto t1 = image.texel(layer[1], level[1], x[1], y[1], z[1]);
-    auto t2 = image.texel(layer[2], level[2], x[2], y[2], z[2]);
-    auto t3 = image.texel(layer[3], level[3], x[3], y[3], z[3]);
+    auto block_index = (y >> IMAGE_BLOCK_SIZE_LOG2) * blocks_per_row + (x >> IMAGE_BLOCK_SIZE_LOG2);
+    auto index_in_block = ((y & (IMAGE_BLOCK_SIZE - 1)) << IMAGE_BLOCK_SIZE_LOG2) + (x & (IMAGE_BLOCK_SIZE - 1));
+    return level_offset + (block_index << (2 * IMAGE_BLOCK_SIZE_LOG2)) + index_in_block;
+}
 
+ALWAYS_INLINE static Vector4<f32x4> unpack_texels(u32x4 bgra)
+{
+    constexpr auto one_over_255 = 1.0f / 255;
     return Vector4<f32x4> {
-        f32x4 { t0.x(), t1.x(), t2.x(), t3.x() },
-        f32x4 { t0.y(), t1.y(), t2.y(), t3.y() },
-        f32x4 { t0.z(), t1.z(), t2.z(), t3.z() },
-        f32x4 { t0.w(), t1.w(), t2.w(), t3.w() },
+        to_f32x4((i32x4)((bgra >> 16) & 0xff)) * one_over_255,
+        to_f32x4((i32x4)((bgra >> 8) & 0xff)) * one_over_255,
+        to_f32x4((i32x4)(bgra & 0xff)) * one_over_255,
+        to_f32x4((i32x4)(bgra >> 24)) * one_over_255,
     };
 }
 
-ALWAYS_INLINE static Vector4<f32x4> texel4border(Image const& image, u32x4 layer, u32x4 level, u32x4 x, u32x4 y, u32x4 z, FloatVector4 const& border, u32x4 w, u32x4 h)
+ALWAYS_INLINE static Vector4<f32x4> texel4(GPU::ColorType const* texels, u32x4 offsets)
 {
-    auto border_mask = maskbits(x < 0 || x >= w || y < 0 || y >= h);
+    return unpack_texels(load4(texels + offsets[0], texels + offsets[1], texels + offsets[2], texels + offsets[3]));
+}
 
-    auto t0 = border_mask & 1 ? border : image.texel(layer[0], level[0], x[0], y[0], z[0]);
-    auto t1 = border_mask & 2 ? border : image.texel(layer[1], level[1], x[1], y[1], z[1]);
-    auto t2 = border_mask & 4 ? border : image.texel(layer[2], level[2], x[2], y[2], z[2]);
-    auto t3 = border_mask & 8 ? border : image.texel(layer[3], level[3], x[3], y[3], z[3]);
+ALWAYS_INLINE static Vector4<f32x4> texel4border(GPU::ColorType const* texels, u32x4 level_offset, u32x4 blocks_per_row, u32x4 x, u32x4 y, FloatVector4 const& border, u32x4 w, u32x4 h)
+{
+    // Lanes that fall outside of the image read the very first texel instead, which is then replaced by the border color.
+    auto is_border = x >= w || y >= h;
+    auto color = texel4(texels, texel_offsets(level_offset, blocks_per_row, x, y) & ~(u32x4)is_border);
 
     return Vector4<f32x4> {
-        f32x4 { t0.x(), t1.x(), t2.x(), t3.x() },
-        f32x4 { t0.y(), t1.y(), t2.y(), t3.y() },
-        f32x4 { t0.z(), t1.z(), t2.z(), t3.z() },
-        f32x4 { t0.w(), t1.w(), t2.w(), t3.w() },
+        is_border ? expand4(border.x()) : color.x(),
+        is_border ? expand4(border.y()) : color.y(),
+        is_border ? expand4(border.z()) : color.z(),
+        is_border ? expand4(border.w()) : color.w(),
     };
 }
 
@@ -109,7 +115,7 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d(Vector2<AK::SIMD::f32x4> const& uv)
     if (m_config.bound_image.is_null())
         return expand4(FloatVector4 { 1, 0, 0, 1 });
 
-    auto const& image = *static_ptr_cast<Image>(m_config.bound_image);
+    auto const& image = static_cast<Image const&>(*m_config.bound_image);
 
     // FIXME: Make base level configurable with glTexParameteri(GL_TEXTURE_BASE_LEVEL, base_level)
     constexpr unsigned base_level = 0;
@@ -152,8 +158,9 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d(Vector2<AK::SIMD::f32x4> const& uv)
 
 Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const& uv, AK::SIMD::u32x4 level, GPU::TextureFilter filter) const
 {
-    auto const& image = *static_ptr_cast<Image>(m_config.bound_image);
-    u32x4 const layer = expand4(0u);
+    auto const& image = static_cast<Image const&>(*m_config.bound_image);
+    auto const* texels = image.texel_data();
+    constexpr unsigned layer = 0;
 
     u32x4 const width = {
         image.level_width(level[0]),
@@ -167,6 +174,18 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const&
         image.level_height(level[2]),
         image.level_height(level[3]),
     };
+    u32x4 const level_offset = {
+        static_cast<u32>(image.level_offset(layer, level[0])),
+        static_cast<u32>(image.level_offset(layer, level[1])),
+        static_cast<u32>(image.level_offset(layer, level[2])),
+        static_cast<u32>(image.level_offset(layer, level[3])),
+    };
+    u32x4 const blocks_per_row = {
+        image.level_blocks_per_row(level[0]),
+        image.level_blocks_per_row(level[1]),
+        image.level_blocks_per_row(level[2]),
+        image.level_blocks_per_row(level[3]),
+    };
 
     u32x4 width_mask = width - 1;
     u32x4 height_mask = height - 1;
@@ -180,12 +199,11 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const&
     if (filter == GPU::TextureFilter::Nearest) {
         u32x4 i = to_u32x4(u);
         u32x4 j = to_u32x4(v);
-        u32x4 k = expand4(0u);
 
         i = image.width_is_power_of_two() ? i & width_mask : i % width;
         j = image.height_is_power_of_two() ? j & height_mask : j % height;
 
-        return texel4(image, layer, level, i, j, k);
+        return texel4(texels, texel_offsets(level_offset, blocks_per_row, i, j));
     }
 
     u -= 0.5f;
@@ -216,20 +234,18 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const&
         }
     }
 
-    u32x4 k = expand4(0u);
-
     Vector4<f32x4> t0, t1, t2, t3;
 
     if (m_config.texture_wrap_u == GPU::TextureWrapMode::Repeat && m_config.texture_wrap_v == GPU::TextureWrapMode::Repeat) {
-        t0 = texel4(image, layer, level, i0, j0, k);
-        t1 = texel4(image, layer, level, i1, j0, k);
-        t2 = texel4(image, layer, level, i0, j1, k);
-        t3 = texel4(image, layer, level, i1, j1, k);
+        t0 = texel4(texels, texel_offsets(level_offset, blocks_per_row, i0, j0));
+        t1 = texel4(texels, texel_offsets(level_offset, blocks_per_row, i1, j0));
+        t2 = texel4(texels, texel_offsets(level_offset, blocks_per_row, i0, j1));
+        t3 = texel4(texels, texel_offsets(level_offset, blocks_per_row, i1, j1));
     } else {
-        t1 = texel4border(image, layer, level, i1, j0, k, m_config.border_color, width, height);
-        t0 = texel4border(image, layer, level, i0, j0, k, m_config.border_color, width, height);
-        t2 = texel4border(image, layer, level, i0, j1, k, m_config.border_color, width, height);
-        t3 = texel4border(image, layer, level, i1, j1, k, m_config.border_color, width, height);
+        t0 = texel4border(texels, level_offset, blocks_per_row, i0, j0, m_config.border_color, width, height);
+        t1 = texel4border(texels, level_offset, blocks_per_row, i1, j0, m_config.border_color, width, height);
+        t2 = texel4border(texels, level_offset, blocks_per_row, i0, j1, m_config.border_color, width, height);
+        t3 = texel4border(texels, level_offset, blocks_per_row, i1, j1, m_config.border_color, width, height);
     }
 
     f32x4 const alpha = frac_int_range(u);
@@ -7,6 +7,7 @@
 
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/Memory.h>
 #include <AK/Random.h>
 
 #include <LibCore/Timer.h>
@@ -35,6 +36,8 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    offer_cached_session();
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -86,6 +89,14 @@ ByteBuffer TLSv12::build_hello()
     if (supports_elliptic_curves)
         extension_length += 6 + elliptic_curves_length + 5 + supported_ec_point_formats_length;
 
+    // session_ticket: Empty to ask for a new ticket, or the ticket of the session we're trying to resume
+    bool use_session_ticket = m_context.options.use_session_resumption;
+    size_t session_ticket_length = 0;
+    if (m_context.session.offered.has_value())
+        session_ticket_length = m_context.session.offered->ticket.size();
+    if (use_session_ticket)
+        extension_length += 4 + session_ticket_length;
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -130,6 +141,14 @@ ByteBuffer TLSv12::build_hello()
             builder.append((u8)format);
     }
 
+    if (use_session_ticket) {
+        // session_ticket extension
+        builder.append((u16)HandshakeExtension::SessionTicket);
+        builder.append((u16)session_ticket_length);
+        if (session_ticket_length)
+            builder.append(m_context.session.offered->ticket.bytes());
+    }
+
     if (alpn_length) {
         // TODO
         VERIFY_NOT_REACHED();
@@ -178,7 +197,7 @@ ByteBuffer TLSv12::build_handshake_finished()
     auto outbuffer = Bytes { out, verify_data_length };
     ByteBuffer dummy;
 
-    auto digest = m_context.handshake_hash.digest();
+    auto digest = m_context.handshake_hash.peek();
     auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
     pseudorandom_function(outbuffer, m_context.master_key, (u8 const*)"client finished", 15, hashbuf, dummy);
 
@@ -211,13 +230,32 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         return (i8)Error::BrokenPacket;
     }
 
-    if (size < buffer.size() - index) {
+    if (size > buffer.size() - index) {
         dbgln_if(TLS_DEBUG, "not enough data after length: {} > {}", size, buffer.size() - index);
         return (i8)Error::NeedMoreData;
     }
 
-    // TODO: Compare Hashes
-    dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+    // RFC 5246 section 7.4.9: The server's verify_data covers all the handshake messages before this one.
+    //                         This is what proves that we are talking to the server that knows the master secret,
+    //                         which is all we have to go by when resuming a session.
+    constexpr u32 verify_data_length = 12;
+    if (size != verify_data_length) {
+        dbgln_if(TLS_DEBUG, "finished packet has unexpected size: {}", size);
+        return (i8)Error::BrokenPacket;
+    }
+
+    u8 expected_verify_data[verify_data_length];
+    ByteBuffer dummy;
+    auto digest = m_context.handshake_hash.peek();
+    auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
+    pseudorandom_function(Bytes { expected_verify_data, verify_data_length }, m_context.master_key, (u8 const*)"server finished", 15, hashbuf, dummy);
+    if (!timing_safe_compare(expected_verify_data, buffer.offset_pointer(index), verify_data_length)) {
+        dbgln("Server Finished message doesn't match the handshake");
+        if (m_context.session.is_resumed)
+            SessionCache::the().remove_session(session_cache_key());
+        return (i8)Error::NotSafe;
+    }
+
     m_context.connection_status = ConnectionStatus::Established;
 
     if (m_handshake_timeout_timer) {
@@ -227,6 +265,15 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
+    store_session_in_cache();
+
+    if (m_context.session.is_resumed) {
+        // RFC 5246 section 7.3: In an abbreviated handshake, the server finishes first, and we still have to
+        //                       send our own ChangeCipherSpec and Finished messages.
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
     if (on_connected)
         on_connected();
 
@@ -340,7 +387,11 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[5];
             dbgln_if(TLS_DEBUG, "server key exchange");
-            if (m_context.is_server) {
+            if (m_context.session.is_resumed) {
+                // RFC 5246 section 7.3: An abbreviated handshake goes straight to ChangeCipherSpec and Finished.
+                dbgln("unexpected server key exchange message in abbreviated handshake");
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
             } else {
@@ -354,7 +405,10 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 break;
             }
             ++m_context.handshake_messages[6];
-            if (m_context.is_server) {
+            if (m_context.session.is_resumed) {
+                dbgln("unexpected certificate request message in abbreviated handshake");
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("invalid request");
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
@@ -374,7 +428,10 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[7];
             dbgln_if(TLS_DEBUG, "server hello done");
-            if (m_context.is_server) {
+            if (m_context.session.is_resumed) {
+                dbgln("unexpected server hello done message in abbreviated handshake");
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
             } else {
@@ -412,6 +469,20 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 payload_res = (i8)Error::UnexpectedMessage;
             }
             break;
+        case NewSessionTicket:
+            if (m_context.handshake_messages[11] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[11];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (m_context.connection_status == ConnectionStatus::KeyExchange) {
+                payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            } else {
+                payload_res = (i8)Error::UnexpectedMessage;
+            }
+            break;
         case Finished:
             m_context.cached_handshake.clear();
             if (m_context.handshake_messages[10] >= 1) {
@@ -554,6 +625,8 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
             }
             m_context.connection_status = ConnectionStatus::Established;
+            if (on_connected)
+                on_connected();
             break;
         }
         payload_size++;
@@ -37,10 +37,30 @@ ssize_t TLSv12::handle_certificate(ReadonlyBytes buffer)
         dbgln_if(TLS_DEBUG, "not enough data for claimed total cert length");
         return (i8)Error::NeedMoreData;
     }
+
+    // Servers keep sending the same chains, so skip parsing the ones we've already seen.
+    auto chain_key = SessionCache::key_for_certificate_chain(buffer.slice(res, certificate_total_length));
+    if (auto* cached_chain = SessionCache::the().find_certificate_chain(chain_key)) {
+        dbgln_if(TLS_DEBUG, "Using cached certificate chain {}", chain_key);
+        bool valid_certificate = false;
+        for (auto& certificate : cached_chain->certificates) {
+            if (certificate.is_valid()) {
+                m_context.certificates.append(certificate);
+                valid_certificate = true;
+            }
+        }
+        if (!valid_certificate)
+            return (i8)Error::UnsupportedCertificate;
+
+        m_context.certificate_chain_key = move(chain_key);
+        return res + certificate_total_length;
+    }
+
     size_t size = certificate_total_length;
 
     size_t index = 0;
     bool valid_certificate = false;
+    Vector<Certificate> parsed_certificates;
 
     while (size > 0) {
         ++index;
@@ -82,6 +102,7 @@ ssize_t TLSv12::handle_certificate(ReadonlyBytes buffer)
 
             auto certificate = Certificate::parse_asn1(buffer.slice(res_cert, certificate_size_specific), false);
             if (certificate.has_value()) {
+                parsed_certificates.append(certificate.value());
                 if (certificate.value().is_valid()) {
                     m_context.certificates.append(certificate.value());
                     valid_certificate = true;
@@ -98,6 +119,9 @@ ssize_t TLSv12::handle_certificate(ReadonlyBytes buffer)
     if (!valid_certificate)
         return (i8)Error::UnsupportedCertificate;
 
+    SessionCache::the().store_certificate_chain(chain_key, move(parsed_certificates));
+    m_context.certificate_chain_key = move(chain_key);
+
     if ((size_t)res != buffer.size())
         dbgln("some data left unread: {} bytes out of {}", res, buffer.size());
 
@@ -8,6 +8,7 @@
 #include <AK/Debug.h>
 #include <AK/Hex.h>
 #include <AK/Random.h>
+#include <LibCore/DateTime.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
 #include <LibCrypto/NumberTheory/ModularFunctions.h>
@@ -152,6 +153,114 @@ bool TLSv12::compute_master_secret_from_pre_master_secret(size_t length)
     return true;
 }
 
+// Sessions let later connections skip certificate validation, so they are only shared between connections
+// that would have validated the certificates the same way.
+String TLSv12::session_cache_key() const
+{
+    auto const& options = m_context.options;
+    if (!options.use_session_resumption || options.root_certificates.has_value())
+        return {};
+    if (m_context.extensions.SNI.is_empty() || !m_context.port.has_value())
+        return {};
+    return String::formatted("{}:{}{}", m_context.extensions.SNI, *m_context.port, options.validate_certificates ? "" : " (unvalidated)");
+}
+
+void TLSv12::offer_cached_session()
+{
+    auto key = session_cache_key();
+    if (key.is_null())
+        return;
+
+    auto session = SessionCache::the().find_session(key);
+    if (!session.has_value())
+        return;
+
+    if (!m_context.options.usable_cipher_suites.contains_slow(session->cipher)) {
+        dbgln_if(TLS_DEBUG, "Not offering cached session for {}, its cipher is no longer usable", key);
+        return;
+    }
+
+    if (!session->ticket.is_empty()) {
+        // RFC 5077 section 3.4: When presenting a ticket, the client MAY generate and include a Session ID in the
+        //                       TLS ClientHello. If the server accepts the ticket, it MUST include the same Session ID.
+        fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+        m_context.session_id_size = sizeof(m_context.session_id);
+    } else {
+        memcpy(m_context.session_id, session->session_id, session->session_id_size);
+        m_context.session_id_size = session->session_id_size;
+    }
+
+    dbgln_if(TLS_DEBUG, "Offering cached session for {}", key);
+    m_context.session.offered = session.release_value();
+}
+
+ssize_t TLSv12::resume_offered_session()
+{
+    auto& session = *m_context.session.offered;
+
+    // RFC 5246 section 7.4.1.3: The cipher suite of a resumed session must stay the same.
+    if (session.cipher != m_context.cipher) {
+        dbgln("Server resumed a session for {} with a different cipher suite", m_context.extensions.SNI);
+        SessionCache::the().remove_session(session_cache_key());
+        return (i8)Error::NotSafe;
+    }
+
+    auto master_key = ByteBuffer::copy(session.master_key);
+    if (master_key.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.master_key = master_key.release_value();
+    m_context.certificates = session.certificates;
+
+    if (!expand_key())
+        return (i8)Error::NotUnderstood;
+
+    dbgln_if(TLS_DEBUG, "Resuming session for {}", m_context.extensions.SNI);
+    m_context.session.is_resumed = true;
+
+    // The server follows up with its ChangeCipherSpec and Finished messages right away.
+    m_context.connection_status = ConnectionStatus::KeyExchange;
+    return 0;
+}
+
+void TLSv12::store_session_in_cache()
+{
+    auto key = session_cache_key();
+    if (key.is_null())
+        return;
+
+    SessionCache::Session session;
+    auto now = Core::DateTime::now().timestamp();
+
+    if (m_context.session.received_new_ticket) {
+        session.ticket = m_context.session.new_ticket;
+        // RFC 5077 section 3.3: A lifetime hint of zero means that the lifetime is unspecified.
+        i64 lifetime = m_context.session.new_ticket_lifetime_hint;
+        if (lifetime == 0 || lifetime > SessionCache::MaximumSessionLifetimeInSeconds)
+            lifetime = SessionCache::MaximumSessionLifetimeInSeconds;
+        session.expires_at = now + lifetime;
+    } else if (m_context.session.is_resumed) {
+        // The server kept the session going without renewing anything, so it lives as long as it did before.
+        session.ticket = m_context.session.offered->ticket;
+        session.expires_at = m_context.session.offered->expires_at;
+    } else {
+        session.expires_at = now + SessionCache::DefaultSessionLifetimeInSeconds;
+    }
+
+    if (session.ticket.is_empty() && m_context.session_id_size == 0) {
+        // The server doesn't support resuming this session in any way.
+        SessionCache::the().remove_session(key);
+        return;
+    }
+
+    memcpy(session.session_id, m_context.session_id, m_context.session_id_size);
+    session.session_id_size = m_context.session_id_size;
+    session.master_key = m_context.master_key;
+    session.cipher = m_context.cipher;
+    session.certificates = m_context.certificates;
+
+    SessionCache::the().store_session(key, move(session));
+}
+
 static bool wildcard_matches(StringView host, StringView subject)
 {
     if (host.matches(subject))
@@ -164,6 +273,31 @@ static bool wildcard_matches(StringView host, StringView subject)
 }
 
 Optional<size_t> TLSv12::verify_chain_and_get_matching_certificate(StringView host) const
+{
+    // The outcome only depends on the chain and the host, unless the set of trusted root certificates is a custom one.
+    SessionCache::CertificateChain* cached_chain = nullptr;
+    if (m_context.options.validate_certificates && !m_context.options.root_certificates.has_value() && !m_context.certificate_chain_key.is_null())
+        cached_chain = SessionCache::the().find_certificate_chain(m_context.certificate_chain_key);
+
+    if (!cached_chain)
+        return verify_chain_and_get_matching_certificate_uncached(host);
+
+    // Certificates may have expired since the chain was cached, which changes the indices.
+    if (cached_chain->verified_certificate_count != m_context.certificates.size()) {
+        cached_chain->matching_certificate_for_host.clear();
+        cached_chain->verified_certificate_count = m_context.certificates.size();
+    }
+
+    String host_string = host;
+    if (auto it = cached_chain->matching_certificate_for_host.find(host_string); it != cached_chain->matching_certificate_for_host.end())
+        return it->value;
+
+    auto result = verify_chain_and_get_matching_certificate_uncached(host);
+    cached_chain->matching_certificate_for_host.set(move(host_string), result);
+    return result;
+}
+
+Optional<size_t> TLSv12::verify_chain_and_get_matching_certificate_uncached(StringView host) const
 {
     if (m_context.certificates.is_empty() || !m_context.verify_chain())
         return {};
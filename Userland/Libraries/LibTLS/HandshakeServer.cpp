@@ -61,6 +61,13 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // RFC 5246 section 7.4.1.3: If the server echoes the session ID we offered, it agrees to resume that session.
+    //                           (RFC 5077 section 3.4: The same goes for the session ID sent along with a ticket.)
+    bool is_resuming_offered_session = m_context.session.offered.has_value()
+        && session_length != 0
+        && session_length == m_context.session_id_size
+        && memcmp(m_context.session_id, buffer.offset_pointer(res), session_length) == 0;
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -187,15 +194,56 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
             // uncompressed points. Therefore, this extension can be safely ignored as it should always inform us
             // that the server supports uncompressed points.
             res += extension_length;
+        } else if (extension_type == HandshakeExtension::SessionTicket) {
+            // RFC 5077 section 3.2: An empty SessionTicket extension means that the server will send us a new ticket
+            // in a NewSessionTicket message, which is handled by handle_new_session_ticket().
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", (u16)extension_type, extension_length);
             res += extension_length;
         }
     }
 
+    if (is_resuming_offered_session) {
+        auto resume_result = resume_offered_session();
+        if (resume_result < 0)
+            return resume_result;
+    }
+
     return res;
 }
 
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    // RFC 5077 section 3.3: u32 ticket_lifetime_hint, followed by opaque ticket<0..2^16-1>
+    if (size < 6)
+        return (i8)Error::BrokenPacket;
+
+    auto lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    size_t ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (6 + ticket_length > size)
+        return (i8)Error::BrokenPacket;
+
+    // An empty ticket means that the server won't let us resume the session after all.
+    auto ticket = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket.is_error())
+        return (i8)Error::OutOfMemory;
+
+    m_context.session.received_new_ticket = true;
+    m_context.session.new_ticket = ticket.release_value();
+    m_context.session.new_ticket_lifetime_hint = lifetime_hint;
+    dbgln_if(TLS_DEBUG, "Received session ticket of {} bytes, lifetime hint: {}s", ticket_length, lifetime_hint);
+
+    return size + 3;
+}
+
 ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
 {
     if (buffer.size() < 3)
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <LibCore/DateTime.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+SessionCache& SessionCache::the()
+{
+    static SessionCache s_the;
+    return s_the;
+}
+
+Optional<SessionCache::Session> SessionCache::find_session(String const& key)
+{
+    auto it = m_sessions.find(key);
+    if (it == m_sessions.end())
+        return {};
+
+    if (it->value.expires_at <= Core::DateTime::now().timestamp()) {
+        dbgln_if(TLS_DEBUG, "Cached session for {} has expired", key);
+        m_sessions.remove(it);
+        return {};
+    }
+
+    return it->value;
+}
+
+void SessionCache::store_session(String const& key, Session session)
+{
+    if (!m_sessions.contains(key) && m_sessions.size() >= MaximumSessions) {
+        // Make room by dropping the session that is going to expire first.
+        auto oldest = m_sessions.begin();
+        for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+            if (it->value.expires_at < oldest->value.expires_at)
+                oldest = it;
+        }
+        m_sessions.remove(oldest);
+    }
+
+    dbgln_if(TLS_DEBUG, "Caching session for {} (session id: {} bytes, ticket: {} bytes)", key, session.session_id_size, session.ticket.size());
+    m_sessions.set(key, move(session));
+}
+
+void SessionCache::remove_session(String const& key)
+{
+    m_sessions.remove(key);
+}
+
+String SessionCache::key_for_certificate_chain(ReadonlyBytes encoded_chain)
+{
+    auto digest = Crypto::Hash::SHA256::hash(encoded_chain);
+    return encode_hex({ digest.immutable_data(), digest.data_length() });
+}
+
+SessionCache::CertificateChain* SessionCache::find_certificate_chain(String const& key)
+{
+    auto it = m_certificate_chains.find(key);
+    if (it == m_certificate_chains.end())
+        return nullptr;
+    it->value.last_used = ++m_certificate_chain_use_counter;
+    return &it->value;
+}
+
+void SessionCache::store_certificate_chain(String const& key, Vector<Certificate> certificates)
+{
+    if (!m_certificate_chains.contains(key) && m_certificate_chains.size() >= MaximumCertificateChains) {
+        auto least_recently_used = m_certificate_chains.begin();
+        for (auto it = m_certificate_chains.begin(); it != m_certificate_chains.end(); ++it) {
+            if (it->value.last_used < least_recently_used->value.last_used)
+                least_recently_used = it;
+        }
+        m_certificate_chains.remove(least_recently_used);
+    }
+
+    CertificateChain chain;
+    chain.certificates = move(certificates);
+    chain.last_used = ++m_certificate_chain_use_counter;
+    m_certificate_chains.set(key, move(chain));
+}
+
+void SessionCache::clear()
+{
+    m_sessions.clear();
+    m_certificate_chains.clear();
+}
+
+}
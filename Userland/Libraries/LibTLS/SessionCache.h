@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibTLS/Certificate.h>
+#include <LibTLS/CipherSuite.h>
+
+namespace TLS {
+
+// Remembers the sessions negotiated with each server (host and port), so that later connections to the
+// same server (from anywhere in the process) can resume them with an abbreviated handshake, skipping the key
+// exchange and certificate validation. Both session IDs (RFC 5246 section 7.3) and session tickets
+// (RFC 5077) are supported.
+// It also keeps the most recently seen certificate chains around in their parsed and validated form,
+// since the same few chains show up over and over again on full handshakes.
+class SessionCache {
+public:
+    static constexpr size_t MaximumSessions = 128;
+    static constexpr size_t MaximumCertificateChains = 32;
+    static constexpr i64 DefaultSessionLifetimeInSeconds = 10 * 60;
+    static constexpr i64 MaximumSessionLifetimeInSeconds = 24 * 60 * 60;
+
+    struct Session {
+        u8 session_id[32];
+        u8 session_id_size { 0 };
+        ByteBuffer ticket;
+        ByteBuffer master_key;
+        CipherSuite cipher { CipherSuite::Invalid };
+        Vector<Certificate> certificates;
+        i64 expires_at { 0 };
+    };
+
+    struct CertificateChain {
+        Vector<Certificate> certificates;
+        // The result of verifying the chain for a host, and the number of certificates it was computed for.
+        HashMap<String, Optional<size_t>> matching_certificate_for_host;
+        size_t verified_certificate_count { 0 };
+        u64 last_used { 0 };
+    };
+
+    static SessionCache& the();
+
+    Optional<Session> find_session(String const& key);
+    void store_session(String const& key, Session);
+    void remove_session(String const& key);
+
+    static String key_for_certificate_chain(ReadonlyBytes encoded_chain);
+    CertificateChain* find_certificate_chain(String const& key);
+    void store_certificate_chain(String const& key, Vector<Certificate>);
+
+    void clear();
+
+private:
+    HashMap<String, Session> m_sessions;
+    HashMap<String, CertificateChain> m_certificate_chains;
+    u64 m_certificate_chain_use_counter { 0 };
+};
+
+}
@@ -19,6 +19,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -123,6 +124,7 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
@@ -138,6 +140,7 @@ enum class HandshakeExtension : u16 {
     ECPointFormats = 0x0b,
     SignatureAlgorithms = 0x0d,
     ApplicationLayerProtocolNegotiation = 0x10,
+    SessionTicket = 0x23,
 };
 
 enum class NameType : u8 {
@@ -252,6 +255,7 @@ struct Options {
     OPTION_WITH_DEFAULTS(bool, use_sni, true)
     OPTION_WITH_DEFAULTS(bool, use_compression, false)
     OPTION_WITH_DEFAULTS(bool, validate_certificates, true)
+    OPTION_WITH_DEFAULTS(bool, use_session_resumption, true)
     OPTION_WITH_DEFAULTS(Optional<Vector<Certificate>>, root_certificates, )
     OPTION_WITH_DEFAULTS(Function<void(AlertDescription)>, alert_handler, [](auto) {})
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
@@ -272,6 +276,7 @@ struct Context {
     CipherSuite cipher;
     bool is_server { false };
     Vector<Certificate> certificates;
+    String certificate_chain_key;
     Certificate private_key;
     Vector<Certificate> client_certificates;
     ByteBuffer master_key;
@@ -308,6 +313,17 @@ struct Context {
         String SNI; // I hate your existence
     } extensions;
 
+    // The port of the server, if known. Sessions are only shared with connections to the same port.
+    Optional<u16> port;
+
+    struct {
+        Optional<SessionCache::Session> offered;
+        bool is_resumed { false };
+        bool received_new_ticket { false };
+        ByteBuffer new_ticket;
+        u32 new_ticket_lifetime_hint { 0 };
+    } session;
+
     u8 request_client_certificate { 0 };
 
     ByteBuffer cached_handshake;
@@ -319,7 +335,7 @@ struct Context {
     bool has_invoked_finish_or_error_callback { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[12] { 0 };
     ByteBuffer user_data;
     Vector<Certificate> root_certificates;
 
@@ -382,12 +398,13 @@ public:
     virtual void set_notifications_enabled(bool enabled) override { underlying_stream().set_notifications_enabled(enabled); }
 
     static ErrorOr<NonnullOwnPtr<TLSv12>> connect(String const& host, u16 port, Options = {});
-    static ErrorOr<NonnullOwnPtr<TLSv12>> connect(String const& host, Core::Stream::Socket& underlying_stream, Options = {});
+    static ErrorOr<NonnullOwnPtr<TLSv12>> connect(String const& host, u16 port, Core::Stream::Socket& underlying_stream, Options = {});
 
     using StreamVariantType = Variant<OwnPtr<Core::Stream::Socket>, Core::Stream::Socket*>;
     explicit TLSv12(StreamVariantType, Options);
 
     bool is_established() const { return m_context.connection_status == ConnectionStatus::Established; }
+    bool is_session_resumed() const { return m_context.session.is_resumed; }
 
     void set_sni(StringView sni)
     {
@@ -482,6 +499,7 @@ private:
     ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
     ssize_t handle_random(ReadonlyBytes);
@@ -560,7 +578,13 @@ private:
 
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
+    String session_cache_key() const;
+    void offer_cached_session();
+    ssize_t resume_offered_session();
+    void store_session_in_cache();
+
     Optional<size_t> verify_chain_and_get_matching_certificate(StringView host) const;
+    Optional<size_t> verify_chain_and_get_matching_certificate_uncached(StringView host) const;
 
     void try_disambiguate_error() const;
 
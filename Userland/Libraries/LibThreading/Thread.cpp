@@ -21,7 +21,7 @@ Threading::Thread::Thread(Function<intptr_t()> action, StringView thread_name)
 Threading::Thread::~Thread()
 {
     if (m_tid && !m_detached) {
-        dbgln("Destroying thread \"{}\"({}) while it is still running!", m_thread_name, m_tid);
+        dbgln("Destroying thread \"{}\"({}) that was not joined!", m_thread_name, m_tid);
         [[maybe_unused]] auto res = join();
     }
 }
@@ -32,9 +32,10 @@ void Threading::Thread::start()
         &m_tid,
         nullptr,
         [](void* arg) -> void* {
+            // NOTE: m_tid is left alone here, since join() might be reading it at the same time. It's reset once the
+            //       thread has been joined.
             Thread* self = static_cast<Thread*>(arg);
             auto exit_code = self->m_action();
-            self->m_tid = 0;
             return reinterpret_cast<void*>(exit_code);
         },
         static_cast<void*>(this));
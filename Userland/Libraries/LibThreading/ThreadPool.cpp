@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+namespace Threading {
+
+ThreadPool::ThreadPool(size_t thread_count, StringView name)
+{
+    if (thread_count == 0) {
+        auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = processor_count > 0 ? processor_count : 1;
+    }
+
+    for (size_t i = 0; i < thread_count; i++) {
+        auto thread = Thread::construct([this] { return run_worker(); }, name);
+        thread->start();
+        m_threads.append(move(thread));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        MutexLocker locker(m_mutex);
+        m_exiting = true;
+        m_work_available.broadcast();
+    }
+    for (auto& thread : m_threads)
+        (void)thread.join();
+}
+
+void ThreadPool::submit(Function<void()> job)
+{
+    MutexLocker locker(m_mutex);
+    m_queue.enqueue(move(job));
+    m_jobs_in_flight++;
+    m_work_available.signal();
+}
+
+void ThreadPool::wait()
+{
+    MutexLocker locker(m_mutex);
+    while (m_jobs_in_flight > 0)
+        m_work_done.wait();
+}
+
+intptr_t ThreadPool::run_worker()
+{
+    m_mutex.lock();
+    while (true) {
+        while (m_queue.is_empty() && !m_exiting)
+            m_work_available.wait();
+        if (m_queue.is_empty())
+            break;
+
+        auto job = m_queue.dequeue();
+        m_mutex.unlock();
+        job();
+        m_mutex.lock();
+
+        if (--m_jobs_in_flight == 0)
+            m_work_done.broadcast();
+    }
+    m_mutex.unlock();
+    return 0;
+}
+
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Noncopyable.h>
+#include <AK/Queue.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace Threading {
+
+// A fixed set of worker threads that run submitted jobs in the order they were submitted.
+// Unlike BackgroundAction, jobs don't report back to an event loop; the submitter waits for them with wait().
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    // A thread count of 0 creates one thread per online processor.
+    explicit ThreadPool(size_t thread_count = 0, StringView name = "Worker"sv);
+    ~ThreadPool();
+
+    size_t thread_count() const { return m_threads.size(); }
+
+    void submit(Function<void()>);
+    // Blocks until all of the submitted jobs have finished running.
+    void wait();
+
+private:
+    intptr_t run_worker();
+
+    NonnullRefPtrVector<Thread> m_threads;
+    Mutex m_mutex;
+    ConditionVariable m_work_available { m_mutex };
+    ConditionVariable m_work_done { m_mutex };
+    Queue<Function<void()>> m_queue;
+    size_t m_jobs_in_flight { 0 };
+    bool m_exiting { false };
+};
+
+}
@@ -159,7 +159,6 @@ bool MatroskaReader::parse_segment_elements(MatroskaDocument& matroska_document)
         return true;
     });
 
-    dbgln("Success {}", success);
     return success;
 }
 
@@ -5,6 +5,8 @@
  */
 
 #include "BitStream.h"
+#include <AK/Endian.h>
+#include <string.h>
 
 namespace Video::VP9 {
 
@@ -12,6 +14,7 @@ u8 BitStream::read_byte()
 {
     VERIFY(m_bytes_remaining >= 1);
     m_bytes_remaining--;
+    m_bytes_read++;
     return *(m_data_ptr++);
 }
 
@@ -28,9 +31,9 @@ bool BitStream::read_bit()
     return bit_value;
 }
 
-u8 BitStream::read_f(size_t n)
+u32 BitStream::read_f(size_t n)
 {
-    u8 result = 0;
+    u32 result = 0;
     for (size_t i = 0; i < n; i++) {
         result = (2 * result) + read_bit();
     }
@@ -41,76 +44,76 @@ u8 BitStream::read_f8()
 {
     if (!m_current_byte.has_value())
         return read_byte();
-
-    auto high_bits = m_current_byte.value() & ((1u << m_current_bit_position) - 1);
-    u8 remaining_bits = 7 - m_current_bit_position;
-    m_current_byte = read_byte();
-    m_current_bit_position = 7;
-    auto low_bits = (m_current_byte.value() >> (8u - remaining_bits)) & ((1u << remaining_bits) - 1);
-    m_current_bit_position -= remaining_bits;
-    return (high_bits << remaining_bits) | low_bits;
+    return read_f(8);
 }
 
 u16 BitStream::read_f16()
 {
-    return (read_f8() << 8u) | read_f8();
+    u16 high_byte = read_f8();
+    return (high_byte << 8u) | read_f8();
 }
 
 /* 9.2.1 */
 bool BitStream::init_bool(size_t bytes)
 {
-    if (bytes < 1)
+    // The arithmetic coded data always starts on a byte boundary.
+    VERIFY(!m_current_byte.has_value());
+    if (bytes < 1 || bytes > m_bytes_remaining)
         return false;
-    m_bool_value = read_f8();
+
+    m_bool_data = m_data_ptr;
+    m_bool_data_end = m_data_ptr + bytes;
+    m_data_ptr += bytes;
+    m_bytes_remaining -= bytes;
+    m_bytes_read += bytes;
+
+    m_bool_value = 0;
+    m_bool_count = -8;
     m_bool_range = 255;
-    m_bool_max_bits = (8 * bytes) - 8;
+    fill_bool_value();
     return !read_bool(128);
 }
 
-/* 9.2.2 */
-bool BitStream::read_bool(u8 probability)
+void BitStream::fill_bool_value()
 {
-    auto split = 1u + (((m_bool_range - 1u) * probability) >> 8u);
-    bool return_bool;
-
-    if (m_bool_value < split) {
-        m_bool_range = split;
-        return_bool = false;
-    } else {
-        m_bool_range -= split;
-        m_bool_value -= split;
-        return_bool = true;
+    int shift = bool_value_bits - 8 - (m_bool_count + 8);
+    size_t bytes_left = m_bool_data_end - m_bool_data;
+
+    if (bytes_left >= sizeof(u64)) {
+        u64 big_endian_value;
+        memcpy(&big_endian_value, m_bool_data, sizeof(big_endian_value));
+        int bits = (shift & ~7) + 8;
+        u64 new_value = AK::convert_between_host_and_big_endian(big_endian_value) >> (bool_value_bits - bits);
+        m_bool_count += bits;
+        m_bool_data += bits >> 3;
+        m_bool_value |= new_value << (shift & 7);
+        return;
     }
 
-    while (m_bool_range < 128) {
-        bool new_bit;
-        if (m_bool_max_bits) {
-            new_bit = read_bit();
-            m_bool_max_bits--;
-        } else {
-            new_bit = false;
+    while (shift >= 0) {
+        if (m_bool_data == m_bool_data_end) {
+            // Past the end of the data, the stream reads as zeroes.
+            m_bool_count += bool_lots_of_bits;
+            return;
         }
-        m_bool_range *= 2;
-        m_bool_value = (m_bool_value << 1u) + new_bit;
+        m_bool_count += 8;
+        m_bool_value |= static_cast<u64>(*m_bool_data++) << shift;
+        shift -= 8;
     }
-
-    return return_bool;
 }
 
 /* 9.2.3 */
 bool BitStream::exit_bool()
 {
-    // FIXME: I'm not sure if this call to min is spec compliant, or if there is an issue elsewhere earlier in the parser.
-    auto padding_element = read_f(min(m_bool_max_bits, (u64)bits_remaining()));
-
-    // FIXME: It is a requirement of bitstream conformance that enough padding bits are inserted to ensure that the final coded byte of a frame is not equal to a superframe marker.
-    //  A byte b is equal to a superframe marker if and only if (b & 0xe0)is equal to 0xc0, i.e. if the most significant 3 bits are equal to 0b110.
-    return padding_element == 0;
+    // NOTE: The padding itself isn't checked, but reading beyond the end of the data means that the stream is corrupt.
+    //       It is also a requirement of bitstream conformance that enough padding bits are inserted to ensure that the
+    //       final coded byte of a frame is not equal to a superframe marker, which is the encoder's business.
+    return !(m_bool_count > bool_value_bits && m_bool_count < bool_lots_of_bits);
 }
 
-u8 BitStream::read_literal(size_t n)
+u32 BitStream::read_literal(size_t n)
 {
-    u8 return_value = 0;
+    u32 return_value = 0;
     for (size_t i = 0; i < n; i++) {
         return_value = (2 * return_value) + read_bool(128);
     }
@@ -119,14 +122,16 @@ u8 BitStream::read_literal(size_t n)
 
 i8 BitStream::read_s(size_t n)
 {
-    auto value = read_f(n);
+    i8 value = read_f(n);
     auto sign = read_bit();
     return sign ? -value : value;
 }
 
 u64 BitStream::get_position()
 {
-    return (m_bytes_read * 8) + (7 - m_current_bit_position);
+    if (!m_current_byte.has_value())
+        return m_bytes_read * 8;
+    return (m_bytes_read * 8) - (m_current_bit_position + 1);
 }
 
 size_t BitStream::bytes_remaining()
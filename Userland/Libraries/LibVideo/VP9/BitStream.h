@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Optional.h>
 #include <AK/Types.h>
 
@@ -23,15 +24,40 @@ public:
     bool read_bit();
 
     /* (9.1) */
-    u8 read_f(size_t n);
+    u32 read_f(size_t n);
     u8 read_f8();
     u16 read_f16();
 
     /* (9.2) */
     bool init_bool(size_t bytes);
-    bool read_bool(u8 probability);
     bool exit_bool();
-    u8 read_literal(size_t n);
+    u32 read_literal(size_t n);
+
+    // NOTE: This is by far the hottest function of the decoder, so the arithmetic decoder keeps a window
+    //       of up to 64 bits of the stream around, which is only refilled (a byte at a time) when it runs dry.
+    ALWAYS_INLINE bool read_bool(u8 probability)
+    {
+        u32 split = 1 + (((m_bool_range - 1) * probability) >> 8);
+        if (m_bool_count < 0)
+            fill_bool_value();
+
+        u64 big_split = static_cast<u64>(split) << (bool_value_bits - 8);
+        bool return_bool;
+        if (m_bool_value >= big_split) {
+            m_bool_range -= split;
+            m_bool_value -= big_split;
+            return_bool = true;
+        } else {
+            m_bool_range = split;
+            return_bool = false;
+        }
+
+        auto shift = count_leading_zeroes(m_bool_range) - 24;
+        m_bool_range <<= shift;
+        m_bool_value <<= shift;
+        m_bool_count -= shift;
+        return return_bool;
+    }
 
     /* (4.9.2) */
     i8 read_s(size_t n);
@@ -41,15 +67,23 @@ public:
     size_t bits_remaining();
 
 private:
+    static constexpr int bool_value_bits = 64;
+    // Added to the bit count once the data runs out, so that the window isn't refilled over and over.
+    static constexpr int bool_lots_of_bits = 0x4000;
+
+    void fill_bool_value();
+
     u8 const* m_data_ptr { nullptr };
     size_t m_bytes_remaining { 0 };
     Optional<u8> m_current_byte;
-    i8 m_current_bit_position { 0 };
+    i8 m_current_bit_position { -1 };
     u64 m_bytes_read { 0 };
 
-    u8 m_bool_value { 0 };
-    u8 m_bool_range { 0 };
-    u64 m_bool_max_bits { 0 };
+    u8 const* m_bool_data { nullptr };
+    u8 const* m_bool_data_end { nullptr };
+    u64 m_bool_value { 0 };
+    int m_bool_count { 0 };
+    u32 m_bool_range { 0 };
 };
 
 }
@@ -5,6 +5,7 @@
  */
 
 #include "Decoder.h"
+#include "InverseTransform.h"
 #include "Utilities.h"
 
 namespace Video::VP9 {
@@ -14,14 +15,92 @@ Decoder::Decoder()
 {
 }
 
+Decoder::~Decoder() = default;
+
 bool Decoder::decode_frame(ByteBuffer const& frame_data)
+{
+    m_shown_frame = nullptr;
+    auto data = frame_data.bytes();
+
+    // (Annex B) A superframe ends in an index of the sizes of the frames within it, which starts and ends with the
+    // same marker byte.
+    if (!data.is_empty()) {
+        u8 marker = data[data.size() - 1];
+        if ((marker & 0xe0) == 0xc0) {
+            u32 frames_in_superframe = (marker & 0x7) + 1;
+            u32 bytes_per_framesize = ((marker >> 3) & 0x3) + 1;
+            size_t index_size = 2 + bytes_per_framesize * frames_in_superframe;
+            if (data.size() >= index_size && data[data.size() - index_size] == marker) {
+                auto frames_size = data.size() - index_size;
+                auto const* frame_sizes = data.offset(frames_size + 1);
+                size_t offset = 0;
+                for (u32 i = 0; i < frames_in_superframe; i++) {
+                    size_t frame_size = 0;
+                    for (u32 j = 0; j < bytes_per_framesize; j++)
+                        frame_size |= static_cast<size_t>(*frame_sizes++) << (j * 8);
+                    if (offset + frame_size > frames_size) {
+                        dbgln("VP9: Superframe index points past the end of the superframe");
+                        return false;
+                    }
+                    if (frame_size > 0)
+                        SAFE_CALL(decode_single_frame(data.slice(offset, frame_size)));
+                    offset += frame_size;
+                }
+                return true;
+            }
+        }
+    }
+
+    return decode_single_frame(data);
+}
+
+bool Decoder::decode_single_frame(ReadonlyBytes frame_data)
 {
     SAFE_CALL(m_parser->parse_frame(frame_data));
-    // TODO:
-    //  - #2
-    //  - #3
-    //  - #4
+
+    if (m_parser->m_show_existing_frame) {
+        m_shown_frame = m_reference_frames[m_parser->m_frame_to_show_map_index];
+        if (!m_shown_frame) {
+            dbgln("VP9: Frame {} was shown before it was decoded", m_parser->m_frame_to_show_map_index);
+            return false;
+        }
+        return true;
+    }
+
+    /* (8.8) Loop Filter Process */
+    SAFE_CALL(m_loop_filter.filter_frame(*m_parser, *m_current_frame));
+    m_current_frame->extend_borders();
+
     SAFE_CALL(update_reference_frames());
+    if (m_parser->m_show_frame)
+        m_shown_frame = m_current_frame;
+    return true;
+}
+
+bool Decoder::allocate_current_frame()
+{
+    auto width = m_parser->m_frame_width;
+    auto height = m_parser->m_frame_height;
+    auto subsampling_x = m_parser->m_subsampling_x;
+    auto subsampling_y = m_parser->m_subsampling_y;
+
+    m_current_frame = nullptr;
+    for (auto& frame : m_frame_pool) {
+        if (frame.ref_count() == 1 && frame.width() == width && frame.height() == height && frame.subsampling_x() == subsampling_x && frame.subsampling_y() == subsampling_y) {
+            m_current_frame = frame;
+            return true;
+        }
+    }
+
+    // Frames of another size will not be reused once the stream has changed size.
+    m_frame_pool.remove_all_matching([](auto& frame) { return frame->ref_count() == 1; });
+    auto frame_or_error = Frame::try_create(width, height, subsampling_x, subsampling_y);
+    if (frame_or_error.is_error()) {
+        dbgln("VP9: Could not allocate a {}x{} frame: {}", width, height, frame_or_error.error());
+        return false;
+    }
+    m_current_frame = frame_or_error.value();
+    m_frame_pool.append(frame_or_error.release_value());
     return true;
 }
 
@@ -30,46 +109,49 @@ void Decoder::dump_frame_info()
     m_parser->dump_info();
 }
 
-u8 Decoder::merge_prob(u8 pre_prob, u8 count_0, u8 count_1, u8 count_sat, u8 max_update_factor)
+u8 Decoder::merge_prob(u8 pre_prob, u32 count_0, u32 count_1, u8 count_sat, u8 max_update_factor)
 {
     auto total_decode_count = count_0 + count_1;
-    auto prob = (total_decode_count == 0) ? 128 : clip_3(1, 255, (count_0 * 256 + (total_decode_count >> 1)) / total_decode_count);
-    auto count = min(total_decode_count, count_sat);
+    auto prob = (total_decode_count == 0) ? 128 : clip_3<u32>(1, 255, (static_cast<u64>(count_0) * 256 + (total_decode_count >> 1)) / total_decode_count);
+    auto count = min<u32>(total_decode_count, count_sat);
     auto factor = (max_update_factor * count) / count_sat;
-    return round_2(pre_prob * (256 - factor) + (prob * factor), 8);
+    return round_2<u32>(pre_prob * (256 - factor) + (prob * factor), 8);
 }
 
-u8 Decoder::merge_probs(int const* tree, int index, u8* probs, u8* counts, u8 count_sat, u8 max_update_factor)
+u32 Decoder::merge_probs(int const* tree, int index, u8 const* pre_probs, u8* probs, u32 const* counts, u8 count_sat, u8 max_update_factor)
 {
     auto s = tree[index];
-    auto left_count = (s <= 0) ? counts[-s] : merge_probs(tree, s, probs, counts, count_sat, max_update_factor);
+    auto left_count = (s <= 0) ? counts[-s] : merge_probs(tree, s, pre_probs, probs, counts, count_sat, max_update_factor);
     auto r = tree[index + 1];
-    auto right_count = (r <= 0) ? counts[-r] : merge_probs(tree, r, probs, counts, count_sat, max_update_factor);
-    probs[index >> 1] = merge_prob(probs[index >> 1], left_count, right_count, count_sat, max_update_factor);
+    auto right_count = (r <= 0) ? counts[-r] : merge_probs(tree, r, pre_probs, probs, counts, count_sat, max_update_factor);
+    probs[index >> 1] = merge_prob(pre_probs[index >> 1], left_count, right_count, count_sat, max_update_factor);
     return left_count + right_count;
 }
 
 bool Decoder::adapt_coef_probs()
 {
     u8 update_factor;
-    if (m_parser->m_frame_is_intra || m_parser->m_last_frame_type != KeyFrame)
-        update_factor = 112;
-    else
+    if (!m_parser->m_frame_is_intra && m_parser->m_last_frame_type == KeyFrame)
         update_factor = 128;
+    else
+        update_factor = 112;
 
-    for (size_t t = 0; t < 4; t++) {
-        for (size_t i = 0; i < 2; i++) {
-            for (size_t j = 0; j < 2; j++) {
-                for (size_t k = 0; k < 6; k++) {
+    auto const& pre_coef_probs = m_parser->m_probability_tables->saved_probs(m_parser->m_frame_context_idx).coef_probs;
+    auto& counter = *m_parser->m_syntax_element_counter;
+    for (size_t t = 0; t < TX_SIZES; t++) {
+        for (size_t i = 0; i < BLOCK_TYPES; i++) {
+            for (size_t j = 0; j < REF_TYPES; j++) {
+                for (size_t k = 0; k < COEF_BANDS; k++) {
                     size_t max_l = (k == 0) ? 3 : 6;
                     for (size_t l = 0; l < max_l; l++) {
-                        auto& coef_probs = m_parser->m_probability_tables->coef_probs()[t][i][j][k][l];
-                        merge_probs(small_token_tree, 2, coef_probs,
-                            m_parser->m_syntax_element_counter->m_counts_token[t][i][j][k][l],
-                            24, update_factor);
-                        merge_probs(binary_tree, 0, coef_probs,
-                            m_parser->m_syntax_element_counter->m_counts_more_coefs[t][i][j][k][l],
-                            24, update_factor);
+                        auto const& pre_probs = pre_coef_probs[t][i][j][k][l];
+                        auto& probs = m_parser->m_probability_tables->coef_probs()[t][i][j][k][l];
+                        auto const& token_counts = counter.m_counts_token[t][i][j][k][l];
+                        // NOTE: The first probability is of there being more coefficients, so it is adapted from the
+                        //       number of times that they did not end, out of the times that they could have.
+                        auto end_of_block_count = token_counts[3];
+                        probs[0] = merge_prob(pre_probs[0], end_of_block_count, counter.m_counts_more_coefs[t][i][j][k][l] - end_of_block_count, 24, update_factor);
+                        merge_probs(small_token_tree, 2, pre_probs, probs, token_counts, 24, update_factor);
                     }
                 }
             }
@@ -79,36 +161,34 @@ bool Decoder::adapt_coef_probs()
     return true;
 }
 
-#define ADAPT_PROB_TABLE(name, size)                                     \
-    do {                                                                 \
-        for (size_t i = 0; i < (size); i++) {                            \
-            auto table = probs.name##_prob();                            \
-            table[i] = adapt_prob(table[i], counter.m_counts_##name[i]); \
-        }                                                                \
+#define ADAPT_PROB_TABLE(name, size)                                                        \
+    do {                                                                                    \
+        for (size_t i = 0; i < (size); i++)                                                 \
+            probs.name##_prob()[i] = adapt_prob(pre.name##_prob[i], counter.m_counts_##name[i]); \
     } while (0)
 
-#define ADAPT_TREE(tree_name, prob_name, count_name, size)                                                 \
-    do {                                                                                                   \
-        for (size_t i = 0; i < (size); i++) {                                                              \
-            adapt_probs(tree_name##_tree, probs.prob_name##_probs()[i], counter.m_counts_##count_name[i]); \
-        }                                                                                                  \
+#define ADAPT_TREE(tree_name, prob_name, count_name, size)                                                                       \
+    do {                                                                                                                         \
+        for (size_t i = 0; i < (size); i++)                                                                                      \
+            adapt_probs(tree_name##_tree, pre.prob_name##_probs[i], probs.prob_name##_probs()[i], counter.m_counts_##count_name[i]); \
     } while (0)
 
 bool Decoder::adapt_non_coef_probs()
 {
     auto& probs = *m_parser->m_probability_tables;
+    auto const& pre = probs.saved_probs(m_parser->m_frame_context_idx);
     auto& counter = *m_parser->m_syntax_element_counter;
     ADAPT_PROB_TABLE(is_inter, IS_INTER_CONTEXTS);
     ADAPT_PROB_TABLE(comp_mode, COMP_MODE_CONTEXTS);
     ADAPT_PROB_TABLE(comp_ref, REF_CONTEXTS);
     for (size_t i = 0; i < REF_CONTEXTS; i++) {
         for (size_t j = 0; j < 2; j++)
-            probs.single_ref_prob()[i][j] = adapt_prob(probs.single_ref_prob()[i][j], counter.m_counts_single_ref[i][j]);
+            probs.single_ref_prob()[i][j] = adapt_prob(pre.single_ref_prob[i][j], counter.m_counts_single_ref[i][j]);
     }
     ADAPT_TREE(inter_mode, inter_mode, inter_mode, INTER_MODE_CONTEXTS);
-    ADAPT_TREE(intra_mode, y_mode, intra_mode, INTER_MODE_CONTEXTS);
-    ADAPT_TREE(intra_mode, uv_mode, uv_mode, INTER_MODE_CONTEXTS);
-    ADAPT_TREE(partition, partition, partition, INTER_MODE_CONTEXTS);
+    ADAPT_TREE(intra_mode, y_mode, intra_mode, BLOCK_SIZE_GROUPS);
+    ADAPT_TREE(intra_mode, uv_mode, uv_mode, INTRA_MODES);
+    ADAPT_TREE(partition, partition, partition, PARTITION_CONTEXTS);
     ADAPT_PROB_TABLE(skip, SKIP_CONTEXTS);
     if (m_parser->m_interpolation_filter == Switchable) {
         ADAPT_TREE(interp_filter, interp_filter, interp_filter, INTERP_FILTER_CONTEXTS);
@@ -116,69 +196,356 @@ bool Decoder::adapt_non_coef_probs()
     if (m_parser->m_tx_mode == TXModeSelect) {
         for (size_t i = 0; i < TX_SIZE_CONTEXTS; i++) {
             auto& tx_probs = probs.tx_probs();
-            auto& tx_counts = counter.m_counts_tx_size;
-            adapt_probs(tx_size_8_tree, tx_probs[TX_8x8][i], tx_counts[TX_8x8][i]);
-            adapt_probs(tx_size_16_tree, tx_probs[TX_16x16][i], tx_counts[TX_16x16][i]);
-            adapt_probs(tx_size_32_tree, tx_probs[TX_32x32][i], tx_counts[TX_32x32][i]);
+            auto const& tx_counts = counter.m_counts_tx_size;
+            adapt_probs(tx_size_8_tree, pre.tx_probs[TX_8x8][i], tx_probs[TX_8x8][i], tx_counts[TX_8x8][i]);
+            adapt_probs(tx_size_16_tree, pre.tx_probs[TX_16x16][i], tx_probs[TX_16x16][i], tx_counts[TX_16x16][i]);
+            adapt_probs(tx_size_32_tree, pre.tx_probs[TX_32x32][i], tx_probs[TX_32x32][i], tx_counts[TX_32x32][i]);
         }
     }
-    adapt_probs(mv_joint_tree, probs.mv_joint_probs(), counter.m_counts_mv_joint);
+    adapt_probs(mv_joint_tree, pre.mv_joint_probs, probs.mv_joint_probs(), counter.m_counts_mv_joint);
     for (size_t i = 0; i < 2; i++) {
-        probs.mv_sign_prob()[i] = adapt_prob(probs.mv_sign_prob()[i], counter.m_counts_mv_sign[i]);
-        adapt_probs(mv_class_tree, probs.mv_class_probs()[i], counter.m_counts_mv_class[i]);
-        probs.mv_class0_bit_prob()[i] = adapt_prob(probs.mv_class0_bit_prob()[i], counter.m_counts_mv_class0_bit[i]);
+        probs.mv_sign_prob()[i] = adapt_prob(pre.mv_sign_prob[i], counter.m_counts_mv_sign[i]);
+        adapt_probs(mv_class_tree, pre.mv_class_probs[i], probs.mv_class_probs()[i], counter.m_counts_mv_class[i]);
+        probs.mv_class0_bit_prob()[i] = adapt_prob(pre.mv_class0_bit_prob[i], counter.m_counts_mv_class0_bit[i]);
         for (size_t j = 0; j < MV_OFFSET_BITS; j++)
-            probs.mv_bits_prob()[i][j] = adapt_prob(probs.mv_bits_prob()[i][j], counter.m_counts_mv_bits[i][j]);
+            probs.mv_bits_prob()[i][j] = adapt_prob(pre.mv_bits_prob[i][j], counter.m_counts_mv_bits[i][j]);
         for (size_t j = 0; j < CLASS0_SIZE; j++)
-            adapt_probs(mv_fr_tree, probs.mv_class0_fr_probs()[i][j], counter.m_counts_mv_class0_fr[i][j]);
-        adapt_probs(mv_fr_tree, probs.mv_fr_probs()[i], counter.m_counts_mv_fr[i]);
+            adapt_probs(mv_fr_tree, pre.mv_class0_fr_probs[i][j], probs.mv_class0_fr_probs()[i][j], counter.m_counts_mv_class0_fr[i][j]);
+        adapt_probs(mv_fr_tree, pre.mv_fr_probs[i], probs.mv_fr_probs()[i], counter.m_counts_mv_fr[i]);
         if (m_parser->m_allow_high_precision_mv) {
-            probs.mv_class0_hp_prob()[i] = adapt_prob(probs.mv_class0_hp_prob()[i], counter.m_counts_mv_class0_hp[i]);
-            probs.mv_hp_prob()[i] = adapt_prob(probs.mv_hp_prob()[i], counter.m_counts_mv_hp[i]);
+            probs.mv_class0_hp_prob()[i] = adapt_prob(pre.mv_class0_hp_prob[i], counter.m_counts_mv_class0_hp[i]);
+            probs.mv_hp_prob()[i] = adapt_prob(pre.mv_hp_prob[i], counter.m_counts_mv_hp[i]);
         }
     }
     return true;
 }
 
-void Decoder::adapt_probs(int const* tree, u8* probs, u8* counts)
+void Decoder::adapt_probs(int const* tree, u8 const* pre_probs, u8* probs, u32 const* counts)
+{
+    merge_probs(tree, 0, pre_probs, probs, counts, COUNT_SAT, MAX_UPDATE_FACTOR);
+}
+
+u8 Decoder::adapt_prob(u8 pre_prob, u32 const counts[2])
 {
-    merge_probs(tree, 0, probs, counts, COUNT_SAT, MAX_UPDATE_FACTOR);
+    return merge_prob(pre_prob, counts[0], counts[1], COUNT_SAT, MAX_UPDATE_FACTOR);
 }
 
-u8 Decoder::adapt_prob(u8 prob, u8 counts[2])
+ALWAYS_INLINE static u8 average_2(u32 a, u32 b)
 {
-    return merge_prob(prob, counts[0], counts[1], COUNT_SAT, MAX_UPDATE_FACTOR);
+    return (a + b + 1) >> 1;
 }
 
-bool Decoder::predict_intra(size_t, u32, u32, bool, bool, bool, TXSize, u32)
+ALWAYS_INLINE static u8 average_3(u32 a, u32 b, u32 c)
 {
-    // TODO: Implement
+    return (a + 2 * b + c + 2) >> 2;
+}
+
+bool Decoder::predict_intra(TileContext& tile, size_t plane, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TXSize tx_size, u32 block_index)
+{
+    auto& frame = *m_current_frame;
+    auto stride = frame.stride(plane);
+    auto* destination = frame.data(plane) + y * stride + x;
+    auto at = [&](u32 row, u32 column) -> u8& { return destination[row * stride + column]; };
+    u32 size = 4u << tx_size;
+
+    u8 mode;
+    if (plane > 0)
+        mode = tile.uv_mode;
+    else if (tile.mi_size >= Block_8x8)
+        mode = tile.y_mode;
+    else
+        mode = tile.block_sub_modes[block_index];
+
+    // NOTE: Edges that reach past the bottom or the right of the frame are extended with the last sample within it.
+    auto max_x = frame.aligned_plane_width(plane);
+    auto max_y = frame.aligned_plane_height(plane);
+
+    u8 left[32];
+    if (have_left) {
+        auto available = min(size, max_y - y);
+        for (u32 i = 0; i < available; i++)
+            left[i] = destination[i * stride - 1];
+        __builtin_memset(left + available, left[available - 1], size - available);
+    } else {
+        __builtin_memset(left, 129, size);
+    }
+
+    // NOTE: above[-1] is the sample above and to the left of the block.
+    u8 above_row[65];
+    u8* above = above_row + 1;
+    if (have_above) {
+        auto const* source = destination - stride;
+        // Only 4x4 blocks use the samples above and to the right of them, as long as those have already been decoded.
+        auto wanted = (size == 4 && not_on_right) ? 2 * size : size;
+        auto available = min(wanted, max_x - x);
+        __builtin_memcpy(above, source, available);
+        __builtin_memset(above + available, above[available - 1], 2 * size - available);
+        above[-1] = have_left ? source[-1] : 129;
+    } else {
+        __builtin_memset(above_row, 127, 2 * size + 1);
+    }
+
+    switch (mode) {
+    case DcPred: {
+        u32 sum = 0;
+        u8 average = 128;
+        if (have_left && have_above) {
+            for (u32 i = 0; i < size; i++)
+                sum += left[i] + above[i];
+            average = (sum + size) >> (tx_size + 3);
+        } else if (have_left) {
+            for (u32 i = 0; i < size; i++)
+                sum += left[i];
+            average = (sum + (size >> 1)) >> (tx_size + 2);
+        } else if (have_above) {
+            for (u32 i = 0; i < size; i++)
+                sum += above[i];
+            average = (sum + (size >> 1)) >> (tx_size + 2);
+        }
+        for (u32 row = 0; row < size; row++)
+            __builtin_memset(&at(row, 0), average, size);
+        break;
+    }
+    case VPred:
+        for (u32 row = 0; row < size; row++)
+            __builtin_memcpy(&at(row, 0), above, size);
+        break;
+    case HPred:
+        for (u32 row = 0; row < size; row++)
+            __builtin_memset(&at(row, 0), left[row], size);
+        break;
+    case TmPred:
+        for (u32 row = 0; row < size; row++) {
+            for (u32 column = 0; column < size; column++)
+                at(row, column) = clip_1(left[row] + above[column] - above[-1]);
+        }
+        break;
+    case D45Pred:
+        for (u32 row = 0; row < size; row++) {
+            for (u32 column = 0; column < size; column++) {
+                auto i = row + column;
+                at(row, column) = (i + 2 < 2 * size) ? average_3(above[i], above[i + 1], above[i + 2]) : above[2 * size - 1];
+            }
+        }
+        break;
+    case D63Pred:
+        for (u32 row = 0; row < size; row++) {
+            for (u32 column = 0; column < size; column++) {
+                auto i = (row >> 1) + column;
+                at(row, column) = (row & 1) ? average_3(above[i], above[i + 1], above[i + 2]) : average_2(above[i], above[i + 1]);
+            }
+        }
+        break;
+    case D117Pred:
+        for (i32 column = 0; column < static_cast<i32>(size); column++)
+            at(0, column) = average_2(above[column - 1], above[column]);
+        at(1, 0) = average_3(left[0], above[-1], above[0]);
+        for (i32 column = 1; column < static_cast<i32>(size); column++)
+            at(1, column) = average_3(above[column - 2], above[column - 1], above[column]);
+        at(2, 0) = average_3(above[-1], left[0], left[1]);
+        for (u32 row = 3; row < size; row++)
+            at(row, 0) = average_3(left[row - 3], left[row - 2], left[row - 1]);
+        for (u32 row = 2; row < size; row++) {
+            for (u32 column = 1; column < size; column++)
+                at(row, column) = at(row - 2, column - 1);
+        }
+        break;
+    case D135Pred: {
+        // The left column, the corner and the above row in one line, running from the bottom left to the top right.
+        u8 edge[65];
+        for (u32 i = 0; i < size; i++)
+            edge[i] = left[size - 1 - i];
+        __builtin_memcpy(edge + size, above - 1, size + 1);
+        for (u32 row = 0; row < size; row++) {
+            for (u32 column = 0; column < size; column++) {
+                auto i = size + column - row;
+                at(row, column) = average_3(edge[i - 1], edge[i], edge[i + 1]);
+            }
+        }
+        break;
+    }
+    case D153Pred:
+        at(0, 0) = average_2(above[-1], left[0]);
+        for (u32 row = 1; row < size; row++)
+            at(row, 0) = average_2(left[row - 1], left[row]);
+        at(0, 1) = average_3(left[0], above[-1], above[0]);
+        at(1, 1) = average_3(above[-1], left[0], left[1]);
+        for (u32 row = 2; row < size; row++)
+            at(row, 1) = average_3(left[row - 2], left[row - 1], left[row]);
+        for (i32 column = 0; column < static_cast<i32>(size) - 2; column++)
+            at(0, column + 2) = average_3(above[column - 1], above[column], above[column + 1]);
+        for (u32 row = 1; row < size; row++) {
+            for (u32 column = 0; column < size - 2; column++)
+                at(row, column + 2) = at(row - 1, column);
+        }
+        break;
+    case D207Pred:
+        for (u32 row = 0; row < size - 1; row++)
+            at(row, 0) = average_2(left[row], left[row + 1]);
+        at(size - 1, 0) = left[size - 1];
+        for (u32 row = 0; row < size - 2; row++)
+            at(row, 1) = average_3(left[row], left[row + 1], left[row + 2]);
+        at(size - 2, 1) = average_3(left[size - 2], left[size - 1], left[size - 1]);
+        at(size - 1, 1) = left[size - 1];
+        for (u32 column = 0; column < size - 2; column++)
+            at(size - 1, column + 2) = left[size - 1];
+        for (i32 row = size - 2; row >= 0; row--) {
+            for (u32 column = 0; column < size - 2; column++)
+                at(row, column + 2) = at(row + 1, column);
+        }
+        break;
+    default:
+        dbgln("VP9: Invalid intra prediction mode {}", mode);
+        return false;
+    }
     return true;
 }
 
-bool Decoder::predict_inter(size_t, u32, u32, u32, u32, u32)
+// Filters a block with the 8-tap subpixel filters, first horizontally and then vertically. Either pass is skipped when
+// the motion vector points at a whole sample in its direction, since the filters then leave the samples as they are.
+static void predict_block(u8 const* source, size_t source_stride, u8* destination, size_t destination_stride, u32 width, u32 height, i16 const (&filters)[16][8], u32 fraction_x, u32 fraction_y)
+{
+    auto filter = [](u8 const* samples, size_t step, i16 const* taps) -> u8 {
+        i32 sum = 0;
+        for (size_t t = 0; t < 8; t++)
+            sum += samples[t * step] * taps[t];
+        return clip_1((sum + 64) >> 7);
+    };
+
+    if (fraction_y == 0) {
+        for (u32 row = 0; row < height; row++) {
+            auto const* source_row = source + row * source_stride;
+            auto* destination_row = destination + row * destination_stride;
+            if (fraction_x == 0) {
+                __builtin_memcpy(destination_row, source_row, width);
+                continue;
+            }
+            for (u32 column = 0; column < width; column++)
+                destination_row[column] = filter(source_row + column - 3, 1, filters[fraction_x]);
+        }
+        return;
+    }
+
+    // The vertical filter reads three rows above the block and four below it.
+    u8 intermediate[(64 + 7) * 64];
+    u8 const* vertical_source = source - 3 * source_stride;
+    size_t vertical_source_stride = source_stride;
+    if (fraction_x != 0) {
+        for (u32 row = 0; row < height + 7; row++) {
+            auto const* source_row = source + (static_cast<ssize_t>(row) - 3) * static_cast<ssize_t>(source_stride);
+            for (u32 column = 0; column < width; column++)
+                intermediate[row * 64 + column] = filter(source_row + column - 3, 1, filters[fraction_x]);
+        }
+        vertical_source = intermediate;
+        vertical_source_stride = 64;
+    }
+
+    for (u32 row = 0; row < height; row++) {
+        auto* destination_row = destination + row * destination_stride;
+        for (u32 column = 0; column < width; column++)
+            destination_row[column] = filter(vertical_source + row * vertical_source_stride + column, vertical_source_stride, filters[fraction_y]);
+    }
+}
+
+bool Decoder::predict_inter(TileContext& tile, size_t plane, u32 x, u32 y, u32 w, u32 h, u32 block_index)
 {
-    // TODO: Implement
+    auto& frame = *m_current_frame;
+    auto stride = frame.stride(plane);
+    auto* destination = frame.data(plane) + y * stride + x;
+    bool subsampling_x = plane > 0 && m_parser->m_subsampling_x;
+    bool subsampling_y = plane > 0 && m_parser->m_subsampling_y;
+
+    // Motion vectors that point further outside the frame than the filter taps reach only read copies of the edge samples,
+    // so they are clamped to just past the edge, relative to the whole block rather than to this part of it.
+    auto plane_size = m_parser->get_plane_block_size(max(tile.mi_size, Block_8x8), plane);
+    i32 block_width = num_4x4_blocks_wide_lookup[plane_size] * 4;
+    i32 block_height = num_4x4_blocks_high_lookup[plane_size] * 4;
+    i32 to_left_edge = -static_cast<i32>(tile.mi_col * MI_SIZE * 8);
+    i32 to_right_edge = (static_cast<i32>(m_parser->m_mi_cols) - num_8x8_blocks_wide_lookup[tile.mi_size] - static_cast<i32>(tile.mi_col)) * MI_SIZE * 8;
+    i32 to_top_edge = -static_cast<i32>(tile.mi_row * MI_SIZE * 8);
+    i32 to_bottom_edge = (static_cast<i32>(m_parser->m_mi_rows) - num_8x8_blocks_high_lookup[tile.mi_size] - static_cast<i32>(tile.mi_row)) * MI_SIZE * 8;
+    i32 scale_x = 1 << (1 - subsampling_x);
+    i32 scale_y = 1 << (1 - subsampling_y);
+    i32 spel_left = (INTERP_EXTEND + block_width) << SUBPEL_BITS;
+    i32 spel_right = spel_left - SUBPEL_SHIFTS;
+    i32 spel_top = (INTERP_EXTEND + block_height) << SUBPEL_BITS;
+    i32 spel_bottom = spel_top - SUBPEL_SHIFTS;
+
+    bool is_compound = tile.ref_frame[1] > IntraFrame;
+    for (u8 ref_list = 0; ref_list < 1 + is_compound; ref_list++) {
+        auto const& reference = m_reference_frames[m_parser->m_ref_frame_idx[tile.ref_frame[ref_list] - LastFrame]];
+        if (!reference) {
+            dbgln("VP9: Block refers to a frame that has not been decoded");
+            return false;
+        }
+        if (reference->width() != frame.width() || reference->height() != frame.height()) {
+            dbgln("VP9: Scaled reference frames are not supported");
+            return false;
+        }
+
+        // Blocks smaller than 8x8 have a motion vector for each 4x4 block, which are averaged in subsampled planes.
+        MV mv;
+        if (tile.mi_size >= Block_8x8) {
+            mv = tile.block_mvs[ref_list][3];
+        } else {
+            auto const* mvs = tile.block_mvs[ref_list];
+            auto average_of_2 = [](i32 a, i32 b) { auto sum = a + b; return (sum < 0 ? sum - 1 : sum + 1) / 2; };
+            auto average_of_4 = [](i32 a, i32 b, i32 c, i32 d) { auto sum = a + b + c + d; return (sum < 0 ? sum - 2 : sum + 2) / 4; };
+            if (subsampling_x && subsampling_y) {
+                mv = MV(average_of_4(mvs[0].row(), mvs[1].row(), mvs[2].row(), mvs[3].row()),
+                    average_of_4(mvs[0].col(), mvs[1].col(), mvs[2].col(), mvs[3].col()));
+            } else if (subsampling_x || subsampling_y) {
+                // NOTE: The lower block of 4:2:2 chroma averages the second and third motion vectors rather than the third
+                //       and fourth, which is what libvpx does and so what the streams out there were encoded against.
+                auto other = block_index + (subsampling_y ? 2 : 1);
+                mv = MV(average_of_2(mvs[block_index].row(), mvs[other].row()), average_of_2(mvs[block_index].col(), mvs[other].col()));
+            } else {
+                mv = mvs[block_index];
+            }
+        }
+
+        i32 row = clamp(mv.row() * scale_y, to_top_edge * scale_y - spel_top, to_bottom_edge * scale_y + spel_bottom);
+        i32 column = clamp(mv.col() * scale_x, to_left_edge * scale_x - spel_left, to_right_edge * scale_x + spel_right);
+        auto reference_stride = reference->stride(plane);
+        auto const* source = reference->data(plane) + (static_cast<i32>(y) + (row >> SUBPEL_BITS)) * static_cast<ssize_t>(reference_stride) + static_cast<i32>(x) + (column >> SUBPEL_BITS);
+        auto const& filters = subpel_filters[tile.interp_filter];
+
+        if (ref_list == 0) {
+            predict_block(source, reference_stride, destination, stride, w, h, filters, column & SUBPEL_MASK, row & SUBPEL_MASK);
+            continue;
+        }
+
+        // The second prediction of a compound block is averaged into the first one.
+        u8 prediction[64 * 64];
+        predict_block(source, reference_stride, prediction, 64, w, h, filters, column & SUBPEL_MASK, row & SUBPEL_MASK);
+        for (u32 i = 0; i < h; i++) {
+            for (u32 j = 0; j < w; j++)
+                destination[i * stride + j] = average_2(destination[i * stride + j], prediction[i * 64 + j]);
+        }
+    }
     return true;
 }
 
-bool Decoder::reconstruct(size_t, u32, u32, TXSize)
+bool Decoder::reconstruct(TileContext& tile, size_t plane, u32 x, u32 y, TXSize tx_size, u32 eob)
 {
-    // TODO: Implement
+    auto& frame = *m_current_frame;
+    auto stride = frame.stride(plane);
+    inverse_transform_and_add(tile.coefficients, tx_size, tile.tx_type, m_parser->m_lossless, eob, tile.last_nonzero_row, frame.data(plane) + y * stride + x, stride);
+
+    // Only the rows up to the last one with a nonzero coefficient can have been written to.
+    __builtin_memset(tile.coefficients, 0, (tile.last_nonzero_row + 1) * (4u << tx_size) * sizeof(i32));
     return true;
 }
 
 bool Decoder::update_reference_frames()
 {
     for (auto i = 0; i < NUM_REF_FRAMES; i++) {
-        dbgln("updating frame {}? {}", i, (m_parser->m_refresh_frame_flags & (1 << i)) == 1);
-        if ((m_parser->m_refresh_frame_flags & (1 << i)) != 1)
+        if ((m_parser->m_refresh_frame_flags & (1 << i)) == 0)
             continue;
+        m_reference_frames[i] = m_current_frame;
         m_parser->m_ref_frame_width[i] = m_parser->m_frame_width;
         m_parser->m_ref_frame_height[i] = m_parser->m_frame_height;
-        // TODO: 1.3-1.7
     }
-    // TODO: 2.1-2.2
     return true;
 }
 
@@ -6,8 +6,12 @@
 
 #pragma once
 
+#include "Frame.h"
+#include "LoopFilter.h"
 #include "Parser.h"
 #include <AK/ByteBuffer.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/RefPtr.h>
 
 namespace Video::VP9 {
 
@@ -16,29 +20,46 @@ class Decoder {
 
 public:
     Decoder();
+    ~Decoder();
+    // Decodes one block of a Matroska stream, which can be a superframe that holds several frames.
     bool decode_frame(ByteBuffer const&);
     void dump_frame_info();
 
+    // The frame that the last call to decode_frame() made visible, if any. Superframes usually carry a frame that
+    // is only decoded to be referenced, so not every call shows a frame.
+    RefPtr<Frame> shown_frame() const { return m_shown_frame; }
+
 private:
+    bool decode_single_frame(ReadonlyBytes);
+    bool allocate_current_frame();
+
     /* (8.4) Probability Adaptation Process */
-    u8 merge_prob(u8 pre_prob, u8 count_0, u8 count_1, u8 count_sat, u8 max_update_factor);
-    u8 merge_probs(int const* tree, int index, u8* probs, u8* counts, u8 count_sat, u8 max_update_factor);
+    u8 merge_prob(u8 pre_prob, u32 count_0, u32 count_1, u8 count_sat, u8 max_update_factor);
+    u32 merge_probs(int const* tree, int index, u8 const* pre_probs, u8* probs, u32 const* counts, u8 count_sat, u8 max_update_factor);
     bool adapt_coef_probs();
     bool adapt_non_coef_probs();
-    void adapt_probs(int const* tree, u8* probs, u8* counts);
-    u8 adapt_prob(u8 prob, u8 counts[2]);
+    void adapt_probs(int const* tree, u8 const* pre_probs, u8* probs, u32 const* counts);
+    u8 adapt_prob(u8 pre_prob, u32 const counts[2]);
 
     /* (8.5) Prediction Processes */
-    bool predict_intra(size_t plane, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TXSize tx_size, u32 block_index);
-    bool predict_inter(size_t plane, u32 x, u32 y, u32 w, u32 h, u32 block_index);
+    bool predict_intra(TileContext&, size_t plane, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TXSize tx_size, u32 block_index);
+    bool predict_inter(TileContext&, size_t plane, u32 x, u32 y, u32 w, u32 h, u32 block_index);
 
     /* (8.6) Reconstruction and Dequantization */
-    bool reconstruct(size_t plane, u32 x, u32 y, TXSize size);
+    bool reconstruct(TileContext&, size_t plane, u32 x, u32 y, TXSize size, u32 eob);
 
     /* (8.10) Reference Frame Update Process */
     bool update_reference_frames();
 
     NonnullOwnPtr<Parser> m_parser;
+    LoopFilter m_loop_filter;
+
+    RefPtr<Frame> m_current_frame;
+    RefPtr<Frame> m_shown_frame;
+    RefPtr<Frame> m_reference_frames[NUM_REF_FRAMES];
+    // Every frame that has been allocated. The ones that are only referenced from here anymore are reused, so
+    // decoding a stream settles down to not allocating at all.
+    NonnullRefPtrVector<Frame> m_frame_pool;
 };
 
 }
@@ -107,11 +107,12 @@ enum IntraMode : u8 {
     TmPred = 9,
 };
 
+// NOTE: The inter modes continue where the intra modes leave off, since a block's y_mode can be either.
 enum InterMode : u8 {
-    NearestMv = 0,
-    NearMv = 1,
-    ZeroMv = 2,
-    NewMv = 3,
+    NearestMv = 10,
+    NearMv = 11,
+    ZeroMv = 12,
+    NewMv = 13,
 };
 
 enum MvJoint : u8 {
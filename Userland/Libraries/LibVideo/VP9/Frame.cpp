@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Frame.h"
+#include "Utilities.h"
+#include <string.h>
+
+namespace Video::VP9 {
+
+ErrorOr<NonnullRefPtr<Frame>> Frame::try_create(u32 width, u32 height, bool subsampling_x, bool subsampling_y)
+{
+    if (width == 0 || height == 0 || width > 65536 || height > 65536)
+        return Error::from_string_literal("Video::VP9::Frame size out of range"sv);
+
+    auto frame = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Frame(width, height, subsampling_x, subsampling_y)));
+    auto aligned_width = align_up_to(width, 8u);
+    auto aligned_height = align_up_to(height, 8u);
+    for (u8 plane = 0; plane < 3; plane++) {
+        auto& frame_plane = frame->m_planes[plane];
+        frame_plane.aligned_width = plane == 0 ? aligned_width : aligned_width >> subsampling_x;
+        frame_plane.aligned_height = plane == 0 ? aligned_height : aligned_height >> subsampling_y;
+        frame_plane.stride = align_up_to(frame_plane.aligned_width + 2 * border_size, 16u);
+        auto rows = frame_plane.aligned_height + 2 * border_size;
+        auto buffer = TRY(FixedArray<u8>::try_create(frame_plane.stride * rows));
+        frame_plane.buffer.swap(buffer);
+        frame_plane.origin = frame_plane.buffer.data() + border_size * frame_plane.stride + border_size;
+    }
+    return frame;
+}
+
+Frame::Frame(u32 width, u32 height, bool subsampling_x, bool subsampling_y)
+    : m_width(width)
+    , m_height(height)
+    , m_subsampling_x(subsampling_x)
+    , m_subsampling_y(subsampling_y)
+{
+}
+
+void Frame::extend_borders()
+{
+    for (u8 plane = 0; plane < 3; plane++) {
+        auto& frame_plane = m_planes[plane];
+        auto width = plane_width(plane);
+        auto height = plane_height(plane);
+        auto right_extent = frame_plane.stride - border_size - width;
+
+        for (u32 y = 0; y < height; y++) {
+            auto* row = frame_plane.origin + y * frame_plane.stride;
+            memset(row - border_size, row[0], border_size);
+            memset(row + width, row[width - 1], right_extent);
+        }
+
+        auto* first_row = frame_plane.origin - border_size;
+        auto* last_row = first_row + (height - 1) * frame_plane.stride;
+        for (u32 y = 1; y <= border_size; y++)
+            memcpy(first_row - y * frame_plane.stride, first_row, frame_plane.stride);
+        for (u32 y = height; y < frame_plane.aligned_height + border_size; y++)
+            memcpy(first_row + y * frame_plane.stride, last_row, frame_plane.stride);
+    }
+}
+
+void Frame::convert_to_bgrx8888(u32* destination, size_t destination_pitch) const
+{
+    for (u32 y = 0; y < m_height; y++) {
+        auto const* y_row = m_planes[0].origin + y * m_planes[0].stride;
+        auto const* u_row = m_planes[1].origin + (y >> m_subsampling_y) * m_planes[1].stride;
+        auto const* v_row = m_planes[2].origin + (y >> m_subsampling_y) * m_planes[2].stride;
+        auto* output = reinterpret_cast<u32*>(reinterpret_cast<u8*>(destination) + y * destination_pitch);
+        for (u32 x = 0; x < m_width; x++) {
+            i32 luma = 298 * (y_row[x] - 16) + 128;
+            i32 cb = u_row[x >> m_subsampling_x] - 128;
+            i32 cr = v_row[x >> m_subsampling_x] - 128;
+            u32 red = clip_1((luma + 409 * cr) >> 8);
+            u32 green = clip_1((luma - 100 * cb - 208 * cr) >> 8);
+            u32 blue = clip_1((luma + 516 * cb) >> 8);
+            output[x] = 0xff000000 | (red << 16) | (green << 8) | blue;
+        }
+    }
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+
+namespace Video::VP9 {
+
+// A decoded frame, kept as three planes of 8-bit samples. The planes are padded up to a multiple of 8 luma
+// samples, which is what blocks are decoded in, and surrounded by a border that extend_borders() fills with
+// copies of the edge samples. Motion vectors are clamped to point no further than this border, so inter
+// prediction can read from reference frames without clamping every coordinate.
+class Frame : public RefCounted<Frame> {
+public:
+    static constexpr u32 border_size = 80;
+
+    static ErrorOr<NonnullRefPtr<Frame>> try_create(u32 width, u32 height, bool subsampling_x, bool subsampling_y);
+
+    u32 width() const { return m_width; }
+    u32 height() const { return m_height; }
+    bool subsampling_x() const { return m_subsampling_x; }
+    bool subsampling_y() const { return m_subsampling_y; }
+
+    // The size of a plane, without the padding.
+    u32 plane_width(u8 plane) const { return plane == 0 ? m_width : (m_width + m_subsampling_x) >> m_subsampling_x; }
+    u32 plane_height(u8 plane) const { return plane == 0 ? m_height : (m_height + m_subsampling_y) >> m_subsampling_y; }
+    // The size of a plane, including the padding to a multiple of 8 luma samples.
+    u32 aligned_plane_width(u8 plane) const { return m_planes[plane].aligned_width; }
+    u32 aligned_plane_height(u8 plane) const { return m_planes[plane].aligned_height; }
+
+    size_t stride(u8 plane) const { return m_planes[plane].stride; }
+    // NOTE: These point at the top left sample of the plane, and the border can be reached with negative offsets.
+    u8* data(u8 plane) { return m_planes[plane].origin; }
+    u8 const* data(u8 plane) const { return m_planes[plane].origin; }
+
+    // Overwrites the border and the padding with copies of the closest samples within the frame.
+    void extend_borders();
+
+    // Converts the frame to 32-bit BGRx pixels, treating the samples as BT.601 studio swing YUV.
+    void convert_to_bgrx8888(u32* destination, size_t destination_pitch) const;
+
+private:
+    struct Plane {
+        FixedArray<u8> buffer;
+        u8* origin { nullptr };
+        size_t stride { 0 };
+        u32 aligned_width { 0 };
+        u32 aligned_height { 0 };
+    };
+
+    Frame(u32 width, u32 height, bool subsampling_x, bool subsampling_y);
+
+    u32 m_width { 0 };
+    u32 m_height { 0 };
+    bool m_subsampling_x { false };
+    bool m_subsampling_y { false };
+    Plane m_planes[3];
+};
+
+}
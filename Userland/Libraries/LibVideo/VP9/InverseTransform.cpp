@@ -0,0 +1,567 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "InverseTransform.h"
+#include "Symbols.h"
+#include "Utilities.h"
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
+
+namespace Video::VP9 {
+
+using AK::SIMD::i32x4;
+
+// cos(k * pi / 64) and 2 * sqrt(2) / 3 * sin(k * pi / 9), with 14 fractional bits.
+static constexpr i32 cospi[32] = {
+    16384, 16364, 16305, 16207, 16069, 15893, 15679, 15426, 15137, 14811, 14449, 14053, 13623, 13160, 12665, 12140,
+    11585, 11003, 10394, 9760, 9102, 8423, 7723, 7005, 6270, 5520, 4756, 3981, 3196, 2404, 1606, 804
+};
+static constexpr i32 sinpi_1_9 = 5283;
+static constexpr i32 sinpi_2_9 = 9929;
+static constexpr i32 sinpi_3_9 = 13377;
+static constexpr i32 sinpi_4_9 = 15212;
+
+// NOTE: All of the 1D transforms are written for both plain integers and vectors of them, so that the 2D transforms
+//       can run them on four rows or columns at once, one per vector lane. The arithmetic is the same either way, and
+//       has to match the reference decoder bit for bit, since any differences would accumulate in later frames.
+template<typename T>
+ALWAYS_INLINE static T round_shift(T value)
+{
+    return (value + (1 << 13)) >> 14;
+}
+
+template<typename T, size_t N>
+struct InverseDCT;
+
+template<typename T>
+struct InverseDCT<T, 4> {
+    ALWAYS_INLINE static void transform(T const* in, T* out)
+    {
+        T step0 = round_shift((in[0] + in[2]) * cospi[16]);
+        T step1 = round_shift((in[0] - in[2]) * cospi[16]);
+        T step2 = round_shift(in[1] * cospi[24] - in[3] * cospi[8]);
+        T step3 = round_shift(in[1] * cospi[8] + in[3] * cospi[24]);
+        out[0] = step0 + step3;
+        out[1] = step1 + step2;
+        out[2] = step1 - step2;
+        out[3] = step0 - step3;
+    }
+};
+
+// The even inputs of an N-point inverse DCT make up an N/2-point inverse DCT, and the odd inputs are combined with its
+// outputs in butterflies, so each of the larger transforms only needs to spell out its odd half.
+template<typename T, size_t N>
+ALWAYS_INLINE static void combine_even_and_odd_halves(T const* in, T* out, void (*odd_half)(T const*, T*))
+{
+    T even_in[N / 2];
+    T even_out[N / 2];
+    T odd_out[N / 2];
+    for (size_t i = 0; i < N / 2; i++)
+        even_in[i] = in[2 * i];
+    InverseDCT<T, N / 2>::transform(even_in, even_out);
+    odd_half(in, odd_out);
+    for (size_t i = 0; i < N / 2; i++) {
+        out[i] = even_out[i] + odd_out[N / 2 - 1 - i];
+        out[N - 1 - i] = even_out[i] - odd_out[N / 2 - 1 - i];
+    }
+}
+
+template<typename T>
+struct InverseDCT<T, 8> {
+    static void odd_half(T const* in, T* out)
+    {
+        T step4 = round_shift(in[1] * cospi[28] - in[7] * cospi[4]);
+        T step7 = round_shift(in[1] * cospi[4] + in[7] * cospi[28]);
+        T step5 = round_shift(in[5] * cospi[12] - in[3] * cospi[20]);
+        T step6 = round_shift(in[5] * cospi[20] + in[3] * cospi[12]);
+
+        T sum45 = step4 + step5;
+        T difference45 = step4 - step5;
+        T difference76 = step7 - step6;
+        T sum67 = step6 + step7;
+
+        out[0] = sum45;
+        out[1] = round_shift((difference76 - difference45) * cospi[16]);
+        out[2] = round_shift((difference45 + difference76) * cospi[16]);
+        out[3] = sum67;
+    }
+
+    ALWAYS_INLINE static void transform(T const* in, T* out)
+    {
+        combine_even_and_odd_halves<T, 8>(in, out, odd_half);
+    }
+};
+
+template<typename T>
+struct InverseDCT<T, 16> {
+    static void odd_half(T const* in, T* out)
+    {
+        // Stage 2
+        T s8 = round_shift(in[1] * cospi[30] - in[15] * cospi[2]);
+        T s15 = round_shift(in[1] * cospi[2] + in[15] * cospi[30]);
+        T s9 = round_shift(in[9] * cospi[14] - in[7] * cospi[18]);
+        T s14 = round_shift(in[9] * cospi[18] + in[7] * cospi[14]);
+        T s10 = round_shift(in[5] * cospi[22] - in[11] * cospi[10]);
+        T s13 = round_shift(in[5] * cospi[10] + in[11] * cospi[22]);
+        T s11 = round_shift(in[13] * cospi[6] - in[3] * cospi[26]);
+        T s12 = round_shift(in[13] * cospi[26] + in[3] * cospi[6]);
+
+        // Stage 3
+        T t8 = s8 + s9;
+        T t9 = s8 - s9;
+        T t10 = s11 - s10;
+        T t11 = s10 + s11;
+        T t12 = s12 + s13;
+        T t13 = s12 - s13;
+        T t14 = s15 - s14;
+        T t15 = s14 + s15;
+
+        // Stage 4
+        T u9 = round_shift(t14 * cospi[24] - t9 * cospi[8]);
+        T u14 = round_shift(t9 * cospi[24] + t14 * cospi[8]);
+        T u10 = round_shift(-t10 * cospi[24] - t13 * cospi[8]);
+        T u13 = round_shift(t13 * cospi[24] - t10 * cospi[8]);
+
+        // Stage 5
+        T v8 = t8 + t11;
+        T v9 = u9 + u10;
+        T v10 = u9 - u10;
+        T v11 = t8 - t11;
+        T v12 = t15 - t12;
+        T v13 = u14 - u13;
+        T v14 = u13 + u14;
+        T v15 = t12 + t15;
+
+        // Stage 6
+        out[0] = v8;
+        out[1] = v9;
+        out[2] = round_shift((v13 - v10) * cospi[16]);
+        out[3] = round_shift((v12 - v11) * cospi[16]);
+        out[4] = round_shift((v11 + v12) * cospi[16]);
+        out[5] = round_shift((v10 + v13) * cospi[16]);
+        out[6] = v14;
+        out[7] = v15;
+    }
+
+    ALWAYS_INLINE static void transform(T const* in, T* out)
+    {
+        combine_even_and_odd_halves<T, 16>(in, out, odd_half);
+    }
+};
+
+template<typename T>
+struct InverseDCT<T, 32> {
+    static void odd_half(T const* in, T* out)
+    {
+        T a[32];
+        T b[32];
+
+        // Stage 1
+        a[16] = round_shift(in[1] * cospi[31] - in[31] * cospi[1]);
+        a[31] = round_shift(in[1] * cospi[1] + in[31] * cospi[31]);
+        a[17] = round_shift(in[17] * cospi[15] - in[15] * cospi[17]);
+        a[30] = round_shift(in[17] * cospi[17] + in[15] * cospi[15]);
+        a[18] = round_shift(in[9] * cospi[23] - in[23] * cospi[9]);
+        a[29] = round_shift(in[9] * cospi[9] + in[23] * cospi[23]);
+        a[19] = round_shift(in[25] * cospi[7] - in[7] * cospi[25]);
+        a[28] = round_shift(in[25] * cospi[25] + in[7] * cospi[7]);
+        a[20] = round_shift(in[5] * cospi[27] - in[27] * cospi[5]);
+        a[27] = round_shift(in[5] * cospi[5] + in[27] * cospi[27]);
+        a[21] = round_shift(in[21] * cospi[11] - in[11] * cospi[21]);
+        a[26] = round_shift(in[21] * cospi[21] + in[11] * cospi[11]);
+        a[22] = round_shift(in[13] * cospi[19] - in[19] * cospi[13]);
+        a[25] = round_shift(in[13] * cospi[13] + in[19] * cospi[19]);
+        a[23] = round_shift(in[29] * cospi[3] - in[3] * cospi[29]);
+        a[24] = round_shift(in[29] * cospi[29] + in[3] * cospi[3]);
+
+        // Stage 2
+        for (size_t i = 16; i < 32; i += 4) {
+            b[i] = a[i] + a[i + 1];
+            b[i + 1] = a[i] - a[i + 1];
+            b[i + 2] = a[i + 3] - a[i + 2];
+            b[i + 3] = a[i + 2] + a[i + 3];
+        }
+
+        // Stage 3
+        a[16] = b[16];
+        a[31] = b[31];
+        a[17] = round_shift(b[30] * cospi[28] - b[17] * cospi[4]);
+        a[30] = round_shift(b[17] * cospi[28] + b[30] * cospi[4]);
+        a[18] = round_shift(-b[18] * cospi[28] - b[29] * cospi[4]);
+        a[29] = round_shift(b[29] * cospi[28] - b[18] * cospi[4]);
+        a[19] = b[19];
+        a[20] = b[20];
+        a[21] = round_shift(b[26] * cospi[12] - b[21] * cospi[20]);
+        a[26] = round_shift(b[21] * cospi[12] + b[26] * cospi[20]);
+        a[22] = round_shift(-b[22] * cospi[12] - b[25] * cospi[20]);
+        a[25] = round_shift(b[25] * cospi[12] - b[22] * cospi[20]);
+        a[23] = b[23];
+        a[24] = b[24];
+        a[27] = b[27];
+        a[28] = b[28];
+
+        // Stage 4
+        for (size_t i = 16; i < 32; i += 8) {
+            b[i] = a[i] + a[i + 3];
+            b[i + 1] = a[i + 1] + a[i + 2];
+            b[i + 2] = a[i + 1] - a[i + 2];
+            b[i + 3] = a[i] - a[i + 3];
+            b[i + 4] = a[i + 7] - a[i + 4];
+            b[i + 5] = a[i + 6] - a[i + 5];
+            b[i + 6] = a[i + 5] + a[i + 6];
+            b[i + 7] = a[i + 4] + a[i + 7];
+        }
+
+        // Stage 5
+        a[16] = b[16];
+        a[17] = b[17];
+        a[18] = round_shift(b[29] * cospi[24] - b[18] * cospi[8]);
+        a[29] = round_shift(b[18] * cospi[24] + b[29] * cospi[8]);
+        a[19] = round_shift(b[28] * cospi[24] - b[19] * cospi[8]);
+        a[28] = round_shift(b[19] * cospi[24] + b[28] * cospi[8]);
+        a[20] = round_shift(-b[20] * cospi[24] - b[27] * cospi[8]);
+        a[27] = round_shift(b[27] * cospi[24] - b[20] * cospi[8]);
+        a[21] = round_shift(-b[21] * cospi[24] - b[26] * cospi[8]);
+        a[26] = round_shift(b[26] * cospi[24] - b[21] * cospi[8]);
+        a[22] = b[22];
+        a[23] = b[23];
+        a[24] = b[24];
+        a[25] = b[25];
+        a[30] = b[30];
+        a[31] = b[31];
+
+        // Stage 6
+        for (size_t i = 0; i < 4; i++) {
+            b[16 + i] = a[16 + i] + a[23 - i];
+            b[23 - i] = a[16 + i] - a[23 - i];
+            b[24 + i] = a[31 - i] - a[24 + i];
+            b[31 - i] = a[24 + i] + a[31 - i];
+        }
+
+        // Stage 7
+        for (size_t i = 16; i < 20; i++)
+            out[i - 16] = b[i];
+        for (size_t i = 0; i < 4; i++) {
+            out[4 + i] = round_shift((b[27 - i] - b[20 + i]) * cospi[16]);
+            out[11 - i] = round_shift((b[20 + i] + b[27 - i]) * cospi[16]);
+        }
+        for (size_t i = 28; i < 32; i++)
+            out[i - 16] = b[i];
+    }
+
+    ALWAYS_INLINE static void transform(T const* in, T* out)
+    {
+        combine_even_and_odd_halves<T, 32>(in, out, odd_half);
+    }
+};
+
+template<typename T>
+static void inverse_adst4(T const* in, T* out)
+{
+    T s0 = in[0] * sinpi_1_9 + in[2] * sinpi_4_9 + in[3] * sinpi_2_9;
+    T s1 = in[0] * sinpi_2_9 - in[2] * sinpi_1_9 - in[3] * sinpi_4_9;
+    T s2 = (in[0] - in[2] + in[3]) * sinpi_3_9;
+    T s3 = in[1] * sinpi_3_9;
+
+    out[0] = round_shift(s0 + s3);
+    out[1] = round_shift(s1 + s3);
+    out[2] = round_shift(s2);
+    out[3] = round_shift(s0 + s1 - s3);
+}
+
+template<typename T>
+static void inverse_adst8(T const* in, T* out)
+{
+    T x0 = in[7];
+    T x1 = in[0];
+    T x2 = in[5];
+    T x3 = in[2];
+    T x4 = in[3];
+    T x5 = in[4];
+    T x6 = in[1];
+    T x7 = in[6];
+
+    // Stage 1
+    T s0 = x0 * cospi[2] + x1 * cospi[30];
+    T s1 = x0 * cospi[30] - x1 * cospi[2];
+    T s2 = x2 * cospi[10] + x3 * cospi[22];
+    T s3 = x2 * cospi[22] - x3 * cospi[10];
+    T s4 = x4 * cospi[18] + x5 * cospi[14];
+    T s5 = x4 * cospi[14] - x5 * cospi[18];
+    T s6 = x6 * cospi[26] + x7 * cospi[6];
+    T s7 = x6 * cospi[6] - x7 * cospi[26];
+
+    x0 = round_shift(s0 + s4);
+    x1 = round_shift(s1 + s5);
+    x2 = round_shift(s2 + s6);
+    x3 = round_shift(s3 + s7);
+    x4 = round_shift(s0 - s4);
+    x5 = round_shift(s1 - s5);
+    x6 = round_shift(s2 - s6);
+    x7 = round_shift(s3 - s7);
+
+    // Stage 2
+    s4 = x4 * cospi[8] + x5 * cospi[24];
+    s5 = x4 * cospi[24] - x5 * cospi[8];
+    s6 = x7 * cospi[8] - x6 * cospi[24];
+    s7 = x6 * cospi[8] + x7 * cospi[24];
+
+    T y0 = x0 + x2;
+    T y1 = x1 + x3;
+    T y2 = x0 - x2;
+    T y3 = x1 - x3;
+    x4 = round_shift(s4 + s6);
+    x5 = round_shift(s5 + s7);
+    x6 = round_shift(s4 - s6);
+    x7 = round_shift(s5 - s7);
+
+    // Stage 3
+    T z2 = round_shift((y2 + y3) * cospi[16]);
+    T z3 = round_shift((y2 - y3) * cospi[16]);
+    T z6 = round_shift((x6 + x7) * cospi[16]);
+    T z7 = round_shift((x6 - x7) * cospi[16]);
+
+    out[0] = y0;
+    out[1] = -x4;
+    out[2] = z6;
+    out[3] = -z2;
+    out[4] = z3;
+    out[5] = -z7;
+    out[6] = x5;
+    out[7] = -y1;
+}
+
+template<typename T>
+static void inverse_adst16(T const* in, T* out)
+{
+    T x[16] = {
+        in[15], in[0], in[13], in[2], in[11], in[4], in[9], in[6],
+        in[7], in[8], in[5], in[10], in[3], in[12], in[1], in[14]
+    };
+    T s[16];
+
+    // Stage 1
+    static constexpr u8 stage_1_angles[8][2] = { { 1, 31 }, { 5, 27 }, { 9, 23 }, { 13, 19 }, { 17, 15 }, { 21, 11 }, { 25, 7 }, { 29, 3 } };
+    for (size_t i = 0; i < 8; i++) {
+        auto c0 = cospi[stage_1_angles[i][0]];
+        auto c1 = cospi[stage_1_angles[i][1]];
+        s[2 * i] = x[2 * i] * c0 + x[2 * i + 1] * c1;
+        s[2 * i + 1] = x[2 * i] * c1 - x[2 * i + 1] * c0;
+    }
+    for (size_t i = 0; i < 8; i++) {
+        x[i] = round_shift(s[i] + s[i + 8]);
+        x[i + 8] = round_shift(s[i] - s[i + 8]);
+    }
+
+    // Stage 2
+    s[8] = x[8] * cospi[4] + x[9] * cospi[28];
+    s[9] = x[8] * cospi[28] - x[9] * cospi[4];
+    s[10] = x[10] * cospi[20] + x[11] * cospi[12];
+    s[11] = x[10] * cospi[12] - x[11] * cospi[20];
+    s[12] = x[13] * cospi[4] - x[12] * cospi[28];
+    s[13] = x[12] * cospi[4] + x[13] * cospi[28];
+    s[14] = x[15] * cospi[20] - x[14] * cospi[12];
+    s[15] = x[14] * cospi[20] + x[15] * cospi[12];
+    for (size_t i = 0; i < 4; i++) {
+        s[i] = x[i] + x[i + 4];
+        s[i + 4] = x[i] - x[i + 4];
+    }
+    for (size_t i = 0; i < 8; i++)
+        x[i] = s[i];
+    for (size_t i = 8; i < 12; i++) {
+        x[i] = round_shift(s[i] + s[i + 4]);
+        x[i + 4] = round_shift(s[i] - s[i + 4]);
+    }
+
+    // Stage 3
+    for (size_t i = 4; i < 16; i += 8) {
+        s[i] = x[i] * cospi[8] + x[i + 1] * cospi[24];
+        s[i + 1] = x[i] * cospi[24] - x[i + 1] * cospi[8];
+        s[i + 2] = x[i + 3] * cospi[8] - x[i + 2] * cospi[24];
+        s[i + 3] = x[i + 2] * cospi[8] + x[i + 3] * cospi[24];
+    }
+    for (size_t i = 0; i < 16; i += 8) {
+        T x0 = x[i];
+        T x1 = x[i + 1];
+        x[i] = x0 + x[i + 2];
+        x[i + 1] = x1 + x[i + 3];
+        x[i + 2] = x0 - x[i + 2];
+        x[i + 3] = x1 - x[i + 3];
+        x[i + 4] = round_shift(s[i + 4] + s[i + 6]);
+        x[i + 5] = round_shift(s[i + 5] + s[i + 7]);
+        x[i + 6] = round_shift(s[i + 4] - s[i + 6]);
+        x[i + 7] = round_shift(s[i + 5] - s[i + 7]);
+    }
+
+    // Stage 4
+    T x2 = round_shift((x[2] + x[3]) * -cospi[16]);
+    T x3 = round_shift((x[2] - x[3]) * cospi[16]);
+    T x6 = round_shift((x[6] + x[7]) * cospi[16]);
+    T x7 = round_shift((x[7] - x[6]) * cospi[16]);
+    T x10 = round_shift((x[10] + x[11]) * cospi[16]);
+    T x11 = round_shift((x[11] - x[10]) * cospi[16]);
+    T x14 = round_shift((x[14] + x[15]) * -cospi[16]);
+    T x15 = round_shift((x[14] - x[15]) * cospi[16]);
+
+    out[0] = x[0];
+    out[1] = -x[8];
+    out[2] = x[12];
+    out[3] = -x[4];
+    out[4] = x6;
+    out[5] = x14;
+    out[6] = x10;
+    out[7] = x2;
+    out[8] = x3;
+    out[9] = x11;
+    out[10] = x15;
+    out[11] = x7;
+    out[12] = x[5];
+    out[13] = -x[13];
+    out[14] = x[9];
+    out[15] = -x[1];
+}
+
+template<typename T, size_t N>
+ALWAYS_INLINE static void inverse_transform_1d(T const* in, T* out, bool adst)
+{
+    if (!adst) {
+        InverseDCT<T, N>::transform(in, out);
+        return;
+    }
+    if constexpr (N == 4)
+        inverse_adst4(in, out);
+    else if constexpr (N == 8)
+        inverse_adst8(in, out);
+    else if constexpr (N == 16)
+        inverse_adst16(in, out);
+    else
+        VERIFY_NOT_REACHED();
+}
+
+ALWAYS_INLINE static i32x4 clamp_to_u8(i32x4 value)
+{
+    value &= ~(value < 0);
+    auto const too_large = value > 255;
+    return (value & ~too_large) | (AK::SIMD::expand4(255) & too_large);
+}
+
+template<size_t N>
+static void inverse_transform_2d_and_add(i32 const* coefficients, bool row_adst, bool column_adst, u32 last_nonzero_row, u8* destination, size_t stride)
+{
+    constexpr u8 shift = N == 4 ? 4 : (N == 8 ? 5 : 6);
+    alignas(16) i32 intermediate[N * N];
+
+    // Rows, four at a time. Rows of zeroes transform to zeroes, and usually most of them are.
+    size_t row = 0;
+    for (; row <= last_nonzero_row; row += 4) {
+        i32x4 in[N];
+        i32x4 out[N];
+        for (size_t i = 0; i < N; i++)
+            in[i] = i32x4 { coefficients[row * N + i], coefficients[(row + 1) * N + i], coefficients[(row + 2) * N + i], coefficients[(row + 3) * N + i] };
+        inverse_transform_1d<i32x4, N>(in, out, row_adst);
+        for (size_t i = 0; i < N; i++) {
+            for (size_t lane = 0; lane < 4; lane++)
+                intermediate[(row + lane) * N + i] = out[i][lane];
+        }
+    }
+    __builtin_memset(intermediate + row * N, 0, (N - row) * N * sizeof(i32));
+
+    // Columns, four at a time, after which the results are added to the prediction.
+    for (size_t column = 0; column < N; column += 4) {
+        i32x4 in[N];
+        i32x4 out[N];
+        for (size_t i = 0; i < N; i++)
+            __builtin_memcpy(&in[i], &intermediate[i * N + column], sizeof(i32x4));
+        inverse_transform_1d<i32x4, N>(in, out, column_adst);
+        for (size_t i = 0; i < N; i++) {
+            auto* pixels = destination + i * stride + column;
+            auto residual = (out[i] + (1 << (shift - 1))) >> shift;
+            auto result = clamp_to_u8(i32x4 { pixels[0], pixels[1], pixels[2], pixels[3] } + residual);
+            for (size_t lane = 0; lane < 4; lane++)
+                pixels[lane] = result[lane];
+        }
+    }
+}
+
+template<size_t N>
+static void inverse_dct_dc_only_and_add(i32 dc, u8* destination, size_t stride)
+{
+    constexpr u8 shift = N == 4 ? 4 : (N == 8 ? 5 : 6);
+    auto value = round_shift(round_shift(dc * cospi[16]) * cospi[16]);
+    auto residual = round_2(value, shift);
+    for (size_t y = 0; y < N; y++) {
+        for (size_t x = 0; x < N; x++)
+            destination[y * stride + x] = clip_1(destination[y * stride + x] + residual);
+    }
+}
+
+static void inverse_wht4x4_and_add(i32 const* coefficients, u8* destination, size_t stride)
+{
+    i32 intermediate[16];
+    auto transform = [](i32 a, i32 c, i32 d, i32 b, i32* out, size_t out_stride) {
+        a += c;
+        d -= b;
+        i32 e = (a - d) >> 1;
+        b = e - b;
+        c = e - c;
+        a -= b;
+        d += c;
+        out[0] = a;
+        out[out_stride] = b;
+        out[2 * out_stride] = c;
+        out[3 * out_stride] = d;
+    };
+
+    for (size_t i = 0; i < 4; i++) {
+        auto const* row = coefficients + i * 4;
+        transform(row[0] >> 2, row[1] >> 2, row[2] >> 2, row[3] >> 2, intermediate + i * 4, 1);
+    }
+    for (size_t i = 0; i < 4; i++) {
+        i32 column[4];
+        transform(intermediate[i], intermediate[4 + i], intermediate[8 + i], intermediate[12 + i], column, 1);
+        for (size_t j = 0; j < 4; j++)
+            destination[j * stride + i] = clip_1(destination[j * stride + i] + column[j]);
+    }
+}
+
+void inverse_transform_and_add(i32 const* coefficients, TXSize tx_size, u8 tx_type, bool lossless, u32 eob, u32 last_nonzero_row, u8* destination, size_t stride)
+{
+    if (lossless) {
+        inverse_wht4x4_and_add(coefficients, destination, stride);
+        return;
+    }
+
+    if (eob == 1 && tx_type == DCT_DCT) {
+        switch (tx_size) {
+        case TX_4x4:
+            return inverse_dct_dc_only_and_add<4>(coefficients[0], destination, stride);
+        case TX_8x8:
+            return inverse_dct_dc_only_and_add<8>(coefficients[0], destination, stride);
+        case TX_16x16:
+            return inverse_dct_dc_only_and_add<16>(coefficients[0], destination, stride);
+        case TX_32x32:
+            return inverse_dct_dc_only_and_add<32>(coefficients[0], destination, stride);
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    // NOTE: ADST_DCT is an ADST down the columns and a DCT along the rows, and vice versa for DCT_ADST.
+    bool row_adst = tx_type == DCT_ADST || tx_type == ADST_ADST;
+    bool column_adst = tx_type == ADST_DCT || tx_type == ADST_ADST;
+    switch (tx_size) {
+    case TX_4x4:
+        return inverse_transform_2d_and_add<4>(coefficients, row_adst, column_adst, last_nonzero_row, destination, stride);
+    case TX_8x8:
+        return inverse_transform_2d_and_add<8>(coefficients, row_adst, column_adst, last_nonzero_row, destination, stride);
+    case TX_16x16:
+        return inverse_transform_2d_and_add<16>(coefficients, row_adst, column_adst, last_nonzero_row, destination, stride);
+    case TX_32x32:
+        return inverse_transform_2d_and_add<32>(coefficients, false, false, last_nonzero_row, destination, stride);
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "Enums.h"
+#include <AK/Types.h>
+
+namespace Video::VP9 {
+
+/* (8.7.2) */
+// Inverse transforms a block of dequantized coefficients and adds the result to the predicted samples at the destination.
+// eob is the number of coefficients that were read in scan order, and rows below last_nonzero_row must be all zero.
+void inverse_transform_and_add(i32 const* coefficients, TXSize, u8 tx_type, bool lossless, u32 eob, u32 last_nonzero_row, u8* destination, size_t stride);
+
+}
@@ -289,4 +289,166 @@ static constexpr u8 cat_probs[7][14] = {
     { 254, 254, 254, 252, 249, 243, 230, 196, 177, 153, 140, 133, 130, 129 }
 };
 
+static constexpr i16 dc_qlookup[256] = {
+    4, 8, 8, 9, 10, 11, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19,
+    20, 21, 22, 23, 24, 25, 26, 26, 27, 28, 29, 30, 31, 32, 32, 33,
+    34, 35, 36, 37, 38, 38, 39, 40, 41, 42, 43, 43, 44, 45, 46, 47,
+    48, 48, 49, 50, 51, 52, 53, 53, 54, 55, 56, 57, 57, 58, 59, 60,
+    61, 62, 62, 63, 64, 65, 66, 66, 67, 68, 69, 70, 70, 71, 72, 73,
+    74, 74, 75, 76, 77, 78, 78, 79, 80, 81, 81, 82, 83, 84, 85, 85,
+    87, 88, 90, 92, 93, 95, 96, 98, 99, 101, 102, 104, 105, 107, 108, 110,
+    111, 113, 114, 116, 117, 118, 120, 121, 123, 125, 127, 129, 131, 134, 136, 138,
+    140, 142, 144, 146, 148, 150, 152, 154, 156, 158, 161, 164, 166, 169, 172, 174,
+    177, 180, 182, 185, 187, 190, 192, 195, 199, 202, 205, 208, 211, 214, 217, 220,
+    223, 226, 230, 233, 237, 240, 243, 247, 250, 253, 257, 261, 265, 269, 272, 276,
+    280, 284, 288, 292, 296, 300, 304, 309, 313, 317, 322, 326, 330, 335, 340, 344,
+    349, 354, 359, 364, 369, 374, 379, 384, 389, 395, 400, 406, 411, 417, 423, 429,
+    435, 441, 447, 454, 461, 467, 475, 482, 489, 497, 505, 513, 522, 530, 539, 549,
+    559, 569, 579, 590, 602, 614, 626, 640, 654, 668, 684, 700, 717, 736, 755, 775,
+    796, 819, 843, 869, 896, 925, 955, 988, 1022, 1058, 1098, 1139, 1184, 1232, 1282, 1336,
+};
+
+static constexpr i16 ac_qlookup[256] = {
+    4, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
+    23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38,
+    39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54,
+    55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70,
+    71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86,
+    87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102,
+    104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124, 126, 128, 130, 132, 134,
+    136, 138, 140, 142, 144, 146, 148, 150, 152, 155, 158, 161, 164, 167, 170, 173,
+    176, 179, 182, 185, 188, 191, 194, 197, 200, 203, 207, 211, 215, 219, 223, 227,
+    231, 235, 239, 243, 247, 251, 255, 260, 265, 270, 275, 280, 285, 290, 295, 300,
+    305, 311, 317, 323, 329, 335, 341, 347, 353, 359, 366, 373, 380, 387, 394, 401,
+    408, 416, 424, 432, 440, 448, 456, 465, 474, 483, 492, 501, 510, 520, 530, 540,
+    550, 560, 571, 582, 593, 604, 615, 627, 639, 651, 663, 676, 689, 702, 715, 729,
+    743, 757, 771, 786, 801, 816, 832, 848, 864, 881, 898, 915, 933, 951, 969, 988,
+    1007, 1026, 1046, 1066, 1087, 1108, 1129, 1151, 1173, 1196, 1219, 1243, 1267, 1292, 1317, 1343,
+    1369, 1396, 1423, 1451, 1479, 1508, 1537, 1567, 1597, 1628, 1660, 1692, 1725, 1759, 1793, 1828,
+};
+
+// The subpixel filters are indexed by InterpolationFilter, then by the position in sixteenths of a pixel.
+static constexpr i16 subpel_filters[4][16][8] = {
+    {
+        // EightTap
+        { 0, 0, 0, 128, 0, 0, 0, 0 },
+        { 0, 1, -5, 126, 8, -3, 1, 0 },
+        { -1, 3, -10, 122, 18, -6, 2, 0 },
+        { -1, 4, -13, 118, 27, -9, 3, -1 },
+        { -1, 4, -16, 112, 37, -11, 4, -1 },
+        { -1, 5, -18, 105, 48, -14, 4, -1 },
+        { -1, 5, -19, 97, 58, -16, 5, -1 },
+        { -1, 6, -19, 88, 68, -18, 5, -1 },
+        { -1, 6, -19, 78, 78, -19, 6, -1 },
+        { -1, 5, -18, 68, 88, -19, 6, -1 },
+        { -1, 5, -16, 58, 97, -19, 5, -1 },
+        { -1, 4, -14, 48, 105, -18, 5, -1 },
+        { -1, 4, -11, 37, 112, -16, 4, -1 },
+        { -1, 3, -9, 27, 118, -13, 4, -1 },
+        { 0, 2, -6, 18, 122, -10, 3, -1 },
+        { 0, 1, -3, 8, 126, -5, 1, 0 },
+    },
+    {
+        // EightTapSmooth
+        { 0, 0, 0, 128, 0, 0, 0, 0 },
+        { -3, -1, 32, 64, 38, 1, -3, 0 },
+        { -2, -2, 29, 63, 41, 2, -3, 0 },
+        { -2, -2, 26, 63, 43, 4, -4, 0 },
+        { -2, -3, 24, 62, 46, 5, -4, 0 },
+        { -2, -3, 21, 60, 49, 7, -4, 0 },
+        { -1, -4, 18, 59, 51, 9, -4, 0 },
+        { -1, -4, 16, 57, 53, 12, -4, -1 },
+        { -1, -4, 14, 55, 55, 14, -4, -1 },
+        { -1, -4, 12, 53, 57, 16, -4, -1 },
+        { 0, -4, 9, 51, 59, 18, -4, -1 },
+        { 0, -4, 7, 49, 60, 21, -3, -2 },
+        { 0, -4, 5, 46, 62, 24, -3, -2 },
+        { 0, -4, 4, 43, 63, 26, -2, -2 },
+        { 0, -3, 2, 41, 63, 29, -2, -2 },
+        { 0, -3, 1, 38, 64, 32, -1, -3 },
+    },
+    {
+        // EightTapSharp
+        { 0, 0, 0, 128, 0, 0, 0, 0 },
+        { -1, 3, -7, 127, 8, -3, 1, 0 },
+        { -2, 5, -13, 125, 17, -6, 3, -1 },
+        { -3, 7, -17, 121, 27, -10, 5, -2 },
+        { -4, 9, -20, 115, 37, -13, 6, -2 },
+        { -4, 10, -23, 108, 48, -16, 8, -3 },
+        { -4, 10, -24, 100, 59, -19, 9, -3 },
+        { -4, 11, -24, 90, 70, -21, 10, -4 },
+        { -4, 11, -23, 80, 80, -23, 11, -4 },
+        { -4, 10, -21, 70, 90, -24, 11, -4 },
+        { -3, 9, -19, 59, 100, -24, 10, -4 },
+        { -3, 8, -16, 48, 108, -23, 10, -4 },
+        { -2, 6, -13, 37, 115, -20, 9, -4 },
+        { -2, 5, -10, 27, 121, -17, 7, -3 },
+        { -1, 3, -6, 17, 125, -13, 5, -2 },
+        { 0, 1, -3, 8, 127, -7, 3, -1 },
+    },
+    {
+        // Bilinear
+        { 0, 0, 0, 128, 0, 0, 0, 0 },
+        { 0, 0, 0, 120, 8, 0, 0, 0 },
+        { 0, 0, 0, 112, 16, 0, 0, 0 },
+        { 0, 0, 0, 104, 24, 0, 0, 0 },
+        { 0, 0, 0, 96, 32, 0, 0, 0 },
+        { 0, 0, 0, 88, 40, 0, 0, 0 },
+        { 0, 0, 0, 80, 48, 0, 0, 0 },
+        { 0, 0, 0, 72, 56, 0, 0, 0 },
+        { 0, 0, 0, 64, 64, 0, 0, 0 },
+        { 0, 0, 0, 56, 72, 0, 0, 0 },
+        { 0, 0, 0, 48, 80, 0, 0, 0 },
+        { 0, 0, 0, 40, 88, 0, 0, 0 },
+        { 0, 0, 0, 32, 96, 0, 0, 0 },
+        { 0, 0, 0, 24, 104, 0, 0, 0 },
+        { 0, 0, 0, 16, 112, 0, 0, 0 },
+        { 0, 0, 0, 8, 120, 0, 0, 0 },
+    },
+};
+
+// The neighbours that are searched for candidate motion vectors, as { row, column } offsets in units of 8x8 blocks.
+static constexpr i8 mv_ref_blocks[BLOCK_SIZES][MVREF_NEIGHBOURS][2] = {
+    { { -1, 0 }, { 0, -1 }, { -1, -1 }, { -2, 0 }, { 0, -2 }, { -2, -1 }, { -1, -2 }, { -2, -2 } },
+    { { -1, 0 }, { 0, -1 }, { -1, -1 }, { -2, 0 }, { 0, -2 }, { -2, -1 }, { -1, -2 }, { -2, -2 } },
+    { { -1, 0 }, { 0, -1 }, { -1, -1 }, { -2, 0 }, { 0, -2 }, { -2, -1 }, { -1, -2 }, { -2, -2 } },
+    { { -1, 0 }, { 0, -1 }, { -1, -1 }, { -2, 0 }, { 0, -2 }, { -2, -1 }, { -1, -2 }, { -2, -2 } },
+    { { 0, -1 }, { -1, 0 }, { 1, -1 }, { -1, -1 }, { 0, -2 }, { -2, 0 }, { -2, -1 }, { -1, -2 } },
+    { { -1, 0 }, { 0, -1 }, { -1, 1 }, { -1, -1 }, { -2, 0 }, { 0, -2 }, { -1, -2 }, { -2, -1 } },
+    { { -1, 0 }, { 0, -1 }, { -1, 1 }, { 1, -1 }, { -1, -1 }, { -3, 0 }, { 0, -3 }, { -3, -3 } },
+    { { 0, -1 }, { -1, 0 }, { 2, -1 }, { -1, -1 }, { -1, 1 }, { 0, -3 }, { -3, 0 }, { -3, -3 } },
+    { { -1, 0 }, { 0, -1 }, { -1, 2 }, { -1, -1 }, { 1, -1 }, { -3, 0 }, { 0, -3 }, { -3, -3 } },
+    { { -1, 1 }, { 1, -1 }, { -1, 2 }, { 2, -1 }, { -1, -1 }, { -3, 0 }, { 0, -3 }, { -3, -3 } },
+    { { 0, -1 }, { -1, 0 }, { 4, -1 }, { -1, 2 }, { -1, -1 }, { 0, -3 }, { -3, 0 }, { 2, -1 } },
+    { { -1, 0 }, { 0, -1 }, { -1, 4 }, { 2, -1 }, { -1, -1 }, { -3, 0 }, { 0, -3 }, { -1, 2 } },
+    { { -1, 3 }, { 3, -1 }, { -1, 4 }, { 4, -1 }, { -1, -1 }, { -1, 0 }, { 0, -1 }, { -1, 6 } },
+};
+
+static constexpr u8 mode_2_counter[MB_MODE_COUNT] = { 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 3, 1 };
+static constexpr u8 counter_to_context[19] = {
+    BOTH_PREDICTED,
+    NEW_PLUS_NON_INTRA,
+    BOTH_NEW,
+    ZERO_PLUS_PREDICTED,
+    NEW_PLUS_NON_INTRA,
+    INVALID_CASE,
+    BOTH_ZERO,
+    INVALID_CASE,
+    INVALID_CASE,
+    INTRA_PLUS_NON_INTRA,
+    INTRA_PLUS_NON_INTRA,
+    INVALID_CASE,
+    INTRA_PLUS_NON_INTRA,
+    INVALID_CASE,
+    INVALID_CASE,
+    INVALID_CASE,
+    INVALID_CASE,
+    INVALID_CASE,
+    BOTH_INTRA
+};
+static constexpr u8 idx_n_column_to_subblock[4][2] = { { 1, 2 }, { 1, 3 }, { 3, 2 }, { 3, 3 } };
+
+// Whether the loop filter level of a block uses the first or second mode delta.
+static constexpr u8 mode_lf_lut[MB_MODE_COUNT] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1 };
+
 }
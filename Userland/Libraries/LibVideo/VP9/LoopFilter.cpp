@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "LoopFilter.h"
+#include "LookupTables.h"
+#include "Parser.h"
+#include <AK/BitCast.h>
+#include <AK/SIMD.h>
+
+// See the comment in AK/SIMDExtras.h, the vector helpers here are all static as well.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace Video::VP9 {
+
+using AK::SIMD::i16x8;
+using AK::SIMD::u64x2;
+using AK::SIMD::u8x8;
+
+// The edge filters work on eight lines across an edge at once, with one line in each lane of the vectors.
+
+ALWAYS_INLINE static i16x8 expand8(i16 value)
+{
+    return i16x8 { value, value, value, value, value, value, value, value };
+}
+
+ALWAYS_INLINE static i16x8 select(i16x8 mask, i16x8 if_set, i16x8 if_clear)
+{
+    return (if_set & mask) | (if_clear & ~mask);
+}
+
+ALWAYS_INLINE static bool any(i16x8 mask)
+{
+    auto halves = bit_cast<u64x2>(mask);
+    return (halves[0] | halves[1]) != 0;
+}
+
+ALWAYS_INLINE static i16x8 absolute_difference(i16x8 a, i16x8 b)
+{
+    auto difference = a - b;
+    auto sign = difference >> 15;
+    return (difference ^ sign) - sign;
+}
+
+ALWAYS_INLINE static i16x8 clamp_to_i8(i16x8 value)
+{
+    value = select(value < expand8(-128), expand8(-128), value);
+    return select(value > expand8(127), expand8(127), value);
+}
+
+// Loads the samples at the given distance from the edge, where the edge is a column of samples for vertical edges
+// and a row of them for horizontal ones.
+template<bool IsVerticalEdge>
+ALWAYS_INLINE static i16x8 load(u8 const* edge, size_t stride, ssize_t distance)
+{
+    if constexpr (IsVerticalEdge) {
+        auto const* samples = edge + distance;
+        return i16x8 { samples[0], samples[stride], samples[2 * stride], samples[3 * stride], samples[4 * stride], samples[5 * stride], samples[6 * stride], samples[7 * stride] };
+    } else {
+        u8x8 samples;
+        __builtin_memcpy(&samples, edge + distance * static_cast<ssize_t>(stride), sizeof(samples));
+        return __builtin_convertvector(samples, i16x8);
+    }
+}
+
+template<bool IsVerticalEdge>
+ALWAYS_INLINE static void store(u8* edge, size_t stride, ssize_t distance, i16x8 value)
+{
+    if constexpr (IsVerticalEdge) {
+        auto* samples = edge + distance;
+        for (size_t i = 0; i < 8; i++)
+            samples[i * stride] = value[i];
+    } else {
+        auto samples = __builtin_convertvector(value, u8x8);
+        __builtin_memcpy(edge + distance * static_cast<ssize_t>(stride), &samples, sizeof(samples));
+    }
+}
+
+// Averages the samples around each one within the given reach of the edge, with the samples past the reach taking
+// the value of the last one before it.
+template<ssize_t Reach>
+ALWAYS_INLINE static void smooth(i16x8 const (&samples)[16], i16x8 (&output)[16])
+{
+    constexpr ssize_t half_width = Reach - 1;
+    constexpr u8 shift = Reach == 4 ? 3 : 4;
+    auto sample = [&](ssize_t distance) { return samples[8 + clamp(distance, -Reach, Reach - 1)]; };
+
+    i16x8 sum = {};
+    for (ssize_t i = -Reach + 1 - half_width; i <= -Reach + 1 + half_width; i++)
+        sum += sample(i);
+    for (ssize_t i = -half_width; i < half_width; i++) {
+        output[8 + i] = (sum + samples[8 + i] + expand8(Reach)) >> shift;
+        sum += sample(i + half_width + 1) - sample(i - half_width);
+    }
+}
+
+/* (8.8.2) Edge Loop Filter Process */
+// Filters eight lines across an edge, with a filter that modifies up to Size / 2 - 1 samples on either side of it.
+// Lines whose samples are smooth enough on both sides of the edge get the wider filters.
+template<u8 Size, bool IsVerticalEdge>
+static void filter_edge(u8* edge, size_t stride, u8 limit_value, u8 blimit_value, u8 hev_threshold_value)
+{
+    constexpr ssize_t reach = Size == 16 ? 8 : 4;
+
+    // NOTE: The sample at distance i from the edge is in samples[8 + i], so p0 is samples[7] and q0 is samples[8].
+    i16x8 samples[16];
+    for (ssize_t i = -reach; i < reach; i++)
+        samples[8 + i] = load<IsVerticalEdge>(edge, stride, i);
+    auto p = [&](size_t i) { return samples[7 - i]; };
+    auto q = [&](size_t i) { return samples[8 + i]; };
+
+    auto limit = expand8(limit_value);
+    i16x8 mask = absolute_difference(p(3), p(2)) <= limit;
+    mask &= absolute_difference(p(2), p(1)) <= limit;
+    mask &= absolute_difference(p(1), p(0)) <= limit;
+    mask &= absolute_difference(q(1), q(0)) <= limit;
+    mask &= absolute_difference(q(2), q(1)) <= limit;
+    mask &= absolute_difference(q(3), q(2)) <= limit;
+    mask &= absolute_difference(p(0), q(0)) * 2 + (absolute_difference(p(1), q(1)) >> 1) <= expand8(blimit_value);
+    if (!any(mask))
+        return;
+
+    i16x8 output[16];
+    for (size_t i = 0; i < 16; i++)
+        output[i] = samples[i];
+
+    // The narrow filter adjusts the two samples closest to the edge, and the second ones only where the edge is smooth.
+    auto hev_threshold = expand8(hev_threshold_value);
+    i16x8 high_edge_variance = (absolute_difference(p(1), p(0)) > hev_threshold) | (absolute_difference(q(1), q(0)) > hev_threshold);
+    auto ps1 = p(1) - 128;
+    auto ps0 = p(0) - 128;
+    auto qs0 = q(0) - 128;
+    auto qs1 = q(1) - 128;
+    auto filter = clamp_to_i8(ps1 - qs1) & high_edge_variance;
+    filter = clamp_to_i8(filter + 3 * (qs0 - ps0)) & mask;
+    auto filter1 = clamp_to_i8(filter + 4) >> 3;
+    auto filter2 = clamp_to_i8(filter + 3) >> 3;
+    output[8] = clamp_to_i8(qs0 - filter1) + 128;
+    output[7] = clamp_to_i8(ps0 + filter2) + 128;
+    filter = ((filter1 + 1) >> 1) & ~high_edge_variance;
+    output[9] = clamp_to_i8(qs1 - filter) + 128;
+    output[6] = clamp_to_i8(ps1 + filter) + 128;
+
+    if constexpr (Size >= 8) {
+        auto one = expand8(1);
+        i16x8 flat = mask;
+        for (size_t i = 1; i < 4; i++)
+            flat &= (absolute_difference(p(i), p(0)) <= one) & (absolute_difference(q(i), q(0)) <= one);
+        if (any(flat)) {
+            i16x8 smoothed[16];
+            smooth<4>(samples, smoothed);
+            for (size_t i = 5; i < 11; i++)
+                output[i] = select(flat, smoothed[i], output[i]);
+
+            if constexpr (Size == 16) {
+                i16x8 flat2 = flat;
+                for (size_t i = 4; i < 8; i++)
+                    flat2 &= (absolute_difference(p(i), p(0)) <= one) & (absolute_difference(q(i), q(0)) <= one);
+                if (any(flat2)) {
+                    smooth<8>(samples, smoothed);
+                    for (size_t i = 1; i < 15; i++)
+                        output[i] = select(flat2, smoothed[i], output[i]);
+                }
+            }
+        }
+    }
+
+    constexpr ssize_t modified_reach = Size == 16 ? 7 : (Size == 8 ? 3 : 2);
+    for (ssize_t i = -modified_reach; i < modified_reach; i++)
+        store<IsVerticalEdge>(edge, stride, i, output[8 + i]);
+}
+
+bool LoopFilter::filter_frame(Parser const& parser, Frame& frame)
+{
+    if (parser.m_loop_filter_level == 0)
+        return true;
+
+    bool is_subsampled = parser.m_subsampling_x && parser.m_subsampling_y;
+    if (parser.m_subsampling_x != parser.m_subsampling_y) {
+        dbgln("VP9: Loop filtering 4:2:2 and 4:4:0 frames is not supported");
+        return false;
+    }
+
+    update_levels(parser);
+
+    /* (8.8.1) */
+    // Each superblock is filtered in raster order, with its vertical edges being filtered before its horizontal ones.
+    for (u32 mi_row = 0; mi_row < parser.m_mi_rows; mi_row += 8) {
+        auto rows = min(8u, parser.m_mi_rows - mi_row);
+        for (u32 mi_col = 0; mi_col < parser.m_mi_cols; mi_col += 8) {
+            build_masks(parser, mi_row, mi_col);
+            for (u8 plane = 0; plane < 3; plane++) {
+                auto stride = frame.stride(plane);
+                if (plane > 0 && is_subsampled) {
+                    filter_superblock_subsampled_plane(frame.data(plane) + mi_row * 4 * stride + mi_col * 4, stride, rows, mi_row == 0);
+                    continue;
+                }
+                filter_superblock_plane(frame.data(plane) + mi_row * 8 * stride + mi_col * 8, stride, rows, mi_row == 0);
+            }
+        }
+    }
+    return true;
+}
+
+void LoopFilter::update_levels(Parser const& parser)
+{
+    auto sharpness = parser.m_loop_filter_sharpness;
+    for (u8 level = 0; level <= MAX_LOOP_FILTER; level++) {
+        u8 limit = level >> ((sharpness > 0) + (sharpness > 4));
+        if (sharpness > 0)
+            limit = min<u8>(limit, 9 - sharpness);
+        limit = max<u8>(limit, 1);
+        m_thresholds[level] = { limit, static_cast<u8>(2 * (level + 2) + limit), static_cast<u8>(level >> 4) };
+    }
+
+    // NOTE: The deltas are scaled by the level of the frame, not by the level of the segment.
+    i32 base_level = parser.m_loop_filter_level;
+    i32 scale = 1 << (base_level >> 5);
+    for (u8 segment_id = 0; segment_id < MAX_SEGMENTS; segment_id++) {
+        i32 segment_level = base_level;
+        if (parser.m_segmentation_enabled && parser.m_feature_enabled[segment_id][SEG_LVL_ALT_L]) {
+            auto data = parser.m_feature_data[segment_id][SEG_LVL_ALT_L];
+            segment_level = clamp(parser.m_segmentation_abs_or_delta_update ? data : segment_level + data, 0, MAX_LOOP_FILTER);
+        }
+
+        auto& levels = m_levels[segment_id];
+        if (!parser.m_loop_filter_delta_enabled) {
+            __builtin_memset(levels, segment_level, sizeof(levels));
+            continue;
+        }
+        levels[IntraFrame][0] = clamp(segment_level + parser.m_loop_filter_ref_deltas[IntraFrame] * scale, 0, MAX_LOOP_FILTER);
+        levels[IntraFrame][1] = levels[IntraFrame][0];
+        for (u8 ref_frame = LastFrame; ref_frame < MAX_REF_FRAMES; ref_frame++) {
+            for (u8 mode = 0; mode < MAX_MODE_LF_DELTAS; mode++)
+                levels[ref_frame][mode] = clamp(segment_level + (parser.m_loop_filter_ref_deltas[ref_frame] + parser.m_loop_filter_mode_deltas[mode]) * scale, 0, MAX_LOOP_FILTER);
+        }
+    }
+}
+
+// Sets a bit for each of the 8x8 blocks that are covered by a block of the given size, or by its left column or top row.
+static constexpr u64 block_mask(u8 width, u8 height, u8 stride)
+{
+    u64 mask = 0;
+    for (u8 row = 0; row < height; row++)
+        mask |= ((1ull << width) - 1) << (row * stride);
+    return mask;
+}
+
+// The 8x8 blocks of a superblock that the first edge of a transform is on, for each transform size.
+static constexpr u64 left_transform_mask_y[TX_SIZES] = { 0xffffffffffffffffull, 0xffffffffffffffffull, 0x5555555555555555ull, 0x1111111111111111ull };
+static constexpr u64 above_transform_mask_y[TX_SIZES] = { 0xffffffffffffffffull, 0xffffffffffffffffull, 0x00ff00ff00ff00ffull, 0x000000ff000000ffull };
+static constexpr u16 left_transform_mask_uv[TX_SIZES] = { 0xffff, 0xffff, 0x5555, 0x1111 };
+static constexpr u16 above_transform_mask_uv[TX_SIZES] = { 0xffff, 0xffff, 0x0f0f, 0x000f };
+
+void LoopFilter::build_masks(Parser const& parser, u32 mi_row, u32 mi_col)
+{
+    auto& masks = m_masks;
+    masks = {};
+    auto rows = min(8u, parser.m_mi_rows - mi_row);
+    auto columns = min(8u, parser.m_mi_cols - mi_col);
+
+    for (u32 row = 0; row < rows; row++) {
+        for (u32 column = 0; column < columns; column++) {
+            auto position = (mi_row + row) * parser.m_mi_cols + mi_col + column;
+            auto mi_size = parser.m_mi_sizes[position];
+            auto width = num_8x8_blocks_wide_lookup[mi_size];
+            auto height = num_8x8_blocks_high_lookup[mi_size];
+            // NOTE: Blocks are aligned to their size, so this finds the top left 8x8 block of each one.
+            if (row % height != 0 || column % width != 0)
+                continue;
+
+            auto mode = parser.m_y_modes[position];
+            auto level = m_levels[parser.m_segment_ids[position]][parser.m_ref_frames[position * 2]][mode_lf_lut[mode]];
+            if (level == 0)
+                continue;
+
+            auto shift_y = row * 8 + column;
+            for (u8 i = 0; i < height; i++)
+                __builtin_memset(masks.levels + shift_y + i * 8, level, width);
+
+            // The edges of the prediction block are always filtered, and so are the edges of its transform blocks if
+            // it has coefficients or is intra predicted.
+            auto tx_size = parser.m_tx_sizes[position];
+            bool has_transform_edges = !parser.m_skips[position] || parser.m_ref_frames[position * 2] == IntraFrame;
+            auto size_mask = block_mask(width, height, 8);
+            masks.left_y[tx_size] |= block_mask(1, height, 8) << shift_y;
+            masks.above_y[tx_size] |= block_mask(width, 1, 8) << shift_y;
+            if (has_transform_edges) {
+                masks.left_y[tx_size] |= (size_mask & left_transform_mask_y[tx_size]) << shift_y;
+                masks.above_y[tx_size] |= (size_mask & above_transform_mask_y[tx_size]) << shift_y;
+                if (tx_size == TX_4x4)
+                    masks.internal_4x4_y |= size_mask << shift_y;
+            }
+
+            // NOTE: The chroma 8x8 blocks of 4:2:0 frames take their edges from the block at their top left.
+            if (row % 2 != 0 || column % 2 != 0)
+                continue;
+            auto uv_tx_size = mi_size < Block_8x8 ? TX_4x4 : min(tx_size, max_txsize_lookup[ss_size_lookup[mi_size][1][1]]);
+            u8 uv_width = max(width >> 1, 1);
+            u8 uv_height = max(height >> 1, 1);
+            auto shift_uv = (row >> 1) * 4 + (column >> 1);
+            auto size_mask_uv = static_cast<u16>(block_mask(uv_width, uv_height, 4));
+            masks.left_uv[uv_tx_size] |= block_mask(1, uv_height, 4) << shift_uv;
+            masks.above_uv[uv_tx_size] |= block_mask(uv_width, 1, 4) << shift_uv;
+            if (has_transform_edges) {
+                masks.left_uv[uv_tx_size] |= (size_mask_uv & left_transform_mask_uv[uv_tx_size]) << shift_uv;
+                masks.above_uv[uv_tx_size] |= (size_mask_uv & above_transform_mask_uv[uv_tx_size]) << shift_uv;
+                if (uv_tx_size == TX_4x4)
+                    masks.internal_4x4_uv |= size_mask_uv << shift_uv;
+            }
+        }
+    }
+
+    // The widest filter is used for the edges of 32x32 transforms as well.
+    masks.left_y[TX_16x16] |= masks.left_y[TX_32x32];
+    masks.above_y[TX_16x16] |= masks.above_y[TX_32x32];
+    masks.left_uv[TX_16x16] |= masks.left_uv[TX_32x32];
+    masks.above_uv[TX_16x16] |= masks.above_uv[TX_32x32];
+
+    // Edges every 32 samples get at least the 8 wide filter, even when they are between 4x4 transforms.
+    constexpr u64 left_border_y = 0x1111111111111111ull;
+    constexpr u64 above_border_y = 0x000000ff000000ffull;
+    constexpr u16 left_border_uv = 0x1111;
+    constexpr u16 above_border_uv = 0x000f;
+    masks.left_y[TX_8x8] |= masks.left_y[TX_4x4] & left_border_y;
+    masks.left_y[TX_4x4] &= ~left_border_y;
+    masks.above_y[TX_8x8] |= masks.above_y[TX_4x4] & above_border_y;
+    masks.above_y[TX_4x4] &= ~above_border_y;
+    masks.left_uv[TX_8x8] |= masks.left_uv[TX_4x4] & left_border_uv;
+    masks.left_uv[TX_4x4] &= ~left_border_uv;
+    masks.above_uv[TX_8x8] |= masks.above_uv[TX_4x4] & above_border_uv;
+    masks.above_uv[TX_4x4] &= ~above_border_uv;
+
+    // Blocks can reach past the bottom and the right of the frame, but their edges out there are not filtered.
+    if (rows < 8) {
+        u64 mask_y = (1ull << (rows * 8)) - 1;
+        u16 mask_uv = (1u << (((rows + 1) >> 1) * 4)) - 1;
+        for (u8 i = 0; i < TX_32x32; i++) {
+            masks.left_y[i] &= mask_y;
+            masks.above_y[i] &= mask_y;
+            masks.left_uv[i] &= mask_uv;
+            masks.above_uv[i] &= mask_uv;
+        }
+        masks.internal_4x4_y &= mask_y;
+        masks.internal_4x4_uv &= mask_uv;
+
+        // The last row of chroma blocks doesn't get the 16 wide filter, which would reach past the frame.
+        if (rows == 1) {
+            masks.above_uv[TX_8x8] |= masks.above_uv[TX_16x16];
+            masks.above_uv[TX_16x16] = 0;
+        } else if (rows == 5) {
+            masks.above_uv[TX_8x8] |= masks.above_uv[TX_16x16] & 0xff00;
+            masks.above_uv[TX_16x16] &= ~0xff00;
+        }
+    }
+    if (columns < 8) {
+        u64 mask_y = ((1ull << columns) - 1) * 0x0101010101010101ull;
+        u16 mask_uv = ((1u << ((columns + 1) >> 1)) - 1) * 0x1111;
+        // NOTE: This also leaves out the internal edges of a last column of chroma blocks that is only half in the frame.
+        u16 mask_uv_internal = ((1u << (columns >> 1)) - 1) * 0x1111;
+        for (u8 i = 0; i < TX_32x32; i++) {
+            masks.left_y[i] &= mask_y;
+            masks.above_y[i] &= mask_y;
+            masks.left_uv[i] &= mask_uv;
+            masks.above_uv[i] &= mask_uv;
+        }
+        masks.internal_4x4_y &= mask_y;
+        masks.internal_4x4_uv &= mask_uv_internal;
+
+        if (columns == 1) {
+            masks.left_uv[TX_8x8] |= masks.left_uv[TX_16x16];
+            masks.left_uv[TX_16x16] = 0;
+        } else if (columns == 5) {
+            masks.left_uv[TX_8x8] |= masks.left_uv[TX_16x16] & 0xcccc;
+            masks.left_uv[TX_16x16] &= ~0xcccc;
+        }
+    }
+
+    // The left edge of the frame is not filtered.
+    if (mi_col == 0) {
+        for (u8 i = 0; i < TX_32x32; i++) {
+            masks.left_y[i] &= 0xfefefefefefefefeull;
+            masks.left_uv[i] &= 0xeeee;
+        }
+    }
+}
+
+void LoopFilter::filter_superblock_plane(u8* origin, size_t stride, u32 rows, bool is_first_row)
+{
+    auto const& masks = m_masks;
+
+    for (u32 row = 0; row < rows; row++) {
+        for (u32 column = 0; column < 8; column++) {
+            auto index = row * 8 + column;
+            auto bit = 1ull << index;
+            auto* block = origin + row * 8 * stride + column * 8;
+            auto const& thresholds = m_thresholds[masks.levels[index]];
+            if (masks.left_y[TX_16x16] & bit)
+                filter_edge<16, true>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            else if (masks.left_y[TX_8x8] & bit)
+                filter_edge<8, true>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            else if (masks.left_y[TX_4x4] & bit)
+                filter_edge<4, true>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            if (masks.internal_4x4_y & bit)
+                filter_edge<4, true>(block + 4, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+        }
+    }
+
+    for (u32 row = 0; row < rows; row++) {
+        for (u32 column = 0; column < 8; column++) {
+            auto index = row * 8 + column;
+            auto bit = 1ull << index;
+            auto* block = origin + row * 8 * stride + column * 8;
+            auto const& thresholds = m_thresholds[masks.levels[index]];
+            // The top edge of the frame is not filtered.
+            if (!is_first_row || row > 0) {
+                if (masks.above_y[TX_16x16] & bit)
+                    filter_edge<16, false>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+                else if (masks.above_y[TX_8x8] & bit)
+                    filter_edge<8, false>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+                else if (masks.above_y[TX_4x4] & bit)
+                    filter_edge<4, false>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            }
+            if (masks.internal_4x4_y & bit)
+                filter_edge<4, false>(block + 4 * stride, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+        }
+    }
+}
+
+void LoopFilter::filter_superblock_subsampled_plane(u8* origin, size_t stride, u32 rows, bool is_first_row)
+{
+    auto const& masks = m_masks;
+    auto uv_rows = (rows + 1) >> 1;
+
+    for (u32 row = 0; row < uv_rows; row++) {
+        for (u32 column = 0; column < 4; column++) {
+            auto bit = 1u << (row * 4 + column);
+            auto* block = origin + row * 8 * stride + column * 8;
+            auto const& thresholds = m_thresholds[masks.levels[row * 16 + column * 2]];
+            if (masks.left_uv[TX_16x16] & bit)
+                filter_edge<16, true>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            else if (masks.left_uv[TX_8x8] & bit)
+                filter_edge<8, true>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            else if (masks.left_uv[TX_4x4] & bit)
+                filter_edge<4, true>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            if (masks.internal_4x4_uv & bit)
+                filter_edge<4, true>(block + 4, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+        }
+    }
+
+    for (u32 row = 0; row < uv_rows; row++) {
+        // The internal edges of a last row of blocks that is only half in the frame would be past the frame.
+        bool has_internal_edges = row * 2 + 1 != rows;
+        for (u32 column = 0; column < 4; column++) {
+            auto bit = 1u << (row * 4 + column);
+            auto* block = origin + row * 8 * stride + column * 8;
+            auto const& thresholds = m_thresholds[masks.levels[row * 16 + column * 2]];
+            if (!is_first_row || row > 0) {
+                if (masks.above_uv[TX_16x16] & bit)
+                    filter_edge<16, false>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+                else if (masks.above_uv[TX_8x8] & bit)
+                    filter_edge<8, false>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+                else if (masks.above_uv[TX_4x4] & bit)
+                    filter_edge<4, false>(block, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+            }
+            if (has_internal_edges && (masks.internal_4x4_uv & bit))
+                filter_edge<4, false>(block + 4 * stride, stride, thresholds.limit, thresholds.blimit, thresholds.hev_threshold);
+        }
+    }
+}
+
+}
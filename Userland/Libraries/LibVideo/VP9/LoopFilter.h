@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "Enums.h"
+#include "Frame.h"
+#include "Symbols.h"
+#include <AK/Types.h>
+
+namespace Video::VP9 {
+
+class Parser;
+
+/* (8.8) Loop Filter Process */
+// Smooths the edges of the prediction and transform blocks of a decoded frame. The edges to filter within each
+// superblock are gathered into bit masks with one bit per 8x8 block, which are then filtered eight lines at a time.
+class LoopFilter {
+public:
+    bool filter_frame(Parser const&, Frame&);
+
+private:
+    struct Thresholds {
+        u8 limit;
+        u8 blimit;
+        u8 hev_threshold;
+    };
+
+    // The edges of one superblock, by the size of the filter that is applied to them. The luma masks have a bit for
+    // each 8x8 block in raster order, and the masks of 4:2:0 chroma have one for each 8x8 block of the chroma planes.
+    struct Masks {
+        u64 left_y[TX_SIZES];
+        u64 above_y[TX_SIZES];
+        u64 internal_4x4_y;
+        u16 left_uv[TX_SIZES];
+        u16 above_uv[TX_SIZES];
+        u16 internal_4x4_uv;
+        u8 levels[64];
+    };
+
+    void update_levels(Parser const&);
+    void build_masks(Parser const&, u32 mi_row, u32 mi_col);
+    void filter_superblock_plane(u8* origin, size_t stride, u32 rows, bool is_first_row);
+    void filter_superblock_subsampled_plane(u8* origin, size_t stride, u32 rows, bool is_first_row);
+
+    Thresholds m_thresholds[MAX_LOOP_FILTER + 1];
+    u8 m_levels[MAX_SEGMENTS][MAX_REF_FRAMES][MAX_MODE_LF_DELTAS];
+    Masks m_masks;
+};
+
+}
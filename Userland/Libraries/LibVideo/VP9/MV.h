@@ -13,20 +13,20 @@ namespace Video::VP9 {
 class MV {
 public:
     MV() = default;
-    MV(u32 row, u32 col);
+    MV(i32 row, i32 col);
 
-    u32 row() const { return m_row; }
-    void set_row(u32 row) { m_row = row; }
-    u32 col() const { return m_col; }
-    void set_col(u32 col) { m_col = col; }
+    i32 row() const { return m_row; }
+    void set_row(i32 row) { m_row = row; }
+    i32 col() const { return m_col; }
+    void set_col(i32 col) { m_col = col; }
 
-    MV& operator=(MV const& other);
     MV& operator=(i32 value);
     MV operator+(MV const& other) const;
+    bool operator==(MV const& other) const { return m_row == other.m_row && m_col == other.m_col; }
 
 private:
-    u32 m_row { 0 };
-    u32 m_col { 0 };
+    i32 m_row { 0 };
+    i32 m_col { 0 };
 };
 
 }
@@ -7,6 +7,8 @@
 #include "Parser.h"
 #include "Decoder.h"
 #include "Utilities.h"
+#include <AK/Array.h>
+#include <AK/Endian.h>
 
 namespace Video::VP9 {
 
@@ -16,58 +18,48 @@ namespace Video::VP9 {
 
 Parser::Parser(Decoder& decoder)
     : m_probability_tables(make<ProbabilityTables>())
-    , m_tree_parser(make<TreeParser>(*this))
+    , m_syntax_element_counter(make<SyntaxElementCounter>())
     , m_decoder(decoder)
 {
 }
 
-Parser::~Parser()
-{
-    cleanup_tile_allocations();
-    free(m_prev_segment_ids);
-}
-
-void Parser::cleanup_tile_allocations()
-{
-    free(m_skips);
-    free(m_tx_sizes);
-    free(m_mi_sizes);
-    free(m_y_modes);
-    free(m_segment_ids);
-    free(m_ref_frames);
-    free(m_interp_filters);
-    free(m_mvs);
-    free(m_sub_mvs);
-    free(m_sub_modes);
-}
+Parser::~Parser() = default;
 
 /* (6.1) */
-bool Parser::parse_frame(ByteBuffer const& frame_data)
+bool Parser::parse_frame(ReadonlyBytes frame_data)
 {
     m_bit_stream = make<BitStream>(frame_data.data(), frame_data.size());
-    m_syntax_element_counter = make<SyntaxElementCounter>();
 
     SAFE_CALL(uncompressed_header());
-    dbgln("Finished reading uncompressed header");
     SAFE_CALL(trailing_bits());
     if (m_header_size_in_bytes == 0) {
-        dbgln("No header");
+        // NOTE: Only frames that show an existing frame have no compressed header, and they leave the decoding state untouched.
+        if (!m_show_existing_frame)
+            return false;
+        m_last_show_frame = true;
         return true;
     }
-    m_probability_tables->load_probs(m_frame_context_idx);
-    m_probability_tables->load_probs2(m_frame_context_idx);
-    m_syntax_element_counter->clear_counts();
+    m_use_prev_frame_mvs = !m_error_resilient_mode && m_last_show_frame
+        && m_frame_width == m_last_frame_width && m_frame_height == m_last_frame_height;
 
+    m_probability_tables->load_probs(m_frame_context_idx);
     SAFE_CALL(m_bit_stream->init_bool(m_header_size_in_bytes));
-    dbgln("Reading compressed header");
     SAFE_CALL(compressed_header());
-    dbgln("Finished reading compressed header");
     SAFE_CALL(m_bit_stream->exit_bool());
+    setup_dequantization();
 
-    SAFE_CALL(decode_tiles());
+    SAFE_CALL(m_decoder.allocate_current_frame());
+    // The mode info of the previous frame is kept around for motion vector prediction.
+    swap(m_ref_frames, m_prev_ref_frames);
+    swap(m_mvs, m_prev_mvs);
+    SAFE_CALL(decode_tiles(frame_data.slice(m_bit_stream->get_position() / 8)));
     SAFE_CALL(refresh_probs());
 
-    dbgln("Finished reading frame!");
+    if (m_segmentation_enabled)
+        swap(m_segmentation_map, m_prev_segmentation_map);
+    m_last_frame_width = m_frame_width;
+    m_last_frame_height = m_frame_height;
+    m_last_show_frame = m_show_frame;
     return true;
 }
 
@@ -81,12 +73,9 @@ bool Parser::trailing_bits()
 bool Parser::refresh_probs()
 {
     if (!m_error_resilient_mode && !m_frame_parallel_decoding_mode) {
-        m_probability_tables->load_probs(m_frame_context_idx);
         SAFE_CALL(m_decoder.adapt_coef_probs());
-        if (!m_frame_is_intra) {
-            m_probability_tables->load_probs2(m_frame_context_idx);
+        if (!m_frame_is_intra)
             SAFE_CALL(m_decoder.adapt_non_coef_probs());
-        }
     }
     if (m_refresh_frame_context)
         m_probability_tables->save_probs(m_frame_context_idx);
@@ -104,8 +93,8 @@ bool Parser::uncompressed_header()
     m_profile = (profile_high_bit << 1u) + profile_low_bit;
     if (m_profile == 3)
         RESERVED_ZERO;
-    auto show_existing_frame = m_bit_stream->read_bit();
-    if (show_existing_frame) {
+    m_show_existing_frame = m_bit_stream->read_bit();
+    if (m_show_existing_frame) {
         m_frame_to_show_map_index = m_bit_stream->read_f(3);
         m_header_size_in_bytes = 0;
         m_refresh_frame_flags = 0;
@@ -160,6 +149,11 @@ bool Parser::uncompressed_header()
         }
     }
 
+    if (m_bit_depth != 8) {
+        dbgln("VP9: Frames with a bit depth of {} are not supported", m_bit_depth);
+        return false;
+    }
+
     if (!m_error_resilient_mode) {
         m_refresh_frame_context = m_bit_stream->read_bit();
         m_frame_parallel_decoding_mode = m_bit_stream->read_bit();
@@ -193,11 +187,11 @@ bool Parser::uncompressed_header()
 
 bool Parser::frame_sync_code()
 {
-    if (m_bit_stream->read_byte() != 0x49)
+    if (m_bit_stream->read_f8() != 0x49)
         return false;
-    if (m_bit_stream->read_byte() != 0x83)
+    if (m_bit_stream->read_f8() != 0x83)
         return false;
-    return m_bit_stream->read_byte() == 0x42;
+    return m_bit_stream->read_f8() == 0x42;
 }
 
 bool Parser::color_config()
@@ -256,11 +250,10 @@ bool Parser::render_size()
 
 bool Parser::frame_size_with_refs()
 {
-    bool found_ref;
+    bool found_ref = false;
     for (auto frame_index : m_ref_frame_idx) {
         found_ref = m_bit_stream->read_bit();
         if (found_ref) {
-            dbgln("Reading size from ref frame {}", frame_index);
             m_frame_width = m_ref_frame_width[frame_index];
             m_frame_height = m_ref_frame_height[frame_index];
             break;
@@ -283,6 +276,14 @@ bool Parser::compute_image_size()
     m_mi_rows = (m_frame_height + 7u) >> 3u;
     m_sb64_cols = (m_mi_cols + 7u) >> 3u;
     m_sb64_rows = (m_mi_rows + 7u) >> 3u;
+
+    // NOTE: The mode info of previous frames can't be used for prediction once the frame size changes, so the
+    //       segmentation maps start out empty again.
+    if (m_frame_width != m_last_frame_width || m_frame_height != m_last_frame_height) {
+        allocate_tile_data();
+        m_segmentation_map.span().fill(0);
+        m_prev_segmentation_map.span().fill(0);
+    }
     return true;
 }
 
@@ -318,11 +319,11 @@ bool Parser::loop_filter_params()
 
 bool Parser::quantization_params()
 {
-    auto base_q_idx = m_bit_stream->read_byte();
-    auto delta_q_y_dc = read_delta_q();
-    auto delta_q_uv_dc = read_delta_q();
-    auto delta_q_uv_ac = read_delta_q();
-    m_lossless = base_q_idx == 0 && delta_q_y_dc == 0 && delta_q_uv_dc == 0 && delta_q_uv_ac == 0;
+    m_base_q_idx = m_bit_stream->read_f8();
+    m_delta_q_y_dc = read_delta_q();
+    m_delta_q_uv_dc = read_delta_q();
+    m_delta_q_uv_ac = read_delta_q();
+    m_lossless = m_base_q_idx == 0 && m_delta_q_y_dc == 0 && m_delta_q_uv_dc == 0 && m_delta_q_uv_ac == 0;
     return true;
 }
 
@@ -335,6 +336,7 @@ i8 Parser::read_delta_q()
 
 bool Parser::segmentation_params()
 {
+    m_segmentation_update_map = false;
     m_segmentation_enabled = m_bit_stream->read_bit();
     if (!m_segmentation_enabled)
         return true;
@@ -348,7 +350,9 @@ bool Parser::segmentation_params()
             segmentation_pred_prob = m_segmentation_temporal_update ? read_prob() : 255;
     }
 
-    SAFE_CALL(m_bit_stream->read_bit());
+    auto segmentation_update_data = m_bit_stream->read_bit();
+    if (!segmentation_update_data)
+        return true;
 
     m_segmentation_abs_or_delta_update = m_bit_stream->read_bit();
     for (auto i = 0; i < MAX_SEGMENTS; i++) {
@@ -373,7 +377,7 @@ bool Parser::segmentation_params()
 u8 Parser::read_prob()
 {
     if (m_bit_stream->read_bit())
-        return m_bit_stream->read_byte();
+        return m_bit_stream->read_f8();
     return 255;
 }
 
@@ -420,9 +424,8 @@ bool Parser::setup_past_independence()
         }
     }
     m_segmentation_abs_or_delta_update = false;
-    if (m_prev_segment_ids)
-        free(m_prev_segment_ids);
-    m_prev_segment_ids = static_cast<u8*>(kmalloc_array(m_mi_rows, m_mi_cols));
+    m_segmentation_map.span().fill(0);
+    m_prev_segmentation_map.span().fill(0);
     m_loop_filter_delta_enabled = true;
     m_loop_filter_ref_deltas[IntraFrame] = 1;
     m_loop_filter_ref_deltas[LastFrame] = 0;
@@ -431,6 +434,8 @@ bool Parser::setup_past_independence()
     for (auto& loop_filter_mode_delta : m_loop_filter_mode_deltas)
         loop_filter_mode_delta = 0;
     m_probability_tables->reset_probs();
+    for (auto& sign_bias : m_ref_frame_sign_bias)
+        sign_bias = 0;
     return true;
 }
 
@@ -502,7 +507,7 @@ u8 Parser::decode_term_subexp()
     if (m_bit_stream->read_literal(1) == 0)
         return m_bit_stream->read_literal(4) + 16;
     if (m_bit_stream->read_literal(1) == 0)
-        return m_bit_stream->read_literal(4) + 32;
+        return m_bit_stream->read_literal(5) + 32;
 
     auto v = m_bit_stream->read_literal(7);
     if (v < 65)
@@ -530,8 +535,8 @@ u8 Parser::inv_recenter_nonneg(u8 v, u8 m)
 
 bool Parser::read_coef_probs()
 {
-    m_max_tx_size = tx_mode_to_biggest_tx_size[m_tx_mode];
-    for (auto tx_size = TX_4x4; tx_size <= m_max_tx_size; tx_size = static_cast<TXSize>(static_cast<int>(tx_size) + 1)) {
+    auto max_tx_size = tx_mode_to_biggest_tx_size[m_tx_mode];
+    for (auto tx_size = TX_4x4; tx_size <= max_tx_size; tx_size = static_cast<TXSize>(static_cast<int>(tx_size) + 1)) {
         auto update_probs = m_bit_stream->read_literal(1);
         if (update_probs == 1) {
             for (auto i = 0; i < 2; i++) {
@@ -731,41 +736,105 @@ bool Parser::setup_compound_reference_mode()
 void Parser::allocate_tile_data()
 {
     auto dimensions = m_mi_rows * m_mi_cols;
-    if (dimensions == m_allocated_dimensions)
-        return;
-    cleanup_tile_allocations();
-    m_skips = static_cast<bool*>(kmalloc_array(dimensions, sizeof(bool)));
-    m_tx_sizes = static_cast<TXSize*>(kmalloc_array(dimensions, sizeof(TXSize)));
-    m_mi_sizes = static_cast<u32*>(kmalloc_array(dimensions, sizeof(u32)));
-    m_y_modes = static_cast<u8*>(kmalloc_array(dimensions, sizeof(u8)));
-    m_segment_ids = static_cast<u8*>(kmalloc_array(dimensions, sizeof(u8)));
-    m_ref_frames = static_cast<ReferenceFrame*>(kmalloc_array(dimensions, 2, sizeof(ReferenceFrame)));
-    m_interp_filters = static_cast<InterpolationFilter*>(kmalloc_array(dimensions, sizeof(InterpolationFilter)));
-    m_mvs = static_cast<MV*>(kmalloc_array(dimensions, 2, sizeof(MV)));
-    m_sub_mvs = static_cast<MV*>(kmalloc_array(dimensions, 8, sizeof(MV)));
-    m_sub_modes = static_cast<IntraMode*>(kmalloc_array(dimensions, 4, sizeof(IntraMode)));
-    m_allocated_dimensions = dimensions;
-}
-
-bool Parser::decode_tiles()
-{
-    auto tile_cols = 1 << m_tile_cols_log2;
-    auto tile_rows = 1 << m_tile_rows_log2;
-    allocate_tile_data();
+    m_skips.resize_and_keep_capacity(dimensions);
+    m_tx_sizes.resize_and_keep_capacity(dimensions);
+    m_mi_sizes.resize_and_keep_capacity(dimensions);
+    m_y_modes.resize_and_keep_capacity(dimensions);
+    m_segment_ids.resize_and_keep_capacity(dimensions);
+    m_ref_frames.resize_and_keep_capacity(dimensions * 2);
+    m_interp_filters.resize_and_keep_capacity(dimensions);
+    m_mvs.resize_and_keep_capacity(dimensions * 2);
+    m_sub_mvs.resize_and_keep_capacity(dimensions * 8);
+    m_sub_modes.resize_and_keep_capacity(dimensions * 4);
+    m_segmentation_map.resize_and_keep_capacity(dimensions);
+    m_prev_segmentation_map.resize_and_keep_capacity(dimensions);
+    m_prev_ref_frames.resize_and_keep_capacity(dimensions * 2);
+    m_prev_mvs.resize_and_keep_capacity(dimensions * 2);
+}
+
+void Parser::setup_dequantization()
+{
+    auto dc_q = [](i32 q_index) { return dc_qlookup[clamp(q_index, 0, 255)]; };
+    auto ac_q = [](i32 q_index) { return ac_qlookup[clamp(q_index, 0, 255)]; };
+
+    for (u8 segment_id = 0; segment_id < MAX_SEGMENTS; segment_id++) {
+        i32 q_index = m_base_q_idx;
+        if (m_segmentation_enabled && m_feature_enabled[segment_id][SEG_LVL_ALT_Q]) {
+            auto data = m_feature_data[segment_id][SEG_LVL_ALT_Q];
+            q_index = clamp(m_segmentation_abs_or_delta_update ? data : q_index + data, 0, 255);
+        }
+        auto& factors = m_dequantization_factors[segment_id];
+        factors[0][0] = dc_q(q_index + m_delta_q_y_dc);
+        factors[0][1] = ac_q(q_index);
+        factors[1][0] = dc_q(q_index + m_delta_q_uv_dc);
+        factors[1][1] = ac_q(q_index + m_delta_q_uv_ac);
+    }
+}
+
+TileContext& Parser::tile_context(size_t tile_col)
+{
+    while (m_tile_contexts.size() <= tile_col)
+        m_tile_contexts.append(make<TileContext>(*this));
+    return m_tile_contexts[tile_col];
+}
+
+bool Parser::decode_tiles(ReadonlyBytes tile_data)
+{
+    auto tile_cols = 1u << m_tile_cols_log2;
+    auto tile_rows = 1u << m_tile_rows_log2;
     SAFE_CALL(clear_above_context());
-    for (auto tile_row = 0; tile_row < tile_rows; tile_row++) {
-        for (auto tile_col = 0; tile_col < tile_cols; tile_col++) {
+    for (size_t tile_col = 0; tile_col < tile_cols; tile_col++)
+        tile_context(tile_col).counter.clear_counts();
+
+    size_t offset = 0;
+    for (u32 tile_row = 0; tile_row < tile_rows; tile_row++) {
+        for (u32 tile_col = 0; tile_col < tile_cols; tile_col++) {
             auto last_tile = (tile_row == tile_rows - 1) && (tile_col == tile_cols - 1);
-            auto tile_size = last_tile ? m_bit_stream->bytes_remaining() : m_bit_stream->read_f(32);
-            m_mi_row_start = get_tile_offset(tile_row, m_mi_rows, m_tile_rows_log2);
-            m_mi_row_end = get_tile_offset(tile_row + 1, m_mi_rows, m_tile_rows_log2);
-            m_mi_col_start = get_tile_offset(tile_col, m_mi_cols, m_tile_cols_log2);
-            m_mi_col_end = get_tile_offset(tile_col + 1, m_mi_cols, m_tile_cols_log2);
-            SAFE_CALL(m_bit_stream->init_bool(tile_size));
-            SAFE_CALL(decode_tile());
-            SAFE_CALL(m_bit_stream->exit_bool());
+            size_t tile_size;
+            if (last_tile) {
+                tile_size = tile_data.size() - offset;
+            } else {
+                if (tile_data.size() - offset < sizeof(u32))
+                    return false;
+                auto const* size_bytes = tile_data.offset_pointer(offset);
+                tile_size = (size_bytes[0] << 24) | (size_bytes[1] << 16) | (size_bytes[2] << 8) | size_bytes[3];
+                offset += sizeof(u32);
+            }
+            if (tile_size > tile_data.size() - offset)
+                return false;
+
+            auto& tile = tile_context(tile_col);
+            tile.bit_stream = make<BitStream>(tile_data.offset_pointer(offset), tile_size);
+            tile.mi_row_start = get_tile_offset(tile_row, m_mi_rows, m_tile_rows_log2);
+            tile.mi_row_end = get_tile_offset(tile_row + 1, m_mi_rows, m_tile_rows_log2);
+            tile.mi_col_start = get_tile_offset(tile_col, m_mi_cols, m_tile_cols_log2);
+            tile.mi_col_end = get_tile_offset(tile_col + 1, m_mi_cols, m_tile_cols_log2);
+            offset += tile_size;
+        }
+
+        // NOTE: The tiles of a row only share the above contexts, of which each of them uses its own columns,
+        //       so all but the smallest frames can be decoded on several threads.
+        if (tile_cols == 1) {
+            SAFE_CALL(decode_tile(tile_context(0)));
+            continue;
+        }
+
+        if (!m_thread_pool)
+            m_thread_pool = make<Threading::ThreadPool>(0, "VP9 Tiles"sv);
+        Array<bool, 64> tile_results;
+        for (size_t tile_col = 0; tile_col < tile_cols; tile_col++) {
+            m_thread_pool->submit([this, &tile_results, tile_col] {
+                tile_results[tile_col] = decode_tile(tile_context(tile_col));
+            });
         }
+        m_thread_pool->wait();
+        for (size_t tile_col = 0; tile_col < tile_cols; tile_col++)
+            SAFE_CALL(tile_results[tile_col]);
     }
+
+    m_syntax_element_counter->clear_counts();
+    for (size_t tile_col = 0; tile_col < tile_cols; tile_col++)
+        *m_syntax_element_counter += tile_context(tile_col).counter;
     return true;
 }
 
@@ -775,18 +844,14 @@ void Parser::clear_context(Vector<u8>& context, size_t size)
     __builtin_memset(context.data(), 0, sizeof(u8) * size);
 }
 
-void Parser::clear_context(Vector<Vector<u8>>& context, size_t outer_size, size_t inner_size)
-{
-    if (context.size() < outer_size)
-        context.resize(outer_size);
-    for (auto& sub_vector : context)
-        clear_context(sub_vector, inner_size);
-}
-
 bool Parser::clear_above_context()
 {
-    clear_context(m_above_nonzero_context, 3, 2 * m_mi_cols);
-    clear_context(m_above_seg_pred_context, m_mi_cols);
+    // NOTE: The contexts cover whole superblocks, as blocks that reach past the edge of the frame update them as well.
+    auto aligned_4x4_cols = m_sb64_cols * 16;
+    clear_context(m_above_nonzero_context[0], aligned_4x4_cols);
+    clear_context(m_above_nonzero_context[1], aligned_4x4_cols >> m_subsampling_x);
+    clear_context(m_above_nonzero_context[2], aligned_4x4_cols >> m_subsampling_x);
+    clear_context(m_above_seg_pred_context, m_sb64_cols * 8);
     clear_context(m_above_partition_context, m_sb64_cols * 8);
     return true;
 }
@@ -798,465 +863,509 @@ u32 Parser::get_tile_offset(u32 tile_num, u32 mis, u32 tile_size_log2)
     return min(offset, mis);
 }
 
-bool Parser::decode_tile()
+bool Parser::decode_tile(TileContext& tile)
 {
-    for (auto row = m_mi_row_start; row < m_mi_row_end; row += 8) {
-        SAFE_CALL(clear_left_context());
-        m_row = row;
-        for (auto col = m_mi_col_start; col < m_mi_col_end; col += 8) {
-            m_col = col;
-            SAFE_CALL(decode_partition(row, col, Block_64x64));
-        }
+    SAFE_CALL(tile.bit_stream->init_bool(tile.bit_stream->bytes_remaining()));
+    for (auto row = tile.mi_row_start; row < tile.mi_row_end; row += 8) {
+        SAFE_CALL(clear_left_context(tile));
+        for (auto col = tile.mi_col_start; col < tile.mi_col_end; col += 8)
+            SAFE_CALL(decode_partition(tile, row, col, Block_64x64));
     }
+    SAFE_CALL(tile.bit_stream->exit_bool());
     return true;
 }
 
-bool Parser::clear_left_context()
+bool Parser::clear_left_context(TileContext& tile)
 {
-    clear_context(m_left_nonzero_context, 3, 2 * m_mi_rows);
-    clear_context(m_left_seg_pred_context, m_mi_rows);
-    clear_context(m_left_partition_context, m_sb64_rows * 8);
+    __builtin_memset(tile.left_nonzero_context, 0, sizeof(tile.left_nonzero_context));
+    __builtin_memset(tile.left_seg_pred_context, 0, sizeof(tile.left_seg_pred_context));
+    __builtin_memset(tile.left_partition_context, 0, sizeof(tile.left_partition_context));
     return true;
 }
 
-bool Parser::decode_partition(u32 row, u32 col, u8 block_subsize)
+bool Parser::decode_partition(TileContext& tile, u32 row, u32 col, BlockSubsize block_subsize)
 {
     if (row >= m_mi_rows || col >= m_mi_cols)
-        return false;
-    m_block_subsize = block_subsize;
-    m_num_8x8 = num_8x8_blocks_wide_lookup[block_subsize];
-    auto half_block_8x8 = m_num_8x8 >> 1;
-    m_has_rows = (row + half_block_8x8) < m_mi_rows;
-    m_has_cols = (col + half_block_8x8) < m_mi_cols;
-
-    auto partition = m_tree_parser->parse_tree(SyntaxElementType::Partition);
+        return true;
+    auto num_8x8 = num_8x8_blocks_wide_lookup[block_subsize];
+    auto half_block_8x8 = num_8x8 >> 1;
+    auto has_rows = (row + half_block_8x8) < m_mi_rows;
+    auto has_cols = (col + half_block_8x8) < m_mi_cols;
+    tile.block_subsize = block_subsize;
+    tile.num_8x8 = num_8x8;
+    tile.has_rows = has_rows;
+    tile.has_cols = has_cols;
+    tile.row = row;
+    tile.col = col;
+
+    auto partition = tile.tree_parser.parse_tree(SyntaxElementType::Partition);
     auto subsize = subsize_lookup[partition][block_subsize];
     if (subsize < Block_8x8 || partition == PartitionNone) {
-        SAFE_CALL(decode_block(row, col, subsize));
+        SAFE_CALL(decode_block(tile, row, col, subsize));
     } else if (partition == PartitionHorizontal) {
-        SAFE_CALL(decode_block(row, col, subsize));
-        if (m_has_rows)
-            SAFE_CALL(decode_block(row + half_block_8x8, col, subsize));
+        SAFE_CALL(decode_block(tile, row, col, subsize));
+        if (has_rows)
+            SAFE_CALL(decode_block(tile, row + half_block_8x8, col, subsize));
     } else if (partition == PartitionVertical) {
-        SAFE_CALL(decode_block(row, col, subsize));
-        if (m_has_cols)
-            SAFE_CALL(decode_block(row, col + half_block_8x8, subsize));
+        SAFE_CALL(decode_block(tile, row, col, subsize));
+        if (has_cols)
+            SAFE_CALL(decode_block(tile, row, col + half_block_8x8, subsize));
     } else {
-        SAFE_CALL(decode_partition(row, col, subsize));
-        SAFE_CALL(decode_partition(row, col + half_block_8x8, subsize));
-        SAFE_CALL(decode_partition(row + half_block_8x8, col, subsize));
-        SAFE_CALL(decode_partition(row + half_block_8x8, col + half_block_8x8, subsize));
+        SAFE_CALL(decode_partition(tile, row, col, subsize));
+        SAFE_CALL(decode_partition(tile, row, col + half_block_8x8, subsize));
+        SAFE_CALL(decode_partition(tile, row + half_block_8x8, col, subsize));
+        SAFE_CALL(decode_partition(tile, row + half_block_8x8, col + half_block_8x8, subsize));
     }
     if (block_subsize == Block_8x8 || partition != PartitionSplit) {
-        for (size_t i = 0; i < m_num_8x8; i++) {
+        for (size_t i = 0; i < num_8x8; i++) {
             m_above_partition_context[col + i] = 15 >> b_width_log2_lookup[subsize];
-            m_left_partition_context[row + i] = 15 >> b_width_log2_lookup[subsize];
+            tile.left_partition_context[(row + i) & 7] = 15 >> b_height_log2_lookup[subsize];
         }
     }
     return true;
 }
 
-bool Parser::decode_block(u32 row, u32 col, u8 subsize)
-{
-    m_mi_row = row;
-    m_mi_col = col;
-    m_mi_size = subsize;
-    m_available_u = row > 0;
-    m_available_l = col > m_mi_col_start;
-    SAFE_CALL(mode_info());
-    m_eob_total = 0;
-    SAFE_CALL(residual());
-    if (m_is_inter && subsize >= Block_8x8 && m_eob_total == 0)
-        m_skip = true;
-    for (size_t y = 0; y < num_8x8_blocks_high_lookup[subsize]; y++) {
-        for (size_t x = 0; x < num_8x8_blocks_wide_lookup[subsize]; x++) {
+bool Parser::decode_block(TileContext& tile, u32 row, u32 col, BlockSubsize subsize)
+{
+    tile.mi_row = row;
+    tile.mi_col = col;
+    tile.mi_size = subsize;
+    tile.available_u = row > 0;
+    tile.available_l = col > tile.mi_col_start;
+    SAFE_CALL(mode_info(tile));
+    tile.eob_total = 0;
+    SAFE_CALL(residual(tile));
+    if (tile.is_inter && subsize >= Block_8x8 && tile.eob_total == 0)
+        tile.skip = true;
+
+    // NOTE: Blocks can reach past the edge of the frame, but only the mode info of the 8x8 blocks within it is kept.
+    auto rows = min<u32>(num_8x8_blocks_high_lookup[subsize], m_mi_rows - row);
+    auto cols = min<u32>(num_8x8_blocks_wide_lookup[subsize], m_mi_cols - col);
+    for (size_t y = 0; y < rows; y++) {
+        for (size_t x = 0; x < cols; x++) {
             auto pos = (row + y) * m_mi_cols + (col + x);
-            m_skips[pos] = m_skip;
-            m_tx_sizes[pos] = m_tx_size;
-            m_mi_sizes[pos] = m_mi_size;
-            m_y_modes[pos] = m_y_mode;
-            m_segment_ids[pos] = m_segment_id;
-            for (size_t ref_list = 0; ref_list < 2; ref_list++)
-                m_ref_frames[(pos * 2) + ref_list] = m_ref_frame[ref_list];
-            if (m_is_inter) {
-                m_interp_filters[pos] = m_interp_filter;
-                for (size_t ref_list = 0; ref_list < 2; ref_list++) {
-                    auto pos_with_ref_list = (pos * 2 + ref_list) * sizeof(MV);
-                    m_mvs[pos_with_ref_list] = m_block_mvs[ref_list][3];
-                    for (size_t b = 0; b < 4; b++)
-                        m_sub_mvs[pos_with_ref_list * 4 + b * sizeof(MV)] = m_block_mvs[ref_list][b];
-                }
+            m_skips[pos] = tile.skip;
+            m_tx_sizes[pos] = tile.tx_size;
+            m_mi_sizes[pos] = tile.mi_size;
+            m_y_modes[pos] = tile.y_mode;
+            m_segment_ids[pos] = tile.segment_id;
+            for (size_t ref_list = 0; ref_list < 2; ref_list++) {
+                m_ref_frames[pos * 2 + ref_list] = tile.ref_frame[ref_list];
+                m_mvs[pos * 2 + ref_list] = tile.block_mvs[ref_list][3];
+                for (size_t b = 0; b < 4; b++)
+                    m_sub_mvs[pos * 8 + ref_list * 4 + b] = tile.block_mvs[ref_list][b];
+            }
+            if (tile.is_inter) {
+                m_interp_filters[pos] = tile.interp_filter;
             } else {
                 for (size_t b = 0; b < 4; b++)
-                    m_sub_modes[pos * 4 + b] = static_cast<IntraMode>(m_block_sub_modes[b]);
+                    m_sub_modes[pos * 4 + b] = static_cast<IntraMode>(tile.block_sub_modes[b]);
             }
         }
     }
     return true;
 }
 
-bool Parser::mode_info()
+bool Parser::mode_info(TileContext& tile)
 {
     if (m_frame_is_intra)
-        return intra_frame_mode_info();
-    return inter_frame_mode_info();
-}
-
-bool Parser::intra_frame_mode_info()
-{
-    SAFE_CALL(intra_segment_id());
-    SAFE_CALL(read_skip());
-    SAFE_CALL(read_tx_size(true));
-    m_ref_frame[0] = IntraFrame;
-    m_ref_frame[1] = None;
-    m_is_inter = false;
-    if (m_mi_size >= Block_8x8) {
-        m_default_intra_mode = m_tree_parser->parse_tree<IntraMode>(SyntaxElementType::DefaultIntraMode);
-        m_y_mode = m_default_intra_mode;
-        for (auto& block_sub_mode : m_block_sub_modes)
-            block_sub_mode = m_y_mode;
+        return intra_frame_mode_info(tile);
+    return inter_frame_mode_info(tile);
+}
+
+bool Parser::intra_frame_mode_info(TileContext& tile)
+{
+    SAFE_CALL(intra_segment_id(tile));
+    SAFE_CALL(read_skip(tile));
+    SAFE_CALL(read_tx_size(tile, true));
+    tile.ref_frame[0] = IntraFrame;
+    tile.ref_frame[1] = None;
+    tile.is_inter = false;
+    __builtin_memset(tile.block_mvs, 0, sizeof(tile.block_mvs));
+    if (tile.mi_size >= Block_8x8) {
+        tile.y_mode = tile.tree_parser.parse_tree<IntraMode>(SyntaxElementType::DefaultIntraMode);
+        for (auto& block_sub_mode : tile.block_sub_modes)
+            block_sub_mode = tile.y_mode;
     } else {
-        m_num_4x4_w = num_4x4_blocks_wide_lookup[m_mi_size];
-        m_num_4x4_h = num_4x4_blocks_high_lookup[m_mi_size];
-        for (auto idy = 0; idy < 2; idy += m_num_4x4_h) {
-            for (auto idx = 0; idx < 2; idx += m_num_4x4_w) {
-                m_tree_parser->set_default_intra_mode_variables(idx, idy);
-                m_default_intra_mode = m_tree_parser->parse_tree<IntraMode>(SyntaxElementType::DefaultIntraMode);
-                for (auto y = 0; y < m_num_4x4_h; y++) {
-                    for (auto x = 0; x < m_num_4x4_w; x++) {
-                        auto index = (idy + y) * 2 + idx + x;
-                        if (index > 3)
-                            dbgln("Trying to access index {} on m_sub_modes", index);
-                        m_block_sub_modes[index] = m_default_intra_mode;
-                    }
+        auto num_4x4_w = num_4x4_blocks_wide_lookup[tile.mi_size];
+        auto num_4x4_h = num_4x4_blocks_high_lookup[tile.mi_size];
+        IntraMode default_intra_mode;
+        for (auto idy = 0; idy < 2; idy += num_4x4_h) {
+            for (auto idx = 0; idx < 2; idx += num_4x4_w) {
+                tile.tree_parser.set_default_intra_mode_variables(idx, idy);
+                default_intra_mode = tile.tree_parser.parse_tree<IntraMode>(SyntaxElementType::DefaultIntraMode);
+                for (auto y = 0; y < num_4x4_h; y++) {
+                    for (auto x = 0; x < num_4x4_w; x++)
+                        tile.block_sub_modes[(idy + y) * 2 + idx + x] = default_intra_mode;
                 }
             }
         }
-        m_y_mode = m_default_intra_mode;
+        tile.y_mode = default_intra_mode;
     }
-    m_uv_mode = m_tree_parser->parse_tree<u8>(SyntaxElementType::DefaultUVMode);
+    tile.uv_mode = tile.tree_parser.parse_tree<u8>(SyntaxElementType::DefaultUVMode);
     return true;
 }
 
-bool Parser::intra_segment_id()
+bool Parser::intra_segment_id(TileContext& tile)
 {
-    if (m_segmentation_enabled && m_segmentation_update_map)
-        m_segment_id = m_tree_parser->parse_tree<u8>(SyntaxElementType::SegmentID);
-    else
-        m_segment_id = 0;
+    tile.segment_id = 0;
+    if (!m_segmentation_enabled)
+        return true;
+    if (!m_segmentation_update_map) {
+        copy_segment_ids(tile);
+        return true;
+    }
+    tile.segment_id = tile.tree_parser.parse_tree<u8>(SyntaxElementType::SegmentID);
+    set_segment_ids(tile);
     return true;
 }
 
-bool Parser::read_skip()
+bool Parser::read_skip(TileContext& tile)
 {
-    if (seg_feature_active(SEG_LVL_SKIP))
-        m_skip = true;
+    if (seg_feature_active(tile, SEG_LVL_SKIP))
+        tile.skip = true;
     else
-        m_skip = m_tree_parser->parse_tree<bool>(SyntaxElementType::Skip);
+        tile.skip = tile.tree_parser.parse_tree<bool>(SyntaxElementType::Skip);
     return true;
 }
 
-bool Parser::seg_feature_active(u8 feature)
+bool Parser::seg_feature_active(TileContext const& tile, u8 feature)
 {
-    return m_segmentation_enabled && m_feature_enabled[m_segment_id][feature];
+    return m_segmentation_enabled && m_feature_enabled[tile.segment_id][feature];
 }
 
-bool Parser::read_tx_size(bool allow_select)
+bool Parser::read_tx_size(TileContext& tile, bool allow_select)
 {
-    m_max_tx_size = max_txsize_lookup[m_mi_size];
-    if (allow_select && m_tx_mode == TXModeSelect && m_mi_size >= Block_8x8)
-        m_tx_size = m_tree_parser->parse_tree<TXSize>(SyntaxElementType::TXSize);
+    tile.max_tx_size = max_txsize_lookup[tile.mi_size];
+    if (allow_select && m_tx_mode == TXModeSelect && tile.mi_size >= Block_8x8)
+        tile.tx_size = tile.tree_parser.parse_tree<TXSize>(SyntaxElementType::TXSize);
     else
-        m_tx_size = min(m_max_tx_size, tx_mode_to_biggest_tx_size[m_tx_mode]);
+        tile.tx_size = min(tile.max_tx_size, tx_mode_to_biggest_tx_size[m_tx_mode]);
     return true;
 }
 
-bool Parser::inter_frame_mode_info()
-{
-    m_left_ref_frame[0] = m_available_l ? m_ref_frames[m_mi_row * m_mi_cols + (m_mi_col - 1)] : IntraFrame;
-    m_above_ref_frame[0] = m_available_u ? m_ref_frames[(m_mi_row - 1) * m_mi_cols + m_mi_col] : IntraFrame;
-    m_left_ref_frame[1] = m_available_l ? m_ref_frames[m_mi_row * m_mi_cols + (m_mi_col - 1) + 1] : None;
-    m_above_ref_frame[1] = m_available_u ? m_ref_frames[(m_mi_row - 1) * m_mi_cols + m_mi_col + 1] : None;
-    m_left_intra = m_left_ref_frame[0] <= IntraFrame;
-    m_above_intra = m_above_ref_frame[0] <= IntraFrame;
-    m_left_single = m_left_ref_frame[1] <= None;
-    m_above_single = m_above_ref_frame[1] <= None;
-    SAFE_CALL(inter_segment_id());
-    SAFE_CALL(read_skip());
-    SAFE_CALL(read_is_inter());
-    SAFE_CALL(read_tx_size(!m_skip || !m_is_inter));
-    if (m_is_inter) {
-        SAFE_CALL(inter_block_mode_info());
+bool Parser::inter_frame_mode_info(TileContext& tile)
+{
+    auto left_pos = (tile.mi_row * m_mi_cols + tile.mi_col - 1) * 2;
+    auto above_pos = ((tile.mi_row - 1) * m_mi_cols + tile.mi_col) * 2;
+    tile.left_ref_frame[0] = tile.available_l ? m_ref_frames[left_pos] : IntraFrame;
+    tile.above_ref_frame[0] = tile.available_u ? m_ref_frames[above_pos] : IntraFrame;
+    tile.left_ref_frame[1] = tile.available_l ? m_ref_frames[left_pos + 1] : None;
+    tile.above_ref_frame[1] = tile.available_u ? m_ref_frames[above_pos + 1] : None;
+    tile.left_intra = tile.left_ref_frame[0] <= IntraFrame;
+    tile.above_intra = tile.above_ref_frame[0] <= IntraFrame;
+    tile.left_single = tile.left_ref_frame[1] <= None;
+    tile.above_single = tile.above_ref_frame[1] <= None;
+    SAFE_CALL(inter_segment_id(tile));
+    SAFE_CALL(read_skip(tile));
+    SAFE_CALL(read_is_inter(tile));
+    SAFE_CALL(read_tx_size(tile, !tile.skip || !tile.is_inter));
+    if (tile.is_inter) {
+        SAFE_CALL(inter_block_mode_info(tile));
     } else {
-        SAFE_CALL(intra_block_mode_info());
+        SAFE_CALL(intra_block_mode_info(tile));
     }
     return true;
 }
 
-bool Parser::inter_segment_id()
+bool Parser::inter_segment_id(TileContext& tile)
 {
     if (!m_segmentation_enabled) {
-        m_segment_id = 0;
+        tile.segment_id = 0;
         return true;
     }
-    auto predicted_segment_id = get_segment_id();
+    auto predicted_segment_id = get_segment_id(tile);
     if (!m_segmentation_update_map) {
-        m_segment_id = predicted_segment_id;
+        copy_segment_ids(tile);
+        tile.segment_id = predicted_segment_id;
         return true;
     }
     if (!m_segmentation_temporal_update) {
-        m_segment_id = m_tree_parser->parse_tree<u8>(SyntaxElementType::SegmentID);
+        tile.segment_id = tile.tree_parser.parse_tree<u8>(SyntaxElementType::SegmentID);
+        set_segment_ids(tile);
         return true;
     }
 
-    auto seg_id_predicted = m_tree_parser->parse_tree<bool>(SyntaxElementType::SegIDPredicted);
+    auto seg_id_predicted = tile.tree_parser.parse_tree<bool>(SyntaxElementType::SegIDPredicted);
     if (seg_id_predicted)
-        m_segment_id = predicted_segment_id;
+        tile.segment_id = predicted_segment_id;
     else
-        m_segment_id = m_tree_parser->parse_tree<u8>(SyntaxElementType::SegmentID);
-    for (size_t i = 0; i < num_8x8_blocks_wide_lookup[m_mi_size]; i++)
-        m_above_seg_pred_context[m_mi_col + i] = seg_id_predicted;
-    for (size_t i = 0; i < num_8x8_blocks_high_lookup[m_mi_size]; i++)
-        m_left_seg_pred_context[m_mi_row + i] = seg_id_predicted;
+        tile.segment_id = tile.tree_parser.parse_tree<u8>(SyntaxElementType::SegmentID);
+    for (size_t i = 0; i < num_8x8_blocks_wide_lookup[tile.mi_size]; i++)
+        m_above_seg_pred_context[tile.mi_col + i] = seg_id_predicted;
+    for (size_t i = 0; i < num_8x8_blocks_high_lookup[tile.mi_size]; i++)
+        tile.left_seg_pred_context[(tile.mi_row + i) & 7] = seg_id_predicted;
+    set_segment_ids(tile);
     return true;
 }
 
-u8 Parser::get_segment_id()
+u8 Parser::get_segment_id(TileContext const& tile)
 {
-    auto bw = num_8x8_blocks_wide_lookup[m_mi_size];
-    auto bh = num_8x8_blocks_high_lookup[m_mi_size];
-    auto xmis = min(m_mi_cols - m_mi_col, (u32)bw);
-    auto ymis = min(m_mi_rows - m_mi_row, (u32)bh);
+    auto xmis = min<u32>(m_mi_cols - tile.mi_col, num_8x8_blocks_wide_lookup[tile.mi_size]);
+    auto ymis = min<u32>(m_mi_rows - tile.mi_row, num_8x8_blocks_high_lookup[tile.mi_size]);
     u8 segment = 7;
     for (size_t y = 0; y < ymis; y++) {
-        for (size_t x = 0; x < xmis; x++) {
-            segment = min(segment, m_prev_segment_ids[(m_mi_row + y) + (m_mi_col + x)]);
-        }
+        for (size_t x = 0; x < xmis; x++)
+            segment = min(segment, m_prev_segmentation_map[(tile.mi_row + y) * m_mi_cols + tile.mi_col + x]);
     }
     return segment;
 }
 
-bool Parser::read_is_inter()
+void Parser::copy_segment_ids(TileContext const& tile)
+{
+    auto xmis = min<u32>(m_mi_cols - tile.mi_col, num_8x8_blocks_wide_lookup[tile.mi_size]);
+    auto ymis = min<u32>(m_mi_rows - tile.mi_row, num_8x8_blocks_high_lookup[tile.mi_size]);
+    for (size_t y = 0; y < ymis; y++) {
+        auto pos = (tile.mi_row + y) * m_mi_cols + tile.mi_col;
+        for (size_t x = 0; x < xmis; x++)
+            m_segmentation_map[pos + x] = m_prev_segmentation_map[pos + x];
+    }
+}
+
+void Parser::set_segment_ids(TileContext const& tile)
+{
+    auto xmis = min<u32>(m_mi_cols - tile.mi_col, num_8x8_blocks_wide_lookup[tile.mi_size]);
+    auto ymis = min<u32>(m_mi_rows - tile.mi_row, num_8x8_blocks_high_lookup[tile.mi_size]);
+    for (size_t y = 0; y < ymis; y++) {
+        auto pos = (tile.mi_row + y) * m_mi_cols + tile.mi_col;
+        for (size_t x = 0; x < xmis; x++)
+            m_segmentation_map[pos + x] = tile.segment_id;
+    }
+}
+
+bool Parser::read_is_inter(TileContext& tile)
 {
-    if (seg_feature_active(SEG_LVL_REF_FRAME))
-        m_is_inter = m_feature_data[m_segment_id][SEG_LVL_REF_FRAME] != IntraFrame;
+    if (seg_feature_active(tile, SEG_LVL_REF_FRAME))
+        tile.is_inter = m_feature_data[tile.segment_id][SEG_LVL_REF_FRAME] != IntraFrame;
     else
-        m_is_inter = m_tree_parser->parse_tree<bool>(SyntaxElementType::IsInter);
+        tile.is_inter = tile.tree_parser.parse_tree<bool>(SyntaxElementType::IsInter);
     return true;
 }
 
-bool Parser::intra_block_mode_info()
+bool Parser::intra_block_mode_info(TileContext& tile)
 {
-    m_ref_frame[0] = IntraFrame;
-    m_ref_frame[1] = None;
-    if (m_mi_size >= Block_8x8) {
-        m_y_mode = m_tree_parser->parse_tree<u8>(SyntaxElementType::IntraMode);
-        for (auto& block_sub_mode : m_block_sub_modes)
-            block_sub_mode = m_y_mode;
+    tile.ref_frame[0] = IntraFrame;
+    tile.ref_frame[1] = None;
+    __builtin_memset(tile.block_mvs, 0, sizeof(tile.block_mvs));
+    if (tile.mi_size >= Block_8x8) {
+        tile.y_mode = tile.tree_parser.parse_tree<u8>(SyntaxElementType::IntraMode);
+        for (auto& block_sub_mode : tile.block_sub_modes)
+            block_sub_mode = tile.y_mode;
     } else {
-        m_num_4x4_w = num_4x4_blocks_wide_lookup[m_mi_size];
-        m_num_4x4_h = num_4x4_blocks_high_lookup[m_mi_size];
+        auto num_4x4_w = num_4x4_blocks_wide_lookup[tile.mi_size];
+        auto num_4x4_h = num_4x4_blocks_high_lookup[tile.mi_size];
         u8 sub_intra_mode;
-        for (auto idy = 0; idy < 2; idy += m_num_4x4_h) {
-            for (auto idx = 0; idx < 2; idx += m_num_4x4_w) {
-                sub_intra_mode = m_tree_parser->parse_tree<u8>(SyntaxElementType::SubIntraMode);
-                for (auto y = 0; y < m_num_4x4_h; y++) {
-                    for (auto x = 0; x < m_num_4x4_w; x++)
-                        m_block_sub_modes[(idy + y) * 2 + idx + x] = sub_intra_mode;
+        for (auto idy = 0; idy < 2; idy += num_4x4_h) {
+            for (auto idx = 0; idx < 2; idx += num_4x4_w) {
+                sub_intra_mode = tile.tree_parser.parse_tree<u8>(SyntaxElementType::SubIntraMode);
+                for (auto y = 0; y < num_4x4_h; y++) {
+                    for (auto x = 0; x < num_4x4_w; x++)
+                        tile.block_sub_modes[(idy + y) * 2 + idx + x] = sub_intra_mode;
                 }
             }
         }
-        m_y_mode = sub_intra_mode;
+        tile.y_mode = sub_intra_mode;
     }
-    m_uv_mode = m_tree_parser->parse_tree<u8>(SyntaxElementType::UVMode);
+    tile.uv_mode = tile.tree_parser.parse_tree<u8>(SyntaxElementType::UVMode);
     return true;
 }
 
-bool Parser::inter_block_mode_info()
+bool Parser::inter_block_mode_info(TileContext& tile)
 {
-    SAFE_CALL(read_ref_frames());
+    SAFE_CALL(read_ref_frames(tile));
     for (auto j = 0; j < 2; j++) {
-        if (m_ref_frame[j] > IntraFrame) {
-            SAFE_CALL(find_mv_refs(m_ref_frame[j], -1));
-            SAFE_CALL(find_best_ref_mvs(j));
+        if (tile.ref_frame[j] > IntraFrame) {
+            SAFE_CALL(find_mv_refs(tile, tile.ref_frame[j], -1));
+            SAFE_CALL(find_best_ref_mvs(tile, j));
         }
     }
-    auto is_compound = m_ref_frame[1] > IntraFrame;
-    if (seg_feature_active(SEG_LVL_SKIP)) {
-        m_y_mode = ZeroMv;
-    } else if (m_mi_size >= Block_8x8) {
-        auto inter_mode = m_tree_parser->parse_tree(SyntaxElementType::InterMode);
-        m_y_mode = NearestMv + inter_mode;
+    auto is_compound = tile.ref_frame[1] > IntraFrame;
+    if (seg_feature_active(tile, SEG_LVL_SKIP)) {
+        if (tile.mi_size < Block_8x8) {
+            dbgln("VP9: The skip segment feature can't be used on blocks smaller than 8x8");
+            return false;
+        }
+        tile.y_mode = ZeroMv;
+    } else if (tile.mi_size >= Block_8x8) {
+        auto inter_mode = tile.tree_parser.parse_tree(SyntaxElementType::InterMode);
+        tile.y_mode = NearestMv + inter_mode;
     }
     if (m_interpolation_filter == Switchable)
-        m_interp_filter = m_tree_parser->parse_tree<InterpolationFilter>(SyntaxElementType::InterpFilter);
+        tile.interp_filter = tile.tree_parser.parse_tree<InterpolationFilter>(SyntaxElementType::InterpFilter);
     else
-        m_interp_filter = m_interpolation_filter;
-    if (m_mi_size < Block_8x8) {
-        m_num_4x4_w = num_4x4_blocks_wide_lookup[m_mi_size];
-        m_num_4x4_h = num_4x4_blocks_high_lookup[m_mi_size];
-        for (auto idy = 0; idy < 2; idy += m_num_4x4_h) {
-            for (auto idx = 0; idx < 2; idx += m_num_4x4_w) {
-                auto inter_mode = m_tree_parser->parse_tree(SyntaxElementType::InterMode);
-                m_y_mode = NearestMv + inter_mode;
-                if (m_y_mode == NearestMv || m_y_mode == NearMv) {
+        tile.interp_filter = m_interpolation_filter;
+    if (tile.mi_size < Block_8x8) {
+        auto num_4x4_w = num_4x4_blocks_wide_lookup[tile.mi_size];
+        auto num_4x4_h = num_4x4_blocks_high_lookup[tile.mi_size];
+        for (auto idy = 0; idy < 2; idy += num_4x4_h) {
+            for (auto idx = 0; idx < 2; idx += num_4x4_w) {
+                auto inter_mode = tile.tree_parser.parse_tree(SyntaxElementType::InterMode);
+                tile.y_mode = NearestMv + inter_mode;
+                if (tile.y_mode == NearestMv || tile.y_mode == NearMv) {
                     for (auto j = 0; j < 1 + is_compound; j++)
-                        SAFE_CALL(append_sub8x8_mvs(idy * 2 + idx, j));
+                        SAFE_CALL(append_sub8x8_mvs(tile, idy * 2 + idx, j));
                 }
-                SAFE_CALL(assign_mv(is_compound));
-                for (auto y = 0; y < m_num_4x4_h; y++) {
-                    for (auto x = 0; x < m_num_4x4_w; x++) {
+                SAFE_CALL(assign_mv(tile, is_compound));
+                for (auto y = 0; y < num_4x4_h; y++) {
+                    for (auto x = 0; x < num_4x4_w; x++) {
                         auto block = (idy + y) * 2 + idx + x;
-                        for (auto ref_list = 0; ref_list < 1 + is_compound; ref_list++) {
-                            m_block_mvs[ref_list][block] = m_mv[ref_list];
-                        }
+                        for (auto ref_list = 0; ref_list < 2; ref_list++)
+                            tile.block_mvs[ref_list][block] = tile.mv[ref_list];
                     }
                 }
             }
         }
         return true;
     }
-    SAFE_CALL(assign_mv(is_compound));
-    for (auto ref_list = 0; ref_list < 1 + is_compound; ref_list++) {
-        for (auto block = 0; block < 4; block++) {
-            m_block_mvs[ref_list][block] = m_mv[ref_list];
-        }
+    SAFE_CALL(assign_mv(tile, is_compound));
+    for (auto ref_list = 0; ref_list < 2; ref_list++) {
+        for (auto block = 0; block < 4; block++)
+            tile.block_mvs[ref_list][block] = tile.mv[ref_list];
     }
     return true;
 }
 
-bool Parser::read_ref_frames()
+bool Parser::read_ref_frames(TileContext& tile)
 {
-    if (seg_feature_active(SEG_LVL_REF_FRAME)) {
-        m_ref_frame[0] = static_cast<ReferenceFrame>(m_feature_data[m_segment_id][SEG_LVL_REF_FRAME]);
-        m_ref_frame[1] = None;
+    if (seg_feature_active(tile, SEG_LVL_REF_FRAME)) {
+        tile.ref_frame[0] = static_cast<ReferenceFrame>(m_feature_data[tile.segment_id][SEG_LVL_REF_FRAME]);
+        tile.ref_frame[1] = None;
         return true;
     }
     ReferenceMode comp_mode;
     if (m_reference_mode == ReferenceModeSelect)
-        comp_mode = m_tree_parser->parse_tree<ReferenceMode>(SyntaxElementType::CompMode);
+        comp_mode = tile.tree_parser.parse_tree<ReferenceMode>(SyntaxElementType::CompMode);
     else
         comp_mode = m_reference_mode;
     if (comp_mode == CompoundReference) {
         auto idx = m_ref_frame_sign_bias[m_comp_fixed_ref];
-        auto comp_ref = m_tree_parser->parse_tree(SyntaxElementType::CompRef);
-        m_ref_frame[idx] = m_comp_fixed_ref;
-        m_ref_frame[!idx] = m_comp_var_ref[comp_ref];
+        auto comp_ref = tile.tree_parser.parse_tree(SyntaxElementType::CompRef);
+        tile.ref_frame[idx] = m_comp_fixed_ref;
+        tile.ref_frame[!idx] = m_comp_var_ref[comp_ref];
         return true;
     }
-    auto single_ref_p1 = m_tree_parser->parse_tree<bool>(SyntaxElementType::SingleRefP1);
+    auto single_ref_p1 = tile.tree_parser.parse_tree<bool>(SyntaxElementType::SingleRefP1);
     if (single_ref_p1) {
-        auto single_ref_p2 = m_tree_parser->parse_tree<bool>(SyntaxElementType::SingleRefP2);
-        m_ref_frame[0] = single_ref_p2 ? AltRefFrame : GoldenFrame;
+        auto single_ref_p2 = tile.tree_parser.parse_tree<bool>(SyntaxElementType::SingleRefP2);
+        tile.ref_frame[0] = single_ref_p2 ? AltRefFrame : GoldenFrame;
     } else {
-        m_ref_frame[0] = LastFrame;
+        tile.ref_frame[0] = LastFrame;
     }
-    m_ref_frame[1] = None;
+    tile.ref_frame[1] = None;
     return true;
 }
 
-bool Parser::assign_mv(bool is_compound)
+bool Parser::assign_mv(TileContext& tile, bool is_compound)
 {
-    m_mv[1] = 0;
+    tile.mv[1] = 0;
     for (auto i = 0; i < 1 + is_compound; i++) {
-        if (m_y_mode == NewMv) {
-            SAFE_CALL(read_mv(i));
-        } else if (m_y_mode == NearestMv) {
-            m_mv[i] = m_nearest_mv[i];
-        } else if (m_y_mode == NearMv) {
-            m_mv[i] = m_near_mv[i];
+        if (tile.y_mode == NewMv) {
+            SAFE_CALL(read_mv(tile, i));
+        } else if (tile.y_mode == NearestMv) {
+            tile.mv[i] = tile.nearest_mv[i];
+        } else if (tile.y_mode == NearMv) {
+            tile.mv[i] = tile.near_mv[i];
         } else {
-            m_mv[i] = 0;
+            tile.mv[i] = 0;
         }
     }
     return true;
 }
 
-bool Parser::read_mv(u8 ref)
+bool Parser::read_mv(TileContext& tile, u8 ref)
 {
-    m_use_hp = m_allow_high_precision_mv && use_mv_hp(m_best_mv[ref]);
+    tile.use_hp = m_allow_high_precision_mv && use_mv_hp(tile.best_mv[ref]);
     MV diff_mv;
-    auto mv_joint = m_tree_parser->parse_tree<MvJoint>(SyntaxElementType::MVJoint);
+    auto mv_joint = tile.tree_parser.parse_tree<MvJoint>(SyntaxElementType::MVJoint);
     if (mv_joint == MvJointHzvnz || mv_joint == MvJointHnzvnz)
-        diff_mv.set_row(read_mv_component(0));
+        diff_mv.set_row(read_mv_component(tile, 0));
     if (mv_joint == MvJointHnzvz || mv_joint == MvJointHnzvnz)
-        diff_mv.set_col(read_mv_component(1));
-    m_mv[ref] = m_best_mv[ref] + diff_mv;
+        diff_mv.set_col(read_mv_component(tile, 1));
+    tile.mv[ref] = tile.best_mv[ref] + diff_mv;
     return true;
 }
 
-i32 Parser::read_mv_component(u8)
+i32 Parser::read_mv_component(TileContext& tile, u8 component)
 {
-    auto mv_sign = m_tree_parser->parse_tree<bool>(SyntaxElementType::MVSign);
-    auto mv_class = m_tree_parser->parse_tree<MvClass>(SyntaxElementType::MVClass);
+    auto& tree_parser = tile.tree_parser;
+    tree_parser.set_mv_component_variables(component, 0, 0);
+    auto mv_sign = tree_parser.parse_tree<bool>(SyntaxElementType::MVSign);
+    auto mv_class = tree_parser.parse_tree<MvClass>(SyntaxElementType::MVClass);
     u32 mag;
     if (mv_class == MvClass0) {
-        auto mv_class0_bit = m_tree_parser->parse_tree<u32>(SyntaxElementType::MVClass0Bit);
-        auto mv_class0_fr = m_tree_parser->parse_tree<u32>(SyntaxElementType::MVClass0FR);
-        auto mv_class0_hp = m_tree_parser->parse_tree<u32>(SyntaxElementType::MVClass0HP);
+        auto mv_class0_bit = tree_parser.parse_tree<u32>(SyntaxElementType::MVClass0Bit);
+        tree_parser.set_mv_component_variables(component, mv_class0_bit, 0);
+        auto mv_class0_fr = tree_parser.parse_tree<u32>(SyntaxElementType::MVClass0FR);
+        auto mv_class0_hp = tree_parser.parse_tree<u32>(SyntaxElementType::MVClass0HP);
         mag = ((mv_class0_bit << 3) | (mv_class0_fr << 1) | mv_class0_hp) + 1;
     } else {
-        auto d = 0;
+        u32 d = 0;
         for (size_t i = 0; i < mv_class; i++) {
-            auto mv_bit = m_tree_parser->parse_tree<bool>(SyntaxElementType::MVBit);
+            tree_parser.set_mv_component_variables(component, 0, i);
+            auto mv_bit = tree_parser.parse_tree<bool>(SyntaxElementType::MVBit);
             d |= mv_bit << i;
         }
         mag = CLASS0_SIZE << (mv_class + 2);
-        auto mv_fr = m_tree_parser->parse_tree<u32>(SyntaxElementType::MVFR);
-        auto mv_hp = m_tree_parser->parse_tree<u32>(SyntaxElementType::MVHP);
+        auto mv_fr = tree_parser.parse_tree<u32>(SyntaxElementType::MVFR);
+        auto mv_hp = tree_parser.parse_tree<u32>(SyntaxElementType::MVHP);
         mag += ((d << 3) | (mv_fr << 1) | mv_hp) + 1;
     }
     return mv_sign ? -static_cast<i32>(mag) : static_cast<i32>(mag);
 }
 
-bool Parser::residual()
+bool Parser::residual(TileContext& tile)
 {
-    auto block_size = m_mi_size < Block_8x8 ? Block_8x8 : static_cast<BlockSubsize>(m_mi_size);
+    auto block_size = tile.mi_size < Block_8x8 ? Block_8x8 : tile.mi_size;
     for (size_t plane = 0; plane < 3; plane++) {
-        auto tx_size = (plane > 0) ? get_uv_tx_size() : m_tx_size;
-        auto step = 1 << tx_size;
+        auto tx_size = (plane > 0) ? get_uv_tx_size(tile) : tile.tx_size;
+        auto step = 1u << tx_size;
         auto plane_size = get_plane_block_size(block_size, plane);
         auto num_4x4_w = num_4x4_blocks_wide_lookup[plane_size];
         auto num_4x4_h = num_4x4_blocks_high_lookup[plane_size];
         auto sub_x = (plane > 0) ? m_subsampling_x : 0;
         auto sub_y = (plane > 0) ? m_subsampling_y : 0;
-        auto base_x = (m_mi_col * 8) >> sub_x;
-        auto base_y = (m_mi_row * 8) >> sub_y;
-        if (m_is_inter) {
-            if (m_mi_size < Block_8x8) {
-                for (auto y = 0; y < num_4x4_h; y++) {
-                    for (auto x = 0; x < num_4x4_w; x++) {
-                        SAFE_CALL(m_decoder.predict_inter(plane, base_x + (4 * x), base_y + (4 * y), 4, 4, (y * num_4x4_w) + x));
-                    }
+        auto base_x = (tile.mi_col * 8) >> sub_x;
+        auto base_y = (tile.mi_row * 8) >> sub_y;
+        if (tile.is_inter) {
+            if (tile.mi_size < Block_8x8) {
+                for (u32 y = 0; y < num_4x4_h; y++) {
+                    for (u32 x = 0; x < num_4x4_w; x++)
+                        SAFE_CALL(m_decoder.predict_inter(tile, plane, base_x + (4 * x), base_y + (4 * y), 4, 4, (y * num_4x4_w) + x));
                 }
             } else {
-                SAFE_CALL(m_decoder.predict_inter(plane, base_x, base_y, num_4x4_w * 4, num_4x4_h * 4, 0));
+                SAFE_CALL(m_decoder.predict_inter(tile, plane, base_x, base_y, num_4x4_w * 4, num_4x4_h * 4, 0));
             }
         }
+
         auto max_x = (m_mi_cols * 8) >> sub_x;
         auto max_y = (m_mi_rows * 8) >> sub_y;
-        auto block_index = 0;
-        for (auto y = 0; y < num_4x4_h; y += step) {
-            for (auto x = 0; x < num_4x4_w; x += step) {
+        auto* above_context = m_above_nonzero_context[plane].data() + (base_x >> 2);
+        auto* left_context = tile.left_nonzero_context[plane] + ((base_y >> 2) & ((16 >> sub_y) - 1));
+        if (tile.skip) {
+            __builtin_memset(above_context, 0, num_4x4_w);
+            __builtin_memset(left_context, 0, num_4x4_h);
+        }
+
+        u32 block_index = 0;
+        for (u32 y = 0; y < num_4x4_h; y += step) {
+            for (u32 x = 0; x < num_4x4_w; x += step) {
                 auto start_x = base_x + (4 * x);
                 auto start_y = base_y + (4 * y);
-                auto non_zero = false;
                 if (start_x < max_x && start_y < max_y) {
-                    if (!m_is_inter)
-                        SAFE_CALL(m_decoder.predict_intra(plane, start_x, start_y, m_available_l || x > 0, m_available_u || y > 0, (x + step) < num_4x4_w, tx_size, block_index));
-                    if (!m_skip) {
-                        non_zero = tokens(plane, start_x, start_y, tx_size, block_index);
-                        SAFE_CALL(m_decoder.reconstruct(plane, start_x, start_y, tx_size));
+                    if (!tile.is_inter)
+                        SAFE_CALL(m_decoder.predict_intra(tile, plane, start_x, start_y, tile.available_l || x > 0, tile.available_u || y > 0, (x + step) < num_4x4_w, tx_size, block_index));
+                    if (!tile.skip) {
+                        auto eob = tokens(tile, plane, start_x, start_y, tx_size, block_index);
+                        if (eob > 0)
+                            SAFE_CALL(m_decoder.reconstruct(tile, plane, start_x, start_y, tx_size, eob));
+                        tile.eob_total += eob;
+                        // NOTE: The parts of the context that lie past the edge of the frame are always left at zero.
+                        for (u32 i = 0; i < step; i++) {
+                            above_context[x + i] = eob > 0 && start_x + 4 * i < max_x;
+                            left_context[y + i] = eob > 0 && start_y + 4 * i < max_y;
+                        }
                     }
                 }
-                auto above_sub_context = m_above_nonzero_context[plane];
-                auto left_sub_context = m_left_nonzero_context[plane];
-                above_sub_context.resize_and_keep_capacity((start_x >> 2) + step);
-                left_sub_context.resize_and_keep_capacity((start_y >> 2) + step);
-                for (auto i = 0; i < step; i++) {
-                    above_sub_context[(start_x >> 2) + i] = non_zero;
-                    left_sub_context[(start_y >> 2) + i] = non_zero;
-                }
                 block_index++;
             }
         }
@@ -1264,11 +1373,11 @@ bool Parser::residual()
     return true;
 }
 
-TXSize Parser::get_uv_tx_size()
+TXSize Parser::get_uv_tx_size(TileContext const& tile)
 {
-    if (m_mi_size < Block_8x8)
+    if (tile.mi_size < Block_8x8)
         return TX_4x4;
-    return min(m_tx_size, max_txsize_lookup[get_plane_block_size(m_mi_size, 1)]);
+    return min(tile.tx_size, max_txsize_lookup[get_plane_block_size(tile.mi_size, 1)]);
 }
 
 BlockSubsize Parser::get_plane_block_size(u32 subsize, u8 plane)
@@ -1278,119 +1387,339 @@ BlockSubsize Parser::get_plane_block_size(u32 subsize, u8 plane)
     return ss_size_lookup[subsize][sub_x][sub_y];
 }
 
-bool Parser::tokens(size_t plane, u32 start_x, u32 start_y, TXSize tx_size, u32 block_index)
-{
-    m_tree_parser->set_start_x_and_y(start_x, start_y);
-    size_t segment_eob = 16 << (tx_size << 1);
-    auto scan = get_scan(plane, tx_size, block_index);
-    auto check_eob = true;
-    size_t c = 0;
-    for (; c < segment_eob; c++) {
-        auto pos = scan[c];
-        auto band = (tx_size == TX_4x4) ? coefband_4x4[c] : coefband_8x8plus[c];
-        m_tree_parser->set_tokens_variables(band, c, plane, tx_size, pos);
-        if (check_eob) {
-            auto more_coefs = m_tree_parser->parse_tree<bool>(SyntaxElementType::MoreCoefs);
-            if (!more_coefs)
-                break;
+// The context of a coefficient is derived from the energy of the tokens above and to the left of it. Row and column
+// scans have only been transformed with an ADST in one direction, so they only look along the other one.
+static ALWAYS_INLINE u8 coefficient_context(u8 const* token_cache, u32 position, u8 log2_of_width, u8 tx_type)
+{
+    auto row = position >> log2_of_width;
+    auto col = position & ((1u << log2_of_width) - 1);
+    auto above = token_cache[position - (row > 0 ? (1u << log2_of_width) : 0)];
+    auto left = token_cache[position - (col > 0 ? 1 : 0)];
+    if (row == 0)
+        return left;
+    if (col == 0 || tx_type == DCT_ADST)
+        return above;
+    if (tx_type == ADST_DCT)
+        return left;
+    return (1 + above + left) >> 1;
+}
+
+u32 Parser::tokens(TileContext& tile, size_t plane, u32 start_x, u32 start_y, TXSize tx_size, u32 block_index)
+{
+    auto& bit_stream = *tile.bit_stream;
+    auto const* scan = get_scan(tile, plane, tx_size, block_index);
+    u32 segment_eob = 16 << (tx_size << 1);
+    u8 log2_of_width = tx_size + 2;
+    auto const* bands = tx_size == TX_4x4 ? coefband_4x4 : coefband_8x8plus;
+    auto is_uv = plane > 0;
+    auto const& probabilities = m_probability_tables->coef_probs()[tx_size][is_uv][tile.is_inter];
+    auto& token_counts = tile.counter.m_counts_token[tx_size][is_uv][tile.is_inter];
+    auto& more_coefs_counts = tile.counter.m_counts_more_coefs[tx_size][is_uv][tile.is_inter];
+    auto const& dequantization_factors = m_dequantization_factors[tile.segment_id][is_uv];
+    auto dequantization_shift = tx_size == TX_32x32 ? 1 : 0;
+    auto const& pareto_table = m_probability_tables->pareto_table();
+
+    // The first coefficient takes its context from the transform blocks above and to the left of this one.
+    auto sub_y = is_uv ? m_subsampling_y : 0;
+    auto const* above_context = m_above_nonzero_context[plane].data() + (start_x >> 2);
+    auto const* left_context = tile.left_nonzero_context[plane] + ((start_y >> 2) & ((16 >> sub_y) - 1));
+    bool above_nonzero = false;
+    bool left_nonzero = false;
+    for (u32 i = 0; i < (1u << tx_size); i++) {
+        above_nonzero |= above_context[i] != 0;
+        left_nonzero |= left_context[i] != 0;
+    }
+    u8 context = above_nonzero + left_nonzero;
+
+    u32 last_nonzero_row = 0;
+    u32 c = 0;
+    while (c < segment_eob) {
+        if (c > 0)
+            context = coefficient_context(tile.token_cache, scan[c], log2_of_width, tile.tx_type);
+        auto band = bands[c];
+        auto const* probs = probabilities[band][context];
+        more_coefs_counts[band][context]++;
+        if (!bit_stream.read_bool(probs[0])) {
+            // NOTE: The end of block is counted as a token of its own in the last entry.
+            token_counts[band][context][3]++;
+            break;
+        }
+
+        // NOTE: There can be no end of block directly after a zero, so runs of them are read without checking for one.
+        while (!bit_stream.read_bool(probs[1])) {
+            token_counts[band][context][ZeroToken]++;
+            tile.token_cache[scan[c]] = energy_class[ZeroToken];
+            if (++c >= segment_eob)
+                goto done;
+            context = coefficient_context(tile.token_cache, scan[c], log2_of_width, tile.tx_type);
+            band = bands[c];
+            probs = probabilities[band][context];
         }
-        auto token = m_tree_parser->parse_tree<Token>(SyntaxElementType::Token);
-        m_token_cache[pos] = energy_class[token];
-        if (token == ZeroToken) {
-            m_tokens[pos] = 0;
-            check_eob = false;
+
+        u8 token;
+        i32 value;
+        if (!bit_stream.read_bool(probs[2])) {
+            token_counts[band][context][OneToken]++;
+            token = OneToken;
+            value = 1;
         } else {
-            i32 coef = static_cast<i32>(read_coef(token));
-            auto sign_bit = m_bit_stream->read_literal(1);
-            m_tokens[pos] = sign_bit ? -coef : coef;
-            check_eob = true;
+            // NOTE: The tokens larger than one are all counted together, and their probabilities follow from the
+            //       probability of reading more than a one through the Pareto table.
+            token_counts[band][context][TwoToken]++;
+            auto x = (probs[2] - 1) / 2;
+            auto pareto_probability = [&](u8 node) -> u8 {
+                if (probs[2] & 1)
+                    return pareto_table[x][node];
+                return (pareto_table[x][node] + pareto_table[x + 1][node]) >> 1;
+            };
+            i32 n = 4;
+            do {
+                n = token_tree[n + bit_stream.read_bool(pareto_probability((n >> 1) - 2))];
+            } while (n > 0);
+            token = -n;
+            if (token <= FourToken) {
+                value = token;
+            } else {
+                auto cat = extra_bits[token][0];
+                auto num_extra = extra_bits[token][1];
+                value = extra_bits[token][2];
+                i32 extra = 0;
+                for (u8 e = 0; e < num_extra; e++)
+                    extra = (extra << 1) | bit_stream.read_bool(cat_probs[cat][e]);
+                value += extra;
+            }
         }
+
+        auto position = scan[c];
+        auto dequantization_factor = dequantization_factors[c == 0 ? 0 : 1];
+        i32 coefficient = (value * dequantization_factor) >> dequantization_shift;
+        tile.coefficients[position] = bit_stream.read_bool(128) ? -coefficient : coefficient;
+        tile.token_cache[position] = energy_class[token];
+        last_nonzero_row = max(last_nonzero_row, position >> log2_of_width);
+        c++;
     }
-    auto non_zero = c > 0;
-    m_eob_total += non_zero;
-    for (size_t i = c; i < segment_eob; i++)
-        m_tokens[scan[i]] = 0;
-    return non_zero;
+done:
+    tile.last_nonzero_row = last_nonzero_row;
+    return c;
 }
 
-u32 const* Parser::get_scan(size_t plane, TXSize tx_size, u32 block_index)
+u32 const* Parser::get_scan(TileContext& tile, size_t plane, TXSize tx_size, u32 block_index)
 {
     if (plane > 0 || tx_size == TX_32x32) {
-        m_tx_type = DCT_DCT;
+        tile.tx_type = DCT_DCT;
     } else if (tx_size == TX_4x4) {
-        if (m_lossless || m_is_inter)
-            m_tx_type = DCT_DCT;
+        if (m_lossless || tile.is_inter)
+            tile.tx_type = DCT_DCT;
         else
-            m_tx_type = mode_to_txfm_map[m_mi_size < Block_8x8 ? m_block_sub_modes[block_index] : m_y_mode];
+            tile.tx_type = mode_to_txfm_map[tile.mi_size < Block_8x8 ? tile.block_sub_modes[block_index] : tile.y_mode];
     } else {
-        m_tx_type = mode_to_txfm_map[m_y_mode];
+        tile.tx_type = mode_to_txfm_map[tile.y_mode];
     }
     if (tx_size == TX_4x4) {
-        if (m_tx_type == ADST_DCT)
+        if (tile.tx_type == ADST_DCT)
             return row_scan_4x4;
-        if (m_tx_type == DCT_ADST)
+        if (tile.tx_type == DCT_ADST)
             return col_scan_4x4;
         return default_scan_4x4;
     }
     if (tx_size == TX_8x8) {
-        if (m_tx_type == ADST_DCT)
+        if (tile.tx_type == ADST_DCT)
             return row_scan_8x8;
-        if (m_tx_type == DCT_ADST)
+        if (tile.tx_type == DCT_ADST)
             return col_scan_8x8;
         return default_scan_8x8;
     }
     if (tx_size == TX_16x16) {
-        if (m_tx_type == ADST_DCT)
+        if (tile.tx_type == ADST_DCT)
             return row_scan_16x16;
-        if (m_tx_type == DCT_ADST)
+        if (tile.tx_type == DCT_ADST)
             return col_scan_16x16;
         return default_scan_16x16;
     }
     return default_scan_32x32;
 }
 
-u32 Parser::read_coef(Token token)
-{
-    auto cat = extra_bits[token][0];
-    auto num_extra = extra_bits[token][1];
-    auto coef = extra_bits[token][2];
-    if (token == DctValCat6) {
-        for (size_t e = 0; e < (u8)(m_bit_depth - 8); e++) {
-            auto high_bit = m_bit_stream->read_bool(255);
-            coef += high_bit << (5 + m_bit_depth - e);
+/* (6.4.22) */
+bool Parser::find_mv_refs(TileContext& tile, ReferenceFrame reference_frame, int block)
+{
+    tile.ref_mv_count = 0;
+    tile.ref_list_mv[0] = 0;
+    tile.ref_list_mv[1] = 0;
+    u8 context_counter = 0;
+    bool different_ref_found = false;
+    auto const& candidates = mv_ref_blocks[tile.mi_size];
+
+    // The search ends as soon as two different motion vectors have been found.
+    auto search = [&] {
+        for (size_t i = 0; i < MVREF_NEIGHBOURS; i++) {
+            auto candidate_row = static_cast<i32>(tile.mi_row) + candidates[i][0];
+            auto candidate_col = static_cast<i32>(tile.mi_col) + candidates[i][1];
+            if (!is_inside(tile, candidate_row, candidate_col))
+                continue;
+            auto pos = candidate_row * m_mi_cols + candidate_col;
+            different_ref_found = true;
+            // NOTE: Only the nearest two neighbours contribute to the mode context, and they are the only ones that
+            //       sub-8x8 blocks take the motion vector of the closest 4x4 block from.
+            auto is_nearest = i < 2;
+            if (is_nearest)
+                context_counter += mode_2_counter[m_y_modes[pos]];
+            for (u8 ref_list = 0; ref_list < 2; ref_list++) {
+                if (m_ref_frames[pos * 2 + ref_list] != reference_frame)
+                    continue;
+                if (is_nearest && block >= 0 && m_mi_sizes[pos] < Block_8x8)
+                    add_mv_ref_list(tile, m_sub_mvs[pos * 8 + ref_list * 4 + idx_n_column_to_subblock[block][candidates[i][1] == 0]]);
+                else
+                    add_mv_ref_list(tile, m_mvs[pos * 2 + ref_list]);
+                break;
+            }
+            if (tile.ref_mv_count == 2)
+                return;
+        }
+
+        auto prev_pos = tile.mi_row * m_mi_cols + tile.mi_col;
+        if (m_use_prev_frame_mvs) {
+            for (u8 ref_list = 0; ref_list < 2; ref_list++) {
+                if (m_prev_ref_frames[prev_pos * 2 + ref_list] != reference_frame)
+                    continue;
+                add_mv_ref_list(tile, m_prev_mvs[prev_pos * 2 + ref_list]);
+                break;
+            }
+            if (tile.ref_mv_count == 2)
+                return;
+        }
+
+        if (different_ref_found) {
+            for (size_t i = 0; i < MVREF_NEIGHBOURS; i++) {
+                auto candidate_row = static_cast<i32>(tile.mi_row) + candidates[i][0];
+                auto candidate_col = static_cast<i32>(tile.mi_col) + candidates[i][1];
+                if (!is_inside(tile, candidate_row, candidate_col))
+                    continue;
+                auto pos = candidate_row * m_mi_cols + candidate_col;
+                if_diff_ref_frame_add_mv(tile, &m_ref_frames[pos * 2], &m_mvs[pos * 2], reference_frame);
+                if (tile.ref_mv_count == 2)
+                    return;
+            }
         }
+
+        if (m_use_prev_frame_mvs)
+            if_diff_ref_frame_add_mv(tile, &m_prev_ref_frames[prev_pos * 2], &m_prev_mvs[prev_pos * 2], reference_frame);
+    };
+    search();
+
+    tile.mode_context[reference_frame] = counter_to_context[context_counter];
+    for (auto& mv : tile.ref_list_mv)
+        clamp_mv_ref(tile, mv, MV_BORDER);
+    return true;
+}
+
+bool Parser::is_inside(TileContext const& tile, i32 row, i32 col)
+{
+    return row >= 0 && row < static_cast<i32>(m_mi_rows) && col >= static_cast<i32>(tile.mi_col_start) && col < static_cast<i32>(tile.mi_col_end);
+}
+
+void Parser::add_mv_ref_list(TileContext& tile, MV const& mv)
+{
+    if (tile.ref_mv_count == 0) {
+        tile.ref_list_mv[0] = mv;
+        tile.ref_mv_count = 1;
+        return;
     }
-    for (size_t e = 0; e < num_extra; e++) {
-        auto coef_bit = m_bit_stream->read_bool(cat_probs[cat][e]);
-        coef += coef_bit << (num_extra - 1 - e);
+    if (mv == tile.ref_list_mv[0])
+        return;
+    tile.ref_list_mv[1] = mv;
+    tile.ref_mv_count = 2;
+}
+
+void Parser::if_diff_ref_frame_add_mv(TileContext& tile, ReferenceFrame const candidate_ref_frames[2], MV const candidate_mvs[2], ReferenceFrame ref_frame)
+{
+    if (candidate_ref_frames[0] <= IntraFrame)
+        return;
+    if (candidate_ref_frames[0] != ref_frame) {
+        add_mv_ref_list(tile, scale_mv(candidate_mvs[0], candidate_ref_frames[0], ref_frame));
+        if (tile.ref_mv_count == 2)
+            return;
     }
-    return coef;
+    if (candidate_ref_frames[1] > IntraFrame && candidate_ref_frames[1] != ref_frame && !(candidate_mvs[1] == candidate_mvs[0]))
+        add_mv_ref_list(tile, scale_mv(candidate_mvs[1], candidate_ref_frames[1], ref_frame));
 }
 
-bool Parser::find_mv_refs(ReferenceFrame, int)
+MV Parser::scale_mv(MV const& mv, ReferenceFrame candidate_ref_frame, ReferenceFrame ref_frame)
 {
-    // TODO: Implement
-    return true;
+    if (m_ref_frame_sign_bias[candidate_ref_frame] != m_ref_frame_sign_bias[ref_frame])
+        return { -mv.row(), -mv.col() };
+    return mv;
 }
 
-bool Parser::find_best_ref_mvs(int)
+void Parser::clamp_mv_ref(TileContext const& tile, MV& mv, i32 border)
 {
-    // TODO: Implement
-    return true;
+    i32 mb_to_left_edge = -static_cast<i32>(tile.mi_col * 8 * 8);
+    i32 mb_to_right_edge = (static_cast<i32>(m_mi_cols) - num_8x8_blocks_wide_lookup[tile.mi_size] - static_cast<i32>(tile.mi_col)) * 8 * 8;
+    i32 mb_to_top_edge = -static_cast<i32>(tile.mi_row * 8 * 8);
+    i32 mb_to_bottom_edge = (static_cast<i32>(m_mi_rows) - num_8x8_blocks_high_lookup[tile.mi_size] - static_cast<i32>(tile.mi_row)) * 8 * 8;
+    mv.set_col(clamp(mv.col(), mb_to_left_edge - border, mb_to_right_edge + border));
+    mv.set_row(clamp(mv.row(), mb_to_top_edge - border, mb_to_bottom_edge + border));
 }
 
-bool Parser::append_sub8x8_mvs(u8, u8)
+void Parser::lower_mv_precision(MV& mv)
 {
-    // TODO: Implement
+    if (m_allow_high_precision_mv && use_mv_hp(mv))
+        return;
+    if (mv.row() & 1)
+        mv.set_row(mv.row() + (mv.row() > 0 ? -1 : 1));
+    if (mv.col() & 1)
+        mv.set_col(mv.col() + (mv.col() > 0 ? -1 : 1));
+}
+
+/* (6.4.23) */
+bool Parser::find_best_ref_mvs(TileContext& tile, int ref_list)
+{
+    for (auto& mv : tile.ref_list_mv)
+        lower_mv_precision(mv);
+    tile.nearest_mv[ref_list] = tile.ref_list_mv[0];
+    tile.near_mv[ref_list] = tile.ref_list_mv[1];
+    tile.best_mv[ref_list] = tile.ref_list_mv[0];
     return true;
 }
 
-bool Parser::use_mv_hp(const MV&)
+/* (6.4.25) */
+bool Parser::append_sub8x8_mvs(TileContext& tile, u8 block, u8 ref_list)
 {
-    // TODO: Implement
+    SAFE_CALL(find_mv_refs(tile, tile.ref_frame[ref_list], block));
+
+    // The nearest motion vector is the one of the closest 4x4 block that has already been read, and the near one
+    // is the next candidate that differs from it.
+    MV candidates[4];
+    size_t candidate_count = 0;
+    if (block == 0) {
+        tile.nearest_mv[ref_list] = tile.ref_list_mv[0];
+        tile.near_mv[ref_list] = tile.ref_list_mv[1];
+        return true;
+    }
+    if (block == 3) {
+        tile.nearest_mv[ref_list] = tile.block_mvs[ref_list][2];
+        candidates[candidate_count++] = tile.block_mvs[ref_list][1];
+        candidates[candidate_count++] = tile.block_mvs[ref_list][0];
+    } else {
+        tile.nearest_mv[ref_list] = tile.block_mvs[ref_list][0];
+    }
+    candidates[candidate_count++] = tile.ref_list_mv[0];
+    candidates[candidate_count++] = tile.ref_list_mv[1];
+
+    tile.near_mv[ref_list] = 0;
+    for (size_t i = 0; i < candidate_count; i++) {
+        if (!(candidates[i] == tile.nearest_mv[ref_list])) {
+            tile.near_mv[ref_list] = candidates[i];
+            break;
+        }
+    }
     return true;
 }
 
+bool Parser::use_mv_hp(MV const& delta_mv)
+{
+    return (abs(delta_mv.row()) >> 3) < COMPANDED_MVREF_THRESH && (abs(delta_mv.col()) >> 3) < COMPANDED_MVREF_THRESH;
+}
+
 void Parser::dump_info()
 {
     outln("Frame dimensions: {}x{}", m_frame_width, m_frame_height);
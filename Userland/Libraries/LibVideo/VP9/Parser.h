@@ -11,22 +11,28 @@
 #include "MV.h"
 #include "ProbabilityTables.h"
 #include "SyntaxElementCounter.h"
+#include "TileContext.h"
 #include "TreeParser.h"
-#include <AK/ByteBuffer.h>
+#include <AK/NonnullOwnPtrVector.h>
 #include <AK/OwnPtr.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace Video::VP9 {
 
 class Decoder;
+class LoopFilter;
 
 class Parser {
     friend class TreeParser;
     friend class Decoder;
+    friend class LoopFilter;
 
 public:
     explicit Parser(Decoder&);
     ~Parser();
-    bool parse_frame(ByteBuffer const&);
+    bool parse_frame(ReadonlyBytes);
     void dump_info();
 
 private:
@@ -46,9 +52,9 @@ private:
 
     /* Utilities */
     void clear_context(Vector<u8>& context, size_t size);
-    void clear_context(Vector<Vector<u8>>& context, size_t outer_size, size_t inner_size);
     void allocate_tile_data();
-    void cleanup_tile_allocations();
+    void setup_dequantization();
+    TileContext& tile_context(size_t tile_col);
 
     /* (6.1) Frame Syntax */
     bool trailing_bits();
@@ -95,52 +101,61 @@ private:
     bool setup_compound_reference_mode();
 
     /* (6.4) Decode Tiles Syntax */
-    bool decode_tiles();
+    bool decode_tiles(ReadonlyBytes tile_data);
     bool clear_above_context();
     u32 get_tile_offset(u32 tile_num, u32 mis, u32 tile_size_log2);
-    bool decode_tile();
-    bool clear_left_context();
-    bool decode_partition(u32 row, u32 col, u8 block_subsize);
-    bool decode_block(u32 row, u32 col, u8 subsize);
-    bool mode_info();
-    bool intra_frame_mode_info();
-    bool intra_segment_id();
-    bool read_skip();
-    bool seg_feature_active(u8 feature);
-    bool read_tx_size(bool allow_select);
-    bool inter_frame_mode_info();
-    bool inter_segment_id();
-    u8 get_segment_id();
-    bool read_is_inter();
-    bool intra_block_mode_info();
-    bool inter_block_mode_info();
-    bool read_ref_frames();
-    bool assign_mv(bool is_compound);
-    bool read_mv(u8 ref);
-    i32 read_mv_component(u8 component);
-    bool residual();
-    TXSize get_uv_tx_size();
+    bool decode_tile(TileContext&);
+    bool clear_left_context(TileContext&);
+    bool decode_partition(TileContext&, u32 row, u32 col, BlockSubsize block_subsize);
+    bool decode_block(TileContext&, u32 row, u32 col, BlockSubsize subsize);
+    bool mode_info(TileContext&);
+    bool intra_frame_mode_info(TileContext&);
+    bool intra_segment_id(TileContext&);
+    bool read_skip(TileContext&);
+    bool seg_feature_active(TileContext const&, u8 feature);
+    bool read_tx_size(TileContext&, bool allow_select);
+    bool inter_frame_mode_info(TileContext&);
+    bool inter_segment_id(TileContext&);
+    u8 get_segment_id(TileContext const&);
+    void copy_segment_ids(TileContext const&);
+    void set_segment_ids(TileContext const&);
+    bool read_is_inter(TileContext&);
+    bool intra_block_mode_info(TileContext&);
+    bool inter_block_mode_info(TileContext&);
+    bool read_ref_frames(TileContext&);
+    bool assign_mv(TileContext&, bool is_compound);
+    bool read_mv(TileContext&, u8 ref);
+    i32 read_mv_component(TileContext&, u8 component);
+    bool residual(TileContext&);
+    TXSize get_uv_tx_size(TileContext const&);
     BlockSubsize get_plane_block_size(u32 subsize, u8 plane);
-    bool tokens(size_t plane, u32 x, u32 y, TXSize tx_size, u32 block_index);
-    u32 const* get_scan(size_t plane, TXSize tx_size, u32 block_index);
-    u32 read_coef(Token token);
+    u32 tokens(TileContext&, size_t plane, u32 x, u32 y, TXSize tx_size, u32 block_index);
+    u32 const* get_scan(TileContext&, size_t plane, TXSize tx_size, u32 block_index);
 
     /* (6.5) Motion Vector Prediction */
-    bool find_mv_refs(ReferenceFrame, int block);
-    bool find_best_ref_mvs(int ref_list);
-    bool append_sub8x8_mvs(u8 block, u8 ref_list);
+    bool find_mv_refs(TileContext&, ReferenceFrame, int block);
+    bool find_best_ref_mvs(TileContext&, int ref_list);
+    bool append_sub8x8_mvs(TileContext&, u8 block, u8 ref_list);
     bool use_mv_hp(MV const& delta_mv);
+    bool is_inside(TileContext const&, i32 row, i32 col);
+    void add_mv_ref_list(TileContext&, MV const&);
+    void if_diff_ref_frame_add_mv(TileContext&, ReferenceFrame const candidate_ref_frames[2], MV const candidate_mvs[2], ReferenceFrame ref_frame);
+    MV scale_mv(MV const&, ReferenceFrame candidate_ref_frame, ReferenceFrame ref_frame);
+    void clamp_mv_ref(TileContext const&, MV&, i32 border);
+    void lower_mv_precision(MV&);
 
     u8 m_profile { 0 };
+    bool m_show_existing_frame { false };
     u8 m_frame_to_show_map_index { 0 };
     u16 m_header_size_in_bytes { 0 };
     u8 m_refresh_frame_flags { 0 };
     u8 m_loop_filter_level { 0 };
     u8 m_loop_filter_sharpness { 0 };
     bool m_loop_filter_delta_enabled { false };
-    FrameType m_frame_type;
-    FrameType m_last_frame_type;
+    FrameType m_frame_type { KeyFrame };
+    FrameType m_last_frame_type { KeyFrame };
     bool m_show_frame { false };
+    bool m_last_show_frame { false };
     bool m_error_resilient_mode { false };
     bool m_frame_is_intra { false };
     u8 m_reset_frame_context { 0 };
@@ -157,6 +172,8 @@ private:
     bool m_subsampling_y { false };
     u32 m_frame_width { 0 };
     u32 m_frame_height { 0 };
+    u32 m_last_frame_width { 0 };
+    u32 m_last_frame_height { 0 };
     u16 m_render_width { 0 };
     u16 m_render_height { 0 };
     bool m_render_and_frame_size_different { false };
@@ -165,11 +182,15 @@ private:
     u32 m_sb64_cols { 0 };
     u32 m_sb64_rows { 0 };
     InterpolationFilter m_interpolation_filter;
+    u8 m_base_q_idx { 0 };
+    i8 m_delta_q_y_dc { 0 };
+    i8 m_delta_q_uv_dc { 0 };
+    i8 m_delta_q_uv_ac { 0 };
     bool m_lossless { false };
     u8 m_segmentation_tree_probs[7];
     u8 m_segmentation_pred_prob[3];
     bool m_feature_enabled[8][4];
-    u8 m_feature_data[8][4];
+    i16 m_feature_data[8][4];
     bool m_segmentation_enabled { false };
     bool m_segmentation_update_map { false };
     bool m_segmentation_temporal_update { false };
@@ -178,81 +199,49 @@ private:
     u16 m_tile_rows_log2 { 0 };
     i8 m_loop_filter_ref_deltas[MAX_REF_FRAMES];
     i8 m_loop_filter_mode_deltas[2];
+    // The dequantization factors of each segment, for the luma and the chroma planes, and for the DC and the AC coefficients.
+    i32 m_dequantization_factors[MAX_SEGMENTS][2][2];
 
-    Vector<Vector<u8>> m_above_nonzero_context;
-    Vector<Vector<u8>> m_left_nonzero_context;
+    // NOTE: The above contexts are shared by all tiles of a tile row, which write to disjoint ranges of them.
+    Vector<u8> m_above_nonzero_context[3];
     Vector<u8> m_above_seg_pred_context;
-    Vector<u8> m_left_seg_pred_context;
     Vector<u8> m_above_partition_context;
-    Vector<u8> m_left_partition_context;
-    u32 m_mi_row_start { 0 };
-    u32 m_mi_row_end { 0 };
-    u32 m_mi_col_start { 0 };
-    u32 m_mi_col_end { 0 };
-    u32 m_mi_row { 0 };
-    u32 m_mi_col { 0 };
-    u32 m_mi_size { 0 };
-    bool m_available_u { false };
-    bool m_available_l { false };
-    u8 m_segment_id { 0 };
-    bool m_skip { false };
-    u8 m_num_8x8 { 0 };
-    bool m_has_rows { false };
-    bool m_has_cols { false };
-    TXSize m_max_tx_size { TX_4x4 };
-    u8 m_block_subsize { 0 };
-    u32 m_row { 0 };
-    u32 m_col { 0 };
-    TXSize m_tx_size { TX_4x4 };
-    ReferenceFrame m_ref_frame[2];
-    bool m_is_inter { false };
-    IntraMode m_default_intra_mode { DcPred };
-    u8 m_y_mode { 0 };
-    u8 m_block_sub_modes[4];
-    u8 m_num_4x4_w { 0 };
-    u8 m_num_4x4_h { 0 };
-    u8 m_uv_mode { 0 }; // FIXME: Is u8 the right size?
-    ReferenceFrame m_left_ref_frame[2];
-    ReferenceFrame m_above_ref_frame[2];
-    bool m_left_intra { false };
-    bool m_above_intra { false };
-    bool m_left_single { false };
-    bool m_above_single { false };
-    InterpolationFilter m_interp_filter { EightTap };
-    MV m_mv[2];
-    MV m_near_mv[2];
-    MV m_nearest_mv[2];
-    MV m_best_mv[2];
-    u32 m_ref_frame_width[NUM_REF_FRAMES];
-    u32 m_ref_frame_height[NUM_REF_FRAMES];
-    u32 m_eob_total { 0 };
-    u8 m_tx_type { 0 };
-    u8 m_token_cache[1024];
-    i32 m_tokens[1024];
-    bool m_use_hp { false };
+
     TXMode m_tx_mode;
     ReferenceMode m_reference_mode;
     ReferenceFrame m_comp_fixed_ref;
     ReferenceFrame m_comp_var_ref[2];
-    MV m_block_mvs[2][4];
-    u8* m_prev_segment_ids { nullptr };
+    bool m_use_prev_frame_mvs { false };
+
+    // The mode info of the current frame, with one entry (or two for each reference list, or four for each 4x4 block)
+    // for each 8x8 block.
+    Vector<bool> m_skips;
+    Vector<TXSize> m_tx_sizes;
+    Vector<BlockSubsize> m_mi_sizes;
+    Vector<u8> m_y_modes;
+    Vector<u8> m_segment_ids;
+    Vector<ReferenceFrame> m_ref_frames;
+    Vector<InterpolationFilter> m_interp_filters;
+    Vector<MV> m_mvs;
+    Vector<MV> m_sub_mvs;
+    Vector<IntraMode> m_sub_modes;
+
+    // The segmentation map that is being decoded, and the one of the previous frame that it is predicted from.
+    Vector<u8> m_segmentation_map;
+    Vector<u8> m_prev_segmentation_map;
+    // The reference frames and motion vectors of the previous frame, which are used as motion vector candidates.
+    Vector<ReferenceFrame> m_prev_ref_frames;
+    Vector<MV> m_prev_mvs;
 
-    u32 m_allocated_dimensions { 0 };
-    bool* m_skips { nullptr };
-    TXSize* m_tx_sizes { nullptr };
-    u32* m_mi_sizes { nullptr };
-    u8* m_y_modes { nullptr };
-    u8* m_segment_ids { nullptr };
-    ReferenceFrame* m_ref_frames { nullptr };
-    InterpolationFilter* m_interp_filters { nullptr };
-    MV* m_mvs { nullptr };
-    MV* m_sub_mvs { nullptr };
-    IntraMode* m_sub_modes { nullptr };
+    u32 m_ref_frame_width[NUM_REF_FRAMES];
+    u32 m_ref_frame_height[NUM_REF_FRAMES];
 
     OwnPtr<BitStream> m_bit_stream;
     OwnPtr<ProbabilityTables> m_probability_tables;
     OwnPtr<SyntaxElementCounter> m_syntax_element_counter;
-    NonnullOwnPtr<TreeParser> m_tree_parser;
+    NonnullOwnPtrVector<TileContext> m_tile_contexts;
+    // Tile columns are decoded in parallel, and the pool is only started once a frame with multiple of them shows up.
+    OwnPtr<Threading::ThreadPool> m_thread_pool;
     Decoder& m_decoder;
 };
 
@@ -1172,7 +1172,7 @@ KfUVModeProbs const& ProbabilityTables::kf_uv_mode_prob() const
 
 void ProbabilityTables::save_probs(size_t index)
 {
-    m_saved_probability_tables.insert(index, m_current_probability_table);
+    m_saved_probability_tables[index] = m_current_probability_table;
 }
 
 void ProbabilityTables::reset_probs()
@@ -1202,17 +1202,7 @@ void ProbabilityTables::reset_probs()
 
 void ProbabilityTables::load_probs(size_t index)
 {
-    auto old_table = m_current_probability_table;
-    m_current_probability_table = m_saved_probability_tables.at(index);
-    __builtin_memcpy(m_current_probability_table.skip_prob, old_table.skip_prob, sizeof(SkipProb));
-    __builtin_memcpy(m_current_probability_table.tx_probs, old_table.tx_probs, sizeof(TxProbs));
-}
-
-void ProbabilityTables::load_probs2(size_t index)
-{
-    auto new_table = m_saved_probability_tables.at(index);
-    __builtin_memcpy(m_current_probability_table.skip_prob, new_table.skip_prob, sizeof(SkipProb));
-    __builtin_memcpy(m_current_probability_table.tx_probs, new_table.tx_probs, sizeof(TxProbs));
+    m_current_probability_table = m_saved_probability_tables[index];
 }
 
 }
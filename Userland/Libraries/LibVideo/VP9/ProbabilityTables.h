@@ -8,7 +8,6 @@
 
 #include "Symbols.h"
 #include <AK/Types.h>
-#include <AK/Vector.h>
 
 namespace Video::VP9 {
 
@@ -40,10 +39,37 @@ typedef u8 CoefProbs[TX_SIZES][BLOCK_TYPES][REF_TYPES][COEF_BANDS][PREV_COEF_CON
 
 class ProbabilityTables final {
 public:
+    struct ProbabilityTable {
+        PartitionProbs partition_probs;
+        YModeProbs y_mode_probs;
+        UVModeProbs uv_mode_probs;
+        SkipProb skip_prob;
+        IsInterProb is_inter_prob;
+        CompModeProb comp_mode_prob;
+        CompRefProb comp_ref_prob;
+        SingleRefProb single_ref_prob;
+        MvSignProb mv_sign_prob;
+        MvBitsProb mv_bits_prob;
+        MvClass0BitProb mv_class0_bit_prob;
+        TxProbs tx_probs;
+        InterModeProbs inter_mode_probs;
+        InterpFilterProbs interp_filter_probs;
+        MvJointProbs mv_joint_probs;
+        MvClassProbs mv_class_probs;
+        MvClass0FrProbs mv_class0_fr_probs;
+        MvClass0HpProbs mv_class0_hp_prob;
+        MvFrProbs mv_fr_probs;
+        MvHpProb mv_hp_prob;
+        CoefProbs coef_probs;
+    };
+
     void save_probs(size_t index);
     void reset_probs();
     void load_probs(size_t index);
-    void load_probs2(size_t index);
+
+    // The probabilities of a saved frame context, which are the starting point when adapting the probabilities
+    // to what was decoded in a frame.
+    ProbabilityTable const& saved_probs(size_t index) const { return m_saved_probability_tables[index]; }
 
     ParetoTable const& pareto_table() const;
     KfPartitionProbs const& kf_partition_probs() const;
@@ -73,31 +99,7 @@ public:
     CoefProbs& coef_probs() { return m_current_probability_table.coef_probs; };
 
 private:
-    struct ProbabilityTable {
-        PartitionProbs partition_probs;
-        YModeProbs y_mode_probs;
-        UVModeProbs uv_mode_probs;
-        SkipProb skip_prob;
-        IsInterProb is_inter_prob;
-        CompModeProb comp_mode_prob;
-        CompRefProb comp_ref_prob;
-        SingleRefProb single_ref_prob;
-        MvSignProb mv_sign_prob;
-        MvBitsProb mv_bits_prob;
-        MvClass0BitProb mv_class0_bit_prob;
-        TxProbs tx_probs;
-        InterModeProbs inter_mode_probs;
-        InterpFilterProbs interp_filter_probs;
-        MvJointProbs mv_joint_probs;
-        MvClassProbs mv_class_probs;
-        MvClass0FrProbs mv_class0_fr_probs;
-        MvClass0HpProbs mv_class0_hp_prob;
-        MvFrProbs mv_fr_probs;
-        MvHpProb mv_hp_prob;
-        CoefProbs coef_probs;
-    };
-
-    Vector<ProbabilityTable, 4> m_saved_probability_tables;
+    ProbabilityTable m_saved_probability_tables[4];
     ProbabilityTable m_current_probability_table;
 };
 
@@ -61,7 +61,7 @@ namespace Video::VP9 {
 #define REF_SCALE_SHIFT 14
 #define SUBPEL_BITS 4
 #define SUBPEL_SHIFTS 16
-#define SUBPEL_MASH 15
+#define SUBPEL_MASK 15
 #define MV_BORDER 128
 #define INTERP_EXTEND 4
 #define BORDERINPIXELS 160
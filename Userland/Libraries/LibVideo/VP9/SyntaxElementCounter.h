@@ -38,8 +38,6 @@ enum class SyntaxElementType {
     MVClass0HP,
     MVFR,
     MVHP,
-    Token,
-    MoreCoefs,
 };
 
 class SyntaxElementCounter final {
@@ -47,28 +45,33 @@ public:
     /* (8.3) Clear Counts Process */
     void clear_counts();
 
-    u8 m_counts_intra_mode[BLOCK_SIZE_GROUPS][INTRA_MODES];
-    u8 m_counts_uv_mode[INTRA_MODES][INTRA_MODES];
-    u8 m_counts_partition[PARTITION_CONTEXTS][PARTITION_TYPES];
-    u8 m_counts_interp_filter[INTERP_FILTER_CONTEXTS][SWITCHABLE_FILTERS];
-    u8 m_counts_inter_mode[INTER_MODE_CONTEXTS][INTER_MODES];
-    u8 m_counts_tx_size[TX_SIZES][TX_SIZE_CONTEXTS][TX_SIZES];
-    u8 m_counts_is_inter[IS_INTER_CONTEXTS][2];
-    u8 m_counts_comp_mode[COMP_MODE_CONTEXTS][2];
-    u8 m_counts_single_ref[REF_CONTEXTS][2][2];
-    u8 m_counts_comp_ref[REF_CONTEXTS][2];
-    u8 m_counts_skip[SKIP_CONTEXTS][2];
-    u8 m_counts_mv_joint[MV_JOINTS];
-    u8 m_counts_mv_sign[2][2];
-    u8 m_counts_mv_class[2][MV_CLASSES];
-    u8 m_counts_mv_class0_bit[2][CLASS0_SIZE];
-    u8 m_counts_mv_class0_fr[2][CLASS0_SIZE][MV_FR_SIZE];
-    u8 m_counts_mv_class0_hp[2][2];
-    u8 m_counts_mv_bits[2][MV_OFFSET_BITS][2];
-    u8 m_counts_mv_fr[2][MV_FR_SIZE];
-    u8 m_counts_mv_hp[2][2];
-    u8 m_counts_token[TX_SIZES][BLOCK_TYPES][REF_TYPES][COEF_BANDS][PREV_COEF_CONTEXTS][UNCONSTRAINED_NODES];
-    u8 m_counts_more_coefs[TX_SIZES][BLOCK_TYPES][REF_TYPES][COEF_BANDS][PREV_COEF_CONTEXTS][2];
+    // Tiles are parsed with counters of their own, which are summed up once the whole frame has been parsed.
+    SyntaxElementCounter& operator+=(SyntaxElementCounter const& other);
+
+    u32 m_counts_intra_mode[BLOCK_SIZE_GROUPS][INTRA_MODES];
+    u32 m_counts_uv_mode[INTRA_MODES][INTRA_MODES];
+    u32 m_counts_partition[PARTITION_CONTEXTS][PARTITION_TYPES];
+    u32 m_counts_interp_filter[INTERP_FILTER_CONTEXTS][SWITCHABLE_FILTERS];
+    u32 m_counts_inter_mode[INTER_MODE_CONTEXTS][INTER_MODES];
+    u32 m_counts_tx_size[TX_SIZES][TX_SIZE_CONTEXTS][TX_SIZES];
+    u32 m_counts_is_inter[IS_INTER_CONTEXTS][2];
+    u32 m_counts_comp_mode[COMP_MODE_CONTEXTS][2];
+    u32 m_counts_single_ref[REF_CONTEXTS][2][2];
+    u32 m_counts_comp_ref[REF_CONTEXTS][2];
+    u32 m_counts_skip[SKIP_CONTEXTS][2];
+    u32 m_counts_mv_joint[MV_JOINTS];
+    u32 m_counts_mv_sign[2][2];
+    u32 m_counts_mv_class[2][MV_CLASSES];
+    u32 m_counts_mv_class0_bit[2][CLASS0_SIZE];
+    u32 m_counts_mv_class0_fr[2][CLASS0_SIZE][MV_FR_SIZE];
+    u32 m_counts_mv_class0_hp[2][2];
+    u32 m_counts_mv_bits[2][MV_OFFSET_BITS][2];
+    u32 m_counts_mv_fr[2][MV_FR_SIZE];
+    u32 m_counts_mv_hp[2][2];
+    // NOTE: The tokens are counted as zero, one, two or more, and the end of the block. The number of times that
+    //       the end of block could have been signaled is counted separately.
+    u32 m_counts_token[TX_SIZES][BLOCK_TYPES][REF_TYPES][COEF_BANDS][PREV_COEF_CONTEXTS][UNCONSTRAINED_NODES + 1];
+    u32 m_counts_more_coefs[TX_SIZES][BLOCK_TYPES][REF_TYPES][COEF_BANDS][PREV_COEF_CONTEXTS];
 };
 
 }
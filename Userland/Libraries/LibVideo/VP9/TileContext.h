@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "BitStream.h"
+#include "Enums.h"
+#include "MV.h"
+#include "SyntaxElementCounter.h"
+#include "TreeParser.h"
+#include <AK/OwnPtr.h>
+#include <AK/Types.h>
+
+namespace Video::VP9 {
+
+class Parser;
+
+// Everything that is needed to decode the blocks of one tile. The tiles of a tile row don't depend on each other,
+// so each one gets a context of its own and they can be decoded in parallel, only sharing the frame-wide state
+// that is held by the Parser.
+struct TileContext {
+    TileContext(Parser& parser)
+        : tree_parser(parser, *this)
+    {
+    }
+
+    OwnPtr<BitStream> bit_stream;
+    SyntaxElementCounter counter;
+    TreeParser tree_parser;
+
+    u32 mi_row_start { 0 };
+    u32 mi_row_end { 0 };
+    u32 mi_col_start { 0 };
+    u32 mi_col_end { 0 };
+
+    // The left contexts, indexed by the position within the current superblock.
+    u8 left_nonzero_context[3][16];
+    u8 left_seg_pred_context[8];
+    u8 left_partition_context[8];
+
+    /* Partition state */
+    BlockSubsize block_subsize { Block_64x64 };
+    u8 num_8x8 { 0 };
+    bool has_rows { false };
+    bool has_cols { false };
+    u32 row { 0 };
+    u32 col { 0 };
+
+    /* Block state */
+    u32 mi_row { 0 };
+    u32 mi_col { 0 };
+    BlockSubsize mi_size { Block_4x4 };
+    bool available_u { false };
+    bool available_l { false };
+    u8 segment_id { 0 };
+    bool skip { false };
+    TXSize max_tx_size { TX_4x4 };
+    TXSize tx_size { TX_4x4 };
+    ReferenceFrame ref_frame[2];
+    bool is_inter { false };
+    u8 y_mode { 0 };
+    u8 block_sub_modes[4];
+    u8 uv_mode { 0 };
+    ReferenceFrame left_ref_frame[2];
+    ReferenceFrame above_ref_frame[2];
+    bool left_intra { false };
+    bool above_intra { false };
+    bool left_single { false };
+    bool above_single { false };
+    InterpolationFilter interp_filter { EightTap };
+    MV mv[2];
+    MV near_mv[2];
+    MV nearest_mv[2];
+    MV best_mv[2];
+    MV block_mvs[2][4];
+    // The motion vector candidates found by find_mv_refs().
+    MV ref_list_mv[2];
+    u8 ref_mv_count { 0 };
+    u8 mode_context[4];
+    bool use_hp { false };
+    u32 eob_total { 0 };
+
+    /* Transform block state */
+    u8 tx_type { DCT_DCT };
+    u32 last_nonzero_row { 0 };
+    u8 token_cache[1024];
+    // NOTE: The coefficients are kept zeroed between transform blocks, so only the ones that were read need clearing.
+    alignas(16) i32 coefficients[1024] {};
+};
+
+}
@@ -14,11 +14,13 @@
 namespace Video::VP9 {
 
 class Parser;
+struct TileContext;
 
 class TreeParser {
 public:
-    explicit TreeParser(Parser& decoder)
-        : m_decoder(decoder)
+    TreeParser(Parser& parser, TileContext& tile)
+        : m_parser(parser)
+        , m_tile(tile)
     {
     }
 
@@ -57,19 +59,11 @@ public:
         m_idy = idy;
     }
 
-    void set_tokens_variables(u8 band, u32 c, u32 plane, TXSize tx_size, u32 pos)
+    void set_mv_component_variables(u8 component, u8 class0_bit, u8 bit_index)
     {
-        m_band = band;
-        m_c = c;
-        m_plane = plane;
-        m_tx_size = tx_size;
-        m_pos = pos;
-    }
-
-    void set_start_x_and_y(u32 start_x, u32 start_y)
-    {
-        m_start_x = start_x;
-        m_start_y = start_y;
+        m_mv_component = component;
+        m_mv_class0_bit = class0_bit;
+        m_mv_bit_index = bit_index;
     }
 
 private:
@@ -90,24 +84,20 @@ private:
     u8 calculate_tx_size_probability(u8 node);
     u8 calculate_inter_mode_probability(u8 node);
     u8 calculate_interp_filter_probability(u8 node);
-    u8 calculate_token_probability(u8 node);
-    u8 calculate_more_coefs_probability();
+    u8 calculate_partition_context();
 
-    Parser& m_decoder;
+    Parser& m_parser;
+    TileContext& m_tile;
     // m_ctx is a member variable because it is required for syntax element counting (section 9.3.4)
     u8 m_ctx { 0 };
 
     // These are variables necessary for parsing tree data, but aren't useful otherwise, so they're
-    // not stored in the Decoder itself.
+    // not stored in the tile context itself.
     u8 m_idx { 0 };
     u8 m_idy { 0 };
-    u8 m_band { 0 };
-    u32 m_start_x { 0 };
-    u32 m_start_y { 0 };
-    u32 m_c { 0 };
-    u32 m_plane { 0 };
-    TXSize m_tx_size;
-    u32 m_pos { 0 };
+    u8 m_mv_component { 0 };
+    u8 m_mv_class0_bit { 0 };
+    u8 m_mv_bit_index { 0 };
 };
 
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 
 namespace Video::VP9 {
@@ -18,7 +19,23 @@ namespace Video::VP9 {
         }                           \
     } while (0)
 
-u8 clip_3(u8 x, u8 y, u8 z);
-u8 round_2(u8 x, u8 n);
+template<typename T>
+ALWAYS_INLINE T clip_3(T x, T y, T z)
+{
+    return clamp(z, x, y);
+}
+
+ALWAYS_INLINE u8 clip_1(i32 x)
+{
+    return static_cast<u8>(clamp(x, 0, 255));
+}
+
+template<typename T>
+ALWAYS_INLINE T round_2(T x, u8 n)
+{
+    if (n == 0)
+        return x;
+    return (x + (static_cast<T>(1) << (n - 1))) >> n;
+}
 
 }
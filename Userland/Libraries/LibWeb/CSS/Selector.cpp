@@ -23,6 +23,40 @@ Selector::Selector(Vector<CompoundSelector>&& compound_selectors)
             }
         }
     }
+
+    collect_ancestor_hashes();
+}
+
+void Selector::collect_ancestor_hashes()
+{
+    // A compound selector is matched against an ancestor of the subject whenever it is followed by a descendant or child
+    // combinator, as everything it chains up to is either an ancestor of the subject, or a sibling of one.
+    if (m_compound_selectors.is_empty())
+        return;
+
+    size_t next_hash_index = 0;
+    for (size_t i = m_compound_selectors.size() - 1; i > 0 && next_hash_index < max_ancestor_hashes; --i) {
+        auto combinator = m_compound_selectors[i].combinator;
+        if (combinator == Combinator::Column)
+            return;
+        if (combinator != Combinator::Descendant && combinator != Combinator::ImmediateChild)
+            continue;
+
+        for (auto const& simple_selector : m_compound_selectors[i - 1].simple_selectors) {
+            if (next_hash_index == max_ancestor_hashes)
+                return;
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::TagName:
+            case SimpleSelector::Type::Id:
+            case SimpleSelector::Type::Class:
+                if (auto hash = ancestor_filter_hash(simple_selector.type, simple_selector.name()); hash != 0)
+                    m_ancestor_hashes[next_hash_index++] = hash;
+                break;
+            default:
+                break;
+            }
+        }
+    }
 }
 
 // https://www.w3.org/TR/selectors-4/#specificity-rules
@@ -7,9 +7,11 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/FlyString.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/RefCounted.h>
+#include <AK/StringHash.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 
@@ -151,15 +153,29 @@ public:
 
     Vector<CompoundSelector> const& compound_selectors() const { return m_compound_selectors; }
     Optional<PseudoElement> pseudo_element() const { return m_pseudo_element; }
+
+    // Hashes of tag names, ids and classes that some ancestor of a matching element must have, for quick rejection
+    // with an ancestor filter. Only the first few are kept, and unused slots are zero.
+    static constexpr size_t max_ancestor_hashes = 8;
+    Array<u32, max_ancestor_hashes> const& ancestor_hashes() const { return m_ancestor_hashes; }
+
+    // Case-insensitive, which keeps it correct for quirks mode and HTML tag names at the cost of a few false positives.
+    static u32 ancestor_filter_hash(SimpleSelector::Type type, StringView name)
+    {
+        return AK::case_insensitive_string_hash(name.characters_without_null_termination(), name.length(), to_underlying(type));
+    }
     u32 specificity() const;
     String serialize() const;
 
 private:
     explicit Selector(Vector<CompoundSelector>&&);
 
+    void collect_ancestor_hashes();
+
     Vector<CompoundSelector> m_compound_selectors;
     mutable Optional<u32> m_specificity;
     Optional<Selector::PseudoElement> m_pseudo_element;
+    Array<u32, max_ancestor_hashes> m_ancestor_hashes {};
 };
 
 constexpr StringView pseudo_element_name(Selector::PseudoElement pseudo_element)
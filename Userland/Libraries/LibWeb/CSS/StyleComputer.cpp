@@ -26,6 +26,7 @@
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/FontCache.h>
 #include <LibWeb/HTML/HTMLHtmlElement.h>
+#include <LibWeb/HTML/HTMLInputElement.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <stdio.h>
 
@@ -145,6 +146,47 @@ void StyleComputer::for_each_stylesheet(CascadeOrigin cascade_origin, Callback c
     }
 }
 
+template<typename Callback>
+static void for_each_ancestor_filter_hash(DOM::Element const& element, Callback callback)
+{
+    callback(Selector::ancestor_filter_hash(Selector::SimpleSelector::Type::TagName, element.local_name()));
+    if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_empty())
+        callback(Selector::ancestor_filter_hash(Selector::SimpleSelector::Type::Id, id));
+    for (auto const& class_name : element.class_names())
+        callback(Selector::ancestor_filter_hash(Selector::SimpleSelector::Type::Class, class_name));
+}
+
+void StyleComputer::push_ancestor(DOM::Element const& element)
+{
+    m_ancestor_filter_elements.append(&element);
+    for_each_ancestor_filter_hash(element, [&](u32 hash) {
+        m_ancestor_filter.increment(hash);
+    });
+}
+
+void StyleComputer::pop_ancestor(DOM::Element const& element)
+{
+    VERIFY(m_ancestor_filter_elements.take_last() == &element);
+    for_each_ancestor_filter_hash(element, [&](u32 hash) {
+        m_ancestor_filter.decrement(hash);
+    });
+}
+
+bool StyleComputer::should_reject_with_ancestor_filter(DOM::Element const& element, Selector const& selector) const
+{
+    // The filter only describes the ancestors of the element if we're in the middle of styling its parent's children.
+    if (m_ancestor_filter_elements.is_empty() || m_ancestor_filter_elements.last() != element.parent_element())
+        return false;
+
+    for (auto hash : selector.ancestor_hashes()) {
+        if (hash == 0)
+            break;
+        if (!m_ancestor_filter.may_contain(hash))
+            return true;
+    }
+    return false;
+}
+
 Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& element, CascadeOrigin cascade_origin, Optional<CSS::Selector::PseudoElement> pseudo_element) const
 {
     if (cascade_origin == CascadeOrigin::Author) {
@@ -170,6 +212,8 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
         matching_rules.ensure_capacity(rules_to_run.size());
         for (auto const& rule_to_run : rules_to_run) {
             auto const& selector = rule_to_run.rule->selectors()[rule_to_run.selector_index];
+            if (should_reject_with_ancestor_filter(element, selector))
+                continue;
             if (SelectorEngine::matches(selector, element, pseudo_element))
                 matching_rules.append(rule_to_run);
         }
@@ -183,7 +227,7 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
         static_cast<CSSStyleSheet const&>(sheet).for_each_effective_style_rule([&](auto const& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element, pseudo_element)) {
+                if (!should_reject_with_ancestor_filter(element, selector) && SelectorEngine::matches(selector, element, pseudo_element)) {
                     matching_rules.append({ rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
                     break;
                 }
@@ -1264,6 +1308,8 @@ void StyleComputer::build_rule_cache()
                 if (!added_to_bucket)
                     m_rule_cache->other_rules.append(move(matching_rule));
 
+                collect_invalidation_data(*m_rule_cache, selector, StyleInvalidationScope::Element);
+
                 ++selector_index;
             }
             ++rule_index;
@@ -1271,6 +1317,13 @@ void StyleComputer::build_rule_cache()
         ++style_sheet_index;
     });
 
+    for_each_stylesheet(CascadeOrigin::UserAgent, [&](auto& sheet) {
+        static_cast<CSSStyleSheet const&>(sheet).for_each_effective_style_rule([&](auto const& rule) {
+            for (CSS::Selector const& selector : rule.selectors())
+                collect_invalidation_data(*m_rule_cache, selector, StyleInvalidationScope::Element);
+        });
+    });
+
     if constexpr (LIBWEB_CSS_DEBUG) {
         dbgln("Built rule cache!");
         dbgln("           ID: {}", num_id_rules);
@@ -1287,6 +1340,194 @@ void StyleComputer::invalidate_rule_cache()
     m_rule_cache = nullptr;
 }
 
+void StyleComputer::collect_invalidation_data(RuleCache& rule_cache, Selector const& selector, StyleInvalidationScope enclosing_scope)
+{
+    auto const& compound_selectors = selector.compound_selectors();
+    bool has_sibling_combinator = any_of(compound_selectors, [](auto const& compound_selector) {
+        return compound_selector.combinator == Selector::Combinator::NextSibling || compound_selector.combinator == Selector::Combinator::SubsequentSibling;
+    });
+    if (has_sibling_combinator)
+        rule_cache.has_structural_selectors = true;
+
+    for (size_t i = 0; i < compound_selectors.size(); ++i) {
+        // Something tested in the rightmost compound selector only affects the element being matched. Anything to the left
+        // of it is tested on one of its ancestors or preceding siblings, so changing it there affects their descendants or siblings.
+        auto scope = StyleInvalidationScope::Element;
+        if (i != compound_selectors.size() - 1)
+            scope = has_sibling_combinator ? StyleInvalidationScope::SubtreeAndSiblings : StyleInvalidationScope::Subtree;
+        scope = max(scope, enclosing_scope);
+
+        auto widen_scope = [](auto& scopes, FlyString const& key, StyleInvalidationScope scope) {
+            auto& existing_scope = scopes.ensure(key.to_lowercase(), [] { return StyleInvalidationScope::None; });
+            existing_scope = max(existing_scope, scope);
+        };
+
+        for (auto const& simple_selector : compound_selectors[i].simple_selectors) {
+            switch (simple_selector.type) {
+            case Selector::SimpleSelector::Type::Id:
+                widen_scope(rule_cache.invalidation_scope_by_id, simple_selector.name(), scope);
+                break;
+            case Selector::SimpleSelector::Type::Class:
+                widen_scope(rule_cache.invalidation_scope_by_class, simple_selector.name(), scope);
+                break;
+            case Selector::SimpleSelector::Type::Attribute:
+                widen_scope(rule_cache.invalidation_scope_by_attribute, simple_selector.attribute().name, scope);
+                break;
+            case Selector::SimpleSelector::Type::PseudoClass: {
+                auto const& pseudo_class = simple_selector.pseudo_class();
+                switch (pseudo_class.type) {
+                case Selector::SimpleSelector::PseudoClass::Type::Is:
+                case Selector::SimpleSelector::PseudoClass::Type::Not:
+                case Selector::SimpleSelector::PseudoClass::Type::Where:
+                    for (auto const& argument_selector : pseudo_class.argument_selector_list)
+                        collect_invalidation_data(rule_cache, argument_selector, scope);
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Link:
+                case Selector::SimpleSelector::PseudoClass::Type::Visited:
+                case Selector::SimpleSelector::PseudoClass::Type::Disabled:
+                case Selector::SimpleSelector::PseudoClass::Type::Enabled:
+                case Selector::SimpleSelector::PseudoClass::Type::Checked:
+                    rule_cache.invalidation_scope_for_any_attribute = max(rule_cache.invalidation_scope_for_any_attribute, scope);
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Lang:
+                    // The language is inherited from the closest ancestor with a lang attribute.
+                    widen_scope(rule_cache.invalidation_scope_by_attribute, HTML::AttributeNames::lang, max(scope, StyleInvalidationScope::Subtree));
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::FirstChild:
+                case Selector::SimpleSelector::PseudoClass::Type::LastChild:
+                case Selector::SimpleSelector::PseudoClass::Type::OnlyChild:
+                case Selector::SimpleSelector::PseudoClass::Type::NthChild:
+                case Selector::SimpleSelector::PseudoClass::Type::NthLastChild:
+                case Selector::SimpleSelector::PseudoClass::Type::Empty:
+                case Selector::SimpleSelector::PseudoClass::Type::FirstOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::LastOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::OnlyOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::NthOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::NthLastOfType:
+                    rule_cache.has_structural_selectors = true;
+                    break;
+                default:
+                    break;
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+}
+
+StyleComputer::StyleInvalidationScope StyleComputer::invalidation_scope_for_attribute_change(FlyString const& attribute_name, String const& old_value, String const& new_value) const
+{
+    build_rule_cache_if_needed();
+
+    auto scope = StyleInvalidationScope::None;
+    auto widen_scope = [&](auto const& scopes, StringView key) {
+        if (auto it = scopes.find(key.to_lowercase_string()); it != scopes.end())
+            scope = max(scope, it->value);
+    };
+
+    auto name = attribute_name.to_lowercase();
+    if (name == HTML::AttributeNames::class_) {
+        // Only the class names that were added or removed matter.
+        auto old_class_names = old_value.split_view(is_ascii_space);
+        auto new_class_names = new_value.split_view(is_ascii_space);
+        for (auto const& class_name : old_class_names) {
+            if (!new_class_names.contains_slow(class_name))
+                widen_scope(m_rule_cache->invalidation_scope_by_class, class_name);
+        }
+        for (auto const& class_name : new_class_names) {
+            if (!old_class_names.contains_slow(class_name))
+                widen_scope(m_rule_cache->invalidation_scope_by_class, class_name);
+        }
+    } else if (name == HTML::AttributeNames::id) {
+        if (!old_value.is_empty())
+            widen_scope(m_rule_cache->invalidation_scope_by_id, old_value);
+        if (!new_value.is_empty())
+            widen_scope(m_rule_cache->invalidation_scope_by_id, new_value);
+    } else {
+        // Any other attribute may be mapped to style properties of the element itself by presentational hints.
+        scope = max(StyleInvalidationScope::Element, m_rule_cache->invalidation_scope_for_any_attribute);
+    }
+    widen_scope(m_rule_cache->invalidation_scope_by_attribute, name);
+
+    return scope;
+}
+
+// Whether the element may match any pseudo-classes that depend on more than its attributes and position in the tree.
+static bool may_match_state_dependent_pseudo_classes(DOM::Element const& element)
+{
+    if (element.is_focused() || element.is_active() || is<HTML::HTMLInputElement>(element))
+        return true;
+    if (auto const* hovered_node = element.document().hovered_node(); hovered_node && element.is_inclusive_ancestor_of(*hovered_node))
+        return true;
+    if (auto const* focused_element = element.document().focused_element(); focused_element && element.is_inclusive_ancestor_of(*focused_element))
+        return true;
+    return false;
+}
+
+static bool can_share_style(DOM::Element const& element, DOM::Element const& candidate)
+{
+    if (!candidate.computed_css_values() || candidate.needs_style_update())
+        return false;
+    if (element.local_name() != candidate.local_name() || element.namespace_() != candidate.namespace_())
+        return false;
+    if (element.inline_style() || candidate.inline_style())
+        return false;
+    if (element.shadow_root() || candidate.shadow_root())
+        return false;
+
+    // Identical attributes take care of the class names, the id, attribute selectors and presentational hints all at once.
+    if (element.attribute_list_size() != candidate.attribute_list_size())
+        return false;
+    bool attributes_match = true;
+    element.for_each_attribute([&](auto const& name, auto const& value) {
+        if (attributes_match && candidate.attribute(name) != value)
+            attributes_match = false;
+    });
+    if (!attributes_match)
+        return false;
+
+    return !may_match_state_dependent_pseudo_classes(candidate);
+}
+
+DOM::Element const* StyleComputer::find_element_to_share_style_with(DOM::Element const& element) const
+{
+    // Looking at a handful of nearby elements finds most of the matches in practice, while keeping misses cheap.
+    static constexpr size_t max_candidates = 8;
+
+    build_rule_cache_if_needed();
+    if (m_rule_cache->has_structural_selectors)
+        return nullptr;
+
+    auto const* parent = element.parent_element();
+    if (!parent || !parent->computed_css_values())
+        return nullptr;
+    if (may_match_state_dependent_pseudo_classes(element))
+        return nullptr;
+
+    size_t candidate_count = 0;
+
+    // Siblings share the parent style by definition.
+    for (auto const* sibling = element.previous_element_sibling(); sibling && candidate_count < max_candidates; sibling = sibling->previous_element_sibling(), ++candidate_count) {
+        if (can_share_style(element, *sibling))
+            return sibling;
+    }
+
+    // Cousins do if their parents share a style themselves.
+    for (auto const* parent_sibling = parent->previous_element_sibling(); parent_sibling && candidate_count < max_candidates; parent_sibling = parent_sibling->previous_element_sibling()) {
+        if (parent_sibling->computed_css_values() != parent->computed_css_values())
+            continue;
+        for (auto const* cousin = parent_sibling->last_child_of_type<DOM::Element>(); cousin && candidate_count < max_candidates; cousin = cousin->previous_element_sibling(), ++candidate_count) {
+            if (can_share_style(element, *cousin))
+                return cousin;
+        }
+    }
+
+    return nullptr;
+}
+
 Gfx::IntRect StyleComputer::viewport_rect() const
 {
     if (auto const* browsing_context = document().browsing_context())
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/CountingBloomFilter.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
@@ -70,6 +71,23 @@ public:
 
     void invalidate_rule_cache();
 
+    // How far the effects of changing an attribute (or the classes or id) of an element may reach.
+    enum class StyleInvalidationScope {
+        None,
+        Element,
+        Subtree,
+        SubtreeAndSiblings,
+    };
+    StyleInvalidationScope invalidation_scope_for_attribute_change(FlyString const& attribute_name, String const& old_value, String const& new_value) const;
+
+    // The ancestors of the elements being styled are kept in a Bloom filter during a style update,
+    // so that selectors requiring an ancestor that isn't there can be rejected without walking up the tree.
+    void push_ancestor(DOM::Element const&);
+    void pop_ancestor(DOM::Element const&);
+
+    // Returns an element whose computed style is guaranteed to be the same as the given element's, if one is close by.
+    DOM::Element const* find_element_to_share_style_with(DOM::Element const&) const;
+
     Gfx::Font const& initial_font() const;
 
     void did_load_font(FlyString const& family_name);
@@ -99,12 +117,9 @@ private:
         Vector<MatchingRule> author_rules;
     };
 
-    void cascade_declarations(StyleProperties&, DOM::Element&, Vector<MatchingRule> const&, CascadeOrigin, Important important) const;
+    bool should_reject_with_ancestor_filter(DOM::Element const&, Selector const&) const;
 
-    void build_rule_cache();
-    void build_rule_cache_if_needed() const;
-
-    DOM::Document& m_document;
+    void cascade_declarations(StyleProperties&, DOM::Element&, Vector<MatchingRule> const&, CascadeOrigin, Important important) const;
 
     struct RuleCache {
         HashMap<FlyString, Vector<MatchingRule>> rules_by_id;
@@ -112,9 +127,29 @@ private:
         HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
         HashMap<Selector::PseudoElement, Vector<MatchingRule>> rules_by_pseudo_element;
         Vector<MatchingRule> other_rules;
+
+        // What may need a style update when a class name, id or attribute changes, based on where the selectors
+        // of all origins test for it. The keys are lowercase, since some of these match case-insensitively.
+        HashMap<FlyString, StyleInvalidationScope> invalidation_scope_by_class;
+        HashMap<FlyString, StyleInvalidationScope> invalidation_scope_by_id;
+        HashMap<FlyString, StyleInvalidationScope> invalidation_scope_by_attribute;
+        // Pseudo-classes like :link or :checked may depend on any attribute.
+        StyleInvalidationScope invalidation_scope_for_any_attribute { StyleInvalidationScope::None };
+        // Whether any selector depends on where an element is among its siblings, or on its children.
+        bool has_structural_selectors { false };
     };
+
+    void build_rule_cache();
+    void build_rule_cache_if_needed() const;
+    static void collect_invalidation_data(RuleCache&, Selector const&, StyleInvalidationScope enclosing_scope);
+
+    DOM::Document& m_document;
+
     OwnPtr<RuleCache> m_rule_cache;
 
+    CountingBloomFilter<u8, 14> m_ancestor_filter;
+    Vector<DOM::Element const*> m_ancestor_filter_elements;
+
     class FontLoader;
     HashMap<String, NonnullOwnPtr<FontLoader>> m_loaded_fonts;
 };
@@ -12,9 +12,11 @@
 #include <LibWeb/CSS/StyleValue.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/HTML/BrowsingContext.h>
+#include <LibWeb/Layout/Box.h>
 #include <LibWeb/Loader/LoadRequest.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/Painting/PaintableBox.h>
 
 namespace Web::CSS {
 
@@ -1239,7 +1241,7 @@ ImageStyleValue::ImageStyleValue(AK::URL const& url)
 
 void ImageStyleValue::load_bitmap(DOM::Document& document)
 {
-    if (m_bitmap)
+    if (resource())
         return;
 
     m_document = &document;
@@ -1249,14 +1251,44 @@ void ImageStyleValue::load_bitmap(DOM::Document& document)
 
 void ImageStyleValue::resource_did_load()
 {
-    if (!m_document)
-        return;
-    m_bitmap = resource()->bitmap();
     // FIXME: Do less than a full repaint if possible?
     if (m_document && m_document->browsing_context())
         m_document->browsing_context()->set_needs_display({});
 }
 
+Gfx::Bitmap const* ImageStyleValue::bitmap() const
+{
+    // NOTE: The bitmap isn't kept around here, so that the resource can discard it when the image is out of view.
+    //       Asking for it again decodes it again.
+    if (!resource())
+        return nullptr;
+    return resource()->bitmap();
+}
+
+void ImageStyleValue::register_layout_node(Badge<Layout::NodeWithStyle>, Layout::NodeWithStyle const& layout_node) const
+{
+    m_layout_nodes.set(&layout_node);
+}
+
+void ImageStyleValue::unregister_layout_node(Badge<Layout::NodeWithStyle>, Layout::NodeWithStyle const& layout_node) const
+{
+    m_layout_nodes.remove(&layout_node);
+}
+
+bool ImageStyleValue::is_visible_in_viewport() const
+{
+    for (auto const* layout_node : m_layout_nodes) {
+        // FIXME: Inline nodes paint their background in each of their fragments, so just assume they're visible.
+        if (!is<Layout::Box>(*layout_node))
+            return true;
+        auto const* browsing_context = layout_node->document().browsing_context();
+        auto const* paint_box = static_cast<Layout::Box const&>(*layout_node).paint_box();
+        if (browsing_context && paint_box && browsing_context->viewport_rect().to_type<float>().intersects(paint_box->absolute_border_box_rect()))
+            return true;
+    }
+    return false;
+}
+
 String ImageStyleValue::to_string() const
 {
     return serialize_a_url(m_url.to_string());
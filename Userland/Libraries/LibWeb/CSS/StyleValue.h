@@ -9,6 +9,7 @@
 #pragma once
 
 #include <AK/Function.h>
+#include <AK/HashTable.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/NonnullRefPtrVector.h>
@@ -919,7 +920,15 @@ public:
     virtual String to_string() const override;
 
     void load_bitmap(DOM::Document& document);
-    Gfx::Bitmap const* bitmap() const { return m_bitmap; }
+    Gfx::Bitmap const* bitmap() const;
+
+    // Layout nodes that paint this image (as a background or list marker) register themselves, so that it can tell
+    // whether it's visible in the viewport.
+    void register_layout_node(Badge<Layout::NodeWithStyle>, Layout::NodeWithStyle const&) const;
+    void unregister_layout_node(Badge<Layout::NodeWithStyle>, Layout::NodeWithStyle const&) const;
+
+    // ^ImageResourceClient
+    virtual bool is_visible_in_viewport() const override;
 
 private:
     ImageStyleValue(AK::URL const&);
@@ -929,7 +938,7 @@ private:
 
     AK::URL m_url;
     WeakPtr<DOM::Document> m_document;
-    RefPtr<Gfx::Bitmap> m_bitmap;
+    mutable HashTable<Layout::NodeWithStyle const*> m_layout_nodes;
 };
 
 class InheritStyleValue final : public StyleValue {
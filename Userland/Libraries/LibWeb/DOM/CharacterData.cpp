@@ -7,6 +7,7 @@
 #include <LibWeb/DOM/CharacterData.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Range.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -24,7 +25,10 @@ void CharacterData::set_data(String data)
     if (parent())
         parent()->children_changed();
     set_needs_style_update(true);
-    document().set_needs_layout();
+    if (auto* layout_node = this->layout_node())
+        layout_node->set_needs_layout();
+    else
+        document().set_needs_layout();
 }
 
 // https://dom.spec.whatwg.org/#concept-cd-substring
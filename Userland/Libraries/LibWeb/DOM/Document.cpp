@@ -59,12 +59,15 @@
 #include <LibWeb/HTML/Scripting/ExceptionReporter.h>
 #include <LibWeb/HTML/Scripting/WindowEnvironmentSettingsObject.h>
 #include <LibWeb/HTML/Window.h>
+#include <LibWeb/Layout/BlockContainer.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Layout/TreeBuilder.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/Origin.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/Painting/BorderPainting.h>
+#include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/SVG/TagNames.h>
 #include <LibWeb/UIEvents/EventNames.h>
 #include <LibWeb/UIEvents/FocusEvent.h>
@@ -488,6 +491,7 @@ void Document::tear_down_layout_tree()
     }
 
     m_layout_root = nullptr;
+    m_previous_layout_state = nullptr;
 }
 
 Color Document::background_color(Gfx::Palette const& palette) const
@@ -549,6 +553,57 @@ void Document::invalidate_layout()
     tear_down_layout_tree();
 }
 
+// The area a box paints into, as far as layout can tell.
+static Gfx::IntRect painted_rect_of(Layout::Box const& box)
+{
+    auto const& paint_box = *box.paint_box();
+    auto border_box_rect = paint_box.absolute_border_box_rect();
+    auto rect = border_box_rect;
+    if (paint_box.has_overflow())
+        rect = rect.united(paint_box.scrollable_overflow_rect().value());
+    // NOTE: The focus outline is painted just outside the border box.
+    rect.inflate(4, 4);
+    for (auto const& shadow : box.computed_values().box_shadow()) {
+        if (shadow.placement == CSS::ShadowPlacement::Inner)
+            continue;
+        auto extent = max(0.0f, 2 * shadow.blur_radius.to_px(box) + shadow.spread_distance.to_px(box));
+        auto shadow_rect = border_box_rect.translated(shadow.offset_x.to_px(box), shadow.offset_y.to_px(box)).inflated(2 * extent, 2 * extent);
+        rect = rect.united(shadow_rect);
+    }
+    return enclosing_int_rect(rect);
+}
+
+// Boxes that were laid out again from scratch, such as text that changed, have to be repainted in full.
+// Other boxes only have to be repainted if they moved or changed size.
+static bool is_relaid_out_in_full(Layout::Box const& box)
+{
+    return box.needs_layout() && (!box.first_child() || box.children_are_inline());
+}
+
+// Whether a box paints the same pixels in the area that it covers both before and after a change in size,
+// so that only the area it stopped or started covering needs to be repainted.
+static bool paints_only_plain_background(Layout::Box const& box)
+{
+    if (!is<Layout::BlockContainer>(box) || box.children_are_inline())
+        return false;
+    auto const& computed_values = box.computed_values();
+    if (!computed_values.box_shadow().is_empty())
+        return false;
+    if (computed_values.border_top().width || computed_values.border_right().width || computed_values.border_bottom().width || computed_values.border_left().width)
+        return false;
+    auto has_image = [](auto const& background_layers) {
+        return any_of(background_layers, [](auto const& layer) { return layer.image; });
+    };
+    if (has_image(computed_values.background_layers()))
+        return false;
+    if (box.is_root_element() && box.document().background_layers() && has_image(*box.document().background_layers()))
+        return false;
+    auto border_radius = Painting::normalized_border_radius_data(box, box.paint_box()->absolute_border_box_rect(),
+        computed_values.border_top_left_radius(), computed_values.border_top_right_radius(),
+        computed_values.border_bottom_right_radius(), computed_values.border_bottom_left_radius());
+    return !border_radius.top_left && !border_radius.top_right && !border_radius.bottom_right && !border_radius.bottom_left;
+}
+
 void Document::update_layout()
 {
     // NOTE: If our parent document needs a relayout, we must do that *first*.
@@ -566,26 +621,84 @@ void Document::update_layout()
 
     auto viewport_rect = browsing_context()->viewport_rect();
 
+    // Remember where everything was painted, so that only the parts of the page that layout changes have to be repainted.
+    // Transforms aren't taken into account by the painted rects, and fixed-position boxes are painted relative
+    // to the viewport, so with either of those around (or without a previous layout), everything is repainted.
+    bool needs_full_repaint = !m_layout_root;
+    HashMap<Layout::Box const*, Gfx::IntRect> painted_rects_before_layout;
+    Vector<Gfx::IntRect> damaged_rects;
+    if (m_layout_root) {
+        m_layout_root->for_each_in_inclusive_subtree_of_type<Layout::Box>([&](auto& box) {
+            if (box.is_fixed_position() || !box.computed_values().transformations().is_empty()) {
+                needs_full_repaint = true;
+                return IterationDecision::Break;
+            }
+            if (!box.paint_box())
+                return IterationDecision::Continue;
+            auto rect = painted_rect_of(box);
+            painted_rects_before_layout.set(&box, rect);
+            if (is_relaid_out_in_full(box))
+                damaged_rects.append(rect);
+            return IterationDecision::Continue;
+        });
+    }
+
     if (!m_layout_root) {
         Layout::TreeBuilder tree_builder;
         m_layout_root = static_ptr_cast<Layout::InitialContainingBlock>(tree_builder.build(*this));
     }
 
-    Layout::FormattingState formatting_state;
-    Layout::BlockFormattingContext root_formatting_context(formatting_state, *m_layout_root, nullptr);
+    auto formatting_state = make<Layout::FormattingState>();
+    formatting_state->previous_layout_state = m_previous_layout_state.ptr();
 
-    auto& icb = static_cast<Layout::InitialContainingBlock&>(*m_layout_root);
-    auto& icb_state = formatting_state.get_mutable(icb);
-    icb_state.content_width = viewport_rect.width();
-    icb_state.content_height = viewport_rect.height();
+    {
+        Layout::BlockFormattingContext root_formatting_context(*formatting_state, *m_layout_root, nullptr);
+
+        auto& icb = static_cast<Layout::InitialContainingBlock&>(*m_layout_root);
+        auto& icb_state = formatting_state->get_mutable(icb);
+        icb_state.content_width = viewport_rect.width();
+        icb_state.content_height = viewport_rect.height();
+
+        icb.set_has_definite_width(true);
+        icb.set_has_definite_height(true);
+
+        root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Normal);
+    }
+    formatting_state->commit();
 
-    icb.set_has_definite_width(true);
-    icb.set_has_definite_height(true);
+    if (!needs_full_repaint) {
+        m_layout_root->for_each_in_inclusive_subtree_of_type<Layout::Box>([&](auto& box) {
+            if (!box.paint_box())
+                return IterationDecision::Continue;
+            auto rect = painted_rect_of(box);
+            auto previous_rect = painted_rects_before_layout.get(&box);
+            if (!previous_rect.has_value() || is_relaid_out_in_full(box)) {
+                damaged_rects.append(rect);
+            } else if (*previous_rect != rect) {
+                if (paints_only_plain_background(box)) {
+                    for (auto const& shard : previous_rect->shatter(rect))
+                        damaged_rects.append(shard);
+                    for (auto const& shard : rect.shatter(*previous_rect))
+                        damaged_rects.append(shard);
+                } else {
+                    damaged_rects.append(*previous_rect);
+                    damaged_rects.append(rect);
+                }
+            }
+            return IterationDecision::Continue;
+        });
+    }
 
-    root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Normal);
-    formatting_state.commit();
+    m_layout_root->clear_needs_layout_in_inclusive_subtree();
+    formatting_state->previous_layout_state = nullptr;
+    m_previous_layout_state = move(formatting_state);
 
-    browsing_context()->set_needs_display();
+    if (needs_full_repaint) {
+        browsing_context()->set_needs_display();
+    } else {
+        for (auto const& rect : damaged_rects)
+            browsing_context()->set_needs_display(rect);
+    }
 
     if (browsing_context()->is_top_level()) {
         if (auto* page = this->page())
@@ -596,28 +709,39 @@ void Document::update_layout()
     m_layout_update_timer->stop();
 }
 
-[[nodiscard]] static bool update_style_recursively(DOM::Node& node)
+// NOTE: When an element's style changes, its children have to be updated as well, since they may inherit from it.
+[[nodiscard]] static bool update_style_recursively(DOM::Node& node, bool parent_style_changed = false)
 {
     bool const needs_full_style_update = node.document().needs_full_style_update();
     bool needs_relayout = false;
+    bool style_changed = parent_style_changed;
 
     if (is<Element>(node)) {
-        needs_relayout |= static_cast<Element&>(node).recompute_style() == Element::NeedsRelayout::Yes;
+        auto& element = static_cast<Element&>(node);
+        auto const* old_computed_css_values = element.computed_css_values();
+        needs_relayout |= element.recompute_style() == Element::NeedsRelayout::Yes;
+        style_changed = element.computed_css_values() != old_computed_css_values;
     }
     node.set_needs_style_update(false);
 
-    if (needs_full_style_update || node.child_needs_style_update()) {
+    if (needs_full_style_update || style_changed || node.child_needs_style_update()) {
+        if (is<Element>(node))
+            node.document().style_computer().push_ancestor(static_cast<Element&>(node));
+
         if (node.is_element()) {
             if (auto* shadow_root = static_cast<DOM::Element&>(node).shadow_root()) {
-                if (needs_full_style_update || shadow_root->needs_style_update() || shadow_root->child_needs_style_update())
-                    needs_relayout |= update_style_recursively(*shadow_root);
+                if (needs_full_style_update || style_changed || shadow_root->needs_style_update() || shadow_root->child_needs_style_update())
+                    needs_relayout |= update_style_recursively(*shadow_root, style_changed);
             }
         }
         node.for_each_child([&](auto& child) {
-            if (needs_full_style_update || child.needs_style_update() || child.child_needs_style_update())
-                needs_relayout |= update_style_recursively(child);
+            if (needs_full_style_update || style_changed || child.needs_style_update() || child.child_needs_style_update())
+                needs_relayout |= update_style_recursively(child, style_changed);
             return IterationDecision::Continue;
         });
+
+        if (is<Element>(node))
+            node.document().style_computer().pop_ancestor(static_cast<Element&>(node));
     }
 
     node.set_child_needs_style_update(false);
@@ -388,6 +388,9 @@ private:
 
     RefPtr<Layout::InitialContainingBlock> m_layout_root;
 
+    // The results of the last layout pass, which are reused for the parts of the layout tree that don't need layout.
+    OwnPtr<Layout::FormattingState> m_previous_layout_state;
+
     Optional<Color> m_link_color;
     Optional<Color> m_active_link_color;
     Optional<Color> m_visited_link_color;
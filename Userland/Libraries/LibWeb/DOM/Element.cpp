@@ -80,6 +80,7 @@ ExceptionOr<void> Element::set_attribute(FlyString const& name, String const& va
 
     // 3. Let attribute be the first attribute in this’s attribute list whose qualified name is qualifiedName, and null otherwise.
     auto* attribute = m_attributes->get_attribute(name);
+    auto old_value = attribute ? attribute->value() : String {};
 
     // 4. If attribute is null, create an attribute whose local name is qualifiedName, value is value, and node document is this’s node document, then append this attribute to this, and then return.
     if (!attribute) {
@@ -96,8 +97,7 @@ ExceptionOr<void> Element::set_attribute(FlyString const& name, String const& va
 
     parse_attribute(attribute->local_name(), value);
 
-    // FIXME: Invalidate less.
-    document().invalidate_style();
+    invalidate_style_after_attribute_change(attribute->local_name(), old_value, value);
 
     return {};
 }
@@ -160,12 +160,13 @@ ExceptionOr<void> Element::set_attribute_ns(FlyString const& namespace_, FlyStri
 // https://dom.spec.whatwg.org/#dom-element-removeattribute
 void Element::remove_attribute(FlyString const& name)
 {
+    auto old_value = get_attribute(name);
+
     m_attributes->remove_attribute(name);
 
     did_remove_attribute(name);
 
-    // FIXME: Invalidate less.
-    document().invalidate_style();
+    invalidate_style_after_attribute_change(name, old_value, {});
 }
 
 // https://dom.spec.whatwg.org/#dom-element-hasattribute
@@ -198,8 +199,7 @@ DOM::ExceptionOr<bool> Element::toggle_attribute(FlyString const& name, Optional
 
             parse_attribute(new_attribute->local_name(), "");
 
-            // FIXME: Invalidate less.
-            document().invalidate_style();
+            invalidate_style_after_attribute_change(new_attribute->local_name(), {}, "");
 
             return true;
         }
@@ -210,12 +210,13 @@ DOM::ExceptionOr<bool> Element::toggle_attribute(FlyString const& name, Optional
 
     // 5. Otherwise, if force is not given or is false, remove an attribute given qualifiedName and this, and then return false.
     if (!force.has_value() || !force.value()) {
+        auto old_value = attribute->value();
+
         m_attributes->remove_attribute(name);
 
         did_remove_attribute(name);
 
-        // FIXME: Invalidate less.
-        document().invalidate_style();
+        invalidate_style_after_attribute_change(name, old_value, {});
     }
 
     // 6. Return true.
@@ -364,11 +365,70 @@ static RequiredInvalidation compute_required_invalidation(CSS::StyleProperties c
     return RequiredInvalidation::None;
 }
 
+static bool custom_properties_are_equal(HashMap<FlyString, CSS::StyleProperty> const& a, HashMap<FlyString, CSS::StyleProperty> const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (auto const& it : a) {
+        auto other = b.get(it.key);
+        // The values come straight from the matched declarations, so unchanged ones are the very same objects.
+        if (!other.has_value() || other->value.ptr() != it.value.value.ptr() || other->important != it.value.important)
+            return false;
+    }
+    return true;
+}
+
+void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name, String const& old_value, String const& new_value)
+{
+    // A null value means that the attribute is absent, which is different from an empty one.
+    if (old_value.is_null() && new_value.is_null())
+        return;
+    if (!old_value.is_null() && !new_value.is_null() && old_value == new_value)
+        return;
+
+    switch (document().style_computer().invalidation_scope_for_attribute_change(attribute_name, old_value, new_value)) {
+    case CSS::StyleComputer::StyleInvalidationScope::None:
+        break;
+    case CSS::StyleComputer::StyleInvalidationScope::Element:
+        set_needs_style_update(true);
+        break;
+    case CSS::StyleComputer::StyleInvalidationScope::Subtree:
+        invalidate_style();
+        break;
+    case CSS::StyleComputer::StyleInvalidationScope::SubtreeAndSiblings:
+        if (auto* parent = this->parent())
+            parent->invalidate_style();
+        else
+            invalidate_style();
+        break;
+    }
+}
+
 Element::NeedsRelayout Element::recompute_style()
 {
     set_needs_style_update(false);
     VERIFY(parent());
-    auto new_computed_css_values = document().style_computer().compute_style(*this);
+
+    auto old_custom_properties = move(m_custom_properties);
+
+    RefPtr<CSS::StyleProperties> new_computed_css_values;
+    auto& style_computer = document().style_computer();
+    if (auto const* element_to_share_style_with = style_computer.find_element_to_share_style_with(*this)) {
+        new_computed_css_values = element_to_share_style_with->m_computed_css_values;
+        m_custom_properties = element_to_share_style_with->m_custom_properties;
+    } else {
+        new_computed_css_values = style_computer.compute_style(*this);
+    }
+
+    // NOTE: Custom properties are looked up on the ancestors of whoever uses them, so any descendant may be affected by a change.
+    if (!document().needs_full_style_update() && !custom_properties_are_equal(old_custom_properties, m_custom_properties)) {
+        for_each_child([](auto& child) {
+            child.invalidate_style();
+            return IterationDecision::Continue;
+        });
+        if (m_shadow_root)
+            m_shadow_root->invalidate_style();
+    }
 
     auto required_invalidation = RequiredInvalidation::Relayout;
 
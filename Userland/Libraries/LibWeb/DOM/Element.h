@@ -94,6 +94,8 @@ public:
     };
     NeedsRelayout recompute_style();
 
+    void invalidate_style_after_attribute_change(FlyString const& attribute_name, String const& old_value, String const& new_value);
+
     Layout::NodeWithStyle* layout_node() { return static_cast<Layout::NodeWithStyle*>(Node::layout_node()); }
     Layout::NodeWithStyle const* layout_node() const { return static_cast<Layout::NodeWithStyle const*>(Node::layout_node()); }
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/ArgsParser.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/Window.h>
 #include <LibWeb/OutOfProcessWebView.h>
@@ -11,14 +12,28 @@
 
 int main(int argc, char** argv)
 {
+    char const* path = nullptr;
+    u32 benchmark_iterations = 0;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(benchmark_iterations, "Time this many full and incremental layout passes instead of dumping the layout tree", "benchmark-layout", 'b', "iterations");
+    args_parser.add_positional_argument(path, "HTML file to lay out", "path");
+    args_parser.parse(argc, argv);
+
     auto app = GUI::Application::construct(argc, argv);
     auto window = GUI::Window::construct();
     window->set_title("DumpLayoutTree");
     window->resize(800, 600);
     window->show();
     auto& web_view = window->set_main_widget<Web::OutOfProcessWebView>();
-    web_view.load(URL::create_with_file_protocol(argv[1]));
+    web_view.load(URL::create_with_file_protocol(path));
     web_view.on_load_finish = [&](auto&) {
+        if (benchmark_iterations > 0) {
+            auto timings = web_view.benchmark_layout(benchmark_iterations);
+            outln("Full layout:        {:.3} ms per pass", timings.full_layout_microseconds / 1000.0 / benchmark_iterations);
+            outln("Incremental layout: {:.3} ms per pass", timings.incremental_layout_microseconds / 1000.0 / benchmark_iterations);
+            _exit(0);
+        }
         auto dump = web_view.dump_layout_tree();
         write(STDOUT_FILENO, dump.characters(), dump.length() + 1);
         _exit(0);
@@ -156,15 +156,17 @@ void BrowsingContext::set_needs_display()
 
 void BrowsingContext::set_needs_display(Gfx::IntRect const& rect)
 {
-    if (!viewport_rect().intersects(rect))
-        return;
-
+    // NOTE: The top-level page client is told about offscreen invalidations as well, since it may be holding on to
+    //       already painted content outside the viewport.
     if (is_top_level()) {
         if (m_page)
             m_page->client().page_did_invalidate(to_top_level_rect(rect));
         return;
     }
 
+    if (!viewport_rect().intersects(rect))
+        return;
+
     if (container() && container()->layout_node())
         container()->layout_node()->set_needs_display();
 }
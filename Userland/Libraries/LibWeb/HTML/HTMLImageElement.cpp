@@ -24,7 +24,10 @@ HTMLImageElement::HTMLImageElement(DOM::Document& document, DOM::QualifiedName q
 {
     m_image_loader.on_load = [this] {
         set_needs_style_update(true);
-        this->document().set_needs_layout();
+        if (auto* layout_node = this->layout_node())
+            layout_node->set_needs_layout();
+        else
+            this->document().set_needs_layout();
         queue_an_element_task(HTML::Task::Source::DOMManipulation, [this] {
             dispatch_event(DOM::Event::create(EventNames::load));
         });
@@ -33,7 +36,10 @@ HTMLImageElement::HTMLImageElement(DOM::Document& document, DOM::QualifiedName q
     m_image_loader.on_fail = [this] {
         dbgln("HTMLImageElement: Resource did fail: {}", src());
         set_needs_style_update(true);
-        this->document().set_needs_layout();
+        if (auto* layout_node = this->layout_node())
+            layout_node->set_needs_layout();
+        else
+            this->document().set_needs_layout();
         queue_an_element_task(HTML::Task::Source::DOMManipulation, [this] {
             dispatch_event(DOM::Event::create(EventNames::error));
         });
@@ -89,7 +95,7 @@ RefPtr<Layout::Node> HTMLImageElement::create_layout_node(NonnullRefPtr<CSS::Sty
 
 Gfx::Bitmap const* HTMLImageElement::bitmap() const
 {
-    return m_image_loader.bitmap(m_image_loader.current_frame_index());
+    return m_image_loader.natural_size_bitmap(m_image_loader.current_frame_index());
 }
 
 // https://html.spec.whatwg.org/multipage/embedded-content.html#dom-img-width
@@ -25,8 +25,11 @@
 #include <LibWeb/HTML/HTMLTemplateElement.h>
 #include <LibWeb/HTML/Parser/HTMLEncodingDetection.h>
 #include <LibWeb/HTML/Parser/HTMLParser.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
 #include <LibWeb/HTML/Window.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/SVG/TagNames.h>
 
@@ -140,6 +143,7 @@ HTMLParser::HTMLParser(DOM::Document& document)
 HTMLParser::~HTMLParser()
 {
     m_document->set_should_invalidate_styles_on_attribute_changes(true);
+    release_unused_speculative_fetches();
 }
 
 void HTMLParser::run()
@@ -189,6 +193,33 @@ void HTMLParser::run()
     flush_character_insertions();
 }
 
+// https://html.spec.whatwg.org/multipage/parsing.html#speculative-html-parsing
+void HTMLParser::run_speculative_preload_scan()
+{
+    // NOTE: The scan always runs to the end of the input, so there is nothing new to find until more input is inserted.
+    auto input = m_tokenizer.unconsumed_input();
+    auto input_length = m_tokenizer.source().length();
+    if (input.is_empty() || m_input_length_at_last_preload_scan == input_length)
+        return;
+    m_input_length_at_last_preload_scan = input_length;
+
+    HTMLPreloadScanner scanner(*m_document, input);
+    for (auto& fetch : scanner.scan()) {
+        // NOTE: This has to be the same request the element would make, so that it finds the resource in the cache.
+        auto request = LoadRequest::create_for_url_on_page(fetch.url, m_document->page());
+        if (auto resource = ResourceLoader::the().load_resource(fetch.type, request))
+            m_speculative_fetches.append(resource.release_nonnull());
+    }
+}
+
+void HTMLParser::release_unused_speculative_fetches()
+{
+    // NOTE: Anything the parser didn't end up using was fetched for nothing, so it shouldn't stay around in the cache.
+    for (auto& resource : m_speculative_fetches)
+        ResourceLoader::the().evict_from_cache_if_unused(resource);
+    m_speculative_fetches.clear();
+}
+
 void HTMLParser::run(const AK::URL& url)
 {
     m_document->set_url(url);
@@ -215,6 +246,9 @@ void HTMLParser::the_end()
     while (!m_stack_of_open_elements.is_empty())
         (void)m_stack_of_open_elements.pop();
 
+    // NOTE: Every element the parser is going to create exists by now, and has asked for the resources it needs.
+    release_unused_speculative_fetches();
+
     // 5. While the list of scripts that will execute when the document has finished parsing is not empty:
     while (!m_document->scripts_to_execute_when_parsing_has_finished().is_empty()) {
         // 1. Spin the event loop until the first script in the list of scripts that will execute when the document has finished parsing
@@ -2259,6 +2293,7 @@ void HTMLParser::handle_text(HTMLToken& token)
                 // that is blocking scripts and the script's "ready to be parser-executed"
                 // flag is set.
                 if (m_document->has_a_style_sheet_that_is_blocking_scripts() || !script->is_ready_to_be_parser_executed()) {
+                    run_speculative_preload_scan();
                     main_thread_event_loop().spin_until([&] {
                         return !m_document->has_a_style_sheet_that_is_blocking_scripts() && script->is_ready_to_be_parser_executed();
                     });
@@ -11,6 +11,7 @@
 #include <LibWeb/HTML/Parser/HTMLTokenizer.h>
 #include <LibWeb/HTML/Parser/ListOfActiveFormattingElements.h>
 #include <LibWeb/HTML/Parser/StackOfOpenElements.h>
+#include <LibWeb/Loader/Resource.h>
 
 namespace Web::HTML {
 
@@ -137,6 +138,8 @@ private:
     void increment_script_nesting_level();
     void decrement_script_nesting_level();
     void reset_the_insertion_mode_appropriately();
+    void run_speculative_preload_scan();
+    void release_unused_speculative_fetches();
 
     void adjust_mathml_attributes(HTMLToken&);
     void adjust_svg_tag_names(HTMLToken&);
@@ -172,6 +175,8 @@ private:
     bool m_parser_pause_flag { false };
     bool m_stop_parsing { false };
     size_t m_script_nesting_level { 0 };
+    Optional<size_t> m_input_length_at_last_preload_scan;
+    NonnullRefPtrVector<Resource> m_speculative_fetches;
 
     NonnullRefPtr<DOM::Document> m_document;
     RefPtr<HTMLHeadElement> m_head_element;
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+#include <LibWeb/HTML/TagNames.h>
+
+namespace Web::HTML {
+
+HTMLPreloadScanner::HTMLPreloadScanner(DOM::Document& document, StringView input)
+    : m_document(document)
+    , m_tokenizer(input, "utf-8")
+{
+}
+
+Vector<HTMLPreloadScanner::SpeculativeFetch> HTMLPreloadScanner::scan()
+{
+    for (;;) {
+        auto token = m_tokenizer.next_token();
+        if (!token.has_value() || token->is_end_of_file())
+            break;
+        if (token->is_start_tag())
+            handle_start_tag(*token);
+    }
+    dbgln_if(HTML_PARSER_DEBUG, "HTMLPreloadScanner: Found {} resources to fetch", m_fetches.size());
+    return move(m_fetches);
+}
+
+static bool is_javascript_type(StringView type)
+{
+    // This errs on the side of fetching, as the script element will make the real decision.
+    type = type.trim_whitespace();
+    return type.is_empty() || type.contains("javascript"sv, CaseSensitivity::CaseInsensitive) || type.contains("ecmascript"sv, CaseSensitivity::CaseInsensitive);
+}
+
+static bool is_stylesheet_link(StringView rel)
+{
+    bool is_stylesheet = false;
+    for (auto keyword : rel.split_view_if(is_ascii_space)) {
+        if (keyword.equals_ignoring_case("alternate"sv))
+            return false;
+        if (keyword.equals_ignoring_case("stylesheet"sv))
+            is_stylesheet = true;
+    }
+    return is_stylesheet;
+}
+
+void HTMLPreloadScanner::handle_start_tag(HTMLToken& token)
+{
+    auto const& tag_name = token.tag_name();
+
+    // The contents of these elements aren't markup, so we have to tokenize them the same way the tree builder would.
+    if (tag_name == HTML::TagNames::script) {
+        m_tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+        if (auto src = token.attribute(HTML::AttributeNames::src); !src.is_empty() && is_javascript_type(token.attribute(HTML::AttributeNames::type)) && token.attribute(HTML::AttributeNames::nomodule).is_null())
+            add_fetch(Resource::Type::Generic, src);
+        return;
+    }
+    if (tag_name.is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes)
+        || (tag_name == HTML::TagNames::noscript && m_document->is_scripting_enabled())) {
+        m_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        return;
+    }
+    if (tag_name.is_one_of(HTML::TagNames::textarea, HTML::TagNames::title)) {
+        m_tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        return;
+    }
+    if (tag_name == HTML::TagNames::plaintext) {
+        m_tokenizer.switch_to(HTMLTokenizer::State::PLAINTEXT);
+        return;
+    }
+
+    if (tag_name == HTML::TagNames::base) {
+        // Only the first base element with an href attribute counts.
+        if (auto href = token.attribute(HTML::AttributeNames::href); !href.is_null() && !m_base_url.has_value())
+            m_base_url = m_document->parse_url(href);
+        return;
+    }
+
+    if (tag_name == HTML::TagNames::link) {
+        if (auto href = token.attribute(HTML::AttributeNames::href); !href.is_empty() && is_stylesheet_link(token.attribute(HTML::AttributeNames::rel)))
+            add_fetch(Resource::Type::Generic, href);
+        return;
+    }
+
+    if (tag_name == HTML::TagNames::img) {
+        if (auto src = token.attribute(HTML::AttributeNames::src); !src.is_empty())
+            add_fetch(Resource::Type::Image, src);
+        return;
+    }
+}
+
+void HTMLPreloadScanner::add_fetch(Resource::Type type, StringView url_string)
+{
+    auto url = m_base_url.has_value() ? m_base_url->complete_url(url_string) : m_document->parse_url(url_string);
+    if (!url.is_valid())
+        return;
+
+    dbgln_if(HTML_PARSER_DEBUG, "HTMLPreloadScanner: Found {}", url);
+    m_fetches.append({ type, move(url) });
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullRefPtr.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+#include <LibWeb/Loader/Resource.h>
+
+namespace Web::HTML {
+
+// Tokenizes ahead of the parser while it is blocked on a script, and finds the scripts, style sheets and images
+// that the parser is going to need, so that they can already be on their way by the time the parser gets to them.
+// Nothing it finds ends up in the document.
+// https://html.spec.whatwg.org/multipage/parsing.html#speculative-html-parsing
+class HTMLPreloadScanner {
+public:
+    HTMLPreloadScanner(DOM::Document&, StringView input);
+
+    struct SpeculativeFetch {
+        Resource::Type type { Resource::Type::Generic };
+        AK::URL url;
+    };
+
+    Vector<SpeculativeFetch> scan();
+
+private:
+    void handle_start_tag(HTMLToken&);
+    void add_fetch(Resource::Type, StringView url);
+
+    NonnullRefPtr<DOM::Document> m_document;
+    HTMLTokenizer m_tokenizer;
+    Optional<AK::URL> m_base_url;
+    Vector<SpeculativeFetch> m_fetches;
+};
+
+}
@@ -408,8 +408,10 @@ void BlockFormattingContext::layout_block_level_children(BlockContainer const& b
             compute_height(child_box, m_state);
         }
 
+        bool did_reuse_previous_layout = try_reuse_previous_layout(child_box, block_container, layout_mode);
+
         OwnPtr<FormattingContext> independent_formatting_context;
-        if (child_box.can_have_children()) {
+        if (!did_reuse_previous_layout && child_box.can_have_children()) {
             independent_formatting_context = create_independent_formatting_context_if_needed(m_state, child_box);
             if (independent_formatting_context)
                 independent_formatting_context->run(child_box, layout_mode);
@@ -445,6 +447,57 @@ void BlockFormattingContext::layout_block_level_children(BlockContainer const& b
     }
 }
 
+// Copies the layout of child_box's contents from the previous layout pass, if nothing that could affect it has changed since.
+// The box itself still gets placed by the caller, as the boxes before it may have moved.
+bool BlockFormattingContext::try_reuse_previous_layout(Box const& child_box, BlockContainer const& containing_block, LayoutMode layout_mode)
+{
+    auto const* previous_state = m_state.previous_layout_state;
+    if (!previous_state || layout_mode != LayoutMode::Normal || child_box.needs_layout())
+        return false;
+
+    // Floats in this BFC may intrude into the line boxes of child_box's descendants.
+    if (!m_left_floats.all_boxes.is_empty() || !m_right_floats.all_boxes.is_empty())
+        return false;
+
+    auto previous_box_state = previous_state->nodes.find(&child_box);
+    auto previous_containing_block_state = previous_state->nodes.find(&containing_block);
+    if (previous_box_state == previous_state->nodes.end() || previous_containing_block_state == previous_state->nodes.end())
+        return false;
+
+    // The contents only depend on the box's own width and the size of its containing block (for percentages).
+    auto const& box_state = m_state.get(child_box);
+    auto const& containing_block_state = m_state.get(containing_block);
+    if (box_state.content_width != previous_box_state->value->content_width
+        || containing_block_state.content_width != previous_containing_block_state->value->content_width
+        || (containing_block.has_definite_height() && containing_block_state.content_height != previous_containing_block_state->value->content_height))
+        return false;
+
+    // Floating and absolutely positioned descendants are laid out by this formatting context rather than
+    // the one of their parent, so their layout can't just be copied.
+    bool can_reuse = true;
+    child_box.for_each_in_subtree_of_type<Box>([&](Box const& box) {
+        if (box.is_floating() || box.is_absolutely_positioned() || !previous_state->nodes.contains(&box)) {
+            can_reuse = false;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    if (!can_reuse)
+        return false;
+
+    child_box.for_each_in_subtree_of_type<NodeWithStyleAndBoxModelMetrics>([&](NodeWithStyleAndBoxModelMetrics const& node) {
+        if (auto it = previous_state->nodes.find(&node); it != previous_state->nodes.end())
+            m_state.nodes.set(&node, adopt_own(*new FormattingState::NodeState(*it->value)));
+        return IterationDecision::Continue;
+    });
+
+    auto& mutable_box_state = m_state.get_mutable(child_box);
+    mutable_box_state.content_height = previous_box_state->value->content_height;
+    mutable_box_state.line_boxes = previous_box_state->value->line_boxes;
+    mutable_box_state.overflow_data = previous_box_state->value->overflow_data;
+    return true;
+}
+
 void BlockFormattingContext::compute_vertical_box_model_metrics(Box const& box, BlockContainer const& containing_block)
 {
     auto& box_state = m_state.get_mutable(box);
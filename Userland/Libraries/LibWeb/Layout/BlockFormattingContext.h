@@ -64,6 +64,8 @@ private:
 
     void layout_list_item_marker(ListItemBox const&);
 
+    bool try_reuse_previous_layout(Box const& child_box, BlockContainer const& containing_block, LayoutMode);
+
     enum class FloatSide {
         Left,
         Right,
@@ -45,6 +45,8 @@ void FormattingState::commit()
     // Only the top-level FormattingState should ever be committed.
     VERIFY(!m_parent);
 
+    // NOTE: The node states are copied rather than moved into the paintables, as they are kept around for the next layout pass.
+
     HashTable<Layout::TextNode*> text_nodes;
 
     for (auto& it : nodes) {
@@ -65,7 +67,7 @@ void FormattingState::commit()
             auto& paint_box = const_cast<Painting::PaintableBox&>(*box.paint_box());
             paint_box.set_offset(node_state.offset);
             paint_box.set_content_size(node_state.content_width, node_state.content_height);
-            paint_box.set_overflow_data(move(node_state.overflow_data));
+            paint_box.set_overflow_data(node_state.overflow_data);
             paint_box.set_containing_line_box_fragment(node_state.containing_line_box_fragment);
 
             if (is<Layout::BlockContainer>(box)) {
@@ -75,7 +77,8 @@ void FormattingState::commit()
                             text_nodes.set(static_cast<Layout::TextNode*>(const_cast<Layout::Node*>(&fragment.layout_node())));
                     }
                 }
-                static_cast<Painting::PaintableWithLines&>(paint_box).set_line_boxes(move(node_state.line_boxes));
+                auto line_boxes = node_state.line_boxes;
+                static_cast<Painting::PaintableWithLines&>(paint_box).set_line_boxes(move(line_boxes));
             }
         }
     }
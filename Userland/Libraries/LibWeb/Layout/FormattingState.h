@@ -107,6 +107,11 @@ struct FormattingState {
     };
     HashMap<NodeWithStyleAndBoxModelMetrics const*, IntrinsicSizes> mutable intrinsic_sizes;
 
+    // The committed state of the previous layout pass, if any. Formatting contexts may copy the results for subtrees
+    // that haven't been marked as needing layout from here, instead of laying them out again.
+    // NOTE: This is only ever set on the top-level FormattingState.
+    FormattingState const* previous_layout_state { nullptr };
+
     FormattingState const* m_parent { nullptr };
     FormattingState const& m_root;
 };
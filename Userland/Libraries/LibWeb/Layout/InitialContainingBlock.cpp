@@ -49,11 +49,22 @@ void InitialContainingBlock::build_stacking_context_tree()
 void InitialContainingBlock::paint_all_phases(PaintContext& context)
 {
     build_stacking_context_tree_if_needed();
-    context.painter().fill_rect(enclosing_int_rect(paint_box()->absolute_rect()), document().background_color(context.palette()));
+    context.painter().fill_rect({ {}, context.viewport_rect().size() }, document().background_color(context.palette()));
     context.painter().translate(-context.viewport_rect().location());
     paint_box()->stacking_context()->paint(context);
 }
 
+void InitialContainingBlock::set_needs_display()
+{
+    if (!paint_box())
+        return;
+    // NOTE: The whole document is covered, not just the part of it that's inside the viewport.
+    auto rect = paint_box()->absolute_rect();
+    if (paint_box()->has_overflow())
+        rect = rect.united(paint_box()->scrollable_overflow_rect().value());
+    browsing_context().set_needs_display(enclosing_int_rect(rect));
+}
+
 void InitialContainingBlock::recompute_selection_states()
 {
     SelectionState state = SelectionState::None;
@@ -20,6 +20,8 @@ public:
 
     void paint_all_phases(PaintContext&);
 
+    virtual void set_needs_display() override;
+
     LayoutRange const& selection() const { return m_selection; }
     void set_selection(LayoutRange const&);
     void set_selection_end(LayoutPosition const&);
@@ -188,6 +188,23 @@ NodeWithStyle::NodeWithStyle(DOM::Document& document, DOM::Node* node, CSS::Comp
 {
     m_has_style = true;
     m_font = Gfx::FontDatabase::default_font();
+    for_each_image([&](auto& image) { image.register_layout_node({}, *this); });
+}
+
+NodeWithStyle::~NodeWithStyle()
+{
+    for_each_image([&](auto& image) { image.unregister_layout_node({}, *this); });
+}
+
+template<typename Callback>
+void NodeWithStyle::for_each_image(Callback callback) const
+{
+    for (auto& layer : background_layers()) {
+        if (layer.image)
+            callback(*layer.image);
+    }
+    if (m_list_style_image)
+        callback(*m_list_style_image);
 }
 
 void NodeWithStyle::did_insert_into_layout_tree(CSS::StyleProperties const& style)
@@ -231,6 +248,9 @@ void NodeWithStyle::apply_style(const CSS::StyleProperties& computed_style)
 {
     auto& computed_values = static_cast<CSS::MutableComputedValues&>(m_computed_values);
 
+    // The images used by the new style register this node again at the end.
+    for_each_image([&](auto& image) { image.unregister_layout_node({}, *this); });
+
     // NOTE: We have to be careful that font-related properties get set in the right order.
     //       m_font is used by Length::to_px() when resolving sizes against this layout node.
     //       That's why it has to be set before everything else.
@@ -545,6 +565,8 @@ void NodeWithStyle::apply_style(const CSS::StyleProperties& computed_style)
         computed_values.set_stroke_width(CSS::Length::make_px(stroke_width->to_number()));
     else
         computed_values.set_stroke_width(stroke_width->to_length());
+
+    for_each_image([&](auto& image) { image.register_layout_node({}, *this); });
 }
 
 bool Node::is_root_element() const
@@ -596,6 +618,24 @@ void Node::set_paintable(RefPtr<Painting::Paintable> paintable)
     m_paintable = move(paintable);
 }
 
+void Node::set_needs_layout()
+{
+    for (auto* node = this; node && !node->m_needs_layout; node = node->parent())
+        node->m_needs_layout = true;
+    document().set_needs_layout();
+}
+
+void Node::clear_needs_layout_in_inclusive_subtree()
+{
+    // NOTE: The ancestors of a node that needs layout need layout as well, so we can skip any subtree whose root doesn't.
+    if (!m_needs_layout)
+        return;
+    m_needs_layout = false;
+    for_each_child([](auto& child) {
+        child.clear_needs_layout_in_inclusive_subtree();
+    });
+}
+
 RefPtr<Painting::Paintable> Node::create_paintable() const
 {
     return nullptr;
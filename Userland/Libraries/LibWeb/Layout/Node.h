@@ -122,6 +122,12 @@ public:
 
     virtual void set_needs_display();
 
+    // Marks this node and all of its ancestors as needing layout. Subtrees that aren't marked
+    // may reuse the results of the previous layout pass.
+    bool needs_layout() const { return m_needs_layout; }
+    void set_needs_layout();
+    void clear_needs_layout_in_inclusive_subtree();
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -152,6 +158,7 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { true };
     SelectionState m_selection_state { SelectionState::None };
 
     bool m_is_flex_item { false };
@@ -159,7 +166,7 @@ private:
 
 class NodeWithStyle : public Node {
 public:
-    virtual ~NodeWithStyle() override = default;
+    virtual ~NodeWithStyle() override;
 
     const CSS::ImmutableComputedValues& computed_values() const { return static_cast<const CSS::ImmutableComputedValues&>(m_computed_values); }
 
@@ -185,6 +192,9 @@ protected:
     NodeWithStyle(DOM::Document&, DOM::Node*, CSS::ComputedValues);
 
 private:
+    template<typename Callback>
+    void for_each_image(Callback) const;
+
     CSS::ComputedValues m_computed_values;
     RefPtr<Gfx::Font> m_font;
     float m_line_height { 0 };
@@ -9,8 +9,10 @@
 #include <LibGfx/Bitmap.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
+#include <LibWeb/Layout/ImageBox.h>
 #include <LibWeb/Loader/ImageLoader.h>
 #include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/Painting/PaintableBox.h>
 
 namespace Web {
 
@@ -138,21 +140,21 @@ bool ImageLoader::has_image() const
 {
     if (!resource())
         return false;
-    return bitmap(0);
+    return !resource()->natural_size().is_empty();
 }
 
 unsigned ImageLoader::width() const
 {
     if (!resource())
         return 0;
-    return bitmap(0) ? bitmap(0)->width() : 0;
+    return resource()->natural_size().width();
 }
 
 unsigned ImageLoader::height() const
 {
     if (!resource())
         return 0;
-    return bitmap(0) ? bitmap(0)->height() : 0;
+    return resource()->natural_size().height();
 }
 
 Gfx::Bitmap const* ImageLoader::bitmap(size_t frame_index) const
@@ -162,4 +164,22 @@ Gfx::Bitmap const* ImageLoader::bitmap(size_t frame_index) const
     return resource()->bitmap(frame_index);
 }
 
+Gfx::Bitmap const* ImageLoader::natural_size_bitmap(size_t frame_index) const
+{
+    if (!resource())
+        return nullptr;
+    return resource()->natural_size_bitmap(frame_index);
+}
+
+Optional<Gfx::IntSize> ImageLoader::displayed_size() const
+{
+    auto const* layout_node = m_owner_element.layout_node();
+    if (!layout_node || !is<Layout::ImageBox>(*layout_node))
+        return {};
+    auto const* paint_box = static_cast<Layout::ImageBox const&>(*layout_node).paint_box();
+    if (!paint_box)
+        return {};
+    return enclosing_int_rect(paint_box->absolute_rect()).size();
+}
+
 }
@@ -21,6 +21,7 @@ public:
     void load(const AK::URL&);
 
     Gfx::Bitmap const* bitmap(size_t index) const;
+    Gfx::Bitmap const* natural_size_bitmap(size_t index) const;
     size_t current_frame_index() const { return m_current_frame_index; }
 
     bool has_image() const;
@@ -43,6 +44,7 @@ private:
     virtual void resource_did_load() override;
     virtual void resource_did_fail() override;
     virtual bool is_visible_in_viewport() const override { return m_visible_in_viewport; }
+    virtual Optional<Gfx::IntSize> displayed_size() const override;
 
     void animate();
 
@@ -4,12 +4,41 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
 #include <LibGfx/Bitmap.h>
 #include <LibWeb/ImageDecoding.h>
 #include <LibWeb/Loader/ImageResource.h>
 
 namespace Web {
 
+// Decoded frames of images that aren't visible in the viewport are discarded, least recently used first,
+// when the decoded frames of all images together take up more memory than this.
+static size_t s_decoded_image_memory_budget = 128 * MiB;
+
+static ImageResource::DecodedImageList& decoded_images()
+{
+    static ImageResource::DecodedImageList list;
+    return list;
+}
+
+static size_t s_decoded_image_memory_usage = 0;
+
+size_t ImageResource::decoded_image_memory_usage()
+{
+    return s_decoded_image_memory_usage;
+}
+
+size_t ImageResource::decoded_image_memory_budget()
+{
+    return s_decoded_image_memory_budget;
+}
+
+void ImageResource::set_decoded_image_memory_budget(size_t budget)
+{
+    s_decoded_image_memory_budget = budget;
+    enforce_decoded_image_memory_budget(nullptr);
+}
+
 NonnullRefPtr<ImageResource> ImageResource::convert_from_resource(Resource& resource)
 {
     return adopt_ref(*new ImageResource(resource));
@@ -25,7 +54,10 @@ ImageResource::ImageResource(Resource& resource)
 {
 }
 
-ImageResource::~ImageResource() = default;
+ImageResource::~ImageResource()
+{
+    discard_decoded_frames();
+}
 
 int ImageResource::frame_duration(size_t frame_index) const
 {
@@ -46,8 +78,9 @@ void ImageResource::decode_if_needed() const
     if (!m_decoded_frames.is_empty())
         return;
 
+    auto ideal_size = ideal_decoded_size();
     NonnullRefPtr decoder = image_decoder_client();
-    auto image = decoder->decode_image(encoded_data());
+    auto image = decoder->decode_image(encoded_data(), ideal_size);
 
     if (image.has_value()) {
         m_loop_count = image.value().loop_count;
@@ -57,10 +90,100 @@ void ImageResource::decode_if_needed() const
             auto& frame = m_decoded_frames[i];
             frame.bitmap = image.value().frames[i].bitmap;
             frame.duration = image.value().frames[i].duration;
+            if (frame.bitmap)
+                m_decoded_size_in_bytes += frame.bitmap->size_in_bytes();
         }
+        // NOTE: Only a decode without an ideal size is guaranteed to produce frames at the natural size.
+        if (!ideal_size.has_value() && !m_decoded_frames.is_empty() && m_decoded_frames[0].bitmap)
+            m_natural_size = m_decoded_frames[0].bitmap->size();
     }
 
     m_has_attempted_decode = true;
+
+    if (m_decoded_size_in_bytes == 0)
+        return;
+
+    dbgln_if(IMAGE_LOADER_DEBUG, "ImageResource: Decoded {} ({} frames, {} bytes, scaled down: {})", url(), m_decoded_frames.size(), m_decoded_size_in_bytes, ideal_size.has_value());
+    s_decoded_image_memory_usage += m_decoded_size_in_bytes;
+    did_use_decoded_frames();
+    enforce_decoded_image_memory_budget(this);
+}
+
+void ImageResource::discard_decoded_frames() const
+{
+    if (m_decoded_image_list_node.is_in_list()) {
+        decoded_images().remove(const_cast<ImageResource&>(*this));
+        s_decoded_image_memory_usage -= m_decoded_size_in_bytes;
+    }
+    m_decoded_size_in_bytes = 0;
+    m_decoded_frames.clear();
+    m_has_attempted_decode = false;
+}
+
+void ImageResource::did_use_decoded_frames() const
+{
+    // Moving the image to the back of the list keeps the list in least recently used order.
+    decoded_images().append(const_cast<ImageResource&>(*this));
+}
+
+void ImageResource::enforce_decoded_image_memory_budget(ImageResource const* resource_to_keep)
+{
+    auto& list = decoded_images();
+    for (auto it = list.begin(); it != list.end() && s_decoded_image_memory_usage > s_decoded_image_memory_budget;) {
+        auto& resource = *it;
+        ++it;
+        if (&resource == resource_to_keep || resource.is_visible_in_viewport())
+            continue;
+        dbgln_if(IMAGE_LOADER_DEBUG, "ImageResource: Discarding decoded frames of {} to stay within budget", resource.url());
+        // NOTE: The frames will be decoded again the next time someone asks for them.
+        resource.discard_decoded_frames();
+    }
+}
+
+bool ImageResource::is_visible_in_viewport() const
+{
+    bool visible_in_viewport = false;
+    const_cast<ImageResource&>(*this).for_each_client([&](auto& client) {
+        if (static_cast<ImageResourceClient const&>(client).is_visible_in_viewport())
+            visible_in_viewport = true;
+    });
+    return visible_in_viewport;
+}
+
+Optional<Gfx::IntSize> ImageResource::ideal_decoded_size() const
+{
+    // The natural size is only known after the image has been decoded once, and it's needed for layout.
+    if (m_needs_natural_size_bitmaps || m_natural_size.is_empty())
+        return {};
+
+    bool every_client_knows_its_displayed_size = true;
+    Gfx::IntSize largest_displayed_size;
+    const_cast<ImageResource&>(*this).for_each_client([&](auto& client) {
+        auto displayed_size = static_cast<ImageResourceClient const&>(client).displayed_size();
+        if (!displayed_size.has_value()) {
+            every_client_knows_its_displayed_size = false;
+            return;
+        }
+        largest_displayed_size.set_width(max(largest_displayed_size.width(), displayed_size->width()));
+        largest_displayed_size.set_height(max(largest_displayed_size.height(), displayed_size->height()));
+    });
+
+    if (!every_client_knows_its_displayed_size || largest_displayed_size.is_empty())
+        return {};
+    if (largest_displayed_size.width() >= m_natural_size.width() && largest_displayed_size.height() >= m_natural_size.height())
+        return {};
+    return largest_displayed_size;
+}
+
+bool ImageResource::decoded_frames_are_large_enough() const
+{
+    if (m_decoded_frames.is_empty() || !m_decoded_frames[0].bitmap)
+        return true;
+    auto decoded_size = m_decoded_frames[0].bitmap->size();
+    auto needed_size = ideal_decoded_size().value_or(m_natural_size);
+    // NOTE: Scaled decodes keep the aspect ratio, so one of the dimensions may come out larger than needed.
+    return decoded_size.width() >= min(needed_size.width(), m_natural_size.width())
+        && decoded_size.height() >= min(needed_size.height(), m_natural_size.height());
 }
 
 Gfx::Bitmap const* ImageResource::bitmap(size_t frame_index) const
@@ -68,18 +191,24 @@ Gfx::Bitmap const* ImageResource::bitmap(size_t frame_index) const
     decode_if_needed();
     if (frame_index >= m_decoded_frames.size())
         return nullptr;
+    did_use_decoded_frames();
     return m_decoded_frames[frame_index].bitmap;
 }
 
-void ImageResource::update_volatility()
+Gfx::Bitmap const* ImageResource::natural_size_bitmap(size_t frame_index) const
 {
-    bool visible_in_viewport = false;
-    for_each_client([&](auto& client) {
-        if (static_cast<const ImageResourceClient&>(client).is_visible_in_viewport())
-            visible_in_viewport = true;
-    });
+    if (!m_needs_natural_size_bitmaps) {
+        // From now on, this image is always decoded at its natural size, so that it doesn't go back and forth.
+        m_needs_natural_size_bitmaps = true;
+        if (!decoded_frames_are_large_enough())
+            discard_decoded_frames();
+    }
+    return bitmap(frame_index);
+}
 
-    if (!visible_in_viewport) {
+void ImageResource::update_volatility()
+{
+    if (!is_visible_in_viewport()) {
         for (auto& frame : m_decoded_frames) {
             if (frame.bitmap)
                 frame.bitmap->set_volatile();
@@ -87,7 +216,7 @@ void ImageResource::update_volatility()
         return;
     }
 
-    bool still_has_decoded_image = true;
+    bool still_has_decoded_image = decoded_frames_are_large_enough();
     for (auto& frame : m_decoded_frames) {
         if (!frame.bitmap) {
             still_has_decoded_image = false;
@@ -101,8 +230,7 @@ void ImageResource::update_volatility()
     if (still_has_decoded_image)
         return;
 
-    m_decoded_frames.clear();
-    m_has_attempted_decode = false;
+    discard_decoded_frames();
 }
 
 ImageResourceClient::~ImageResourceClient() = default;
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/IntrusiveList.h>
+#include <LibGfx/Size.h>
 #include <LibWeb/Loader/Resource.h>
 
 namespace Web {
@@ -23,7 +25,18 @@ public:
         size_t duration { 0 };
     };
 
+    // NOTE: The bitmap returned here may have been decoded at a smaller size than the image's natural size,
+    //       to match the size it's displayed at. Use natural_size_bitmap() if the actual pixels are needed.
     Gfx::Bitmap const* bitmap(size_t frame_index = 0) const;
+    Gfx::Bitmap const* natural_size_bitmap(size_t frame_index = 0) const;
+    Gfx::IntSize natural_size() const
+    {
+        // NOTE: The natural size is remembered when decoded frames are discarded, so layout doesn't have to decode again.
+        if (m_natural_size.is_empty())
+            decode_if_needed();
+        return m_natural_size;
+    }
+
     int frame_duration(size_t frame_index) const;
     size_t frame_count() const
     {
@@ -43,16 +56,38 @@ public:
 
     void update_volatility();
 
+    bool has_decoded_frames() const { return !m_decoded_frames.is_empty(); }
+
+    static size_t decoded_image_memory_usage();
+    static size_t decoded_image_memory_budget();
+    static void set_decoded_image_memory_budget(size_t);
+
 private:
     explicit ImageResource(LoadRequest const&);
     explicit ImageResource(Resource&);
 
     void decode_if_needed() const;
+    void discard_decoded_frames() const;
+    void did_use_decoded_frames() const;
+    bool is_visible_in_viewport() const;
+    Optional<Gfx::IntSize> ideal_decoded_size() const;
+    bool decoded_frames_are_large_enough() const;
+
+    static void enforce_decoded_image_memory_budget(ImageResource const* resource_to_keep);
 
     mutable bool m_animated { false };
     mutable int m_loop_count { 0 };
     mutable Vector<Frame> m_decoded_frames;
     mutable bool m_has_attempted_decode { false };
+    mutable Gfx::IntSize m_natural_size;
+    mutable size_t m_decoded_size_in_bytes { 0 };
+    mutable bool m_needs_natural_size_bitmaps { false };
+
+    mutable IntrusiveListNode<ImageResource> m_decoded_image_list_node;
+
+public:
+    // Images with decoded frames, least recently used first.
+    using DecodedImageList = IntrusiveList<&ImageResource::m_decoded_image_list_node>;
 };
 
 class ImageResourceClient : public ResourceClient {
@@ -61,6 +96,10 @@ public:
 
     virtual bool is_visible_in_viewport() const { return false; }
 
+    // The size the image is being displayed at, if known. If every client knows it, the image is decoded at that size
+    // rather than its natural size.
+    virtual Optional<Gfx::IntSize> displayed_size() const { return {}; }
+
 protected:
     ImageResource* resource() { return static_cast<ImageResource*>(ResourceClient::resource()); }
     ImageResource const* resource() const { return static_cast<ImageResource const*>(ResourceClient::resource()); }
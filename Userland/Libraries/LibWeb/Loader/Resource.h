@@ -45,6 +45,7 @@ public:
     bool has_encoded_data() const { return !m_encoded_data.is_empty(); }
 
     const AK::URL& url() const { return m_request.url(); }
+    LoadRequest const& request() const { return m_request; }
     ByteBuffer const& encoded_data() const { return m_encoded_data; }
 
     HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers() const { return m_response_headers; }
@@ -53,6 +54,7 @@ public:
 
     void register_client(Badge<ResourceClient>, ResourceClient&);
     void unregister_client(Badge<ResourceClient>, ResourceClient&);
+    bool has_clients() const { return !m_clients.is_empty(); }
 
     bool has_encoding() const { return m_encoding.has_value(); }
     Optional<String> const& encoding() const { return m_encoding; }
@@ -283,4 +283,18 @@ void ResourceLoader::evict_from_cache(LoadRequest const& request)
     s_resource_cache.remove(request);
 }
 
+void ResourceLoader::evict_from_cache_if_unused(Resource const& resource)
+{
+    if (resource.has_clients())
+        return;
+
+    // NOTE: The cache may have moved on to another resource for the same request in the meantime.
+    auto it = s_resource_cache.find(resource.request());
+    if (it == s_resource_cache.end() || it->value.ptr() != &resource)
+        return;
+
+    dbgln_if(CACHE_DEBUG, "Removing unused resource {} from cache", resource.url());
+    s_resource_cache.remove(it);
+}
+
 }
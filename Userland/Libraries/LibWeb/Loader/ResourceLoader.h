@@ -50,6 +50,7 @@ public:
 
     void clear_cache();
     void evict_from_cache(LoadRequest const&);
+    void evict_from_cache_if_unused(Resource const&);
 
 private:
     ResourceLoader(NonnullRefPtr<Protocol::RequestClient> protocol_client);
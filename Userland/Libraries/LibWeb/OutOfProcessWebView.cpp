@@ -490,6 +490,12 @@ String OutOfProcessWebView::dump_layout_tree()
     return client().dump_layout_tree();
 }
 
+OutOfProcessWebView::LayoutTimings OutOfProcessWebView::benchmark_layout(u32 iterations)
+{
+    auto response = client().benchmark_layout(iterations);
+    return { response.full_layout_microseconds(), response.incremental_layout_microseconds() };
+}
+
 OrderedHashMap<String, String> OutOfProcessWebView::get_local_storage_entries()
 {
     return client().get_local_storage_entries();
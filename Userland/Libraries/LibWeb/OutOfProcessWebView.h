@@ -52,6 +52,12 @@ public:
 
     String dump_layout_tree();
 
+    struct LayoutTimings {
+        u64 full_layout_microseconds { 0 };
+        u64 incremental_layout_microseconds { 0 };
+    };
+    LayoutTimings benchmark_layout(u32 iterations);
+
     OrderedHashMap<String, String> get_local_storage_entries();
 
     void set_content_filters(Vector<String>);
@@ -22,7 +22,24 @@ void ConnectionFromClient::die()
     Core::EventLoop::current().quit(0);
 }
 
-Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer)
+static NonnullRefPtr<Gfx::Bitmap> scale_down_to_ideal_size(NonnullRefPtr<Gfx::Bitmap> bitmap, Optional<Gfx::IntSize> const& ideal_size)
+{
+    if (!ideal_size.has_value() || ideal_size->is_empty())
+        return bitmap;
+    if (ideal_size->width() >= bitmap->width() && ideal_size->height() >= bitmap->height())
+        return bitmap;
+
+    // Keep the aspect ratio, so that the client can still scale the result to any size it likes.
+    auto scale = max(static_cast<float>(ideal_size->width()) / bitmap->width(), static_cast<float>(ideal_size->height()) / bitmap->height());
+    auto scaled_bitmap_or_error = bitmap->scaled(scale, scale);
+    if (scaled_bitmap_or_error.is_error()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Could not scale decoded image down to {}", *ideal_size);
+        return bitmap;
+    }
+    return scaled_bitmap_or_error.release_value();
+}
+
+Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer, Optional<Gfx::IntSize> const& ideal_size)
 {
     if (!encoded_buffer.is_valid()) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
@@ -50,7 +67,7 @@ Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_i
             durations.append(0);
         } else {
             auto frame = frame_or_error.release_value();
-            bitmaps.append(frame.image->to_shareable_bitmap());
+            bitmaps.append(scale_down_to_ideal_size(*frame.image, ideal_size)->to_shareable_bitmap());
             durations.append(frame.duration);
         }
     }
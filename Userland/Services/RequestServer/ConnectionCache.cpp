@@ -13,6 +13,9 @@ namespace RequestServer::ConnectionCache {
 
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket, Core::Stream::Socket>>>> g_tcp_connection_cache {};
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache {};
+Statistics g_statistics {};
+size_t g_max_concurrent_connections_per_host { DefaultMaxConcurrentConnectionsPerHost };
+size_t g_connection_keep_alive_time_milliseconds { DefaultConnectionKeepAliveTimeMilliseconds };
 
 void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
 {
@@ -37,12 +40,14 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
         }
 
         auto& connection = *connection_it;
+        ++connection->completed_requests;
         if (connection->request_queue.is_empty()) {
             Core::deferred_invoke([&connection, &cache_entry = *it->value, key = it->key, &cache] {
                 connection->socket->set_notifications_enabled(false);
                 connection->has_started = false;
                 connection->current_url = {};
                 connection->job_data = {};
+                connection->idle_timer.start();
                 connection->removal_timer->on_timeout = [ptr = connection.ptr(), &cache_entry, key = move(key), &cache]() mutable {
                     Core::deferred_invoke([&, key = move(key), ptr] {
                         dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket);
@@ -65,6 +70,7 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
                 connection->timer.start();
                 connection->current_url = url;
                 connection->job_data = connection->request_queue.take_first();
+                g_statistics.did_dequeue(connection->job_data.queue_timer);
                 connection->socket->set_notifications_enabled(true);
                 connection->job_data.start(*connection->socket);
             });
@@ -85,24 +91,28 @@ void dump_jobs()
     for (auto& connection : g_tls_connection_cache) {
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
-            dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            dbgln("  - Connection {} (started={}) (socket={}) (completed={})", &entry, entry.has_started, entry.socket, entry.completed_requests);
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
-                dbgln("    - {}", &job);
+                dbgln("    - {} ({} waiting)", &job, job.queue_timer.elapsed());
         }
     }
     dbgln("=========== TCP Connection Cache ==========");
     for (auto& connection : g_tcp_connection_cache) {
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
-            dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            dbgln("  - Connection {} (started={}) (socket={}) (completed={})", &entry, entry.has_started, entry.socket, entry.completed_requests);
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
-                dbgln("    - {}", &job);
+                dbgln("    - {} ({} waiting)", &job, job.queue_timer.elapsed());
         }
     }
+    dbgln("=========== Connection Statistics ==========");
+    auto total_connections_used = g_statistics.connections_created + g_statistics.connections_reopened + g_statistics.connections_reused;
+    dbgln(" - Connections created: {}, reopened: {}, reused: {} ({}% reuse rate)", g_statistics.connections_created, g_statistics.connections_reopened, g_statistics.connections_reused, total_connections_used ? g_statistics.connections_reused * 100 / total_connections_used : 0);
+    dbgln(" - Requests queued: {}, total wait: {}ms, max wait: {}ms", g_statistics.requests_queued, g_statistics.total_queue_wait_milliseconds, g_statistics.max_queue_wait_milliseconds);
 }
 
 }
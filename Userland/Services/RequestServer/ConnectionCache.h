@@ -41,9 +41,9 @@ struct Proxy {
             return TRY(SocketType::connect(url.host(), url.port_or_default(), forward<Args>(args)...));
         }
         if (data.type == Core::ProxyData::SOCKS5) {
-            if constexpr (requires { SocketType::connect(declval<String>(), *proxy_client_storage, forward<Args>(args)...); }) {
+            if constexpr (requires { SocketType::connect(declval<String>(), declval<u16>(), *proxy_client_storage, forward<Args>(args)...); }) {
                 proxy_client_storage = TRY(Core::SOCKSProxyClient::connect(data.host_ipv4, data.port, Core::SOCKSProxyClient::Version::V5, url.host(), url.port_or_default()));
-                return TRY(SocketType::connect(url.host(), *proxy_client_storage, forward<Args>(args)...));
+                return TRY(SocketType::connect(url.host(), url.port_or_default(), *proxy_client_storage, forward<Args>(args)...));
             } else if constexpr (IsSame<SocketType, Core::Stream::TCPSocket>) {
                 return TRY(Core::SOCKSProxyClient::connect(data.host_ipv4, data.port, Core::SOCKSProxyClient::Version::V5, url.host(), url.port_or_default()));
             } else {
@@ -60,6 +60,7 @@ struct Connection {
         Function<void(Core::Stream::Socket&)> start {};
         Function<void(Core::NetworkJob::Error)> fail {};
         Function<Vector<TLS::Certificate>()> provide_client_certificates {};
+        Core::ElapsedTimer queue_timer {};
 
         template<typename T>
         static JobData create(T& job)
@@ -83,6 +84,7 @@ struct Connection {
                     }
                     return Vector<TLS::Certificate> {};
                 },
+                .queue_timer = Core::ElapsedTimer::start_new(),
             };
             // clang-format on
         }
@@ -97,6 +99,8 @@ struct Connection {
     bool has_started { false };
     URL current_url {};
     Core::ElapsedTimer timer {};
+    Core::ElapsedTimer idle_timer {};
+    size_t completed_requests { 0 };
     JobData job_data {};
     Proxy proxy {};
 };
@@ -124,11 +128,34 @@ namespace RequestServer::ConnectionCache {
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket, Core::Stream::Socket>>>> g_tcp_connection_cache;
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache;
 
+struct Statistics {
+    size_t connections_created { 0 };
+    size_t connections_reused { 0 };
+    size_t connections_reopened { 0 };
+    size_t requests_queued { 0 };
+    u64 total_queue_wait_milliseconds { 0 };
+    u64 max_queue_wait_milliseconds { 0 };
+
+    void did_dequeue(Core::ElapsedTimer const& queue_timer)
+    {
+        if (!queue_timer.is_valid())
+            return;
+        u64 waited = queue_timer.elapsed();
+        total_queue_wait_milliseconds += waited;
+        max_queue_wait_milliseconds = max(max_queue_wait_milliseconds, waited);
+    }
+};
+
+extern Statistics g_statistics;
+
 void request_did_finish(URL const&, Core::Stream::Socket const*);
 void dump_jobs();
 
-constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
-constexpr static size_t ConnectionKeepAliveTimeMilliseconds = 10'000;
+constexpr static size_t DefaultMaxConcurrentConnectionsPerHost = 6;
+constexpr static size_t DefaultConnectionKeepAliveTimeMilliseconds = 10'000;
+
+extern size_t g_max_concurrent_connections_per_host;
+extern size_t g_connection_keep_alive_time_milliseconds;
 
 template<typename T>
 ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
@@ -179,10 +206,29 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
     Proxy proxy { proxy_data };
 
     using ReturnType = decltype(&sockets_for_url[0]);
-    auto it = sockets_for_url.find_if([](auto& connection) { return connection->request_queue.is_empty(); });
+
+    // Prefer an idle connection whose socket is still open, picking the one that went idle most recently
+    // (it's the least likely to have been closed by the server), then any idle connection at all.
+    Optional<size_t> idle_index;
+    auto idle_index_is_warm = false;
+    for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
+        auto& connection = *it;
+        if (connection.has_started || !connection.request_queue.is_empty())
+            continue;
+        auto is_warm = connection.socket->is_open() && !connection.socket->is_eof();
+        if (idle_index.has_value()) {
+            auto& current = sockets_for_url[*idle_index];
+            if (idle_index_is_warm && !is_warm)
+                continue;
+            if (idle_index_is_warm == is_warm && current.idle_timer.is_valid() && connection.idle_timer.is_valid() && current.idle_timer.elapsed() <= connection.idle_timer.elapsed())
+                continue;
+        }
+        idle_index = it.index();
+        idle_index_is_warm = is_warm;
+    }
+
     auto did_add_new_connection = false;
-    auto failed_to_find_a_socket = it.is_end();
-    if (failed_to_find_a_socket && sockets_for_url.size() < ConnectionCache::MaxConcurrentConnectionsPerURL) {
+    if (!idle_index.has_value() && sockets_for_url.size() < ConnectionCache::g_max_concurrent_connections_per_host) {
         using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
         auto connection_result = proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
         if (connection_result.is_error()) {
@@ -203,27 +249,31 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
         sockets_for_url.append(make<ConnectionType>(
             socket_result.release_value(),
             typename ConnectionType::QueueType {},
-            Core::Timer::create_single_shot(ConnectionKeepAliveTimeMilliseconds, nullptr)));
+            Core::Timer::create_single_shot(ConnectionCache::g_connection_keep_alive_time_milliseconds, nullptr)));
         sockets_for_url.last().proxy = move(proxy);
         did_add_new_connection = true;
+        ++g_statistics.connections_created;
     }
     size_t index;
-    if (failed_to_find_a_socket) {
-        if (did_add_new_connection) {
-            index = sockets_for_url.size() - 1;
-        } else {
-            // Find the least backed-up connection (based on how many entries are in their request queue).
-            index = 0;
-            auto min_queue_size = (size_t)-1;
-            for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
-                if (auto queue_size = it->request_queue.size(); min_queue_size > queue_size) {
-                    index = it.index();
-                    min_queue_size = queue_size;
-                }
+    if (idle_index.has_value()) {
+        index = *idle_index;
+    } else if (did_add_new_connection) {
+        index = sockets_for_url.size() - 1;
+    } else {
+        // Find the least backed-up connection (based on how many entries are in their request queue).
+        // Ties go to the connection that has been on its current request the longest, as it's the most likely to free up first.
+        index = 0;
+        auto min_queue_size = (size_t)-1;
+        i64 max_elapsed = -1;
+        for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
+            auto queue_size = it->request_queue.size();
+            i64 elapsed = it->timer.is_valid() ? it->timer.elapsed() : 0;
+            if (min_queue_size > queue_size || (min_queue_size == queue_size && elapsed > max_elapsed)) {
+                index = it.index();
+                min_queue_size = queue_size;
+                max_elapsed = elapsed;
             }
         }
-    } else {
-        index = it.index();
     }
     if (sockets_for_url.is_empty()) {
         Core::deferred_invoke([&job] {
@@ -234,6 +284,8 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
 
     auto& connection = sockets_for_url[index];
     if (!connection.has_started) {
+        // Only an idle connection whose socket is still open saves us a connection; one that has to reopen its socket doesn't.
+        auto reuses_open_socket = !did_add_new_connection && connection.socket->is_open() && !connection.socket->is_eof();
         if (auto result = recreate_socket_if_needed(connection, url); result.is_error()) {
             dbgln("ConnectionCache: request failed to start, failed to make a socket: {}", result.error());
             Core::deferred_invoke([&job] {
@@ -241,6 +293,10 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             });
             return ReturnType { nullptr };
         }
+        if (reuses_open_socket)
+            ++g_statistics.connections_reused;
+        else if (!did_add_new_connection)
+            ++g_statistics.connections_reopened;
         dbgln_if(REQUESTSERVER_DEBUG, "Immediately start request for url {} in {} - {}", url, &connection, connection.socket);
         connection.has_started = true;
         connection.removal_timer->stop();
@@ -252,6 +308,7 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
     } else {
         dbgln_if(REQUESTSERVER_DEBUG, "Enqueue request for URL {} in {} - {}", url, &connection, connection.socket);
         connection.request_queue.append(decltype(connection.job_data)::create(job));
+        ++g_statistics.requests_queued;
     }
     return &connection;
 }
@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
+#include <LibCore/System.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <RequestServer/DiskCache.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+DiskCache& DiskCache::the()
+{
+    static DiskCache s_the;
+    return s_the;
+}
+
+static i64 now()
+{
+    return Core::DateTime::now().timestamp();
+}
+
+static Optional<i64> parse_http_date(StringView value)
+{
+    // Only the IMF-fixdate format (e.g. "Sun, 06 Nov 1994 08:49:37 GMT") is supported.
+    // Note: Dates are only ever compared with one another, so it doesn't matter that this is parsed as local time.
+    auto date = Core::DateTime::parse("%a, %d %b %Y %H:%M:%S GMT", value);
+    if (!date.has_value())
+        return {};
+    return date->timestamp();
+}
+
+struct CacheControl {
+    bool no_store { false };
+    bool no_cache { false };
+    Optional<i64> max_age;
+};
+
+static CacheControl parse_cache_control(Optional<String> const& value)
+{
+    CacheControl cache_control;
+    if (!value.has_value())
+        return cache_control;
+
+    for (auto directive : value->split_view(',')) {
+        directive = directive.trim_whitespace();
+        if (directive.equals_ignoring_case("no-store"sv)) {
+            cache_control.no_store = true;
+        } else if (directive.equals_ignoring_case("no-cache"sv) || directive.starts_with("no-cache="sv, CaseSensitivity::CaseInsensitive)) {
+            cache_control.no_cache = true;
+        } else if (directive.starts_with("max-age="sv, CaseSensitivity::CaseInsensitive)) {
+            auto max_age = directive.substring_view(8).trim("\""sv).to_uint<u64>();
+            // A max-age that isn't a valid number makes the response stale.
+            cache_control.max_age = max_age.has_value() ? static_cast<i64>(max_age.value()) : 0;
+        }
+    }
+    return cache_control;
+}
+
+static i64 age_of(DiskCache::Headers const& response_headers)
+{
+    if (auto age = response_headers.get("Age"sv); age.has_value())
+        return static_cast<i64>(age->to_uint<u64>().value_or(0));
+    return 0;
+}
+
+static Optional<String> header_value(HashMap<String, String> const& headers, StringView name)
+{
+    for (auto& it : headers) {
+        if (it.key.equals_ignoring_case(name))
+            return it.value;
+    }
+    return {};
+}
+
+bool DiskCache::Entry::is_fresh() const
+{
+    return now() - stored_at < freshness_lifetime;
+}
+
+bool DiskCache::Entry::can_be_revalidated() const
+{
+    return response_headers.contains("ETag"sv) || response_headers.contains("Last-Modified"sv);
+}
+
+bool DiskCache::is_cacheable_request(String const& method, HashMap<String, String> const& request_headers, ReadonlyBytes body)
+{
+    if (!method.equals_ignoring_case("GET"sv) || !body.is_empty())
+        return false;
+
+    // Leave requests that the client is conditionalizing or partially fetching itself alone.
+    for (auto header : { "Authorization"sv, "Range"sv, "If-None-Match"sv, "If-Modified-Since"sv }) {
+        if (header_value(request_headers, header).has_value())
+            return false;
+    }
+
+    auto cache_control = parse_cache_control(header_value(request_headers, "Cache-Control"sv));
+    return !cache_control.no_store && !cache_control.no_cache;
+}
+
+Optional<i64> DiskCache::freshness_lifetime_for_response(u32 status_code, Headers const& response_headers)
+{
+    if (status_code != 200 && status_code != 203 && status_code != 301)
+        return {};
+
+    auto cache_control = parse_cache_control(response_headers.get("Cache-Control"sv));
+    if (cache_control.no_store)
+        return {};
+
+    // FIXME: Key entries on the request headers named in Vary instead of refusing to store them.
+    if (auto vary = response_headers.get("Vary"sv); vary.has_value()) {
+        for (auto field : vary->split_view(',')) {
+            if (!field.trim_whitespace().equals_ignoring_case("Accept-Encoding"sv))
+                return {};
+        }
+    }
+
+    auto has_validator = response_headers.contains("ETag"sv) || response_headers.contains("Last-Modified"sv);
+
+    if (cache_control.no_cache)
+        return has_validator ? Optional<i64> { 0 } : Optional<i64> {};
+
+    if (cache_control.max_age.has_value())
+        return cache_control.max_age;
+
+    Optional<i64> date;
+    if (auto date_header = response_headers.get("Date"sv); date_header.has_value())
+        date = parse_http_date(*date_header);
+    if (auto expires = response_headers.get("Expires"sv); expires.has_value()) {
+        auto expires_date = parse_http_date(*expires);
+        if (!expires_date.has_value() || !date.has_value())
+            return has_validator ? Optional<i64> { 0 } : Optional<i64> {};
+        return max(*expires_date - *date, 0);
+    }
+
+    // Heuristic freshness, as suggested by RFC 9111 section 4.2.2: 10% of the time since the last modification.
+    if (auto last_modified = response_headers.get("Last-Modified"sv); last_modified.has_value() && date.has_value()) {
+        if (auto last_modified_date = parse_http_date(*last_modified); last_modified_date.has_value())
+            return max((*date - *last_modified_date) / 10, 0);
+    }
+
+    return has_validator ? Optional<i64> { 0 } : Optional<i64> {};
+}
+
+void DiskCache::add_revalidation_headers(Entry const& entry, HashMap<String, String>& request_headers)
+{
+    if (auto etag = entry.response_headers.get("ETag"sv); etag.has_value())
+        request_headers.set("If-None-Match", *etag);
+    if (auto last_modified = entry.response_headers.get("Last-Modified"sv); last_modified.has_value())
+        request_headers.set("If-Modified-Since", *last_modified);
+}
+
+DiskCache::DirectoryLock::DirectoryLock(int fd)
+    : m_fd(fd)
+{
+    m_is_held = m_fd >= 0 && flock(m_fd, LOCK_EX | LOCK_NB) == 0;
+}
+
+DiskCache::DirectoryLock::~DirectoryLock()
+{
+    if (m_is_held)
+        flock(m_fd, LOCK_UN | LOCK_NB);
+}
+
+ErrorOr<void> DiskCache::set_directory(String const& path)
+{
+    auto directory = TRY(Core::Directory::create(path, Core::Directory::CreateDirectories::Yes));
+    auto directory_path = TRY(directory.path()).string();
+    auto lock_fd = TRY(Core::System::open(String::formatted("{}/lock", directory_path), O_RDWR | O_CREAT | O_CLOEXEC, 0600));
+
+    if (m_lock_fd >= 0)
+        (void)Core::System::close(m_lock_fd);
+    m_directory = move(directory_path);
+    m_lock_fd = lock_fd;
+
+    DirectoryLock lock(m_lock_fd);
+    if (lock.is_held())
+        evict_to_fit(lock, 0);
+
+    dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: Using {}", m_directory);
+    return {};
+}
+
+String DiskCache::key_for(URL const& url) const
+{
+    auto digest = Crypto::Hash::SHA1::hash(url.serialize(URL::ExcludeFragment::Yes));
+    return encode_hex(digest.bytes());
+}
+
+String DiskCache::meta_path(String const& key) const
+{
+    return String::formatted("{}/{}.meta", m_directory, key);
+}
+
+String DiskCache::body_path(String const& key) const
+{
+    return String::formatted("{}/{}.body", m_directory, key);
+}
+
+ErrorOr<DiskCache::Entry> DiskCache::read_entry(String const& key) const
+{
+    auto file = TRY(Core::File::open(meta_path(key), Core::OpenMode::ReadOnly));
+    auto json = TRY(JsonValue::from_string(file->read_all()));
+    if (!json.is_object())
+        return Error::from_string_literal("DiskCache: Metadata is not an object");
+
+    auto& object = json.as_object();
+    Entry entry;
+    entry.url = object.get("url"sv).to_string();
+    entry.status_code = object.get("status_code"sv).to_u32();
+    entry.stored_at = object.get("stored_at"sv).to_i64();
+    entry.freshness_lifetime = object.get("freshness_lifetime"sv).to_i64();
+    auto& headers = object.get("response_headers"sv);
+    if (!entry.url.is_valid() || !headers.is_object())
+        return Error::from_string_literal("DiskCache: Malformed metadata");
+    headers.as_object().for_each_member([&](auto& name, auto& value) {
+        entry.response_headers.set(name, value.to_string());
+    });
+    return entry;
+}
+
+static String serialize_entry(DiskCache::Entry const& entry)
+{
+    JsonObject headers;
+    for (auto& it : entry.response_headers)
+        headers.set(it.key, it.value);
+
+    JsonObject object;
+    object.set("url", entry.url.serialize(URL::ExcludeFragment::Yes));
+    object.set("status_code", entry.status_code);
+    object.set("stored_at", entry.stored_at);
+    object.set("freshness_lifetime", entry.freshness_lifetime);
+    object.set("response_headers", move(headers));
+    return object.to_string();
+}
+
+ErrorOr<void> DiskCache::write_entry(DirectoryLock const& lock, String const& key, Entry const& entry) const
+{
+    return write_file(lock, meta_path(key), serialize_entry(entry).bytes());
+}
+
+ErrorOr<void> DiskCache::write_file(DirectoryLock const&, String const& path, ReadonlyBytes bytes) const
+{
+    // Write to a temporary file first, so a reader never sees a half-written file.
+    auto temporary_path = String::formatted("{}.{}.tmp", path, getpid());
+    auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate));
+    if (!file->write_or_error(bytes)) {
+        file->close();
+        (void)Core::System::unlink(temporary_path);
+        return Error::from_string_literal("DiskCache: Failed to write file");
+    }
+    file->close();
+    if (auto result = Core::System::rename(temporary_path, path); result.is_error()) {
+        (void)Core::System::unlink(temporary_path);
+        return result.release_error();
+    }
+    return {};
+}
+
+void DiskCache::touch(String const& key)
+{
+    // The modification time of the body is the last time the entry was used, by any instance.
+    (void)Core::System::utime(body_path(key), {});
+}
+
+void DiskCache::remove_key(DirectoryLock const&, String const& key)
+{
+    // Removing the body first makes the entry disappear at once, the metadata is only of use next to a body.
+    (void)Core::System::unlink(body_path(key));
+    (void)Core::System::unlink(meta_path(key));
+}
+
+Vector<DiskCache::DiskEntry> DiskCache::scan_directory(DirectoryLock const&)
+{
+    Vector<DiskEntry> entries;
+    Vector<String> leftover_paths;
+
+    Core::DirIterator iterator(m_directory, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto name = iterator.next_path();
+
+        // Nobody else is writing to the directory while we hold the lock, so any temporary file is left over from a crash.
+        if (name.ends_with(".tmp"sv)) {
+            leftover_paths.append(String::formatted("{}/{}", m_directory, name));
+            continue;
+        }
+
+        if (name.ends_with(".meta"sv)) {
+            // Metadata without a body belongs to an entry that was never finished or is being removed.
+            auto key = name.substring(0, name.length() - 5);
+            if (Core::System::stat(body_path(key)).is_error())
+                leftover_paths.append(meta_path(key));
+            continue;
+        }
+
+        if (!name.ends_with(".body"sv))
+            continue;
+        auto key = name.substring(0, name.length() - 5);
+        auto body_stat_or_error = Core::System::stat(body_path(key));
+        if (body_stat_or_error.is_error())
+            continue;
+        auto meta_stat_or_error = Core::System::stat(meta_path(key));
+        if (meta_stat_or_error.is_error()) {
+            leftover_paths.append(body_path(key));
+            continue;
+        }
+
+        auto size = static_cast<u64>(body_stat_or_error.value().st_size) + static_cast<u64>(meta_stat_or_error.value().st_size);
+        entries.append({ move(key), size, body_stat_or_error.value().st_mtime });
+    }
+
+    for (auto& path : leftover_paths) {
+        dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: Removing leftover file {}", path);
+        (void)Core::System::unlink(path);
+    }
+    return entries;
+}
+
+void DiskCache::evict_to_fit(DirectoryLock const& lock, u64 incoming_size)
+{
+    // Other instances store entries in the same directory, so the only reliable size of the cache is the one on disk.
+    auto entries = scan_directory(lock);
+    u64 total_size = 0;
+    for (auto& entry : entries)
+        total_size += entry.size;
+
+    dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: {} has {} entries ({} bytes)", m_directory, entries.size(), total_size);
+    if (total_size + incoming_size <= m_maximum_size)
+        return;
+
+    quick_sort(entries, [](auto& a, auto& b) { return a.last_access < b.last_access; });
+    for (auto& entry : entries) {
+        if (total_size + incoming_size <= m_maximum_size)
+            break;
+        dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: Evicting {} ({} bytes)", entry.key, entry.size);
+        remove_key(lock, entry.key);
+        total_size -= entry.size;
+    }
+}
+
+Optional<DiskCache::Entry> DiskCache::lookup(URL const& url)
+{
+    if (!is_enabled())
+        return {};
+
+    // An entry only exists once its body is in place, its metadata alone may still be in the middle of being stored.
+    auto key = key_for(url);
+    if (Core::System::stat(body_path(key)).is_error())
+        return {};
+
+    auto entry_or_error = read_entry(key);
+    if (entry_or_error.is_error() || entry_or_error.value().url.serialize(URL::ExcludeFragment::Yes) != url.serialize(URL::ExcludeFragment::Yes)) {
+        dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: Dropping unusable entry for {}", url);
+        DirectoryLock lock(m_lock_fd);
+        if (lock.is_held())
+            remove_key(lock, key);
+        return {};
+    }
+
+    touch(key);
+    return entry_or_error.release_value();
+}
+
+ErrorOr<RefPtr<Core::MappedFile>> DiskCache::open_body(URL const& url)
+{
+    auto path = body_path(key_for(url));
+    auto stat = TRY(Core::System::stat(path));
+    if (stat.st_size == 0)
+        return RefPtr<Core::MappedFile> {};
+    return TRY(Core::MappedFile::map(path));
+}
+
+ErrorOr<void> DiskCache::store(URL const& url, u32 status_code, Headers const& response_headers, ReadonlyBytes body)
+{
+    if (!is_enabled() || body.size() > MaximumEntrySize || body.size() > m_maximum_size)
+        return {};
+
+    auto freshness_lifetime = freshness_lifetime_for_response(status_code, response_headers);
+    if (!freshness_lifetime.has_value())
+        return {};
+
+    DirectoryLock lock(m_lock_fd);
+    if (!lock.is_held()) {
+        dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: Not storing {}, the cache is busy", url);
+        return {};
+    }
+
+    Entry entry;
+    entry.url = url;
+    entry.status_code = status_code;
+    for (auto& it : response_headers) {
+        // Hop-by-hop headers only describe the connection the response arrived on.
+        if (it.key.equals_ignoring_case("Connection"sv) || it.key.equals_ignoring_case("Keep-Alive"sv) || it.key.equals_ignoring_case("Transfer-Encoding"sv))
+            continue;
+        entry.response_headers.set(it.key, it.value);
+    }
+    entry.stored_at = now() - age_of(response_headers);
+    entry.freshness_lifetime = *freshness_lifetime;
+    auto metadata = serialize_entry(entry);
+
+    auto key = key_for(url);
+    remove_key(lock, key);
+    evict_to_fit(lock, metadata.length() + body.size());
+
+    // The metadata has to be in place before the body, as the body appearing is what makes the entry visible.
+    TRY(write_file(lock, meta_path(key), metadata.bytes()));
+    if (auto result = write_file(lock, body_path(key), body); result.is_error()) {
+        remove_key(lock, key);
+        return result.release_error();
+    }
+
+    dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: Stored {} ({} bytes, fresh for {}s)", url, body.size(), entry.freshness_lifetime);
+    return {};
+}
+
+ErrorOr<DiskCache::Entry> DiskCache::update_after_revalidation(Entry const& entry, Headers const& not_modified_headers)
+{
+    Entry updated_entry = entry;
+    for (auto& it : not_modified_headers) {
+        // These describe the (empty) 304 response itself, not the stored representation.
+        if (it.key.equals_ignoring_case("Content-Length"sv) || it.key.equals_ignoring_case("Content-Encoding"sv) || it.key.equals_ignoring_case("Transfer-Encoding"sv))
+            continue;
+        updated_entry.response_headers.set(it.key, it.value);
+    }
+
+    auto freshness_lifetime = freshness_lifetime_for_response(updated_entry.status_code, updated_entry.response_headers);
+    if (!freshness_lifetime.has_value()) {
+        remove(entry.url);
+        return updated_entry;
+    }
+
+    updated_entry.stored_at = now() - age_of(not_modified_headers);
+    updated_entry.freshness_lifetime = *freshness_lifetime;
+
+    DirectoryLock lock(m_lock_fd);
+    if (!lock.is_held())
+        return updated_entry;
+
+    auto key = key_for(entry.url);
+    TRY(write_entry(lock, key, updated_entry));
+    touch(key);
+    return updated_entry;
+}
+
+void DiskCache::remove(URL const& url)
+{
+    if (!is_enabled())
+        return;
+
+    DirectoryLock lock(m_lock_fd);
+    if (!lock.is_held()) {
+        dbgln_if(REQUESTSERVER_DEBUG, "DiskCache: Not removing {}, the cache is busy", url);
+        return;
+    }
+    remove_key(lock, key_for(url));
+}
+
+ErrorOr<size_t> DiskCacheWriter::write(ReadonlyBytes bytes)
+{
+    auto written = TRY(m_target.write(bytes));
+    if (m_overflowed)
+        return written;
+
+    if (m_body.size() + written > DiskCache::MaximumEntrySize || m_body.try_append(bytes.trim(written)).is_error()) {
+        m_overflowed = true;
+        m_body.clear();
+    }
+    return written;
+}
+
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
+
+namespace RequestServer {
+
+// A persistent HTTP response cache, loosely following RFC 9111.
+// Every entry is stored as two files in the cache directory: `<key>.meta` holds the URL, status code,
+// response headers and freshness information as JSON, and `<key>.body` holds the raw (decoded) response body,
+// which is memory-mapped when the entry is served.
+// The directory is shared by all RequestServer instances. An entry only exists once its body is in place,
+// which always happens after its metadata has been written, and the size of the cache is based on what's
+// actually on disk rather than what this instance stored.
+class DiskCache {
+public:
+    static DiskCache& the();
+
+    static constexpr u64 DefaultMaximumSize = 64 * MiB;
+    static constexpr u64 MaximumEntrySize = 8 * MiB;
+
+    using Headers = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+    struct Entry {
+        URL url;
+        u32 status_code { 0 };
+        Headers response_headers;
+        i64 stored_at { 0 };
+        i64 freshness_lifetime { 0 };
+
+        bool is_fresh() const;
+        bool can_be_revalidated() const;
+    };
+
+    ErrorOr<void> set_directory(String const& path);
+    void set_maximum_size(u64 maximum_size) { m_maximum_size = maximum_size; }
+    bool is_enabled() const { return !m_directory.is_null(); }
+
+    static bool is_cacheable_request(String const& method, HashMap<String, String> const& request_headers, ReadonlyBytes body);
+    static Optional<i64> freshness_lifetime_for_response(u32 status_code, Headers const& response_headers);
+    static void add_revalidation_headers(Entry const&, HashMap<String, String>& request_headers);
+
+    Optional<Entry> lookup(URL const&);
+    ErrorOr<RefPtr<Core::MappedFile>> open_body(URL const&);
+
+    ErrorOr<void> store(URL const&, u32 status_code, Headers const& response_headers, ReadonlyBytes body);
+    ErrorOr<Entry> update_after_revalidation(Entry const&, Headers const& not_modified_headers);
+    void remove(URL const&);
+
+private:
+    DiskCache() = default;
+
+    // Everything that writes files into the cache directory holds this lock, as that's what makes it safe to
+    // clean up leftover temporary files and to evict entries stored by other instances.
+    // Taking the lock never blocks: if another instance is busy with the cache, we skip writing to it instead.
+    class DirectoryLock {
+        AK_MAKE_NONCOPYABLE(DirectoryLock);
+        AK_MAKE_NONMOVABLE(DirectoryLock);
+
+    public:
+        explicit DirectoryLock(int fd);
+        ~DirectoryLock();
+
+        bool is_held() const { return m_is_held; }
+
+    private:
+        int m_fd { -1 };
+        bool m_is_held { false };
+    };
+
+    struct DiskEntry {
+        String key;
+        u64 size { 0 };
+        i64 last_access { 0 };
+    };
+
+    String key_for(URL const&) const;
+    String meta_path(String const& key) const;
+    String body_path(String const& key) const;
+
+    ErrorOr<Entry> read_entry(String const& key) const;
+    ErrorOr<void> write_entry(DirectoryLock const&, String const& key, Entry const&) const;
+    ErrorOr<void> write_file(DirectoryLock const&, String const& path, ReadonlyBytes) const;
+    void remove_key(DirectoryLock const&, String const& key);
+    void touch(String const& key);
+    Vector<DiskEntry> scan_directory(DirectoryLock const&);
+    void evict_to_fit(DirectoryLock const&, u64 incoming_size);
+
+    String m_directory;
+    int m_lock_fd { -1 };
+    u64 m_maximum_size { DefaultMaximumSize };
+};
+
+// Forwards everything written to it to the request's output stream, keeping a copy of what was
+// actually written so the complete response body can be stored in the DiskCache once the job is done.
+class DiskCacheWriter final : public Core::Stream::Stream {
+public:
+    explicit DiskCacheWriter(Core::Stream::Stream& target)
+        : m_target(target)
+    {
+    }
+
+    virtual ErrorOr<size_t> read(Bytes) override { return Error::from_errno(EBADF); }
+    virtual bool is_writable() const override { return m_target.is_writable(); }
+    virtual ErrorOr<size_t> write(ReadonlyBytes) override;
+    virtual bool is_eof() const override { return m_target.is_eof(); }
+    virtual bool is_open() const override { return m_target.is_open(); }
+    virtual void close() override { m_target.close(); }
+
+    bool has_complete_body() const { return !m_overflowed; }
+    ReadonlyBytes body() const { return m_body.bytes(); }
+
+private:
+    Core::Stream::Stream& m_target;
+    ByteBuffer m_body;
+    bool m_overflowed { false };
+};
+
+}
@@ -14,8 +14,10 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ConnectionCache.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/DiskCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer::Detail {
@@ -24,6 +26,11 @@ template<typename TSelf, typename TJob>
 void init(TSelf* self, TJob job)
 {
     job->on_headers_received = [self](auto& headers, auto response_code) {
+        // Our stored copy is still good, the client gets that instead once the (empty) 304 response is done.
+        if (response_code.has_value() && response_code.value() == 304 && self->cache_entry_for_revalidation().has_value()) {
+            self->set_was_revalidated();
+            return;
+        }
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
@@ -33,10 +40,30 @@ void init(TSelf* self, TJob job)
         Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
             ConnectionCache::request_did_finish(url, socket);
         });
+        if (self->was_revalidated()) {
+            auto& cache = DiskCache::the();
+            auto& entry = *self->cache_entry_for_revalidation();
+            auto body_or_error = cache.open_body(entry.url);
+            if (!body_or_error.is_error()) {
+                auto* response = self->job().response();
+                auto updated_entry_or_error = cache.update_after_revalidation(entry, response ? response->headers() : DiskCache::Headers {});
+                self->send_cached_response(updated_entry_or_error.is_error() ? entry : updated_entry_or_error.value(), body_or_error.release_value());
+                return;
+            }
+            dbgln("Revalidated {}, but its cached body is gone: {}", entry.url, body_or_error.error());
+            self->did_progress(0, 0);
+            self->did_finish(false);
+            return;
+        }
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
             self->set_downloaded_size(response->downloaded_size());
+
+            if (auto* cache_writer = self->cache_writer(); success && cache_writer && cache_writer->has_complete_body()) {
+                if (auto result = DiskCache::the().store(self->job().url(), response->code(), response->headers(), cache_writer->body()); result.is_error())
+                    dbgln("Failed to store {} in the disk cache: {}", self->job().url(), result.error());
+            }
         }
 
         // if we didn't know the total size, pretend that the request finished successfully
@@ -70,13 +97,34 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
         return {};
     }
 
+    auto& disk_cache = DiskCache::the();
+    auto is_cacheable = disk_cache.is_enabled() && DiskCache::is_cacheable_request(method, headers, body);
+    auto cached_entry = is_cacheable ? disk_cache.lookup(url) : Optional<DiskCache::Entry> {};
+
+    if (cached_entry.has_value() && cached_entry->is_fresh()) {
+        if (auto body_or_error = disk_cache.open_body(url); !body_or_error.is_error()) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Serving {} from the disk cache", url);
+            auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
+            auto cached_request = CachedRequest::create(client, url, move(output_stream));
+            cached_request->set_request_fd(pipe_result.value().read_fd);
+            cached_request->send_cached_response(*cached_entry, body_or_error.release_value());
+            return cached_request;
+        }
+    }
+
     HTTP::HttpRequest request;
     if (method.equals_ignoring_case("post"))
         request.set_method(HTTP::HttpRequest::Method::POST);
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+    if (cached_entry.has_value() && cached_entry->can_be_revalidated()) {
+        auto revalidation_headers = headers;
+        DiskCache::add_revalidation_headers(*cached_entry, revalidation_headers);
+        request.set_headers(revalidation_headers);
+    } else {
+        request.set_headers(headers);
+    }
 
     auto allocated_body_result = ByteBuffer::copy(body);
     if (allocated_body_result.is_error())
@@ -84,9 +132,15 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     request.set_body(allocated_body_result.release_value());
 
     auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
-    auto job = TJob::construct(move(request), *output_stream);
+    OwnPtr<DiskCacheWriter> cache_writer;
+    if (is_cacheable)
+        cache_writer = make<DiskCacheWriter>(*output_stream);
+    auto job = TJob::construct(move(request), cache_writer ? static_cast<Core::Stream::Stream&>(*cache_writer) : *output_stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     protocol_request->set_request_fd(pipe_result.value().read_fd);
+    protocol_request->set_cache_writer(move(cache_writer));
+    if (cached_entry.has_value() && cached_entry->can_be_revalidated())
+        protocol_request->set_cache_entry_for_revalidation(cached_entry.release_value());
 
     if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
         ConnectionCache::get_or_create_connection(ConnectionCache::g_tls_connection_cache, url, *job, proxy_data);
@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/EventLoop.h>
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/Request.h>
+#include <errno.h>
 
 namespace RequestServer {
 
@@ -51,4 +53,54 @@ void Request::did_request_certificates()
     m_client.did_request_certificates({}, *this);
 }
 
+void Request::send_cached_response(DiskCache::Entry const& entry, RefPtr<Core::MappedFile> body)
+{
+    m_cached_body = move(body);
+    m_cached_body_offset = 0;
+
+    // The client only learns about this request once start_request() returns, so defer sending anything until then.
+    m_cached_body_timer = Core::Timer::create_single_shot(0, [this, status_code = entry.status_code, headers = entry.response_headers] {
+        if (!m_has_sent_cached_headers) {
+            m_has_sent_cached_headers = true;
+            set_status_code(status_code);
+            set_response_headers(headers);
+        }
+        write_cached_body();
+    });
+    m_has_sent_cached_headers = false;
+    m_cached_body_timer->start();
+}
+
+void Request::write_cached_body()
+{
+    auto total_size = m_cached_body ? m_cached_body->size() : 0;
+    while (m_cached_body_offset < total_size) {
+        auto result = m_output_stream->write(m_cached_body->bytes().slice(m_cached_body_offset));
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            if (result.error().is_errno() && result.error().code() == EAGAIN) {
+                // The client hasn't drained the pipe yet, try again in a bit.
+                m_cached_body_timer->restart(50);
+                return;
+            }
+            dbgln("Request: Failed to write cached body for {}: {}", url(), result.error());
+            Core::deferred_invoke([weak_this = make_weak_ptr()]() mutable {
+                if (weak_this)
+                    weak_this->did_finish(false);
+            });
+            return;
+        }
+        m_cached_body_offset += result.value();
+    }
+
+    Core::deferred_invoke([weak_this = make_weak_ptr(), total_size]() mutable {
+        if (!weak_this)
+            return;
+        weak_this->set_downloaded_size(total_size);
+        weak_this->did_progress(total_size, total_size);
+        weak_this->did_finish(true);
+    });
+}
+
 }
@@ -12,11 +12,14 @@
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
+#include <AK/Weakable.h>
+#include <LibCore/Timer.h>
+#include <RequestServer/DiskCache.h>
 #include <RequestServer/Forward.h>
 
 namespace RequestServer {
 
-class Request {
+class Request : public Weakable<Request> {
 public:
     virtual ~Request() = default;
 
@@ -43,6 +46,17 @@ public:
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     Core::Stream::File const& output_stream() const { return *m_output_stream; }
 
+    void set_cache_writer(OwnPtr<DiskCacheWriter> writer) { m_cache_writer = move(writer); }
+    DiskCacheWriter* cache_writer() { return m_cache_writer.ptr(); }
+
+    void set_cache_entry_for_revalidation(DiskCache::Entry entry) { m_cache_entry_for_revalidation = move(entry); }
+    Optional<DiskCache::Entry> const& cache_entry_for_revalidation() const { return m_cache_entry_for_revalidation; }
+    bool was_revalidated() const { return m_was_revalidated; }
+    void set_was_revalidated() { m_was_revalidated = true; }
+
+    // Replays a stored response to the client, writing the body to the request pipe as the client drains it.
+    void send_cached_response(DiskCache::Entry const&, RefPtr<Core::MappedFile> body);
+
 protected:
     explicit Request(ConnectionFromClient&, NonnullOwnPtr<Core::Stream::File>&&);
 
@@ -55,6 +69,16 @@ private:
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<Core::Stream::File> m_output_stream;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
+
+    void write_cached_body();
+
+    OwnPtr<DiskCacheWriter> m_cache_writer;
+    Optional<DiskCache::Entry> m_cache_entry_for_revalidation;
+    bool m_was_revalidated { false };
+    RefPtr<Core::MappedFile> m_cached_body;
+    size_t m_cached_body_offset { 0 };
+    bool m_has_sent_cached_headers { false };
+    RefPtr<Core::Timer> m_cached_body_timer;
 };
 
 }
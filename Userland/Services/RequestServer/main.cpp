@@ -5,28 +5,59 @@
  */
 
 #include <AK/OwnPtr.h>
+#include <LibCore/ArgsParser.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/StandardPaths.h>
 #include <LibCore/System.h>
 #include <LibIPC/SingleServer.h>
 #include <LibMain/Main.h>
 #include <LibTLS/Certificate.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/DiskCache.h>
 #include <RequestServer/GeminiProtocol.h>
 #include <RequestServer/HttpProtocol.h>
 #include <RequestServer/HttpsProtocol.h>
 #include <signal.h>
 
-ErrorOr<int> serenity_main(Main::Arguments)
+ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    if constexpr (TLS_SSL_KEYLOG_DEBUG)
-        TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd sigaction"));
-    else
+    TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath fattr sendfd recvfd sigaction"));
+
+    unsigned max_connections_per_host = RequestServer::ConnectionCache::DefaultMaxConcurrentConnectionsPerHost;
+    unsigned keep_alive_timeout = RequestServer::ConnectionCache::DefaultConnectionKeepAliveTimeMilliseconds;
+    String cache_directory = String::formatted("{}/.cache/RequestServer", Core::StandardPaths::home_directory());
+    unsigned cache_size_in_mib = RequestServer::DiskCache::DefaultMaximumSize / MiB;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(max_connections_per_host, "Maximum number of concurrent connections per host", "max-connections-per-host", 'c', "count");
+    args_parser.add_option(keep_alive_timeout, "Time to keep idle connections open, in milliseconds", "keep-alive-timeout", 't', "ms");
+    args_parser.add_option(cache_directory, "Directory to keep the HTTP cache in", "cache-directory", 0, "path");
+    args_parser.add_option(cache_size_in_mib, "Maximum size of the HTTP cache in MiB, 0 disables it", "cache-size", 0, "size");
+    args_parser.parse(arguments);
+
+    // Only the disk cache (and the TLS key log) create and write files, so drop those promises when it's disabled.
+    if (cache_size_in_mib == 0 && !TLS_SSL_KEYLOG_DEBUG)
         TRY(Core::System::pledge("stdio inet accept unix rpath sendfd recvfd sigaction"));
 
+    RequestServer::ConnectionCache::g_max_concurrent_connections_per_host = max(1u, max_connections_per_host);
+    RequestServer::ConnectionCache::g_connection_keep_alive_time_milliseconds = keep_alive_timeout;
+
+    auto has_disk_cache = false;
+    if (cache_size_in_mib > 0) {
+        auto& disk_cache = RequestServer::DiskCache::the();
+        disk_cache.set_maximum_size(static_cast<u64>(cache_size_in_mib) * MiB);
+        if (auto result = disk_cache.set_directory(cache_directory); result.is_error())
+            dbgln("RequestServer: Unable to use {} as the HTTP cache directory: {}", cache_directory, result.error());
+        else
+            has_disk_cache = true;
+    }
+
     signal(SIGINFO, [](int) { RequestServer::ConnectionCache::dump_jobs(); });
 
-    if constexpr (TLS_SSL_KEYLOG_DEBUG)
+    if (has_disk_cache)
+        TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath fattr sendfd recvfd"));
+    else if constexpr (TLS_SSL_KEYLOG_DEBUG)
         TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd"));
     else
         TRY(Core::System::pledge("stdio inet accept unix rpath sendfd recvfd"));
@@ -38,6 +69,8 @@ ErrorOr<int> serenity_main(Main::Arguments)
     // FIXME: Establish a connection to LookupServer and then drop "unix"?
     TRY(Core::System::unveil("/tmp/portal/lookup", "rw"));
     TRY(Core::System::unveil("/etc/timezone", "r"));
+    if (has_disk_cache)
+        TRY(Core::System::unveil(cache_directory, "rwc"));
     if constexpr (TLS_SSL_KEYLOG_DEBUG)
         TRY(Core::System::unveil("/home/anon", "rwc"));
     TRY(Core::System::unveil(nullptr, nullptr));
@@ -8,6 +8,7 @@
 #include <AK/Debug.h>
 #include <AK/JsonObject.h>
 #include <AK/QuickSort.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibGfx/SystemTheme.h>
@@ -24,6 +25,7 @@
 #include <LibWeb/HTML/Storage.h>
 #include <LibWeb/HTML/Window.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
+#include <LibWeb/Layout/TextNode.h>
 #include <LibWeb/Loader/ContentFilter.h>
 #include <LibWeb/Loader/ProxyMappings.h>
 #include <LibWeb/Loader/ResourceLoader.h>
@@ -450,6 +452,38 @@ Messages::WebContentServer::DumpLayoutTreeResponse ConnectionFromClient::dump_la
     return builder.to_string();
 }
 
+Messages::WebContentServer::BenchmarkLayoutResponse ConnectionFromClient::benchmark_layout(u32 iterations)
+{
+    auto* document = page().top_level_browsing_context().active_document();
+    if (!document || !document->layout_node())
+        return { 0, 0 };
+
+    auto timer = Core::ElapsedTimer::start_new();
+    for (u32 i = 0; i < iterations; ++i)
+        document->force_layout();
+    auto full_layout_microseconds = timer.elapsed_time().to_microseconds();
+
+    // Simulate a change to the last piece of text in the document, which has to be laid out again
+    // along with its ancestors, while everything else may reuse the results of the previous pass.
+    Web::Layout::TextNode* last_text_node = nullptr;
+    document->layout_node()->for_each_in_inclusive_subtree_of_type<Web::Layout::TextNode>([&](auto& text_node) {
+        last_text_node = &text_node;
+        return IterationDecision::Continue;
+    });
+
+    timer.start();
+    for (u32 i = 0; i < iterations; ++i) {
+        if (last_text_node)
+            last_text_node->set_needs_layout();
+        else
+            document->set_needs_layout();
+        document->update_layout();
+    }
+    auto incremental_layout_microseconds = timer.elapsed_time().to_microseconds();
+
+    return { static_cast<u64>(full_layout_microseconds), static_cast<u64>(incremental_layout_microseconds) };
+}
+
 void ConnectionFromClient::set_content_filters(Vector<String> const& filters)
 {
     for (auto& filter : filters)
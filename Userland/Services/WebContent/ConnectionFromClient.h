@@ -58,6 +58,7 @@ private:
     virtual Messages::WebContentServer::InspectDomNodeResponse inspect_dom_node(i32 node_id, Optional<Web::CSS::Selector::PseudoElement> const& pseudo_element) override;
     virtual Messages::WebContentServer::GetHoveredNodeIdResponse get_hovered_node_id() override;
     virtual Messages::WebContentServer::DumpLayoutTreeResponse dump_layout_tree() override;
+    virtual Messages::WebContentServer::BenchmarkLayoutResponse benchmark_layout(u32 iterations) override;
     virtual void set_content_filters(Vector<String> const&) override;
     virtual void set_proxy_mappings(Vector<String> const&, HashMap<String, size_t> const&) override;
     virtual void set_preferred_color_scheme(Web::CSS::PreferredColorScheme const&) override;
@@ -30,7 +30,18 @@ PageHost::PageHost(ConnectionFromClient& client)
 
 void PageHost::set_has_focus(bool has_focus)
 {
+    if (m_has_focus == has_focus)
+        return;
     m_has_focus = has_focus;
+    m_tile_cache.clear();
+}
+
+void PageHost::set_should_show_line_box_borders(bool should_show_line_box_borders)
+{
+    if (m_should_show_line_box_borders == should_show_line_box_borders)
+        return;
+    m_should_show_line_box_borders = should_show_line_box_borders;
+    m_tile_cache.clear();
 }
 
 void PageHost::setup_palette()
@@ -53,6 +64,7 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(Gfx::PaletteImpl const& impl)
 {
     m_palette_impl = impl;
+    m_tile_cache.clear();
 }
 
 void PageHost::set_preferred_color_scheme(Web::CSS::PreferredColorScheme color_scheme)
@@ -77,23 +89,69 @@ Web::Layout::InitialContainingBlock* PageHost::layout_root()
 
 void PageHost::paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target)
 {
-    Gfx::Painter painter(target);
-    Gfx::IntRect bitmap_rect { {}, content_rect.size() };
-
     if (auto* document = page().top_level_browsing_context().active_document())
         document->update_layout();
 
     auto* layout_root = this->layout_root();
     if (!layout_root) {
-        painter.fill_rect(bitmap_rect, palette().base());
+        Gfx::Painter painter(target);
+        painter.fill_rect({ {}, content_rect.size() }, palette().base());
+        return;
+    }
+
+    if (m_tile_cache_layout_root != layout_root) {
+        m_tile_cache.clear();
+        m_tile_cache_layout_root = layout_root;
+        m_has_content_that_depends_on_scroll_position.clear();
+    }
+
+    // Fixed-position boxes and fixed backgrounds move relative to the content when scrolling,
+    // so tiles painted at one scroll position can't be reused at another.
+    if (has_content_that_depends_on_scroll_position(*layout_root)) {
+        m_tile_cache.clear();
+        paint_content(*layout_root, content_rect, target);
         return;
     }
 
+    m_tile_cache.paint(content_rect, target, [&](Gfx::IntRect const& rect, Gfx::Bitmap& bitmap) {
+        paint_content(*layout_root, rect, bitmap);
+    });
+    m_tile_cache.evict_tiles_far_from(content_rect);
+}
+
+void PageHost::paint_content(Web::Layout::InitialContainingBlock& layout_root, Gfx::IntRect const& content_rect, Gfx::Bitmap& target)
+{
+    Gfx::Painter painter(target);
     Web::PaintContext context(painter, palette(), content_rect.top_left());
     context.set_should_show_line_box_borders(m_should_show_line_box_borders);
     context.set_viewport_rect(content_rect);
     context.set_has_focus(m_has_focus);
-    layout_root->paint_all_phases(context);
+    layout_root.paint_all_phases(context);
+}
+
+bool PageHost::has_content_that_depends_on_scroll_position(Web::Layout::InitialContainingBlock& layout_root)
+{
+    if (m_has_content_that_depends_on_scroll_position.has_value())
+        return m_has_content_that_depends_on_scroll_position.value();
+
+    bool found = false;
+    layout_root.for_each_in_inclusive_subtree([&](auto& layout_node) {
+        if (!layout_node.has_style())
+            return IterationDecision::Continue;
+        if (layout_node.is_fixed_position()) {
+            found = true;
+            return IterationDecision::Break;
+        }
+        for (auto const& layer : layout_node.computed_values().background_layers()) {
+            if (layer.attachment == Web::CSS::BackgroundAttachment::Fixed) {
+                found = true;
+                return IterationDecision::Break;
+            }
+        }
+        return IterationDecision::Continue;
+    });
+    m_has_content_that_depends_on_scroll_position = found;
+    return found;
 }
 
 void PageHost::set_viewport_rect(Gfx::IntRect const& rect)
@@ -103,6 +161,11 @@ void PageHost::set_viewport_rect(Gfx::IntRect const& rect)
 
 void PageHost::page_did_invalidate(Gfx::IntRect const& content_rect)
 {
+    // NOTE: Invalidations outside the viewport still have to drop the tiles they cover, but the client doesn't need to hear about them.
+    m_tile_cache.invalidate(content_rect);
+    if (!page().top_level_browsing_context().viewport_rect().intersects(content_rect))
+        return;
+
     m_invalidation_rect = m_invalidation_rect.united(content_rect);
     if (!m_invalidation_coalescing_timer->is_active())
         m_invalidation_coalescing_timer->start();
@@ -122,6 +185,10 @@ void PageHost::page_did_layout()
 {
     auto* layout_root = this->layout_root();
     VERIFY(layout_root);
+
+    // NOTE: The tiles aren't dropped here, the document invalidates the parts of the page that layout changed.
+    m_has_content_that_depends_on_scroll_position.clear();
+
     Gfx::IntSize content_size;
     if (layout_root->paint_box()->has_overflow())
         content_size = enclosing_int_rect(layout_root->paint_box()->scrollable_overflow_rect().value()).size();
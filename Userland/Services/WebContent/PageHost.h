@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "TileCache.h"
 #include <LibGfx/Rect.h>
 #include <LibWeb/Page/Page.h>
 
@@ -31,7 +32,7 @@ public:
     void set_screen_rects(Vector<Gfx::IntRect, 4> const& rects, size_t main_screen_index) { m_screen_rect = rects[main_screen_index]; };
     void set_preferred_color_scheme(Web::CSS::PreferredColorScheme);
 
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool);
     void set_has_focus(bool);
     void set_is_scripting_enabled(bool);
 
@@ -72,6 +73,9 @@ private:
     Web::Layout::InitialContainingBlock* layout_root();
     void setup_palette();
 
+    void paint_content(Web::Layout::InitialContainingBlock&, Gfx::IntRect const& content_rect, Gfx::Bitmap&);
+    bool has_content_that_depends_on_scroll_position(Web::Layout::InitialContainingBlock&);
+
     ConnectionFromClient& m_client;
     NonnullOwnPtr<Web::Page> m_page;
     RefPtr<Gfx::PaletteImpl> m_palette_impl;
@@ -81,6 +85,10 @@ private:
 
     RefPtr<Core::Timer> m_invalidation_coalescing_timer;
     Gfx::IntRect m_invalidation_rect;
+
+    TileCache m_tile_cache;
+    Web::Layout::InitialContainingBlock const* m_tile_cache_layout_root { nullptr };
+    Optional<bool> m_has_content_that_depends_on_scroll_position;
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
 };
 
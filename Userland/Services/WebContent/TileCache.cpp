@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "TileCache.h"
+#include <LibGfx/Painter.h>
+
+namespace WebContent {
+
+// Tiles within this many tile sizes of the visible area are kept around, which covers scrolling back and forth.
+static constexpr int retained_tile_margin = 4 * TileCache::tile_size;
+
+Gfx::IntRect TileCache::rect_for_tile(Gfx::IntPoint const& index)
+{
+    return { index.x() * tile_size, index.y() * tile_size, tile_size, tile_size };
+}
+
+static int tile_index_for_coordinate(int coordinate)
+{
+    // NOTE: Content coordinates can be negative, and those still need to round down.
+    if (coordinate < 0)
+        return -((-coordinate + TileCache::tile_size - 1) / TileCache::tile_size);
+    return coordinate / TileCache::tile_size;
+}
+
+template<typename Callback>
+void TileCache::for_each_tile_index_in(Gfx::IntRect const& content_rect, Callback callback)
+{
+    if (content_rect.is_empty())
+        return;
+    auto first_column = tile_index_for_coordinate(content_rect.left());
+    auto last_column = tile_index_for_coordinate(content_rect.right());
+    auto first_row = tile_index_for_coordinate(content_rect.top());
+    auto last_row = tile_index_for_coordinate(content_rect.bottom());
+    for (int row = first_row; row <= last_row; ++row) {
+        for (int column = first_column; column <= last_column; ++column)
+            callback(Gfx::IntPoint { column, row });
+    }
+}
+
+void TileCache::paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target, RasterizeCallback const& rasterize)
+{
+    Gfx::Painter painter(target);
+    painter.translate(-content_rect.location());
+
+    Vector<Gfx::IntPoint> missing_tiles;
+    Gfx::IntRect missing_rect;
+    for_each_tile_index_in(content_rect, [&](Gfx::IntPoint const& index) {
+        if (m_tiles.contains(index))
+            return;
+        missing_tiles.append(index);
+        missing_rect = missing_rect.united(rect_for_tile(index));
+    });
+
+    // NOTE: Every rasterization is a full walk of the paint tree, so all the missing tiles are painted together
+    //       and then cut up, rather than painting the page once per tile.
+    if (!missing_tiles.is_empty()) {
+        auto bitmap_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, missing_rect.size());
+        if (bitmap_or_error.is_error()) {
+            // Without memory for the missing tiles, paint straight into the target instead.
+            dbgln("TileCache: Failed to allocate {} tiles, painting without caching", missing_tiles.size());
+            rasterize(content_rect, target);
+            return;
+        }
+        auto bitmap = bitmap_or_error.release_value();
+        rasterize(missing_rect, *bitmap);
+
+        for (auto& index : missing_tiles) {
+            auto tile_rect = rect_for_tile(index);
+            auto rect_in_bitmap = tile_rect.translated(-missing_rect.location());
+            auto tile_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, tile_rect.size());
+            if (tile_or_error.is_error()) {
+                dbgln("TileCache: Failed to allocate a tile, painting without caching");
+                auto visible_rect = tile_rect.intersected(content_rect);
+                painter.blit(visible_rect.location(), *bitmap, visible_rect.translated(-missing_rect.location()));
+                continue;
+            }
+            auto tile = tile_or_error.release_value();
+            Gfx::Painter tile_painter(*tile);
+            tile_painter.blit({}, *bitmap, rect_in_bitmap);
+            m_tiles.set(index, move(tile));
+        }
+    }
+
+    for_each_tile_index_in(content_rect, [&](Gfx::IntPoint const& index) {
+        auto it = m_tiles.find(index);
+        if (it == m_tiles.end())
+            return;
+        auto tile_rect = rect_for_tile(index);
+        auto visible_rect = tile_rect.intersected(content_rect);
+        painter.blit(visible_rect.location(), *it->value, visible_rect.translated(-tile_rect.location()));
+    });
+}
+
+void TileCache::invalidate(Gfx::IntRect const& content_rect)
+{
+    if (m_tiles.is_empty())
+        return;
+    for_each_tile_index_in(content_rect, [&](Gfx::IntPoint const& index) {
+        m_tiles.remove(index);
+    });
+}
+
+void TileCache::evict_tiles_far_from(Gfx::IntRect const& content_rect)
+{
+    auto retained_rect = content_rect.inflated(2 * retained_tile_margin, 2 * retained_tile_margin);
+    m_tiles.remove_all_matching([&](auto const& index, auto const&) {
+        return !rect_for_tile(index).intersects(retained_rect);
+    });
+}
+
+}
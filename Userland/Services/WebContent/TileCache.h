@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Point.h>
+#include <LibGfx/Rect.h>
+
+namespace WebContent {
+
+// Keeps the page content rasterized in fixed-size tiles, in content coordinates.
+// Paints only have to rasterize the tiles that are new or have been invalidated since they were last painted,
+// so scrolling mostly comes down to copying tiles that are already there.
+class TileCache {
+public:
+    static constexpr int tile_size = 256;
+
+    // Paints the given content rect into the bitmap, which is exactly as large as the rect.
+    using RasterizeCallback = Function<void(Gfx::IntRect const& content_rect, Gfx::Bitmap&)>;
+
+    // Rasterizes all the tiles that are missing from the content rect with a single call to the callback.
+    void paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target, RasterizeCallback const&);
+
+    void invalidate(Gfx::IntRect const& content_rect);
+    void clear() { m_tiles.clear(); }
+
+    // Drops the tiles that are far away from the given rect, to bound the memory used by the cache.
+    void evict_tiles_far_from(Gfx::IntRect const& content_rect);
+
+    size_t tile_count() const { return m_tiles.size(); }
+
+private:
+    static Gfx::IntRect rect_for_tile(Gfx::IntPoint const& index);
+
+    template<typename Callback>
+    static void for_each_tile_index_in(Gfx::IntRect const& content_rect, Callback);
+
+    HashMap<Gfx::IntPoint, NonnullRefPtr<Gfx::Bitmap>> m_tiles;
+};
+
+}
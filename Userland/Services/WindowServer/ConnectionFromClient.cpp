@@ -6,6 +6,7 @@
 
 #include <AK/Badge.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/StandardCursor.h>
 #include <LibGfx/SystemTheme.h>
 #include <WindowServer/AppletManager.h>
@@ -45,6 +46,13 @@ ConnectionFromClient* ConnectionFromClient::from_client_id(int client_id)
     return (*it).value.ptr();
 }
 
+static Optional<IPC::File> glyph_atlas_file()
+{
+    if (auto* atlas = Gfx::GlyphAtlas::the())
+        return IPC::File(atlas->read_only_fd());
+    return {};
+}
+
 ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket> client_socket, int client_id)
     : IPC::ConnectionFromClient<WindowClientEndpoint, WindowServerEndpoint>(*this, move(client_socket), client_id)
 {
@@ -53,7 +61,7 @@ ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSock
     s_connections->set(client_id, *this);
 
     auto& wm = WindowManager::the();
-    async_fast_greet(Screen::rects(), Screen::main().index(), wm.window_stack_rows(), wm.window_stack_columns(), Gfx::current_system_theme_buffer(), Gfx::FontDatabase::default_font_query(), Gfx::FontDatabase::fixed_width_font_query(), client_id);
+    async_fast_greet(Screen::rects(), Screen::main().index(), wm.window_stack_rows(), wm.window_stack_columns(), Gfx::current_system_theme_buffer(), Gfx::FontDatabase::default_font_query(), Gfx::FontDatabase::fixed_width_font_query(), glyph_atlas_file(), client_id);
 }
 
 ConnectionFromClient::~ConnectionFromClient()
@@ -1174,6 +1182,12 @@ void ConnectionFromClient::set_flash_flush(bool enabled)
     Compositor::the().set_flash_flush(enabled);
 }
 
+void ConnectionFromClient::add_glyph_to_atlas(u32 typeface_index, u32 x_scale_bits, u32 y_scale_bits, u32 glyph_id)
+{
+    if (auto* atlas = Gfx::GlyphAtlas::the())
+        atlas->rasterize_and_insert({ typeface_index, x_scale_bits, y_scale_bits, glyph_id });
+}
+
 void ConnectionFromClient::set_window_parent_from_client(i32 client_id, i32 parent_id, i32 child_id)
 {
     auto child_window = window_from_id(child_id);
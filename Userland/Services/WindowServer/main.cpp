@@ -13,6 +13,8 @@
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibCore/System.h>
+#include <LibGfx/Font/FontDatabase.h>
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/Palette.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibMain/Main.h>
@@ -22,6 +24,20 @@
 ErrorOr<int> serenity_main(Main::Arguments)
 {
     TRY(Core::System::pledge("stdio video thread sendfd recvfd accept rpath wpath cpath unix proc sigaction exec"));
+
+    // Clients get a read-only mapping of this atlas when they connect, so glyphs rasterized by us are shared with all of them.
+    // NOTE: This happens before unveiling, since the atlas is backed by a file in /tmp that we have to open twice.
+    if (auto glyph_atlas_or_error = Gfx::GlyphAtlas::try_create(); !glyph_atlas_or_error.is_error()) {
+        auto glyph_atlas = glyph_atlas_or_error.release_value();
+        Gfx::FontDatabase::the().for_each_typeface([&](Gfx::Typeface const& typeface) {
+            if (auto vector_font = typeface.vector_font())
+                (void)glyph_atlas->register_typeface(typeface.family(), typeface.variant(), *vector_font);
+        });
+        Gfx::GlyphAtlas::set_the(move(glyph_atlas));
+    } else {
+        dbgln("Failed to create glyph atlas: {}", glyph_atlas_or_error.error());
+    }
+
     TRY(Core::System::unveil("/res", "r"));
     TRY(Core::System::unveil("/tmp", "cw"));
     TRY(Core::System::unveil("/etc/WindowServer.ini", "rwc"));
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
+#include <LibELF/PrelinkCache.h>
+#include <LibMain/Main.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static ErrorOr<int> run_loader(StringView program, Vector<StringView> const& extra_environment)
+{
+    Vector<String> environment_strings;
+    for (char** env = environ; *env; ++env)
+        environment_strings.append(*env);
+    for (auto variable : extra_environment)
+        environment_strings.append(variable);
+
+    Vector<char*> environment;
+    for (auto& variable : environment_strings)
+        environment.append(const_cast<char*>(variable.characters()));
+    environment.append(nullptr);
+
+    auto program_string = program.to_string();
+    char* arguments[] = { const_cast<char*>(program_string.characters()), nullptr };
+    pid_t child_pid = TRY(Core::System::posix_spawnp(program, nullptr, nullptr, arguments, environment.data()));
+    auto [_, status] = TRY(Core::System::waitpid(child_pid));
+    if (!WIFEXITED(status))
+        return 1;
+    return WEXITSTATUS(status);
+}
+
+// Measures how long it takes to get each program ready to run, i.e. loading and linking everything up to the initializers.
+static ErrorOr<u64> average_link_time_in_microseconds(StringView program, int runs, bool use_prelink_cache)
+{
+    Vector<StringView> environment { "_LOADER_EXIT_BEFORE_INITIALIZERS=1"sv };
+    if (!use_prelink_cache)
+        environment.append("_LOADER_PRELINK=ignore"sv);
+
+    u64 total_time = 0;
+    for (int i = 0; i < runs; ++i) {
+        Core::ElapsedTimer timer { true };
+        timer.start();
+        if (TRY(run_loader(program, environment)) != 0)
+            return Error::from_string_literal("Program failed to load");
+        total_time += timer.elapsed_time().to_microseconds();
+    }
+    return total_time / runs;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> programs;
+    int benchmark_runs = 0;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Record the symbol resolutions of programs in the prelink cache, so they start faster.");
+    args_parser.add_option(benchmark_runs, "Afterwards, compare load times with and without the cache over this many runs", "benchmark", 'b', "runs");
+    args_parser.add_positional_argument(programs, "Programs to prelink", "programs");
+    args_parser.parse(arguments);
+
+    // The dynamic loader only trusts a cache that's owned by root.
+    if (geteuid() != 0) {
+        warnln("Not running as root :^(");
+        return 1;
+    }
+
+    if (auto result = Core::System::mkdir(ELF::PrelinkCache::directory, 0755); result.is_error() && result.error().code() != EEXIST)
+        return result.release_error();
+
+    int exit_code = 0;
+    for (auto program : programs) {
+        if (TRY(run_loader(program, { "_LOADER_PRELINK=record"sv })) != 0) {
+            warnln("{}: Failed to record prelink cache", program);
+            exit_code = 1;
+            continue;
+        }
+        outln("{}: Prelinked", program);
+
+        if (benchmark_runs <= 0)
+            continue;
+        auto time_without_cache = TRY(average_link_time_in_microseconds(program, benchmark_runs, false));
+        auto time_with_cache = TRY(average_link_time_in_microseconds(program, benchmark_runs, true));
+        outln("{}: Average load time without cache: {} us, with cache: {} us", program, time_without_cache, time_with_cache);
+    }
+    return exit_code;
+}